@@ -0,0 +1,604 @@
+/* Headless benchmarks for the core components of the library. Meshes are
+ * generated synthetically (icosphere, quad grid, tet grid), so that the same
+ * numbers can be obtained on any machine, at three scales. Results (timings,
+ * throughput, resident and peak memory) are written in JSON format, so that
+ * performance regressions can be tracked automatically.
+ *
+ * Usage: benchmarks [-size small|medium|large] [-filter substring] [-out file.json]
+*/
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/icosphere.h>
+#include <cinolib/grid_mesh.h>
+#include <cinolib/voxelize.h>
+#include <cinolib/voxel_grid_to_hexmesh.h>
+#include <cinolib/tetrahedralization.h>
+#include <cinolib/octree.h>
+#include <cinolib/laplacian.h>
+#include <cinolib/harmonic_map.h>
+#include <cinolib/geodesics.h>
+#include <cinolib/dijkstra.h>
+#include <cinolib/marching_tets.h>
+#include <cinolib/export_surface.h>
+#include <cinolib/quality_stats.h>
+#include <cinolib/dual_mesh.h>
+#include <cinolib/subdivision_midpoint.h>
+#include <cinolib/subdivision_barycentric.h>
+#include <cinolib/hex_transition_install.h>
+#include <cinolib/laplacian_spectrum.h>
+#include <cinolib/memory_usage.h>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <thread>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+struct BenchmarkResult
+{
+    std::string name;
+    std::string unit;       // what is being processed (verts, tris, queries, ...)
+    size_t      items;      // how many of them are processed by each run
+    uint        reps;       // number of timed runs
+    double      best_s;     // fastest run
+    double      mean_s;     // average run
+    size_t      rss;        // resident memory after the benchmark
+    size_t      peak_rss;   // peak resident memory of the process so far
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class BenchmarkRunner
+{
+    public:
+
+        explicit BenchmarkRunner(const std::string & filter) : filter(filter) {}
+
+        bool enabled(const std::string & name) const
+        {
+            return filter.empty() || name.find(filter)!=std::string::npos;
+        }
+
+        // runs f at least once, and then repeats it until either min_time
+        // seconds have been spent or max_reps runs have been done. Benchmarks
+        // may be skipped by the filter, hence f must not produce inputs for
+        // other benchmarks (inputs are built outside of run)
+        void run(const std::string           & name,
+                 const std::string           & unit,
+                 const size_t                  items,
+                 const std::function<void()> & f)
+        {
+            if(!enabled(name)) return;
+
+            BenchmarkResult r;
+            r.name   = name;
+            r.unit   = unit;
+            r.items  = items;
+            r.reps   = 0;
+            r.best_s = inf_double;
+            double tot = 0;
+            do
+            {
+                auto t0 = std::chrono::steady_clock::now();
+                f();
+                auto t1 = std::chrono::steady_clock::now();
+                double s = std::chrono::duration<double>(t1-t0).count();
+                r.best_s = std::min(r.best_s, s);
+                tot += s;
+                ++r.reps;
+            }
+            while(tot<min_time && r.reps<max_reps);
+            r.mean_s   = tot/r.reps;
+            r.rss      = memory_usage_in_bytes();
+            r.peak_rss = memory_peak_usage_in_bytes();
+            results.push_back(r);
+
+            std::cerr << std::left  << std::setw(32) << name
+                      << std::right << std::setw(12) << std::fixed << std::setprecision(6) << r.best_s << "s"
+                      << std::setw(14) << std::setprecision(0) << items/r.best_s << " " << unit << "/s"
+                      << std::setw(10) << std::setprecision(1) << r.peak_rss/1048576.0 << "MB peak" << std::endl;
+        }
+
+        void write_json(const std::string & filename, const std::string & size) const
+        {
+            std::ofstream f(filename);
+            if(!f.is_open())
+            {
+                std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write_json() : couldn't open output file " << filename << std::endl;
+                exit(-1);
+            }
+            f << std::setprecision(9);
+            f << "{\n";
+            f << "  \"size\": \""    << size << "\",\n";
+            f << "  \"threads\": "   << std::thread::hardware_concurrency() << ",\n";
+            f << "  \"results\": [\n";
+            for(uint i=0; i<results.size(); ++i)
+            {
+                const BenchmarkResult & r = results.at(i);
+                f << "    { \"name\": \""       << r.name  << "\""
+                  <<   ", \"unit\": \""         << r.unit  << "\""
+                  <<   ", \"items\": "          << r.items
+                  <<   ", \"reps\": "           << r.reps
+                  <<   ", \"best_s\": "         << r.best_s
+                  <<   ", \"mean_s\": "         << r.mean_s
+                  <<   ", \"throughput\": "     << r.items/r.best_s
+                  <<   ", \"rss_bytes\": "      << r.rss
+                  <<   ", \"peak_rss_bytes\": " << r.peak_rss
+                  << " }" << (i+1<results.size() ? ",\n" : "\n");
+            }
+            f << "  ]\n";
+            f << "}\n";
+        }
+
+        double min_time = 0.5;
+        uint   max_reps = 10;
+
+    private:
+
+        std::string                  filter;
+        std::vector<BenchmarkResult> results;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// regular grid of n x n x n voxels in [-1,1]^3, split into tetrahedra
+void tet_grid(const uint n, std::vector<vec3d> & verts, std::vector<uint> & tets)
+{
+    VoxelGrid g;
+    voxelize([](const vec3d &) { return -1.0; }, AABB(vec3d(-1,-1,-1),vec3d(1,1,1)), n, g);
+    Hexmesh<> hm;
+    voxel_grid_to_hexmesh(g, hm, VOXEL_INSIDE | VOXEL_OUTSIDE | VOXEL_BOUNDARY);
+    Tetmesh<> tm;
+    hex_to_tets(hm, tm);
+    verts = tm.vector_verts();
+    tets.clear();
+    for(uint pid=0; pid<tm.num_polys(); ++pid)
+    {
+        for(uint vid : tm.poly_verts_id(pid)) tets.push_back(vid);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// weakly balanced grid: a layer of n x n x 2 coarse hexes on top of a layer of
+// 2n x 2n x 2 fine hexes. Transitions are requested at every other coarse vertex
+// of the interface (in both directions), which yields flat and edge schemes
+void transition_grid(const uint n, Polyhedralmesh<> & m, std::vector<bool> & transition_verts)
+{
+    std::map<std::array<int,3>,uint> v_index; // coords in units of fine hexes
+    std::vector<vec3d>             verts;
+    std::vector<std::vector<uint>> hexes;
+    auto vid = [&](const int x, const int y, const int z)
+    {
+        auto it = v_index.insert(std::make_pair(std::array<int,3>{{x,y,z}},uint(verts.size())));
+        if(it.second) verts.push_back(vec3d(x,y,z)*0.5);
+        return it.first->second;
+    };
+    auto add = [&](const int x, const int y, const int z, const int s)
+    {
+        hexes.push_back({vid(x  ,y  ,z  ), vid(x+s,y  ,z  ), vid(x+s,y  ,z+s), vid(x  ,y  ,z+s),
+                         vid(x  ,y+s,z  ), vid(x+s,y+s,z  ), vid(x+s,y+s,z+s), vid(x  ,y+s,z+s)});
+    };
+    int w = int(2*n);
+    for(int x=0; x<w; x+=2) for(int z=0; z<w; z+=2) for(int y= 0; y<4; y+=2) add(x,y,z,2);
+    for(int x=0; x<w; x+=1) for(int z=0; z<w; z+=1) for(int y=-2; y<0; y+=1) add(x,y,z,1);
+
+    Hexmesh<> hm(verts, hexes);
+    std::vector<std::vector<bool>> winding(hm.num_polys());
+    for(uint pid=0; pid<hm.num_polys(); ++pid) winding.at(pid) = hm.poly_faces_winding(pid);
+    m = Polyhedralmesh<>(hm.vector_verts(), hm.vector_faces(), hm.vector_polys(), winding);
+
+    transition_verts.assign(m.num_verts(), false);
+    for(const auto & v : v_index)
+    {
+        const std::array<int,3> & c = v.first;
+        if(c[1]==0 && c[0]%4==2 && c[2]%4==2) transition_verts.at(v.second) = true;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// icosphere() outputs a triangle soup (midpoints are not shared across
+// adjacent triangles). Bitwise identical vertices are merged here
+void weld(std::vector<double> & verts, std::vector<uint> & tris)
+{
+    std::map<vec3d,uint> unique;
+    std::vector<uint>    vmap(verts.size()/3);
+    std::vector<double>  tmp;
+    for(uint vid=0; vid<vmap.size(); ++vid)
+    {
+        vec3d p(verts[3*vid], verts[3*vid+1], verts[3*vid+2]);
+        auto it = unique.insert(std::make_pair(p,uint(unique.size())));
+        if(it.second)
+        {
+            tmp.push_back(p.x());
+            tmp.push_back(p.y());
+            tmp.push_back(p.z());
+        }
+        vmap[vid] = it.first->second;
+    }
+    for(uint & vid : tris) vid = vmap[vid];
+    verts.swap(tmp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    std::string size   = "medium";
+    std::string filter = "";
+    std::string out    = "benchmarks.json";
+    for(int i=1; i+1<argc; i+=2)
+    {
+        if     (strcmp(argv[i],"-size"  )==0) size   = argv[i+1];
+        else if(strcmp(argv[i],"-filter")==0) filter = argv[i+1];
+        else if(strcmp(argv[i],"-out"   )==0) out    = argv[i+1];
+    }
+
+    uint scale = 1;
+    if(size=="small") scale = 0; else
+    if(size=="large") scale = 2;
+
+    const uint ico_subd[3]    = {  5,   6,    7 }; // 10K, 40K, 160K verts
+    const uint quads[3]       = { 128, 512, 1024 }; // quads per side
+    const uint voxels[3]      = {  16,  32,   48 }; // voxels per side (tet grid)
+    const uint coarse_hexs[3] = {  16,  32,   64 }; // coarse hexes per side (transition grid)
+    const uint n_queries      = 10000;
+    const uint n_eigenpairs   = 100;
+
+    // the library logs on stdout (e.g. when a mesh is loaded), which
+    // is silenced here. Progress is reported on stderr instead
+    std::cout.setstate(std::ios_base::failbit);
+
+    BenchmarkRunner b(filter);
+    std::mt19937 rng(1234);
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+    // inputs shared by all benchmarks (built untimed, regardless of the filter)
+
+    std::vector<double> tri_verts;
+    std::vector<uint>   tri_polys;
+    icosphere(1.f, ico_subd[scale], tri_verts, tri_polys);
+    weld(tri_verts, tri_polys);
+
+    Quadmesh<> qm;
+    grid_mesh(quads[scale], quads[scale], qm);
+    std::vector<vec3d> quad_verts = qm.vector_verts();
+    std::vector<uint>  quad_polys = serialized_vids_from_polys(qm.vector_polys());
+
+    std::vector<vec3d> tet_verts;
+    std::vector<uint>  tet_polys;
+    tet_grid(voxels[scale], tet_verts, tet_polys);
+
+    Trimesh<> tm(tri_verts, tri_polys);
+    Tetmesh<> tetm(tet_verts, tet_polys);
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+    // generators
+
+    b.run("generate/icosphere", "tris", 20*(1u<<(2*ico_subd[scale])), [&]()
+    {
+        std::vector<double> verts;
+        std::vector<uint>   tris;
+        icosphere(1.f, ico_subd[scale], verts, tris);
+        weld(verts, tris);
+    });
+
+    b.run("generate/grid_mesh", "quads", quads[scale]*quads[scale], [&]()
+    {
+        Quadmesh<> tmp;
+        grid_mesh(quads[scale], quads[scale], tmp);
+    });
+
+    b.run("generate/tet_grid", "voxels", voxels[scale]*voxels[scale]*voxels[scale], [&]()
+    {
+        std::vector<vec3d> verts;
+        std::vector<uint>  tets;
+        tet_grid(voxels[scale], verts, tets);
+    });
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+    // mesh initialization
+
+    b.run("init/trimesh", "tris", tri_polys.size()/3, [&]()
+    {
+        Trimesh<> tmp(tri_verts, tri_polys);
+    });
+
+    b.run("init/quadmesh", "quads", quad_polys.size()/4, [&]()
+    {
+        Quadmesh<> tmp(quad_verts, quad_polys);
+    });
+
+    b.run("init/tetmesh", "tets", tet_polys.size()/4, [&]()
+    {
+        Tetmesh<> tmp(tet_verts, tet_polys);
+    });
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+    // adjacency queries and attribute updates
+
+    b.run("query/edge_id_trimesh", "queries", tm.num_edges(), [&]()
+    {
+        volatile int sum = 0;
+        for(uint eid=0; eid<tm.num_edges(); ++eid)
+        {
+            sum += tm.edge_id(tm.edge_vert_id(eid,0), tm.edge_vert_id(eid,1));
+        }
+    });
+
+    b.run("query/edge_id_tetmesh", "queries", tetm.num_edges(), [&]()
+    {
+        volatile int sum = 0;
+        for(uint eid=0; eid<tetm.num_edges(); ++eid)
+        {
+            sum += tetm.edge_id(tetm.edge_vert_id(eid,0), tetm.edge_vert_id(eid,1));
+        }
+    });
+
+    Trimesh<> tm_indexed = tm;
+    tm_indexed.hash_index_enable();
+    b.run("query/edge_id_trimesh_indexed", "queries", tm_indexed.num_edges(), [&]()
+    {
+        volatile int sum = 0;
+        for(uint eid=0; eid<tm_indexed.num_edges(); ++eid)
+        {
+            sum += tm_indexed.edge_id(tm_indexed.edge_vert_id(eid,0), tm_indexed.edge_vert_id(eid,1));
+        }
+    });
+
+    b.run("query/poly_id_trimesh_indexed", "queries", tm_indexed.num_polys(), [&]()
+    {
+        volatile int sum = 0;
+        for(uint pid=0; pid<tm_indexed.num_polys(); ++pid)
+        {
+            sum += tm_indexed.poly_id(tm_indexed.adj_p2v(pid));
+        }
+    });
+
+    // removes every other triangle (both timings include the copy of the mesh)
+    std::vector<uint> pids_to_remove;
+    for(uint pid=0; pid<tm.num_polys(); pid+=2) pids_to_remove.push_back(pid);
+
+    b.run("edit/polys_remove_trimesh", "tris", pids_to_remove.size(), [&]()
+    {
+        Trimesh<> m = tm;
+        m.polys_remove(pids_to_remove);
+    });
+
+    b.run("edit/polys_remove_trimesh_batch", "tris", pids_to_remove.size(), [&]()
+    {
+        Trimesh<> m = tm;
+        m.batch_begin();
+        m.polys_remove(pids_to_remove);
+        m.batch_end();
+    });
+
+    b.run("update/normals_trimesh", "tris", tm.num_polys(), [&]()
+    {
+        tm.update_normals();
+    });
+
+    b.run("update/normals_tetmesh", "faces", tetm.num_faces(), [&]()
+    {
+        tetm.update_normals();
+    });
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+    // spatial queries
+
+    b.run("octree/build", "tris", tm.num_polys(), [&]()
+    {
+        Octree tmp;
+        tmp.build_from_mesh_polys(tm);
+    });
+
+    Octree octree;
+    if(b.enabled("octree/closest_point") || b.enabled("octree/ray_first_hit")) octree.build_from_mesh_polys(tm);
+
+    std::uniform_real_distribution<double> rnd(-1.5, 1.5);
+    std::vector<vec3d> points(n_queries);
+    for(vec3d & p : points) p = vec3d(rnd(rng), rnd(rng), rnd(rng));
+
+    b.run("octree/closest_point", "queries", n_queries, [&]()
+    {
+        uint   id;
+        vec3d  pos;
+        double dist;
+        for(const vec3d & p : points) octree.closest_point(p, id, pos, dist);
+    });
+
+    b.run("octree/ray_first_hit", "queries", n_queries, [&]()
+    {
+        uint   id;
+        double t;
+        for(const vec3d & p : points) octree.intersects_ray(p*2, -p, t, id);
+    });
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+    // linear algebra and geometry processing
+
+    b.run("solver/laplacian_assembly", "verts", tm.num_verts(), [&]()
+    {
+        laplacian(tm, COTANGENT);
+    });
+
+    std::map<uint,double> bc;
+    bc[0] = 0.0;
+    bc[tm.num_verts()-1] = 1.0;
+    b.run("solver/harmonic_map", "verts", tm.num_verts(), [&]()
+    {
+        harmonic_map(tm, bc);
+    });
+
+    b.run("geodesics/heat", "verts", tm.num_verts(), [&]()
+    {
+        compute_geodesics(tm, {0});
+    });
+
+    b.run("dijkstra/exhaustive", "verts", tm.num_verts(), [&]()
+    {
+        std::vector<double> dist;
+        dijkstra_exhaustive(tm, 0, dist);
+    });
+
+    b.run("voxelize/trimesh", "voxels", 128*128*128, [&]()
+    {
+        VoxelGrid g;
+        voxelize(tm, 128, g);
+    });
+
+    for(uint vid=0; vid<tetm.num_verts(); ++vid)
+    {
+        tetm.vert_uvw(vid)[0] = tetm.vert(vid).norm();
+    }
+    b.run("marching_tets", "tets", tetm.num_polys(), [&]()
+    {
+        std::vector<vec3d> verts, norms;
+        std::vector<uint>  tris;
+        marching_tets(tetm, 0.5, verts, tris, norms);
+    });
+
+    b.run("quality/update_quality_tetmesh", "tets", tetm.num_polys(), [&]()
+    {
+        tetm.update_quality();
+    });
+
+    b.run("quality/mesh_quality_tetmesh", "tets", tetm.num_polys(), [&]()
+    {
+        MeshQuality tmp;
+        mesh_quality(tetm, QUALITY_SCALED_JACOBIAN | QUALITY_VOLUME, tmp);
+    });
+
+    MeshQuality tet_q;
+    mesh_quality(tetm, QUALITY_SCALED_JACOBIAN | QUALITY_VOLUME, tet_q);
+    std::vector<uint> moved_verts;
+    for(uint vid=0; vid<tetm.num_verts(); vid+=100) moved_verts.push_back(vid);
+    b.run("quality/mesh_quality_update", "verts", moved_verts.size(), [&]()
+    {
+        mesh_quality_update(tetm, moved_verts, tet_q);
+    });
+
+    b.run("export_surface/tetmesh", "faces", tetm.num_faces(), [&]()
+    {
+        Trimesh<>         tmp;
+        std::vector<int>  m2srf;
+        std::vector<uint> srf2m;
+        export_surface(tetm, tmp, m2srf, srf2m);
+    });
+
+    Trimesh<>         tet_srf;
+    std::vector<int>  m2srf;
+    std::vector<uint> srf2m;
+    export_surface(tetm, tet_srf, m2srf, srf2m);
+    b.run("export_surface/positions", "verts", tet_srf.num_verts(), [&]()
+    {
+        export_surface_positions(tetm, tet_srf, srf2m);
+    });
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+    // dual meshes
+
+    b.run("dual_mesh/trimesh", "verts", tm.num_verts(), [&]()
+    {
+        Polygonmesh<> tmp;
+        dual_mesh(tm, tmp, true);
+    });
+    b.run("dual_mesh/tetmesh", "verts", tetm.num_verts(), [&]()
+    {
+        Polyhedralmesh<> tmp;
+        dual_mesh(tetm, tmp, true);
+    });
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+    // subdivision
+
+    b.run("subdivision/midpoint_tetmesh", "tets", tetm.num_polys(), [&]()
+    {
+        Hexmesh<> tmp;
+        subdivision_midpoint(tetm, tmp);
+    });
+
+    Hexmesh<> hexm;
+    if(b.enabled("subdivision/midpoint_hexmesh")) subdivision_midpoint(tetm, hexm);
+    b.run("subdivision/midpoint_hexmesh", "hexas", hexm.num_polys(), [&]()
+    {
+        Hexmesh<> tmp;
+        subdivision_midpoint(hexm, tmp);
+    });
+    b.run("subdivision/midpoint_tetmesh_2_levels", "tets", tetm.num_polys(), [&]()
+    {
+        Hexmesh<> tmp;
+        subdivision_midpoint(tetm, tmp, 2);
+    });
+    b.run("subdivision/barycentric_tetmesh", "tets", tetm.num_polys(), [&]()
+    {
+        Tetmesh<> tmp = tetm;
+        subdivision_barycentric(tmp);
+    });
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+    // spectral analysis
+
+    b.run("spectrum/laplacian_trimesh", "eigenpairs", n_eigenpairs, [&]()
+    {
+        LaplacianSpectrum spectrum(tm);
+        spectrum.compute(n_eigenpairs);
+    });
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+    // hex transitions
+
+    Polyhedralmesh<>  grid;
+    std::vector<bool> transition_verts;
+    transition_grid(coarse_hexs[scale], grid, transition_verts);
+    size_t n_transitions = std::count(transition_verts.begin(), transition_verts.end(), true);
+    b.run("hex_transition/install", "transitions", n_transitions, [&]()
+    {
+        Polyhedralmesh<> tmp;
+        hex_transition_install(grid, transition_verts, tmp);
+    });
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+    // I/O
+
+    for(std::string ext : {".obj", ".off", ".stl"})
+    {
+        std::string filename = "cinolib_benchmark" + ext;
+        b.run("io/write" + ext, "tris", tm.num_polys(), [&]()
+        {
+            tm.save(filename.c_str());
+        });
+        if(b.enabled("io/read" + ext) && !b.enabled("io/write" + ext)) tm.save(filename.c_str());
+        b.run("io/read" + ext, "tris", tm.num_polys(), [&]()
+        {
+            Trimesh<> tmp(filename.c_str());
+        });
+        std::remove(filename.c_str());
+    }
+
+    for(std::string ext : {".mesh", ".tet"})
+    {
+        std::string filename = "cinolib_benchmark" + ext;
+        b.run("io/write" + ext, "tets", tetm.num_polys(), [&]()
+        {
+            tetm.save(filename.c_str());
+        });
+        if(b.enabled("io/read" + ext) && !b.enabled("io/write" + ext)) tetm.save(filename.c_str());
+        b.run("io/read" + ext, "tets", tetm.num_polys(), [&]()
+        {
+            Tetmesh<> tmp(filename.c_str());
+        });
+        std::remove(filename.c_str());
+    }
+
+    std::cout.clear();
+    b.write_json(out, size);
+    std::cerr << "results written to " << out << std::endl;
+    return 0;
+}
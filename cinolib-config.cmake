@@ -41,6 +41,11 @@ option(CINOLIB_USES_VTK                 "Use VTK"                    OFF)
 option(CINOLIB_USES_SPECTRA             "Use Spectra"                OFF)
 option(CINOLIB_USES_CGAL                "Use CGAL"                   OFF)
 
+option(CINOLIB_COMPILED_LIB             "Compile the default meshes in a library (static, or shared if BUILD_SHARED_LIBS)" OFF)
+option(CINOLIB_PRECOMPILED_HEADERS      "Precompile the mesh headers (CMake 3.16+)"                                       OFF)
+option(CINOLIB_UNITY_BUILD              "Unity build for the compiled library (CMake 3.16+)"                              OFF)
+option(CINOLIB_PROFILING                "Enable the profiler zones spread across the library (see profiler_zones.h)"      OFF)
+
 #::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 #::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 #::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -178,3 +183,58 @@ if(CINOLIB_USES_CGAL)
     endif()
 endif()
 
+#::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+if(CINOLIB_PROFILING)
+    message("CINOLIB PROFILING")
+    target_compile_definitions(cinolib INTERFACE CINOLIB_PROFILING)
+endif()
+
+#::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+# COMPILED LIBRARY ::::::::::::::::::::::::::::::::::::::::::::::::::::::
+#::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+# The meshes with default attributes (Trimesh<>, Tetmesh<>, Hexmesh<>, ...)
+# are explicitly instantiated once in cinolib_meshes, and client code only
+# sees extern template declarations (CINOLIB_COMPILED_LIB). Everything else
+# stays header only. This section must come after the optional modules,
+# because the library inherits their settings from the interface target
+
+if(CINOLIB_COMPILED_LIB)
+    message("CINOLIB COMPILED LIBRARY")
+    add_library(cinolib_meshes ${cinolib_DIR}/src/polygon_meshes.cpp
+                               ${cinolib_DIR}/src/polyhedral_meshes.cpp)
+    # copy (rather than link) the usage requirements of cinolib, which will depend on cinolib_meshes
+    foreach(prop INCLUDE_DIRECTORIES COMPILE_DEFINITIONS COMPILE_FEATURES COMPILE_OPTIONS LINK_LIBRARIES)
+        get_target_property(value cinolib INTERFACE_${prop})
+        if(value)
+            set_property(TARGET cinolib_meshes PROPERTY ${prop} ${value})
+        endif()
+    endforeach()
+    target_compile_definitions(cinolib_meshes PRIVATE CINOLIB_COMPILED_LIB)
+    set_target_properties(cinolib_meshes PROPERTIES WINDOWS_EXPORT_ALL_SYMBOLS ON)
+    target_compile_definitions(cinolib INTERFACE CINOLIB_COMPILED_LIB)
+    target_link_libraries(cinolib INTERFACE cinolib_meshes)
+    if(CINOLIB_UNITY_BUILD)
+        if(CMAKE_VERSION VERSION_LESS 3.16)
+            message("Unity build requires CMake 3.16 or newer!")
+        else()
+            set_target_properties(cinolib_meshes PROPERTIES UNITY_BUILD ON)
+        endif()
+    endif()
+endif()
+
+#::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+if(CINOLIB_PRECOMPILED_HEADERS)
+    if(CMAKE_VERSION VERSION_LESS 3.16)
+        message("Precompiled headers require CMake 3.16 or newer!")
+    else()
+        message("CINOLIB PRECOMPILED HEADERS")
+        # every target linking cinolib builds (once) its own precompiled header
+        target_precompile_headers(cinolib INTERFACE <cinolib/meshes/meshes.h>)
+        if(TARGET cinolib_meshes)
+            target_precompile_headers(cinolib_meshes PRIVATE <cinolib/meshes/meshes.h>)
+        endif()
+    endif()
+endif()
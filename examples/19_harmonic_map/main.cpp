@@ -33,7 +33,7 @@ int main(int argc, char **argv)
     DrawableTrimesh<> m_uvw(uv_map, m_xyz.vector_polys());
 
     // copy uv coordinates to m (for texture visualization)
-    for(uint vid=0; vid<m_xyz.num_verts(); ++vid) m_xyz.vert_data(vid).uvw = m_uvw.vert(vid);
+    for(uint vid=0; vid<m_xyz.num_verts(); ++vid) m_xyz.vert_uvw(vid) = m_uvw.vert(vid);
 
     GLcanvas gui_xyz, gui_uvw;
     m_xyz.show_wireframe(true);
@@ -0,0 +1,85 @@
+/* This example measures the effect of mesh element ordering on the
+ * performances of traversal heavy algorithms (Laplacian assembly and
+ * exhaustive Dijkstra). The input mesh is first randomly shuffled to
+ * emulate a file with poor memory locality, and then reordered using
+ * Morton, Hilbert and Reverse Cuthill-McKee orderings.
+*/
+
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/reorder_mesh.h>
+#include <cinolib/laplacian.h>
+#include <cinolib/dijkstra.h>
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+void benchmark(const Mesh & m, const std::string & name)
+{
+    typedef std::chrono::steady_clock clock;
+    const int n_runs = 5;
+
+    clock::time_point t0 = clock::now();
+    for(int i=0; i<n_runs; ++i) laplacian(m, COTANGENT);
+    clock::time_point t1 = clock::now();
+    std::vector<double> dist;
+    for(int i=0; i<n_runs; ++i) dijkstra_exhaustive(m, uint(i*m.num_verts()/n_runs), dist);
+    clock::time_point t2 = clock::now();
+
+    double t_lap = std::chrono::duration<double>(t1-t0).count()/n_runs;
+    double t_dij = std::chrono::duration<double>(t2-t1).count()/n_runs;
+    std::cout << "  " << name << "\tlaplacian: " << t_lap << "s\tdijkstra: " << t_dij << "s" << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+void run(const std::string & filename)
+{
+    Mesh m(filename.c_str());
+
+    std::cout << std::endl << filename << std::endl;
+    benchmark(m, "file order");
+
+    std::mt19937 rng(0);
+    std::vector<uint> v_order(m.num_verts()), p_order(m.num_polys());
+    std::iota(v_order.begin(), v_order.end(), 0);
+    std::iota(p_order.begin(), p_order.end(), 0);
+    std::shuffle(v_order.begin(), v_order.end(), rng);
+    std::shuffle(p_order.begin(), p_order.end(), rng);
+    permute_verts(m, v_order);
+    permute_polys(m, p_order);
+    benchmark(m, "shuffled");
+
+    const char * names[] = { "morton", "hilbert", "rcm" };
+    ReorderStrategy s[] = { REORDER_MORTON, REORDER_HILBERT, REORDER_RCM };
+    for(int i=0; i<3; ++i)
+    {
+        Mesh tmp = m;
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        reorder_mesh(tmp, s[i]);
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        benchmark(tmp, std::string(names[i]) + " (reordering: " + std::to_string(std::chrono::duration<double>(t1-t0).count()) + "s)");
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char *argv[])
+{
+    if(argc==2)
+    {
+        std::string s(argv[1]);
+        if(s.substr(s.size()-5)==".mesh") run<Tetmesh<>>(s);
+        else                              run<Trimesh<>>(s);
+        return 0;
+    }
+    run<Trimesh<>>(std::string(DATA_PATH) + "/bunny.obj");
+    run<Tetmesh<>>(std::string(DATA_PATH) + "/sphere.mesh");
+    return 0;
+}
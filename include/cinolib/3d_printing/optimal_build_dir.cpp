@@ -34,142 +34,330 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/3d_printing/optimal_build_dir.h>
-#include <cinolib/3d_printing/overhangs.h>
-#include <cinolib/3d_printing/height_along_build_dir.h>
-#include <cinolib/3d_printing/supports_contact_area.h>
-#include <cinolib/3d_printing/supports_volume.h>
 #include <cinolib/3d_printing/shadow_on_build_platform.h>
+#include <cinolib/octree.h>
 #include <cinolib/sphere_coverage.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/how_many_seconds.h>
+#include <cinolib/deg_rad.h>
+#include <numeric>
+#include <mutex>
 
 namespace cinolib
 {
 
+// appends to dirs n directions evenly spread (spherical Fibonacci spiral)
+// within a cone of amplitude ang (radians) around direction d
+//
+CINO_INLINE
+static void build_dir_cone_samples(const vec3d              & d,
+                                   const double               ang,
+                                   const uint                 n,
+                                         std::vector<vec3d> & dirs)
+{
+    vec3d u = d.cross((std::fabs(d.x())<0.9) ? vec3d(1,0,0) : vec3d(0,1,0));
+    u.normalize();
+    vec3d v = d.cross(u);
+    double cos_max = std::cos(ang);
+    for(uint k=0; k<n; ++k)
+    {
+        double cos_t = 1.0 - (1.0-cos_max)*(k+0.5)/n;
+        double sin_t = std::sqrt(std::max(0.0, 1.0-cos_t*cos_t));
+        double phi   = k*2.399963229728653; // golden angle
+        vec3d  s     = d*cos_t + (u*std::cos(phi) + v*std::sin(phi))*sin_t;
+        s.normalize();
+        dirs.push_back(s);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
-vec3d optimal_build_dir(const DrawableTrimesh<M,V,E,P> & m,
+vec3d optimal_build_dir(const Trimesh<M,V,E,P>         & m,
                         const OptimalBuildDirOptions   & opt,
                               float                    & best_height,
                               float                    & best_shadow_area,
                               float                    & best_contact_area,
-                              float                    & best_supp_volume)
+                              float                    & best_supp_volume,
+                              OptimalBuildDirTimings   & timings)
 {
-    // evenly sample the unit sphere to produce
-    // a set of candidate build directions
-    std::vector<vec3d> dirs;
-    sphere_coverage(opt.n_dirs, dirs);
+    typedef std::chrono::steady_clock Time;
+    timings = OptimalBuildDirTimings();
 
-    // cache everything that can be cached to speed up computation
-    GLFWwindow *GL_context = create_offline_GL_context(opt.buffer_size, opt.buffer_size);
-    u_int8_t   *data       = new u_int8_t[opt.buffer_size*opt.buffer_size];
+    // cache everything that can be cached to speed up computation. Per polygon
+    // normals are stored in flat arrays so that overhang classification vectorizes
+    uint  np = m.num_polys();
+    uint  nv = m.num_verts();
+    vec3d c  = m.centroid();
+    std::vector<float> nx(np), ny(np), nz(np), area(np);
+    std::vector<float> vx(nv), vy(nv), vz(nv);
+    std::vector<vec3d> centroid(np);
+    std::vector<bool>  critical(np, false);
+    for(uint pid=0; pid<np; ++pid)
+    {
+        vec3d n = m.poly_normal(pid);
+        nx[pid] = float(n.x());
+        ny[pid] = float(n.y());
+        nz[pid] = float(n.z());
+        area[pid] = float(m.poly_area(pid));
+        centroid[pid] = m.poly_centroid(pid) - c;
+    }
+    for(uint vid=0; vid<nv; ++vid)
+    {
+        vec3d p = m.vert(vid) - c;
+        vx[vid] = float(p.x());
+        vy[vid] = float(p.y());
+        vz[vid] = float(p.z());
+    }
+    for(uint pid : opt.crit_srf) critical.at(pid) = true;
+    bool need_overhangs = (opt.w_support_contact>0 || opt.w_support_volume>0);
     Octree octree;
-    octree.build_from_mesh_polys(m);
+    if(need_overhangs) octree.build_from_mesh_polys(m);
+    double eps = 1e-6*m.bbox().diag();
 
-    // compute scores for all candidate directions. scores are stored separately because this will
+    // a triangle is overhanging if angle(n,build_dir)-90 > thresh, that is if n.dot(build_dir) < -sin(thresh)
+    float cos_thresh = -float(std::sin(to_rad(opt.overhang_threshold)));
+
+    // scores for all candidate directions are stored separately because this will
     // allow to normalize them in the same range and combine them in a meaningful way...
     //
-    std::vector<float> h(opt.n_dirs, inf_float); // height (along the build direction)
-    std::vector<float> a(opt.n_dirs, inf_float); // area of the projection on the building platform
-    std::vector<float> c(opt.n_dirs, inf_float); // area of the contacts between model and supports
-    std::vector<float> v(opt.n_dirs, inf_float); // volume of the supports
-    //
-    for(uint i=0; i<opt.n_dirs; ++i)
+    std::vector<vec3d> dirs;
+    std::vector<float> h; // height (along the build direction)
+    std::vector<float> a; // area of the projection on the building platform
+    std::vector<float> s; // area of the contacts between model and supports
+    std::vector<float> v; // volume of the supports
+    std::mutex mutex;
+
+    // evaluates all directions from beg on, in parallel batches
+    auto evaluate = [&](const uint beg)
     {
-        bool skip = false;
-        for(const vec3d & fd : opt.forb_dirs)
+        const uint batch     = 8;
+        const uint block     = 1024;
+        uint       n_batches = (uint(dirs.size())-beg+batch-1)/batch;
+        h.resize(dirs.size(), inf_float);
+        a.resize(dirs.size(), inf_float);
+        s.resize(dirs.size(), inf_float);
+        v.resize(dirs.size(), inf_float);
+
+        PARALLEL_FOR(0, n_batches, 1, [&](const uint b)
         {
-            if(fd.angle_deg(dirs[i])<opt.forb_cone_angle)
+            OptimalBuildDirTimings t;
+            std::vector<u_int8_t> data(opt.buffer_size*opt.buffer_size);
+
+            std::vector<uint> todo;
+            for(uint i=beg+b*batch; i<std::min(beg+(b+1)*batch, uint(dirs.size())); ++i)
+            {
+                bool skip = false;
+                for(const vec3d & fd : opt.forb_dirs)
+                {
+                    if(fd.angle_deg(dirs[i])<opt.forb_cone_angle)
+                    {
+                        skip = true;
+                        break;
+                    }
+                }
+                if(!skip) todo.push_back(i);
+            }
+            t.n_dirs_tested = uint(todo.size());
+
+            // classify overhangs for the whole batch, sweeping the normals once
+            Time::time_point t0 = Time::now();
+            std::vector<std::vector<std::pair<uint,uint>>> polys_hanging(todo.size());
+            if(need_overhangs)
             {
-                skip = true;
-                break;
+                std::vector<float> dot(block);
+                for(uint p0=0; p0<np; p0+=block)
+                {
+                    uint p1 = std::min(p0+block, np);
+                    for(uint k=0; k<todo.size(); ++k)
+                    {
+                        const float dx = float(dirs[todo[k]].x());
+                        const float dy = float(dirs[todo[k]].y());
+                        const float dz = float(dirs[todo[k]].z());
+                        for(uint pid=p0; pid<p1; ++pid) dot[pid-p0] = nx[pid]*dx + ny[pid]*dy + nz[pid]*dz;
+                        for(uint pid=p0; pid<p1; ++pid)
+                        {
+                            if(dot[pid-p0]<cos_thresh) polys_hanging[k].push_back(std::make_pair(pid,pid));
+                        }
+                    }
+                }
+                // find the first triangle below each overhang (if any)
+                for(uint k=0; k<todo.size(); ++k)
+                {
+                    const vec3d & d = dirs[todo[k]];
+                    for(auto & ov : polys_hanging[k])
+                    {
+                        double hit_t;
+                        uint   hit_id;
+                        if(octree.intersects_ray(centroid[ov.first] + c - d*eps, -d, hit_t, hit_id) && hit_id!=ov.first)
+                        {
+                            ov.second = hit_id;
+                        }
+                    }
+                }
             }
-        }
-        if(skip) continue;
+            Time::time_point t1 = Time::now();
+            t.overhangs += how_many_seconds(t0,t1);
 
-        // NOTE: this call is 90% of the computational cost
-        std::vector<std::pair<uint,uint>> polys_hanging;
-        overhangs(m, opt.overhang_threshold, dirs[i], polys_hanging, octree);
+            for(uint k=0; k<todo.size(); ++k)
+            {
+                const uint    i = todo[k];
+                const vec3d & d = dirs[i];
+                const auto  & ov_list = polys_hanging[k];
 
-        // projection of the "lowest" mesh vertex along the build direction
-        // this is used further down to estimate the volume of support structures
-        // which are supposed to expand from the overhang down to the floor
-        float floor;
+                // projection of the "lowest" mesh vertex along the build direction
+                // this is used further down to estimate the volume of support structures
+                // which are supposed to expand from the overhang down to the floor
+                t0 = Time::now();
+                const float dx = float(d.x());
+                const float dy = float(d.y());
+                const float dz = float(d.z());
+                float floor = inf_float, top = -inf_float;
+                for(uint vid=0; vid<nv; ++vid)
+                {
+                    float val = vx[vid]*dx + vy[vid]*dy + vz[vid]*dz;
+                    floor = std::min(floor, val);
+                    top   = std::max(top,   val);
+                }
+                h[i] = (opt.w_height>0) ? top - floor : 0.f;
+                t1 = Time::now();
+                t.height += how_many_seconds(t0,t1);
 
-        h[i] = (opt.w_height         >0) ? height_along_build_dir(m, dirs[i], floor) : 0.f;
-        a[i] = (opt.w_shadow_area    >0) ? shadow_on_build_platform(m, dirs[i], opt.buffer_size, data, GL_context) : 0.f;
-        c[i] = (opt.w_support_contact>0) ? supports_contact_area(m, polys_hanging) : 0.f;
-        v[i] = (opt.w_support_volume >0) ? supports_volume(m, dirs[i], floor, polys_hanging) : 0.f;
+                a[i] = (opt.w_shadow_area>0) ? shadow_on_build_platform_cpu(m, d, opt.buffer_size, data.data()) : 0.f;
+                t0 = Time::now();
+                t.shadow_area += how_many_seconds(t1,t0);
 
-        // add penalty for critical surfaces
-        if(opt.w_support_contact>0 &&
-           opt.crit_srf.size()  >0)
-        {
-            for(auto & ov : polys_hanging)
-            {
-                // scale overhang area
-                if(CONTAINS(opt.crit_srf,ov.first))
+                // if overhang projects over the mesh, the contact area counts twice.
+                // Critical surfaces touched by supports are further penalized
+                float contact = 0;
+                if(opt.w_support_contact>0)
                 {
-                    c[i] += m.poly_area(ov.first) * opt.crit_srf_boost;
+                    for(const auto & ov : ov_list)
+                    {
+                        contact += area[ov.first];
+                        if(ov.second!=ov.first) contact += area[ov.first];
+                        if(critical[ov.first]) contact += area[ov.first] * opt.crit_srf_boost;
+                        if(ov.second!=ov.first && critical[ov.second]) contact += area[ov.second] * opt.crit_srf_boost;
+                    }
                 }
-                // scale area of poly vertically below overhang
-                if(ov.second!=ov.first && CONTAINS(opt.crit_srf,ov.second))
+                s[i] = contact;
+                t1 = Time::now();
+                t.contact_area += how_many_seconds(t0,t1);
+
+                float vol = 0;
+                if(opt.w_support_volume>0)
                 {
-                    c[i] += m.poly_area(ov.second) * opt.crit_srf_boost;
+                    for(const auto & ov : ov_list)
+                    {
+                        float z_beg = float(centroid[ov.first].dot(d));
+                        float z_end = (ov.first==ov.second) ? floor : float(centroid[ov.second].dot(d));
+                        vol += area[ov.first] * (z_beg - z_end);
+                    }
                 }
+                v[i] = vol;
+                t0 = Time::now();
+                t.supp_volume += how_many_seconds(t1,t0);
             }
+
+            std::lock_guard<std::mutex> guard(mutex);
+            timings.overhangs     += t.overhangs;
+            timings.height        += t.height;
+            timings.shadow_area   += t.shadow_area;
+            timings.contact_area  += t.contact_area;
+            timings.supp_volume   += t.supp_volume;
+            timings.n_dirs_tested += t.n_dirs_tested;
+        });
+    };
+
+    // normalizes all (finite) scores in [0,1] and combines them into a global score
+    auto global_scores = [&]() -> std::vector<float>
+    {
+        auto finite_range = [](const std::vector<float> & x, float & min, float & max)
+        {
+            min =  inf_float;
+            max = -inf_float;
+            for(float f : x) if(f<inf_float) { min = std::min(min,f); max = std::max(max,f); }
+        };
+        auto norm = [](const float f, const float min, const float max)
+        {
+            return (max > min) ? (f - min)/(max - min) : 1.f;
+        };
+        float h_min, h_max; finite_range(h, h_min, h_max);
+        float a_min, a_max; finite_range(a, a_min, a_max);
+        float s_min, s_max; finite_range(s, s_min, s_max);
+        float v_min, v_max; finite_range(v, v_min, v_max);
+        std::vector<float> scores(dirs.size(), inf_float);
+        for(uint i=0; i<dirs.size(); ++i)
+        {
+            if(h[i]==inf_float) continue; // forbidden direction
+            scores[i] = opt.w_height          * norm(h[i], h_min, h_max) +
+                        opt.w_shadow_area     * norm(a[i], a_min, a_max) +
+                        opt.w_support_contact * norm(s[i], s_min, s_max) +
+                        opt.w_support_volume  * norm(v[i], v_min, v_max);
         }
-    }
+        return scores;
+    };
 
-    // release memory
-    destroy_offline_GL_context(GL_context);
-    delete[] data;
+    // evenly sample the unit sphere to produce
+    // a set of candidate build directions
+    sphere_coverage(opt.n_dirs, dirs);
+    evaluate(0);
 
-    // normalize all scores in [0,1]
-    auto h_minmax = std::minmax_element(h.begin(), h.end());
-    auto a_minmax = std::minmax_element(a.begin(), a.end());
-    auto c_minmax = std::minmax_element(c.begin(), c.end());
-    auto v_minmax = std::minmax_element(v.begin(), v.end());
-    //
-    float h_min = *h_minmax.first; float h_max = *h_minmax.second;
-    float a_min = *a_minmax.first; float a_max = *a_minmax.second;
-    float c_min = *c_minmax.first; float c_max = *c_minmax.second;
-    float v_min = *v_minmax.first; float v_max = *v_minmax.second;
-    //
-    for(float & f : h) f = (h_max > h_min) ? (f - h_min)/(h_max - h_min) : 1;
-    for(float & f : a) f = (a_max > a_min) ? (f - a_min)/(a_max - a_min) : 1;
-    for(float & f : c) f = (c_max > c_min) ? (f - c_min)/(c_max - c_min) : 1;
-    for(float & f : v) f = (v_max > v_min) ? (f - v_min)/(v_max - v_min) : 1;
-
-    // compute global scores
-    std::vector<float> scores(opt.n_dirs);
-    for(uint i=0; i<opt.n_dirs; ++i)
+    // coarse-to-fine refinement around the most promising directions, starting
+    // from a cone as wide as the average spacing between the initial samples
+    double cone = std::sqrt(4.0*M_PI/std::max(opt.n_dirs,1u));
+    for(uint it=0; it<opt.refine_iters; ++it)
     {
-        float h_norm = (h_max > h_min) ? (h[i] - h_min)/(h_max - h_min) : 1;
-        float a_norm = (a_max > a_min) ? (a[i] - a_min)/(a_max - a_min) : 1;
-        float c_norm = (c_max > c_min) ? (c[i] - c_min)/(c_max - c_min) : 1;
-        float v_norm = (v_max > v_min) ? (v[i] - v_min)/(v_max - v_min) : 1;
-
-        scores[i] = opt.w_height          * h_norm +
-                    opt.w_shadow_area     * a_norm +
-                    opt.w_support_contact * c_norm +
-                    opt.w_support_volume  * v_norm;
+        std::vector<float> scores = global_scores();
+        std::vector<uint>  order(dirs.size());
+        std::iota(order.begin(), order.end(), 0);
+        uint n_best = std::min(opt.refine_best, uint(order.size()));
+        std::partial_sort(order.begin(), order.begin()+n_best, order.end(), [&](const uint i, const uint j)
+        {
+            return scores[i] < scores[j];
+        });
+        uint beg = uint(dirs.size());
+        for(uint i=0; i<n_best; ++i)
+        {
+            if(scores[order[i]]<inf_float) build_dir_cone_samples(dirs[order[i]], cone, opt.refine_dirs, dirs);
+        }
+        evaluate(beg);
+        cone *= 0.5;
     }
 
     // pick the best dir (lowest score)
-    auto   it = std::min_element(scores.begin(), scores.end());
+    std::vector<float> scores = global_scores();
+    uint best = uint(std::distance(scores.begin(), std::min_element(scores.begin(), scores.end())));
 
-    best_height       = h.at(std::distance(scores.begin(),it));
-    best_shadow_area  = a.at(std::distance(scores.begin(),it));
-    best_contact_area = c.at(std::distance(scores.begin(),it));
-    best_supp_volume  = v.at(std::distance(scores.begin(),it));
+    best_height       = h.at(best);
+    best_shadow_area  = a.at(best);
+    best_contact_area = s.at(best);
+    best_supp_volume  = v.at(best);
+
+    return dirs.at(best);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    return dirs.at(std::distance(scores.begin(),it));
+template<class M, class V, class E, class P>
+CINO_INLINE
+vec3d optimal_build_dir(const Trimesh<M,V,E,P>         & m,
+                        const OptimalBuildDirOptions   & opt,
+                              float                    & best_height,
+                              float                    & best_shadow_area,
+                              float                    & best_contact_area,
+                              float                    & best_supp_volume)
+{
+    OptimalBuildDirTimings timings;
+    return optimal_build_dir(m, opt, best_height, best_shadow_area, best_contact_area, best_supp_volume, timings);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class M, class V, class E, class P>
 CINO_INLINE
-vec3d optimal_build_dir(const DrawableTrimesh<M,V,E,P> & m,
+vec3d optimal_build_dir(const Trimesh<M,V,E,P>         & m,
                         const OptimalBuildDirOptions   & opt)
 {
     float best_height;
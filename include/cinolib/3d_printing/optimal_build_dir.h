@@ -36,7 +36,7 @@
 #ifndef CINO_OPTIMAL_BUILD_DIR_H
 #define CINO_OPTIMAL_BUILD_DIR_H
 
-#include <cinolib/meshes/drawable_trimesh.h>
+#include <cinolib/meshes/trimesh.h>
 
 namespace cinolib
 {
@@ -76,6 +76,14 @@ namespace cinolib
  * the support contact area, the area of critical surfaces touched by a support structure
  * will be multiplied by a boost factor, in order to count more than the other regular
  * surface elements.
+ *
+ * Coarse-to-fine: optionally, the best candidates are iteratively refined by sampling
+ * new directions in a cone around them, halving the cone amplitude at each round.
+ * Metrics are normalized over all the directions tested so far.
+ *
+ * Candidate directions are evaluated in parallel, in batches that share one pass over
+ * the triangle normals for overhang classification. The Octree used to find the surface
+ * below each overhang is built once and shared by all threads. No GL context is needed.
 */
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -93,13 +101,30 @@ struct OptimalBuildDirOptions
     float forb_cone_angle    = 3.0;     // amplitude of each cone hosting a forbidden build direction
     std::vector<vec3d>       forb_dirs; // set of forbidden build directions
     std::unordered_set<uint> crit_srf;  // list of triangles that are critical
+    uint  refine_iters       = 0;       // coarse-to-fine: # of refinement rounds around the best candidates
+    uint  refine_best        = 4;       // coarse-to-fine: # of best candidates refined at each round
+    uint  refine_dirs        = 16;      // coarse-to-fine: # of new directions sampled around each of them
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// time spent computing each metric (in seconds, summed over all threads)
+//
+struct OptimalBuildDirTimings
+{
+    double overhangs     = 0; // overhang classification and ray casting below them
+    double height        = 0;
+    double shadow_area   = 0;
+    double contact_area  = 0;
+    double supp_volume   = 0;
+    uint   n_dirs_tested = 0;
 };
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class M, class V, class E, class P>
 CINO_INLINE
-vec3d optimal_build_dir(const DrawableTrimesh<M,V,E,P> & m,
+vec3d optimal_build_dir(const Trimesh<M,V,E,P>         & m,
                         const OptimalBuildDirOptions   & opt,
                               float                    & best_height,
                               float                    & best_shadow_area,
@@ -110,7 +135,19 @@ vec3d optimal_build_dir(const DrawableTrimesh<M,V,E,P> & m,
 
 template<class M, class V, class E, class P>
 CINO_INLINE
-vec3d optimal_build_dir(const DrawableTrimesh<M,V,E,P> & m,
+vec3d optimal_build_dir(const Trimesh<M,V,E,P>         & m,
+                        const OptimalBuildDirOptions   & opt,
+                              float                    & best_height,
+                              float                    & best_shadow_area,
+                              float                    & best_contact_area,
+                              float                    & best_supp_volume,
+                              OptimalBuildDirTimings   & timings);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+vec3d optimal_build_dir(const Trimesh<M,V,E,P>         & m,
                         const OptimalBuildDirOptions   & opt);
 
 }
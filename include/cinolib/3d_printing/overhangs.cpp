@@ -52,7 +52,7 @@ void overhangs(const Trimesh<M,V,E,P>  & m,
     std::mutex mutex;
     PARALLEL_FOR(0, m.num_polys(), 1000, [&](const uint pid)
     {
-        float ang = build_dir.angle_deg(m.poly_data(pid).normal);
+        float ang = build_dir.angle_deg(m.poly_normal(pid));
         if(ang-90.f > thresh)
         {
             std::lock_guard<std::mutex> guard(mutex);
@@ -34,12 +34,35 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/3d_printing/shadow_on_build_platform.h>
+#include <cinolib/cast_shadow_cpu.h>
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
 #include <cinolib/cast_shadow.h>
 #include <cinolib/gl/offline_gl_context.h>
+#endif
 
 namespace cinolib
 {
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+float shadow_on_build_platform_cpu(const Trimesh<M,V,E,P> & m,
+                                   const vec3d            & build_dir,
+                                   const uint               img_size,
+                                         u_int8_t         * data)
+{
+    cast_shadow_cpu(m, build_dir, img_size, img_size, data);
+    uint shadow_pixels = 0;
+    for(uint i=0; i<img_size*img_size; ++i)
+    {
+        if(data[i]==0xFF) ++shadow_pixels;
+    }
+    return (float)shadow_pixels/(img_size*img_size);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 float shadow_on_build_platform(const DrawableTrimesh<M,V,E,P> & m,         //
@@ -77,4 +100,6 @@ float shadow_on_build_platform(const DrawableTrimesh<M,V,E,P> & m,          //
     return (float)shadow_pixels/(img_size*img_size);
 }
 
+#endif // CINOLIB_USES_OPENGL_GLFW_IMGUI
+
 }
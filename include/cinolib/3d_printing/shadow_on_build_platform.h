@@ -36,8 +36,11 @@
 #ifndef CINO_SHADOW_ON_BUILD_PLATFORM_H
 #define CINO_SHADOW_ON_BUILD_PLATFORM_H
 
+#include <cinolib/meshes/trimesh.h>
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
 #include <cinolib/meshes/drawable_trimesh.h>
 #include <cinolib/gl/gl_glfw.h>
+#endif
 
 namespace cinolib
 {
@@ -54,6 +57,20 @@ namespace cinolib
  * a GL context so as to amortize the cost of initialization.
 */
 
+// CPU version, which scan converts the mesh without requiring any GL context
+// (see cast_shadow_cpu.h). Output is the same of the GL versions below
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+float shadow_on_build_platform_cpu(const Trimesh<M,V,E,P> & m,         //
+                                   const vec3d            & build_dir, //
+                                   const uint               img_size,  // frame buffer will be img_size x img_size
+                                         u_int8_t         * data);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 float shadow_on_build_platform(const DrawableTrimesh<M,V,E,P> & m,         //
@@ -71,6 +88,7 @@ float shadow_on_build_platform(const DrawableTrimesh<M,V,E,P> & m,           //
                                      u_int8_t                 * data,        //
                                      GLFWwindow               * GL_context); // cached for amortized computation
 
+#endif // CINOLIB_USES_OPENGL_GLFW_IMGUI
 
 }
 
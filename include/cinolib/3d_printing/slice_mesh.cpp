@@ -0,0 +1,297 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/3d_printing/slice_mesh.h>
+#include <cinolib/parallel_for.h>
+#include <thread>
+#include <cstdint>
+
+namespace cinolib
+{
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint slice_mesh(const Trimesh<M,V,E,P>                       & m,
+                const double                                   layer_thickness,
+                const vec3d                                  & build_dir,
+                std::vector<std::vector<std::vector<vec3d>>> & internal_polylines,
+                std::vector<std::vector<std::vector<vec3d>>> & external_polylines)
+{
+    std::vector<uint> tris(3*m.num_polys());
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        tris[3*pid+0] = m.poly_vert_id(pid,0);
+        tris[3*pid+1] = m.poly_vert_id(pid,1);
+        tris[3*pid+2] = m.poly_vert_id(pid,2);
+    }
+    return slice_mesh(m.vector_verts(), tris, layer_thickness, build_dir, internal_polylines, external_polylines);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint slice_mesh(const std::vector<vec3d>                     & verts,
+                const std::vector<uint>                      & tris,
+                const double                                   layer_thickness,
+                const vec3d                                  & build_dir,
+                std::vector<std::vector<std::vector<vec3d>>> & internal_polylines,
+                std::vector<std::vector<std::vector<vec3d>>> & external_polylines)
+{
+    assert(layer_thickness>0);
+    internal_polylines.clear();
+    external_polylines.clear();
+
+    uint nv = uint(verts.size());
+    uint nt = uint(tris.size()/3);
+    if(nv==0 || nt==0) return 0;
+
+    // minimal rotation that brings the build direction onto the Z axis (Rodrigues)
+    vec3d Z(0,0,1);
+    vec3d k = build_dir.cross(Z);
+    double c = build_dir.dot(Z);
+    mat3d R = mat3d::DIAG(1.0);
+    if(c < -1+1e-12) R = mat3d::DIAG(vec3d(1,-1,-1)); else
+    {
+        mat3d K({     0, -k.z(),  k.y(),
+                  k.z(),      0, -k.x(),
+                 -k.y(),  k.x(),      0});
+        R += K + K*K*(1.0/(1.0+c));
+    }
+    std::vector<vec3d> pos(nv);
+    PARALLEL_FOR(0, nv, 10000, [&](const uint vid)
+    {
+        pos[vid] = R*verts[vid];
+    });
+
+    double h_min = pos.front().z();
+    double h_max = pos.front().z();
+    for(const vec3d & p : pos)
+    {
+        h_min = std::min(h_min, p.z());
+        h_max = std::max(h_max, p.z());
+    }
+    uint n_layers = std::max(1u, uint(std::ceil((h_max-h_min)/layer_thickness)));
+    auto layer_z = [&](const uint l) { return h_min + (l+0.5)*layer_thickness; };
+    internal_polylines.resize(n_layers);
+    external_polylines.resize(n_layers);
+
+    // range of layers spanned by each triangle (conservative, the exact test is done while sweeping)
+    std::vector<uint> lo(nt), hi(nt);
+    PARALLEL_FOR(0, nt, 10000, [&](const uint tid)
+    {
+        double h0 = pos[tris[3*tid+0]].z();
+        double h1 = pos[tris[3*tid+1]].z();
+        double h2 = pos[tris[3*tid+2]].z();
+        double lo_h = std::min(h0, std::min(h1,h2));
+        double hi_h = std::max(h0, std::max(h1,h2));
+        double l0 = std::floor((lo_h-h_min)/layer_thickness - 0.5);
+        double l1 = std::floor((hi_h-h_min)/layer_thickness - 0.5) + 1;
+        lo[tid] = uint(std::max(0.0, std::min(l0, double(n_layers-1))));
+        hi[tid] = uint(std::max(0.0, std::min(l1, double(n_layers-1))));
+    });
+
+    // counting sort by first layer + per layer workload (number of active triangles)
+    std::vector<uint> first(n_layers+1, 0);
+    std::vector<int64_t> load(n_layers+1, 0);
+    for(uint tid=0; tid<nt; ++tid)
+    {
+        ++first[lo[tid]+1];
+        ++load[lo[tid]];
+        --load[hi[tid]+1];
+    }
+    for(uint l=0; l<n_layers; ++l)
+    {
+        first[l+1] += first[l];
+        load [l+1] += load [l];
+    }
+    std::vector<uint> order(nt);
+    {
+        std::vector<uint> cursor(first.begin(), first.end()-1);
+        for(uint tid=0; tid<nt; ++tid) order[cursor[lo[tid]]++] = tid;
+    }
+
+    // split the stack in blocks of consecutive layers with (roughly) the same workload
+    uint n_threads = std::max(1u, std::thread::hardware_concurrency());
+    uint n_blocks  = std::min(n_threads, n_layers);
+    int64_t tot_load = 0;
+    for(uint l=0; l<n_layers; ++l) tot_load += load[l];
+    std::vector<uint> block_beg(n_blocks+1, n_layers);
+    block_beg[0] = 0;
+    {
+        int64_t acc = 0;
+        uint    b   = 1;
+        for(uint l=0; l<n_layers && b<n_blocks; ++l)
+        {
+            acc += load[l];
+            while(b<n_blocks && acc*int64_t(n_blocks) >= tot_load*int64_t(b)) block_beg[b++] = l+1;
+        }
+    }
+
+    struct Segment
+    {
+        uint64_t beg, end; // ids of the crossed mesh edges (i.e., the endpoints of the segment)
+        vec3d    p;        // crossing point at the beginning of the segment
+    };
+    auto edge_key = [](uint v0, uint v1) -> uint64_t
+    {
+        if(v0>v1) std::swap(v0,v1);
+        return (uint64_t(v0)<<32) | uint64_t(v1);
+    };
+    auto edge_hash = [](uint64_t k) -> uint64_t
+    {
+        k ^= k >> 33; k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33; k *= 0xc4ceb9fe1a85ec53ULL;
+        k ^= k >> 33;
+        return k;
+    };
+
+    PARALLEL_FOR(0, n_blocks, 1, [&](const uint b)
+    {
+        uint l_beg = block_beg[b];
+        uint l_end = block_beg[b+1];
+        if(l_beg>=l_end) return;
+
+        // triangles that started before the block and are still active
+        std::vector<uint> active;
+        for(uint i=0; i<first[l_beg]; ++i)
+        {
+            uint tid = order[i];
+            if(hi[tid]>=l_beg) active.push_back(tid);
+        }
+
+        std::vector<Segment> segs;
+        std::vector<uint>    table;
+        std::vector<int>     next;
+        std::vector<bool>    has_prev, visited;
+        std::vector<vec3d>   loop;
+
+        for(uint l=l_beg; l<l_end; ++l)
+        {
+            for(uint i=first[l]; i<first[l+1]; ++i) active.push_back(order[i]);
+
+            // intersect active triangles with the plane
+            double z = layer_z(l);
+            segs.clear();
+            uint n_alive = 0;
+            for(uint tid : active)
+            {
+                if(hi[tid]>l) active[n_alive++] = tid;
+
+                const uint * v = &tris[3*tid];
+                int up = -1, down = -1;
+                for(int i=0; i<3; ++i)
+                {
+                    bool below_i = pos[v[i]].z()       < z;
+                    bool below_j = pos[v[(i+1)%3]].z() < z;
+                    if( below_i && !below_j) up   = i;
+                    if(!below_i &&  below_j) down = i;
+                }
+                if(up<0 || down<0) continue;
+
+                // with outward normals, going from the downward to the upward crossing
+                // leaves the material on the left, hence outer loops are counter-clockwise
+                uint a = v[down], b = v[(down+1)%3];
+                if(a>b) std::swap(a,b); // same edge => bitwise identical crossing point
+                double t = (z - pos[a].z())/(pos[b].z() - pos[a].z());
+                Segment s;
+                s.beg = edge_key(v[down], v[(down+1)%3]);
+                s.end = edge_key(v[up],   v[(up+1)%3]);
+                s.p   = pos[a] + (pos[b]-pos[a])*t;
+                s.p.z() = z;
+                segs.push_back(s);
+            }
+            active.resize(n_alive);
+
+            uint ns = uint(segs.size());
+            if(ns==0) continue;
+
+            // link segments (open addressing, linear probing)
+            uint size = 1;
+            while(size < 2*ns) size <<= 1;
+            table.assign(size, 0);
+            for(uint i=0; i<ns; ++i)
+            {
+                uint64_t h = edge_hash(segs[i].beg) & (size-1);
+                while(table[h]!=0) h = (h+1) & (size-1);
+                table[h] = i+1;
+            }
+            next.assign(ns, -1);
+            has_prev.assign(ns, false);
+            for(uint i=0; i<ns; ++i)
+            {
+                uint64_t h = edge_hash(segs[i].end) & (size-1);
+                while(table[h]!=0)
+                {
+                    uint j = table[h]-1;
+                    if(segs[j].beg==segs[i].end) { next[i] = int(j); has_prev[j] = true; break; }
+                    h = (h+1) & (size-1);
+                }
+            }
+
+            // open chains first (so that they are not mistaken for loops), then closed loops
+            visited.assign(ns, false);
+            for(uint i=0; i<ns; ++i)
+            {
+                if(has_prev[i]) continue;
+                for(int j=int(i); j>=0 && !visited[j]; j=next[j]) visited[j] = true;
+            }
+            for(uint i=0; i<ns; ++i)
+            {
+                if(visited[i]) continue;
+                loop.clear();
+                double area = 0;
+                for(int j=int(i); j>=0 && !visited[j]; j=next[j])
+                {
+                    visited[j] = true;
+                    if(loop.empty() || !(loop.back()==segs[j].p)) loop.push_back(segs[j].p);
+                }
+                if(loop.size()>1 && loop.back()==loop.front()) loop.pop_back();
+                if(loop.size()<3) continue;
+                for(uint j=0; j<loop.size(); ++j)
+                {
+                    const vec3d & p0 = loop[j];
+                    const vec3d & p1 = loop[(j+1)%loop.size()];
+                    area += p0.x()*p1.y() - p1.x()*p0.y();
+                }
+                if(area>0) external_polylines[l].push_back(loop);
+                else       internal_polylines[l].push_back(loop);
+            }
+        }
+    });
+
+    return n_layers;
+}
+
+}
@@ -0,0 +1,88 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_SLICE_MESH_H
+#define CINO_SLICE_MESH_H
+
+#include <cinolib/meshes/trimesh.h>
+
+namespace cinolib
+{
+
+/* Slices a triangle mesh with a stack of parallel planes orthogonal to the build
+ * direction, producing one set of closed contours per layer. Planes are placed at
+ * mid layer, starting from the lowest point of the mesh along the build direction.
+ *
+ * Contours are expressed in a reference frame where the build direction is the Z
+ * axis (if the build direction is Z itself, coordinates are left untouched), and
+ * are organized as in read_CLI, so that they can be fed directly to SlicedObj or
+ * written to file with write_CLI. The mesh is assumed to be closed and consistently
+ * oriented (outward normals): outer boundaries come out counter-clockwise, holes
+ * clockwise. Open chains (generated by cracks in the input) are discarded.
+ *
+ * Triangles are sorted by the range of layers they span, and each thread sweeps
+ * a block of consecutive layers keeping track of the active triangles only. The
+ * crossing points are identified by the mesh edge they lay on, and segments are
+ * linked into closed loops through a hash table keyed on such edges. Vertices
+ * that lay exactly on a plane are considered above it (symbolic perturbation), so
+ * that contours never degenerate.
+*/
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint slice_mesh(const Trimesh<M,V,E,P>                       & m,
+                const double                                   layer_thickness,
+                const vec3d                                  & build_dir,          // assumed to be unit length!
+                std::vector<std::vector<std::vector<vec3d>>> & internal_polylines, // inner holes
+                std::vector<std::vector<std::vector<vec3d>>> & external_polylines);// outer slice boundary
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same as above, for an indexed triangle soup (three vertex ids per triangle)
+//
+CINO_INLINE
+uint slice_mesh(const std::vector<vec3d>                     & verts,
+                const std::vector<uint>                      & tris,
+                const double                                   layer_thickness,
+                const vec3d                                  & build_dir,          // assumed to be unit length!
+                std::vector<std::vector<std::vector<vec3d>>> & internal_polylines, // inner holes
+                std::vector<std::vector<std::vector<vec3d>>> & external_polylines);// outer slice boundary
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "slice_mesh.cpp"
+#endif
+
+#endif // CINO_SLICE_MESH_H
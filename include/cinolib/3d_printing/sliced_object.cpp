@@ -35,9 +35,11 @@
 *********************************************************************************/
 #include <cinolib/3d_printing/sliced_object.h>
 #include <cinolib/io/read_CLI.h>
+#include <cinolib/3d_printing/slice_mesh.h>
 #include <cinolib/triangle_wrap.h>
 #include <cinolib/vector_serialization.h>
 #include <cinolib/ANSI_color_codes.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -73,6 +75,25 @@ SlicedObj<M,V,E,P>::SlicedObj(const std::vector<std::vector<std::vector<vec3d>>>
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+SlicedObj<M,V,E,P>::SlicedObj(const Trimesh<M,V,E,P> & m,
+                              const double             layer_thickness,
+                              const vec3d            & build_dir,
+                              const double             thick_radius)
+    : Trimesh<M,V,E,P>()
+    , thick_radius(thick_radius)
+{
+    std::vector<std::vector<std::vector<vec3d>>> slice_polys;
+    std::vector<std::vector<std::vector<vec3d>>> slice_holes;
+    uint n_layers = slice_mesh(m, layer_thickness, build_dir, slice_polys, slice_holes);
+    std::vector<std::vector<std::vector<vec3d>>> supports(n_layers);
+    hatches.resize(n_layers);
+    init(slice_polys, slice_holes, supports);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 BoostMultiPolygon SlicedObj<M,V,E,P>::slice_as_boost_poly(const uint sid) const
@@ -90,35 +111,43 @@ void SlicedObj<M,V,E,P>::init(const std::vector<std::vector<std::vector<vec3d>>>
 {
     uint num_slices = slice_polys.size();
 
-    for(uint sid=0; sid<num_slices; ++sid)
+    // slices are independent: build them in parallel, then drop the empty ones
+    std::vector<BoostMultiPolygon> tmp_slices(num_slices);
+    std::vector<float>             tmp_z(num_slices);
+    std::vector<char>              is_empty(num_slices, false); // not vector<bool>: written concurrently
+    PARALLEL_FOR(0, num_slices, 2, [&](const uint sid)
     {
         uint np = slice_holes.at(sid).size();
-        uint nh = slice_polys.at(sid).size();
         uint ns = (thick_radius>0) ? supports.at(sid).size() : 0;
 
-        std::cout << "processing slice " << sid << " out of " << num_slices << "\t(" << np << " polys / " << nh << " holes / "  << ns << " supports)" << std::endl;
-
-        if(np>0) z.push_back(slice_holes.at(sid).front().front().z()); else
-        if(ns>0) z.push_back(supports.at(sid).front().front().z());    else
-        continue; // empty slice, skip it
+        if(np>0) tmp_z.at(sid) = slice_holes.at(sid).front().front().z(); else
+        if(ns>0) tmp_z.at(sid) = supports.at(sid).front().front().z();    else
+        { is_empty.at(sid) = true; return; } // empty slice, skip it
 
         std::vector<BoostPolygon> polys;
         std::vector<BoostPolygon> holes;
-        for(auto p : slice_holes.at(sid)) polys.push_back(make_polygon(p));
-        for(auto h : slice_polys.at(sid)) holes.push_back(make_polygon(h));
+        for(const auto & p : slice_holes.at(sid)) polys.push_back(make_polygon(p));
+        for(const auto & h : slice_polys.at(sid)) holes.push_back(make_polygon(h));
         if(thick_radius>0)
         {
-            for(auto s : supports.at(sid)) polys.push_back(make_polygon(s, thick_radius));
+            for(const auto & s : supports.at(sid)) polys.push_back(make_polygon(s, thick_radius));
         }
 
-        BoostMultiPolygon mp;
-        for(auto p : polys) mp = polygon_union(mp, p);
-        for(auto p : holes) mp = polygon_difference(mp, p);
+        BoostMultiPolygon mp = polygon_union(polys);
+        if(!holes.empty()) mp = polygon_difference(mp, polygon_union(holes));
         mp = polygon_simplify(mp, 0.1*thick_radius);
 
         assert(mp.size()>0);
-        slices.push_back(mp);
+        tmp_slices.at(sid) = std::move(mp);
+    });
+
+    for(uint sid=0; sid<num_slices; ++sid)
+    {
+        if(is_empty.at(sid)) continue;
+        z.push_back(tmp_z.at(sid));
+        slices.push_back(std::move(tmp_slices.at(sid)));
     }
+    std::cout << "processed " << num_slices << " slices (" << num_slices-slices.size() << " empty)" << std::endl;
 
     triangulate_slices();
 }
@@ -129,32 +158,56 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void SlicedObj<M,V,E,P>::triangulate_slices()
 {
-    for(uint sid=0; sid<slices.size(); ++sid)
+    // triangulate each slice in its own buffer. This is done serially, as
+    // Triangle is not thread safe (it relies on process-wide globals)...
+    std::vector<std::vector<vec3d>> slice_verts(num_slices());
+    std::vector<std::vector<uint>>  slice_tris (num_slices());
+    for(uint sid=0; sid<num_slices(); ++sid)
     {
-        const BoostMultiPolygon & mp = slices.at(sid);
-
-        std::vector<vec3d> verts;
-        std::vector<uint>  tris;
-        triangulate_polygon(mp, "Q", z.at(sid), verts, tris);
+        triangulate_polygon(slices.at(sid), "Q", z.at(sid), slice_verts.at(sid), slice_tris.at(sid));
+    }
 
-        uint base_addr = this->num_verts();
-        uint n_tris = tris.size()/3;
+    // ...then stitch all buffers together and initialize the mesh in one go
+    std::vector<uint> v_offset(num_slices()+1, 0);
+    std::vector<uint> p_offset(num_slices()+1, 0);
+    for(uint sid=0; sid<num_slices(); ++sid)
+    {
+        v_offset.at(sid+1) = v_offset.at(sid) + slice_verts.at(sid).size();
+        p_offset.at(sid+1) = p_offset.at(sid) + slice_tris.at(sid).size()/3;
+    }
+    std::vector<vec3d>             verts(v_offset.back());
+    std::vector<std::vector<uint>> tris (p_offset.back());
+    PARALLEL_FOR(0, num_slices(), 2, [&](const uint sid)
+    {
+        std::copy(slice_verts.at(sid).begin(), slice_verts.at(sid).end(), verts.begin() + v_offset.at(sid));
+        const std::vector<uint> & t = slice_tris.at(sid);
+        for(uint i=0; i<t.size()/3; ++i)
+        {
+            tris.at(p_offset.at(sid)+i) = { v_offset.at(sid) + t.at(3*i+0),
+                                            v_offset.at(sid) + t.at(3*i+1),
+                                            v_offset.at(sid) + t.at(3*i+2) };
+        }
+        std::vector<vec3d>().swap(slice_verts.at(sid));
+        std::vector<uint>().swap(slice_tris.at(sid));
+    });
+    AbstractPolygonMesh<M,V,E,P>::init(verts, tris);
 
-        for(auto p : verts)
+    for(uint sid=0; sid<num_slices(); ++sid)
+    {
+        for(uint vid=v_offset.at(sid); vid<v_offset.at(sid+1); ++vid)
         {
-            uint vid = this->vert_add(p);
-            this->vert_data(vid).uvw[0] = static_cast<double>(sid)/static_cast<double>(num_slices());
+            this->vert_uvw(vid)[0] = static_cast<double>(sid)/static_cast<double>(num_slices());
             this->vert_data(vid).label  = sid;
         }
-        for(uint i=0; i<n_tris; ++i)
+        for(uint pid=p_offset.at(sid); pid<p_offset.at(sid+1); ++pid)
         {
-            uint pid = this->poly_add(base_addr + tris.at(3*i+0),
-                                      base_addr + tris.at(3*i+1),
-                                      base_addr + tris.at(3*i+2));
             this->poly_data(pid).label = sid;
-            for(uint eid : this->adj_p2e(pid)) this->edge_data(eid).label = sid;
         }
     }
+    for(uint eid=0; eid<this->num_edges(); ++eid)
+    {
+        this->edge_data(eid).label = this->vert_data(this->edge_vert_id(eid,0)).label;
+    }
     std::cout << "new sliced object (" << num_slices() << " slices)" << std::endl;
     this->edge_mark_boundaries();
 }
@@ -70,6 +70,14 @@ class SlicedObj : public Trimesh<M,V,E,P>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        // slices a triangle mesh with layers of the given thickness (see slice_mesh.h)
+        explicit SlicedObj(const Trimesh<M,V,E,P> & m,
+                           const double             layer_thickness,
+                           const vec3d            & build_dir    = vec3d(0,0,1),
+                           const double             thick_radius = 0.01);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         uint num_slices() const { return slices.size(); }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
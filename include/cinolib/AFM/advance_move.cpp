@@ -76,9 +76,9 @@ bool advance_by_triangle_split(      AFM_data & data,
         V2[2] = (V0[2]*99 + V1[2]*99 + O[2]*2)/200;
         if(data.enable_sanity_checks)
         {
-            assert(orient2d(V0,V1,V2)>0);
-            assert(orient2d(V1,O,V2 )>0);
-            assert(orient2d(V0,V2,O )>0);
+            assert(orient2d_sign(V0,V1,V2)>0);
+            assert(orient2d_sign(V1,O,V2 )>0);
+            assert(orient2d_sign(V0,V2,O )>0);
         }
         data.m1.vert(v2) = vec3d(CGAL::to_double(V2[0]),
                                  CGAL::to_double(V2[1]),
@@ -71,9 +71,9 @@ uint concavify_front(AFM_data & data,
     // if the next flip is concave, just focus on this one
     // (the next will be made valid by the convexification routine)
 
-    auto res = orient2d(&data.exact_coords[3*v0],
-                        &data.exact_coords[3*v2],
-                        &data.exact_coords[3*v3]);
+    auto res = orient2d_sign(&data.exact_coords[3*v0],
+                             &data.exact_coords[3*v2],
+                             &data.exact_coords[3*v3]);
     if(res==0 || (res<0) == CCW || v3==data.origin)
     {
         CGAL_Q A[3] =
@@ -88,8 +88,8 @@ uint concavify_front(AFM_data & data,
         line_intersection2d(&data.exact_coords[3*v1], A, &data.exact_coords[3*v0], &data.exact_coords[3*v2], B);
         if(data.enable_sanity_checks)
         {
-            assert(orient2d(&data.exact_coords[3*v0],B,&data.exact_coords[3*data.origin]) *
-                   orient2d(B,&data.exact_coords[3*v2],&data.exact_coords[3*data.origin])>0);
+            assert(orient2d_sign(&data.exact_coords[3*v0],B,&data.exact_coords[3*data.origin]) *
+                   orient2d_sign(B,&data.exact_coords[3*v2],&data.exact_coords[3*data.origin])>0);
         }
         //
         midpoint(A,B,&data.exact_coords[3*split_point_id]);
@@ -107,8 +107,8 @@ uint concavify_front(AFM_data & data,
         // if O,v0,v1 are aligned, then A==v0, that's why >= and not >
         if(data.enable_sanity_checks)
         {
-            assert(orient2d(&data.exact_coords[3*v0],A,&data.exact_coords[3*data.origin]) *
-                   orient2d(A,&data.exact_coords[3*v2],&data.exact_coords[3*data.origin])>=0);
+            assert(orient2d_sign(&data.exact_coords[3*v0],A,&data.exact_coords[3*data.origin]) *
+                   orient2d_sign(A,&data.exact_coords[3*v2],&data.exact_coords[3*data.origin])>=0);
         }
 
         //
@@ -118,8 +118,8 @@ uint concavify_front(AFM_data & data,
                             &data.exact_coords[3*v0],
                             &data.exact_coords[3*v2], B);
         // if B does not lie in between v0 and v2, set B as v2
-        if(orient2d(&data.exact_coords[3*v0],B,&data.exact_coords[3*data.origin]) *
-           orient2d(B,&data.exact_coords[3*v2],&data.exact_coords[3*data.origin])<=0)
+        if(orient2d_sign(&data.exact_coords[3*v0],B,&data.exact_coords[3*data.origin]) *
+           orient2d_sign(B,&data.exact_coords[3*v2],&data.exact_coords[3*data.origin])<=0)
         {
             B[0] = data.exact_coords[3*v2+0];
             B[1] = data.exact_coords[3*v2+1];
@@ -129,8 +129,8 @@ uint concavify_front(AFM_data & data,
         // make sure A comes "before" B in the segment v0-v2
         if(data.enable_sanity_checks)
         {
-            assert(orient2d(&data.exact_coords[3*v0],A,&data.exact_coords[3*data.origin]) *
-                   orient2d(A,B,&data.exact_coords[3*data.origin])>0);
+            assert(orient2d_sign(&data.exact_coords[3*v0],A,&data.exact_coords[3*data.origin]) *
+                   orient2d_sign(A,B,&data.exact_coords[3*data.origin])>0);
         }
 
         data.exact_coords[3*split_point_id+0] = (A[0]*49 + B[0]*49 + data.exact_coords[3*data.origin+0]*2)/100;
@@ -122,9 +122,9 @@ bool triangle_is_blocking(AFM_data & data,
 
     // it the positive half space of the edge opposite to front_vert
     // does not contain the new_pos, the triangle is blocking
-    if(orient2d(&data.exact_coords[3*v0],
-                &data.exact_coords[3*v1],
-                p)<=0) return true;
+    if(orient2d_sign(&data.exact_coords[3*v0],
+                     &data.exact_coords[3*v1],
+                     p)<=0) return true;
     return false;
 }
 
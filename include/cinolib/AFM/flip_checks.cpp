@@ -46,9 +46,9 @@ bool flipped(AFM_data & data,
              const uint b,
              const uint c)
 {
-    return orient2d(&data.exact_coords[3*a],
-                    &data.exact_coords[3*b],
-                    &data.exact_coords[3*c]) <= 0;
+    return orient2d_sign(&data.exact_coords[3*a],
+                         &data.exact_coords[3*b],
+                         &data.exact_coords[3*c]) <= 0;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -58,9 +58,9 @@ bool flipped(AFM_data & data, const uint pid, const bool use_rationals)
 {
     if(use_rationals)
     {
-        return orient2d(&data.exact_coords[3*data.m1.poly_vert_id(pid,0)],
-                        &data.exact_coords[3*data.m1.poly_vert_id(pid,1)],
-                        &data.exact_coords[3*data.m1.poly_vert_id(pid,2)]) <= 0;
+        return orient2d_sign(&data.exact_coords[3*data.m1.poly_vert_id(pid,0)],
+                             &data.exact_coords[3*data.m1.poly_vert_id(pid,1)],
+                             &data.exact_coords[3*data.m1.poly_vert_id(pid,2)]) <= 0;
     }
     return orient2d(data.m1.poly_vert(pid,0).ptr(),
                     data.m1.poly_vert(pid,1).ptr(),
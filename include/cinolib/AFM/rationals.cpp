@@ -103,6 +103,51 @@ CGAL_Q orient2d(const CGAL_Q * pa,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+int orient2d_sign(const CGAL_Q * pa,
+                  const CGAL_Q * pb,
+                  const CGAL_Q * pc)
+{
+    {
+        CGAL::Protect_FPU_rounding<true> rounding_guard;
+        typedef CGAL::Interval_nt<false> Interval;
+
+        Interval acx = Interval(CGAL::to_interval(pa[0])) - Interval(CGAL::to_interval(pc[0]));
+        Interval bcx = Interval(CGAL::to_interval(pb[0])) - Interval(CGAL::to_interval(pc[0]));
+        Interval acy = Interval(CGAL::to_interval(pa[1])) - Interval(CGAL::to_interval(pc[1]));
+        Interval bcy = Interval(CGAL::to_interval(pb[1])) - Interval(CGAL::to_interval(pc[1]));
+
+        CGAL::Uncertain<CGAL::Sign> s = CGAL::sign(acx * bcy - acy * bcx);
+        if(CGAL::is_certain(s)) return static_cast<int>(CGAL::get_certain(s));
+    }
+
+    // the filter failed: evaluate the determinant directly on the exact
+    // values, without going through the lazy wrappers
+    const CGAL::Gmpq & cx = pc[0].exact();
+    const CGAL::Gmpq & cy = pc[1].exact();
+    CGAL::Gmpq acx = pa[0].exact() - cx;
+    CGAL::Gmpq bcx = pb[0].exact() - cx;
+    CGAL::Gmpq acy = pa[1].exact() - cy;
+    CGAL::Gmpq bcy = pb[1].exact() - cy;
+
+    return static_cast<int>(CGAL::sign(acx * bcy - acy * bcx));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool is_double(const CGAL_Q * p)
+{
+    for(int i=0; i<3; ++i)
+    {
+        std::pair<double,double> I = CGAL::to_interval(p[i]);
+        if(I.first!=I.second) return false;
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void midpoint(const CGAL_Q * pa,
               const CGAL_Q * pb,
@@ -150,8 +195,8 @@ void line_intersection2d(const CGAL_Q * pa,
     res[1] = (det_ab*det_cd_y - det_ab_y*det_cd)/den;
 
     // sanity checks
-    assert(orient2d(pa,pb,res)==0);
-    assert(orient2d(pc,pd,res)==0);
+    assert(orient2d_sign(pa,pb,res)==0);
+    assert(orient2d_sign(pc,pd,res)==0);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
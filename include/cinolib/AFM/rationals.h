@@ -40,6 +40,7 @@
 
 #include <CGAL/Lazy_exact_nt.h>
 #include <CGAL/Gmpq.h>
+#include <CGAL/Interval_nt.h>
 #include <cinolib/cino_inline.h>
 
 namespace cinolib
@@ -65,6 +66,26 @@ CGAL_Q orient2d(const CGAL_Q * pa,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// Filtered version of orient2d. The sign is first evaluated with interval
+// arithmetic on the approximations cached inside each lazy number, and the
+// rationals are used only if the interval contains zero. Differently from
+// orient2d above, no node is appended to the lazy DAG of the inputs, hence
+// the cost of a certain sign is just a few floating point operations
+//
+CINO_INLINE
+int orient2d_sign(const CGAL_Q * pa,
+                  const CGAL_Q * pb,
+                  const CGAL_Q * pc);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// true if all the coordinates of p are exactly representable as doubles
+//
+CINO_INLINE
+bool is_double(const CGAL_Q * p);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void midpoint(const CGAL_Q * pa,
               const CGAL_Q * pb,
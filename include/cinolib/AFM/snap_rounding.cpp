@@ -48,10 +48,15 @@ bool snap_rounding(AFM_data & data, const uint vid)
     CGAL_Q tmp[3];
     copy(&data.exact_coords[3*vid],tmp);
 
-    // round them to the closest double
-    data.exact_coords[3*vid+0] = CGAL::to_double(tmp[0]);
-    data.exact_coords[3*vid+1] = CGAL::to_double(tmp[1]);
-    data.exact_coords[3*vid+2] = CGAL::to_double(tmp[2]);
+    // round them to the closest double. There is nothing to round if the point
+    // is already made of doubles (e.g. it was snapped before, or never moved by
+    // the front), but flips are checked anyway, as before
+    if(!is_double(tmp))
+    {
+        data.exact_coords[3*vid+0] = CGAL::to_double(tmp[0]);
+        data.exact_coords[3*vid+1] = CGAL::to_double(tmp[1]);
+        data.exact_coords[3*vid+2] = CGAL::to_double(tmp[2]);
+    }
 
     // check for flips
     bool flips = false;
@@ -172,7 +172,7 @@ void ARAP_2D_mapping(Trimesh<M,V,E,P> & m, ARAP_2D_map_data & data)
 
     for(uint vid=0; vid<m.num_verts(); ++vid)
     {
-        m.vert_data(vid).uvw = data.uv_out[vid].add_coord(0);
+        m.vert_uvw(vid) = data.uv_out[vid].add_coord(0);
     }
 }
 
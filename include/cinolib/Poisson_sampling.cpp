@@ -35,158 +35,381 @@
 *********************************************************************************/
 #include <cinolib/Poisson_sampling.h>
 #include <cinolib/random_generator.h>
-#include <cinolib/serialize_index.h>
-#include <cinolib/min_max_inf.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/geometry/aabb.h>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
 
 namespace cinolib
 {
 
-/* This is almost a 1:1 copy of the reference implementation of the Fast Poisson disk sampling in arbitrary
- * dimensions released by Robert Bridson (https://www.cs.ubc.ca/~rbridson/download/curlnoise.tar.gz). See:
- *
- * Fast Poisson Disk Sampling in Arbitrary Dimensions
- * Robert Bridson
- * SIGGRAPH Technical Sketch, 2007
-*/
-
-//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-
-template<uint Dim, class Point>
-void sample_annulus(const double radius, const Point & center, uint & seed, Point & x)
+// decomposes the linear id of a grid cell into its integer coordinates
+//
+template<uint Dim>
+CINO_INLINE
+void Poisson_cell_coords(const std::array<uint,Dim> & extent, uint64_t cell, std::array<uint,Dim> & c)
 {
-    Point r;
-    for(;;)
+    for(uint i=0; i<Dim; ++i)
     {
-        for(uint i=0; i<Dim; ++i)
-        {
-            r[i]=4*(random_uint(seed++)/static_cast<double>(max_uint)-0.5);
-        }
-        double r2=r.norm_sqrd();
-        if(r2>1 && r2<=4) break;
+        c[i]  = uint(cell % extent[i]);
+        cell /= extent[i];
     }
-    x=center+radius*r;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<uint Dim, class Point>
 CINO_INLINE
-void Poisson_sampling(const double          radius,
-                      const Point           min,
-                      const Point           max,
-                      std::vector<Point> &  samples,
-                      uint                  seed,
-                      const int             max_attempts)
+void Poisson_sampling_phase_groups(const Point                                                         & min,
+                                   const double                                                          step,
+                                   const std::array<uint,Dim>                                          & extent,
+                                   const std::vector<uint64_t>                                         & cells,
+                                   const std::function<bool(const uint64_t cell, uint seed, Point & p)> & throw_dart,
+                                   const std::function<double(const Point &)>                          & radius,
+                                   const double                                                          r_max,
+                                   std::vector<Point>                                                  & samples,
+                                   const int                                                             max_attempts,
+                                   const uint                                                            seed)
 {
     samples.clear();
-    std::vector<uint> active_list;
 
-    // acceleration grid
-    double step = 0.999*radius/std::sqrt(static_cast<double>(Dim)); // a grid cell this size can have at most one sample in it
-    std::array<uint,Dim> dim_extent;
-    unsigned long int grid_size = 1;
-    for(uint i=0; i<Dim; ++i)
+    // cells within ring steps from a sample may contain a conflicting sample.
+    // Cells in the same phase group are (ring+1) cells apart along some axis
+    int  ring   = std::max(1, int(std::ceil(r_max/step)));
+    uint period = uint(ring+1);
+
+    bool     dense   = cells.empty();
+    uint64_t n_slots = cells.size();
+    if(dense)
     {
-        dim_extent[i] = static_cast<uint>(std::ceil((max[i]-min[i])/step));
-        grid_size *= dim_extent[i];
+        n_slots = 1;
+        for(uint i=0; i<Dim; ++i) n_slots *= extent[i];
     }
-    std::vector<int> grid(grid_size, -1); // -1 indicates no sample there; otherwise index of sample point
+    std::unordered_map<uint64_t,uint64_t> sparse_slot;
+    for(uint64_t slot=0; slot<cells.size(); ++slot) sparse_slot[cells[slot]] = slot;
+    auto cell_of = [&](const uint64_t slot) -> uint64_t { return dense ? slot : cells[slot]; };
+    auto slot_of = [&](const uint64_t cell) -> int64_t
+    {
+        if(dense) return int64_t(cell);
+        auto it = sparse_slot.find(cell);
+        return (it!=sparse_slot.end()) ? int64_t(it->second) : -1;
+    };
 
-    // first sample
-    Point x;
-    for(uint i=0; i<Dim; ++i)
+    // partition cells into phase groups
+    uint n_groups = 1;
+    for(uint i=0; i<Dim; ++i) n_groups *= period;
+    std::vector<std::vector<uint64_t>> groups(n_groups);
+    std::array<uint,Dim> c;
+    for(uint64_t slot=0; slot<n_slots; ++slot)
     {
-        x[i] = (max[i]-min[i])*(random_uint(seed++)/static_cast<double>(max_uint)) + min[i];
+        Poisson_cell_coords<Dim>(extent, cell_of(slot), c);
+        uint g = 0;
+        for(int i=Dim-1; i>=0; --i) g = g*period + c[i]%period;
+        groups[g].push_back(slot);
     }
-    samples.push_back(x);
-    active_list.push_back(0);
-    uint index = serialize_nD_index<Dim,Point>(dim_extent, (x-min)/step);
-    grid[index] = 0;
 
-    while(!active_list.empty())
+    // neighbor cells that may contain a conflicting sample, sorted by distance.
+    // Most darts are rejected by a close sample, hence nearest cells are tested
+    // first. Offsets are also stored as linear id deltas, which are valid for
+    // cells far enough from the grid boundary
+    std::vector<std::pair<double,std::array<int,Dim>>> offsets;
+    std::array<int,Dim> j;
+    j.fill(-ring);
+    for(;;)
     {
-        uint r = static_cast<int>(random_float(seed++, 0, active_list.size()-0.0001f));
-        int  p = active_list[r];
-        bool found_sample = false;
-        Point j, jmin, jmax;
-
-        for(int attempt=0; attempt<max_attempts; ++attempt)
+        double d = 0;
+        for(uint k=0; k<Dim; ++k)
         {
-            sample_annulus<Dim,Point>(radius, samples[p], seed, x);
+            double gap = std::max(0, std::abs(j[k])-1)*step;
+            d += gap*gap;
+        }
+        if(d < r_max*r_max) offsets.push_back(std::make_pair(d,j));
 
-            // check this sample is within bounds
-            for(uint i=0; i<Dim; ++i)
-            {
-                if(x[i]<min[i] || x[i]>max[i]) goto reject_sample;
-            }
+        // move on to next j
+        uint k=0;
+        for(; k<Dim; ++k)
+        {
+            if(++j[k]<=ring) break;
+            j[k] = -ring;
+        }
+        if(k==Dim) break;
+    }
+    std::sort(offsets.begin(), offsets.end());
+    std::vector<int64_t> deltas;
+    for(const auto & o : offsets)
+    {
+        int64_t delta  = 0;
+        int64_t stride = 1;
+        for(uint k=0; k<Dim; ++k)
+        {
+            delta  += o.second[k]*stride;
+            stride *= extent[k];
+        }
+        deltas.push_back(delta);
+    }
 
-            // test proximity to nearby samples
-            for(uint i=0; i<Dim; ++i)
-            {
-                int this_min = static_cast<int>((x[i]-radius-min[i])/step);
+    // each cell hosts at most one sample
+    std::vector<Point>  pos(n_slots);
+    std::vector<double> rad(n_slots);
+    std::vector<char>   full(n_slots, 0); // 0: empty, 1: has sample, 2: retired (not std::vector<bool>, as it is written concurrently)
 
-                if(this_min<0) this_min=0;
-                else if(this_min>=(int)dim_extent[i]) this_min=dim_extent[i]-1;
+    // returns false if there is a conflicting sample, and retires the cell if
+    // it is entirely covered by the disk of the conflicting sample
+    auto test_nbr = [&](const uint64_t slot, const std::array<uint,Dim> & c, const Point & p, const double r, const int64_t nbr_slot) -> bool
+    {
+        if(nbr_slot<0 || full[nbr_slot]!=1) return true;
+        double d = std::max(r, rad[nbr_slot]);
+        if((p-pos[nbr_slot]).norm_sqrd() >= d*d) return true;
+        double far = 0;
+        for(uint k=0; k<Dim; ++k)
+        {
+            double lo  = min[k] + c[k]*step;
+            double gap = std::max(pos[nbr_slot][k]-lo, lo+step-pos[nbr_slot][k]);
+            far += gap*gap;
+        }
+        if(far < rad[nbr_slot]*rad[nbr_slot]) full[slot] = 2;
+        return false;
+    };
 
-                jmin[i]=(uint)this_min;
-                int this_max=(int)((x[i]+radius-min[i])/step);
+    for(int round=0; round<max_attempts; ++round)
+    for(auto & group : groups)
+    {
+        PARALLEL_FOR(0, uint(group.size()), 1000, [&](const uint i)
+        {
+            uint64_t slot = group[i];
+            if(full[slot]) return;
 
-                if(this_max<0) this_max=0;
-                else if(this_max>=(int)dim_extent[i]) this_max=dim_extent[i]-1;
+            uint64_t cell = cell_of(slot);
+            uint     s    = random_uint(seed ^ random_uint(uint(cell ^ (cell>>32)) ^ random_uint(uint(round))));
+            Point    p;
+            if(!throw_dart(cell, s, p)) return;
+            double r = radius(p);
 
-                jmax[i]=(uint)this_max;
+            // test proximity to nearby samples
+            std::array<uint,Dim> c;
+            Poisson_cell_coords<Dim>(extent, cell, c);
+            bool interior = true;
+            for(uint k=0; k<Dim; ++k)
+            {
+                if(int(c[k])<ring || int(c[k])+ring>=int(extent[k])) interior = false;
             }
-
-            for(j=jmin;;)
+            if(interior)
             {
-                // check if there's a sample at j that's too close to x
-                index = serialize_nD_index<Dim,Point>(dim_extent, j);
-                if(grid[index]>=0 && grid[index]!=p)
+                for(int64_t delta : deltas)
                 {
-                    // if there is a sample point different from p
-                    if((x - samples[grid[index]]).norm_sqrd()<radius*radius) goto reject_sample;
+                    if(!test_nbr(slot, c, p, r, slot_of(uint64_t(int64_t(cell)+delta)))) return;
                 }
-
-                // move on to next j
-                for(uint i=0; i<Dim; ++i)
+            }
+            else for(const auto & o : offsets)
+            {
+                uint64_t nbr    = 0;
+                uint64_t stride = 1;
+                bool     inside = true;
+                for(uint k=0; k<Dim; ++k)
                 {
-                    ++j[i];
-                    if(j[i]<=jmax[i])
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        if(i==Dim-1) goto done_j_loop;
-                        else j[i]=jmin[i]; // and try incrementing the next dimension along
-                    }
+                    int x = int(c[k]) + o.second[k];
+                    if(x<0 || x>=int(extent[k])) { inside = false; break; }
+                    nbr    += uint64_t(x)*stride;
+                    stride *= extent[k];
                 }
+                if(inside && !test_nbr(slot, c, p, r, slot_of(nbr))) return;
             }
 
-            done_j_loop:
-            // if we made it here, we're good!
-            found_sample=true;
-            break;
-            // if we goto here, x is too close to an existing sample
-            reject_sample:
-            ; // nothing to do except go to the next iteration in this loop
+            pos[slot]  = p;
+            rad[slot]  = r;
+            full[slot] = 1;
+        });
+
+        // drop completed cells from the group
+        group.erase(std::remove_if(group.begin(), group.end(), [&](const uint64_t slot) { return full[slot]!=0; }), group.end());
+    }
+
+    for(uint64_t slot=0; slot<n_slots; ++slot)
+    {
+        if(full[slot]==1) samples.push_back(pos[slot]);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint Dim, class Point>
+CINO_INLINE
+void Poisson_sampling(const std::function<double(const Point &)> & radius,
+                      const double                                 r_min,
+                      const double                                 r_max,
+                      const Point                                  min,
+                      const Point                                  max,
+                      std::vector<Point>                         & samples,
+                      const int                                    max_attempts,
+                      uint                                         seed)
+{
+    assert(r_min>0 && r_min<=r_max);
+
+    double step = 0.999*r_min/std::sqrt(static_cast<double>(Dim)); // a grid cell this size can have at most one sample in it
+    std::array<uint,Dim> extent;
+    for(uint i=0; i<Dim; ++i)
+    {
+        extent[i] = std::max(1u, static_cast<uint>(std::ceil((max[i]-min[i])/step)));
+    }
+
+    auto throw_dart = [&](const uint64_t cell, uint s, Point & p) -> bool
+    {
+        std::array<uint,Dim> c;
+        Poisson_cell_coords<Dim>(extent, cell, c);
+        for(uint i=0; i<Dim; ++i)
+        {
+            p[i] = min[i] + (c[i] + random_double(s++))*step;
+            if(p[i]>max[i]) return false; // last cells may exceed the box
         }
+        return true;
+    };
+
+    Poisson_sampling_phase_groups<Dim,Point>(min, step, extent, std::vector<uint64_t>(), throw_dart, radius, r_max, samples, max_attempts, seed);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        if(found_sample)
+template<uint Dim, class Point>
+CINO_INLINE
+void Poisson_sampling(const double          radius,
+                      const Point           min,
+                      const Point           max,
+                      std::vector<Point> &  samples,
+                      const int             max_attempts,
+                      uint                  seed)
+{
+    auto r = [radius](const Point &) { return radius; };
+    Poisson_sampling<Dim,Point>(r, radius, radius, min, max, samples, max_attempts, seed);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void Poisson_sampling(const AbstractPolygonMesh<M,V,E,P>           & m,
+                      const std::function<double(const vec3d &)> & radius,
+                      const double                                 r_min,
+                      const double                                 r_max,
+                      std::vector<vec3d>                         & samples,
+                      const int                                    max_attempts,
+                      uint                                         seed)
+{
+    assert(r_min>0 && r_min<=r_max);
+
+    AABB   bb(m.vector_verts());
+    double step = 0.999*r_min/std::sqrt(3.0);
+    std::array<uint,3> extent;
+    for(uint i=0; i<3; ++i) extent[i] = static_cast<uint>(std::floor(bb.delta()[i]/step))+1;
+
+    auto cell_of = [&](const vec3d & p) -> std::array<uint,3>
+    {
+        std::array<uint,3> c;
+        for(uint i=0; i<3; ++i) c[i] = std::min(extent[i]-1, static_cast<uint>(std::max(0.0, (p[i]-bb.min[i])/step)));
+        return c;
+    };
+    auto lin = [&](const std::array<uint,3> & c) -> uint64_t
+    {
+        return c[0] + uint64_t(extent[0])*(c[1] + uint64_t(extent[1])*c[2]);
+    };
+
+    // bin triangles into grid cells. Triangles spanning more than two cells
+    // per axis are recursively split, so that only cells close to the surface
+    // are activated
+    std::vector<vec3d> tris; // sub triangles, 3 verts each
+    std::vector<std::pair<uint64_t,uint>> bins;
+    std::vector<vec3d> stack;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        const std::vector<uint> & tess = m.poly_tessellation(pid);
+        for(uint i=0; i<tess.size(); i+=3)
         {
-            uint id=uint(samples.size()); // the index of the new sample
-            samples.push_back(x);
-            active_list.push_back(id);
-            index=serialize_nD_index<Dim,Point>(dim_extent, (x-min)/step);
-            grid[index]=(int)id;
+            stack.push_back(m.vert(tess[i  ]));
+            stack.push_back(m.vert(tess[i+1]));
+            stack.push_back(m.vert(tess[i+2]));
         }
-        else
+        while(!stack.empty())
+        {
+            vec3d c = stack.back(); stack.pop_back();
+            vec3d b = stack.back(); stack.pop_back();
+            vec3d a = stack.back(); stack.pop_back();
+            AABB tb(std::vector<vec3d>{a,b,c});
+            if(tb.delta().max_entry()>step)
+            {
+                vec3d ab = (a+b)*0.5, bc = (b+c)*0.5, ca = (c+a)*0.5;
+                for(const vec3d & v : {a,ab,ca, ab,b,bc, ca,bc,c, ab,bc,ca}) stack.push_back(v);
+                continue;
+            }
+            uint tid = uint(tris.size()/3);
+            tris.push_back(a);
+            tris.push_back(b);
+            tris.push_back(c);
+            std::array<uint,3> c0 = cell_of(tb.min);
+            std::array<uint,3> c1 = cell_of(tb.max);
+            for(uint x=c0[0]; x<=c1[0]; ++x)
+            for(uint y=c0[1]; y<=c1[1]; ++y)
+            for(uint z=c0[2]; z<=c1[2]; ++z)
+            {
+                bins.push_back(std::make_pair(lin({x,y,z}), tid));
+            }
+        }
+    }
+    std::sort(bins.begin(), bins.end());
+
+    // CSR list of per cell triangles, with cumulated areas for area weighted picking
+    std::vector<uint64_t> cells;
+    std::vector<uint>     offset;
+    std::vector<uint>     cell_tris;
+    std::vector<double>   cell_areas;
+    for(uint i=0; i<bins.size(); ++i)
+    {
+        if(cells.empty() || cells.back()!=bins[i].first)
         {
-            // since we couldn't find a sample on p's disk, we remove p from the active list
-            active_list[r]=active_list.back();
-            active_list.pop_back();
+            cells.push_back(bins[i].first);
+            offset.push_back(i);
         }
+        uint   tid  = bins[i].second;
+        double area = 0.5*(tris[3*tid+1]-tris[3*tid]).cross(tris[3*tid+2]-tris[3*tid]).norm();
+        double prev = (offset.back()==i) ? 0.0 : cell_areas.back();
+        cell_tris.push_back(tid);
+        cell_areas.push_back(prev + area);
     }
+    offset.push_back(uint(bins.size()));
+
+    auto throw_dart = [&](const uint64_t cell, uint s, vec3d & p) -> bool
+    {
+        uint slot = uint(std::lower_bound(cells.begin(), cells.end(), cell) - cells.begin());
+        uint beg  = offset[slot];
+        uint end  = offset[slot+1];
+        double a  = random_double(s++)*cell_areas[end-1];
+        uint i    = beg;
+        while(i<end-1 && cell_areas[i]<a) ++i;
+        uint tid  = cell_tris[i];
+
+        // uniform point in triangle
+        double r1 = std::sqrt(random_double(s++));
+        double r2 = random_double(s++);
+        p = (1-r1)*tris[3*tid] + r1*(1-r2)*tris[3*tid+1] + r1*r2*tris[3*tid+2];
+
+        // reject if outside the cell (triangles may cover multiple cells)
+        return lin(cell_of(p))==cell;
+    };
+
+    Poisson_sampling_phase_groups<3,vec3d>(bb.min, step, extent, cells, throw_dart, radius, r_max, samples, max_attempts, seed);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void Poisson_sampling(const AbstractPolygonMesh<M,V,E,P> & m,
+                      const double                       radius,
+                      std::vector<vec3d>               & samples,
+                      const int                          max_attempts,
+                      uint                               seed)
+{
+    auto r = [radius](const vec3d &) { return radius; };
+    Poisson_sampling(m, r, radius, radius, samples, max_attempts, seed);
 }
 
 }
@@ -36,28 +36,107 @@
 #ifndef CINO_POISSON_SAMPLING
 #define CINO_POISSON_SAMPLING
 
-#include <cinolib/cino_inline.h>
+#include <array>
+#include <functional>
+#include <vector>
+#include <stdint.h>
 #include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/meshes/abstract_polygonmesh.h>
 
 namespace cinolib
 {
 
-/* This is almost a 1:1 copy of the reference implementation of the Fast Poisson disk sampling in arbitrary
- * dimensions released by Robert Bridson (https://www.cs.ubc.ca/~rbridson/download/curlnoise.tar.gz). See:
+/* Parallel Poisson disk sampling, implemented with the phase group dart
+ * throwing strategy described in:
+ *
+ * Parallel Poisson Disk Sampling
+ * Li-Yi Wei
+ * ACM Transactions on Graphics (SIGGRAPH 2008)
  *
- * Fast Poisson Disk Sampling in Arbitrary Dimensions
- * Robert Bridson
- * SIGGRAPH Technical Sketch, 2007
+ * The domain is covered by a grid with cells of size r_min/sqrt(Dim), so that
+ * each cell hosts at most one sample. Cells are partitioned into phase groups,
+ * such that cells in the same group are far enough apart to never conflict.
+ * Darts are thrown in parallel in all the cells of a group, and groups are
+ * visited in a fixed order. Each cell receives one dart per round, for
+ * max_attempts rounds. Random numbers are drawn from a stateless generator
+ * seeded with (seed, cell, round), hence the output depends on the seed only,
+ * and not on the number of threads. Output samples are sorted by grid cell.
+ *
+ * Spatially varying radii are supported: two samples p,q are in conflict if
+ * their distance is below max(radius(p),radius(q)). The radius function must
+ * be thread safe and return values in [r_min,r_max]. Notice that the grid
+ * resolution depends on r_min, and the size of the neighborhood that must be
+ * checked for conflicts grows with r_max/r_min.
 */
 
+template<uint Dim, class Point>
+CINO_INLINE
+void Poisson_sampling(const std::function<double(const Point &)> & radius,
+                      const double                                 r_min,
+                      const double                                 r_max,
+                      const Point                                  min,
+                      const Point                                  max,
+                      std::vector<Point>                         & samples,
+                      const int                                    max_attempts=30,
+                      uint                                         seed=0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// uniform radius sampling of the box [min,max]
+//
 template<uint Dim, class Point>
 CINO_INLINE
 void Poisson_sampling(const double         radius,
                       const Point          min,
                       const Point          max,
                       std::vector<Point> & samples,
-                      uint                 seed=0,
-                      const int            max_attempts=30);
+                      const int            max_attempts=30,
+                      uint                 seed=0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Poisson disk sampling of the surface of a polygonal mesh. Distances are
+// measured in the ambient space (not geodesic)
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void Poisson_sampling(const AbstractPolygonMesh<M,V,E,P>           & m,
+                      const std::function<double(const vec3d &)> & radius,
+                      const double                                 r_min,
+                      const double                                 r_max,
+                      std::vector<vec3d>                         & samples,
+                      const int                                    max_attempts=30,
+                      uint                                         seed=0);
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void Poisson_sampling(const AbstractPolygonMesh<M,V,E,P> & m,
+                      const double                       radius,
+                      std::vector<vec3d>               & samples,
+                      const int                          max_attempts=30,
+                      uint                               seed=0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// core routine, shared by all the samplers above. The grid has extent cells
+// of size step along each axis, starting at min. If cells is empty all grid cells are sampled,
+// otherwise only the cells in the list (sorted linear ids). throw_dart draws a
+// random point in the cell with the given linear id, and returns false if it
+// fails to do so
+//
+template<uint Dim, class Point>
+CINO_INLINE
+void Poisson_sampling_phase_groups(const Point                                                         & min,
+                                   const double                                                          step,
+                                   const std::array<uint,Dim>                                          & extent,
+                                   const std::vector<uint64_t>                                         & cells,
+                                   const std::function<bool(const uint64_t cell, uint seed, Point & p)> & throw_dart,
+                                   const std::function<double(const Point &)>                          & radius,
+                                   const double                                                          r_max,
+                                   std::vector<Point>                                                  & samples,
+                                   const int                                                             max_attempts,
+                                   const uint                                                            seed);
 
 }
 
@@ -110,7 +110,7 @@ void ambient_occlusion_srf_meshes(      Mesh & m,
 
                 if(z_buffer[buffer_size*int(pp.y())+int(pp.x())]+0.0025 > depth)
                 {
-                    ao[pid] += float(std::max(-dir.dot(m.poly_data(pid).normal),0.0));
+                    ao[pid] += float(std::max(-dir.dot(m.poly_normal(pid)),0.0));
                 }
             }
         });
@@ -124,7 +124,7 @@ void ambient_occlusion_srf_meshes(      Mesh & m,
     auto max     = *min_max.second;
     for(uint pid=0; pid<m.num_polys(); ++pid)
     {
-        m.poly_data(pid).AO = (m.poly_data(pid).flags[HIDDEN]) ? 1.f : (ao[pid]-min)/max;
+        m.poly_AO(pid) = (m.poly_data(pid).flags[HIDDEN]) ? 1.f : (ao[pid]-min)/max;
     }
 }
 
@@ -212,7 +212,7 @@ void ambient_occlusion_vol_meshes(      Mesh & m,
     float max     = *min_max.second;
     for(uint fid=0; fid<m.num_faces(); ++fid)
     {
-        m.face_data(fid).AO = (face_visible.at(fid)) ? (ao[fid]-min)/max : 1.f;
+        m.face_AO(fid) = (face_visible.at(fid)) ? (ao[fid]-min)/max : 1.f;
     }
 }
 
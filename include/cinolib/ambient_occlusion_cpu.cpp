@@ -0,0 +1,187 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/ambient_occlusion_cpu.h>
+#include <cinolib/octree.h>
+#include <cinolib/sphere_coverage.h>
+#include <cinolib/parallel_for.h>
+
+namespace cinolib
+{
+
+// k-th point of a low discrepancy sequence (Roberts' R2) folded onto a triangle
+//
+CINO_INLINE
+static vec3d ao_sample_in_triangle(const vec3d & a, const vec3d & b, const vec3d & c, const uint k)
+{
+    double u = std::fmod(0.5 + 0.7548776662466927*k, 1.0);
+    double v = std::fmod(0.5 + 0.5698402909980532*k, 1.0);
+    if(u+v>1) { u = 1-u; v = 1-v; }
+    return a + (b-a)*u + (c-a)*v;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// accumulates the (cosine weighted) fraction of unoccluded rays thrown from n_elems
+// elements, each represented by a list of triangles and a normal. Elements for
+// which tris(id) is empty are skipped
+//
+template<class Tris, class Normal>
+CINO_INLINE
+static void ao_accumulate(const uint                 n_elems,
+                          const Tris               & tris,
+                          const Normal             & normal,
+                          const Octree             & octree,
+                          const std::vector<vec3d> & dirs,
+                          const double               eps,
+                                std::vector<float> & ao)
+{
+    ao.assign(n_elems, 0.f);
+    PARALLEL_FOR(0, n_elems, 100, [&](const uint id)
+    {
+        std::vector<vec3d> t = tris(id);
+        if(t.empty()) return;
+        vec3d  n = normal(id);
+        uint   k = 0;
+        for(const vec3d & dir : dirs)
+        {
+            // same convention of the GL version: the element is lit from -dir
+            double w = -dir.dot(n);
+            if(w<=0) continue;
+
+            uint  tid = k%(t.size()/3);
+            vec3d p   = ao_sample_in_triangle(t[3*tid], t[3*tid+1], t[3*tid+2], k/(t.size()/3)) + n*eps;
+            ++k;
+            if(!octree.intersects_ray(p, -dir)) ao[id] += float(w);
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void ambient_occlusion_srf_meshes_cpu(AbstractPolygonMesh<M,V,E,P> & m,
+                                      const uint                     sample_dirs)
+{
+    std::vector<vec3d> dirs;
+    sphere_coverage(sample_dirs, dirs);
+
+    // hidden polygons do not occlude
+    Octree octree(10,8);
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        if(m.poly_data(pid).flags[HIDDEN]) continue;
+        const std::vector<uint> & tess = m.poly_tessellation(pid);
+        for(uint i=0; i+2<tess.size(); i+=3)
+        {
+            octree.push_triangle(pid, m.vert(tess[i]), m.vert(tess[i+1]), m.vert(tess[i+2]));
+        }
+    }
+    octree.build();
+
+    std::vector<float> ao;
+    ao_accumulate(m.num_polys(), [&](const uint pid)
+    {
+        std::vector<vec3d> t;
+        if(!m.poly_data(pid).flags[HIDDEN])
+        {
+            for(uint vid : m.poly_tessellation(pid)) t.push_back(m.vert(vid));
+        }
+        return t;
+    },
+    [&](const uint pid) { return m.poly_normal(pid); },
+    octree, dirs, 1e-5*m.bbox().diag(), ao);
+
+    // apply AO
+    auto min_max = std::minmax_element(ao.begin(), ao.end());
+    auto min     = *min_max.first;
+    auto max     = *min_max.second;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        m.poly_AO(pid) = (m.poly_data(pid).flags[HIDDEN]) ? 1.f : (ao[pid]-min)/max;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void ambient_occlusion_vol_meshes_cpu(AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                      const uint                          sample_dirs)
+{
+    std::vector<vec3d> dirs;
+    sphere_coverage(sample_dirs, dirs);
+
+    // only visible faces (i.e. the current outer surface) occlude
+    std::vector<int> pid_beneath(m.num_faces(), -1);
+    Octree octree(10,8);
+    for(uint fid=0; fid<m.num_faces(); ++fid)
+    {
+        uint pid;
+        if(!m.face_is_visible(fid, pid)) continue;
+        pid_beneath.at(fid) = int(pid);
+        std::vector<uint> tess = m.face_tessellation(fid);
+        for(uint i=0; i+2<tess.size(); i+=3)
+        {
+            octree.push_triangle(fid, m.vert(tess[i]), m.vert(tess[i+1]), m.vert(tess[i+2]));
+        }
+    }
+    octree.build();
+
+    std::vector<float> ao;
+    ao_accumulate(m.num_faces(), [&](const uint fid)
+    {
+        std::vector<vec3d> t;
+        if(pid_beneath.at(fid)>=0)
+        {
+            for(uint vid : m.face_tessellation(fid)) t.push_back(m.vert(vid));
+        }
+        return t;
+    },
+    [&](const uint fid) { return m.poly_face_normal(uint(pid_beneath.at(fid)), fid); },
+    octree, dirs, 1e-5*m.bbox().diag(), ao);
+
+    // apply AO
+    auto  min_max = std::minmax_element(ao.begin(), ao.end());
+    float min     = *min_max.first;
+    float max     = *min_max.second;
+    for(uint fid=0; fid<m.num_faces(); ++fid)
+    {
+        m.face_AO(fid) = (pid_beneath.at(fid)>=0) ? (ao[fid]-min)/max : 1.f;
+    }
+}
+
+}
@@ -0,0 +1,74 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_AMBIENT_OCCLUSION_CPU_H
+#define CINO_AMBIENT_OCCLUSION_CPU_H
+
+#include <cinolib/meshes/abstract_polygonmesh.h>
+#include <cinolib/meshes/abstract_polyhedralmesh.h>
+
+namespace cinolib
+{
+
+/* CPU counterpart of ambient_occlusion_srf_meshes/ambient_occlusion_vol_meshes,
+ * which does not require any GL context (e.g. for headless batch processing).
+ * Visibility is computed by ray casting against an Octree of the visible
+ * elements, in parallel over polygons (resp. faces). Each element throws one
+ * ray per sample direction, stratified both in direction space (spherical
+ * Fibonacci lattice) and on the element itself (low discrepancy origins over
+ * its tessellation), rather than probing its centroid only.
+ *
+ * AO values are accumulated and normalized as in the GL version, and stored
+ * in the AO field of the polygon (resp. face) attributes.
+*/
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void ambient_occlusion_srf_meshes_cpu(AbstractPolygonMesh<M,V,E,P> & m,
+                                      const uint                     sample_dirs = 64);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void ambient_occlusion_vol_meshes_cpu(AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                      const uint                          sample_dirs = 128);
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "ambient_occlusion_cpu.cpp"
+#endif
+
+#endif // CINO_AMBIENT_OCCLUSION_CPU_H
@@ -34,40 +34,59 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/bfs.h>
-//
-#include <cinolib/stl_container_utilities.h>
-#include <queue>
+#include <vector>
 
 namespace cinolib
 {
 
-//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-
+// shared BFS core. Visited elements are tracked with a dense array rather than
+// with the output hash set, which is only filled at the end. expand(curr,nbrs)
+// must append to nbrs all the elements that can be reached from curr
+//
+template<class Expand>
 CINO_INLINE
-void bfs(const std::vector<std::vector<uint>> & nodes_adjacency,
-         const uint                             source,
-               std::unordered_set<uint>       & visited)
+void bfs_flood(const uint                       n,
+               const uint                       source,
+               const Expand                   & expand,
+                     std::unordered_set<uint> & visited)
 {
-    visited.clear();
-
-    std::queue<uint> q;
-    q.push(source);
+    std::vector<bool> seen(n, false);
+    std::vector<uint> order;
+    std::vector<uint> nbrs;
+    seen.at(source) = true;
+    order.push_back(source);
 
-    while(!q.empty())
+    for(uint i=0; i<order.size(); ++i)
     {
-        uint vid = q.front();
-        q.pop();
-
-        visited.insert(vid);
-
-        for(uint nbr : nodes_adjacency.at(vid))
+        nbrs.clear();
+        expand(order[i], nbrs);
+        for(uint nbr : nbrs)
         {
-            if (DOES_NOT_CONTAIN(visited,nbr))
+            if(!seen.at(nbr))
             {
-                q.push(nbr);
+                seen.at(nbr) = true;
+                order.push_back(nbr);
             }
         }
     }
+
+    visited.clear();
+    visited.reserve(order.size());
+    visited.insert(order.begin(), order.end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void bfs(const std::vector<std::vector<uint>> & nodes_adjacency,
+         const uint                             source,
+               std::unordered_set<uint>       & visited)
+{
+    bfs_flood(uint(nodes_adjacency.size()), source, [&](const uint vid, std::vector<uint> & nbrs)
+    {
+        nbrs = nodes_adjacency.at(vid);
+    },
+    visited);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -78,26 +97,11 @@ void bfs(const AbstractMesh<M,V,E,P>    & m,
          const uint                       source,
                std::unordered_set<uint> & visited)
 {
-    visited.clear();
-    visited.insert(source);
-
-    std::queue<uint> q;
-    q.push(source);
-
-    while(!q.empty())
+    bfs_flood(m.num_verts(), source, [&](const uint vid, std::vector<uint> & nbrs)
     {
-        uint vid = q.front();
-        q.pop();
-
-        for(uint nbr : m.adj_v2v(vid))
-        {
-            if (DOES_NOT_CONTAIN(visited,nbr))
-            {
-                visited.insert(nbr);
-                q.push(nbr);
-            }
-        }
-    }
+        nbrs = m.adj_v2v(vid);
+    },
+    visited);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -109,26 +113,11 @@ void bfs(const AbstractMesh<M,V,E,P>    & m,
          const std::vector<bool>        & mask, // if mask[vid] = true, path cannot pass through vertex vid
                std::unordered_set<uint> & visited)
 {
-    visited.clear();
-    visited.insert(source);
-
-    std::queue<uint> q;
-    q.push(source);
-
-    while(!q.empty())
+    bfs_flood(m.num_verts(), source, [&](const uint vid, std::vector<uint> & nbrs)
     {
-        uint vid = q.front();
-        q.pop();
-
-        for(uint nbr : m.adj_v2v(vid))
-        {
-            if (!mask.at(nbr) && DOES_NOT_CONTAIN(visited,nbr))
-            {
-                visited.insert(nbr);
-                q.push(nbr);
-            }
-        }
-    }
+        for(uint nbr : m.adj_v2v(vid)) if(!mask.at(nbr)) nbrs.push_back(nbr);
+    },
+    visited);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -140,30 +129,16 @@ void bfs_srf_only(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
                   const std::vector<bool>                 & mask, // if mask[vid] = true, path cannot pass through vertex vid
                   std::unordered_set<uint>                & visited)
 {
-    visited.clear();
-    visited.insert(source);
-
-    std::queue<uint> q;
-    q.push(source);
-
-    while(!q.empty())
+    bfs_flood(m.num_verts(), source, [&](const uint vid, std::vector<uint> & nbrs)
     {
-        uint vid = q.front();
-        q.pop();
-
         for(uint eid : m.adj_v2e(vid))
         {
-            if(m.edge_is_on_srf(eid))
-            {
-                uint nbr = m.vert_opposite_to(eid,vid);
-                if (!mask.at(nbr) && DOES_NOT_CONTAIN(visited,nbr))
-                {
-                    visited.insert(nbr);
-                    q.push(nbr);
-                }
-            }
+            if(!m.edge_is_on_srf(eid)) continue;
+            uint nbr = m.vert_opposite_to(eid,vid);
+            if(!mask.at(nbr)) nbrs.push_back(nbr);
         }
-    }
+    },
+    visited);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -175,26 +150,11 @@ void bfs_on_dual(const AbstractMesh<M,V,E,P>    & m,
                  const std::vector<bool>        & mask, // if mask[p] = true, path cannot pass through it
                        std::unordered_set<uint> & visited)
 {
-    visited.clear();
-    visited.insert(source);
-
-    std::queue<uint> q;
-    q.push(source);
-
-    while(!q.empty())
+    bfs_flood(m.num_polys(), source, [&](const uint pid, std::vector<uint> & nbrs)
     {
-        uint pid = q.front();
-        q.pop();
-
-        for(uint nbr : m.adj_p2p(pid))
-        {
-            if (!mask.at(nbr) && DOES_NOT_CONTAIN(visited,nbr))
-            {
-                visited.insert(nbr);
-                q.push(nbr);
-            }
-        }
-    }
+        for(uint nbr : m.adj_p2p(pid)) if(!mask.at(nbr)) nbrs.push_back(nbr);
+    },
+    visited);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -208,27 +168,14 @@ void bfs_on_dual_w_edge_barriers(const AbstractPolygonMesh<M,V,E,P> & m,
                                  const std::vector<bool>            & mask_edges, // if mask[e] = true, bfs cannot expand through edge e
                                  std::unordered_set<uint>           & visited)
 {
-    visited.clear();
-    visited.insert(source);
-
-    std::queue<uint> q;
-    q.push(source);
-
-    while(!q.empty())
+    bfs_flood(m.num_polys(), source, [&](const uint pid, std::vector<uint> & nbrs)
     {
-        uint pid = q.front();
-        q.pop();
-
         for(uint nbr : m.adj_p2p(pid))
         {
-            uint eid = m.edge_shared(pid,nbr);
-            if (!mask_edges.at(eid) && DOES_NOT_CONTAIN(visited,nbr))
-            {
-                visited.insert(nbr);
-                q.push(nbr);
-            }
+            if(!mask_edges.at(m.edge_shared(pid,nbr))) nbrs.push_back(nbr);
         }
-    }
+    },
+    visited);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -242,27 +189,15 @@ void bfs_on_dual_w_face_barriers(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
                                  const std::vector<bool>                 & mask_faces, // if mask[f] = true, bfs cannot expand through face f
                                  std::unordered_set<uint>                & visited)
 {
-    visited.clear();
-    visited.insert(source);
-
-    std::queue<uint> q;
-    q.push(source);
-
-    while(!q.empty())
+    bfs_flood(m.num_polys(), source, [&](const uint pid, std::vector<uint> & nbrs)
     {
-        uint pid = q.front();
-        q.pop();
-
         for(uint fid : m.adj_p2f(pid))
         {
-            int nbr = (m.poly_adj_through_face(pid,fid));
-            if (nbr>=0 && !mask_faces.at(fid) && DOES_NOT_CONTAIN(visited,nbr))
-            {
-                visited.insert(nbr);
-                q.push(nbr);
-            }
+            int nbr = m.poly_adj_through_face(pid,fid);
+            if(nbr>=0 && !mask_faces.at(fid)) nbrs.push_back(uint(nbr));
         }
-    }
+    },
+    visited);
 }
 
 }
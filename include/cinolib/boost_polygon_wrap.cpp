@@ -141,6 +141,34 @@ BoostMultiPolygon polygon_union(const Poly0 & p0, const Poly1 & p1)
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<typename Poly>
+CINO_INLINE
+BoostMultiPolygon polygon_union(const std::vector<Poly> & polys)
+{
+    if(polys.empty()) return BoostMultiPolygon();
+
+    std::vector<BoostMultiPolygon> level;
+    level.reserve((polys.size()+1)/2);
+    for(size_t i=0; i<polys.size(); i+=2)
+    {
+        if(i+1<polys.size()) level.push_back(polygon_union(polys[i], polys[i+1]));
+        else                 level.push_back(polygon_union(BoostMultiPolygon(), polys[i]));
+    }
+    while(level.size()>1)
+    {
+        size_t n = 0;
+        for(size_t i=0; i<level.size(); i+=2)
+        {
+            if(i+1<level.size()) level[n++] = polygon_union(level[i], level[i+1]);
+            else                 level[n++] = std::move(level[i]);
+        }
+        level.resize(n);
+    }
+    return level.front();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<typename Poly0, typename Poly1>
 CINO_INLINE
 BoostMultiPolygon polygon_difference(const Poly0 & p0, const Poly1 & p1)
@@ -99,6 +99,15 @@ namespace cinolib
 
     //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+    // union of many polygons, merged pairwise in a balanced binary tree (i.e.
+    // O(n log n) instead of the O(n^2) of a left fold on an ever growing union)
+    //
+    template<typename Poly>
+    CINO_INLINE
+    BoostMultiPolygon polygon_union(const std::vector<Poly> & polys);
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
     template<typename Poly0, typename Poly1>
     CINO_INLINE
     BoostMultiPolygon polygon_difference(const Poly0 & p0, const Poly1 & p1);
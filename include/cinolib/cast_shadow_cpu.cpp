@@ -0,0 +1,110 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/cast_shadow_cpu.h>
+#include <cinolib/deg_rad.h>
+#include <cstring>
+
+namespace cinolib
+{
+
+CINO_INLINE
+mat3d cast_shadow_view_rotation(const vec3d & dir)
+{
+    vec3d Z(0,0,1);
+    vec3d a = dir.cross(Z);
+    if(a.norm()<1e-12) return (dir.dot(Z)>0) ? mat3d::DIAG(1.0) : mat3d::DIAG(vec3d(1,-1,-1));
+    a.normalize();
+    return mat3d::ROT_3D(a, to_rad(Z.angle_deg(dir)));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void cast_shadow_cpu(const AbstractPolygonMesh<M,V,E,P> & m,
+                     const vec3d                        & dir,
+                     const uint                           w,
+                     const uint                           h,
+                           uint8_t                      * data)
+{
+    std::memset(data, 0x00, w*h);
+
+    // same model-view-projection-viewport of the GL version
+    mat3d  R = cast_shadow_view_rotation(dir);
+    vec3d  c = m.centroid();
+    double s = 2.0/m.bbox().diag();
+    auto to_pixel = [&](const vec3d & p) -> vec2d
+    {
+        vec3d q = R*(p-c)*s;
+        return vec2d((q.x()+1.0)*0.5*w, (q.y()+1.0)*0.5*h);
+    };
+
+    std::vector<vec2d> pix(m.num_verts());
+    for(uint vid=0; vid<m.num_verts(); ++vid) pix[vid] = to_pixel(m.vert(vid));
+
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        if(m.poly_data(pid).flags[HIDDEN]) continue;
+
+        const std::vector<uint> & tess = m.poly_tessellation(pid);
+        for(uint i=0; i+2<tess.size(); i+=3)
+        {
+            const vec2d & a = pix[tess[i  ]];
+            const vec2d & b = pix[tess[i+1]];
+            const vec2d & d = pix[tess[i+2]];
+            double area = (b-a).x()*(d-a).y() - (b-a).y()*(d-a).x();
+            if(area==0) continue;
+            double sign = (area>0) ? 1.0 : -1.0;
+
+            // scan convert the triangle, testing pixel centers against the three edge functions
+            int x0 = std::max(0,    int(std::floor(std::min(a.x(), std::min(b.x(), d.x())) - 0.5)));
+            int x1 = std::min(int(w)-1, int(std::ceil (std::max(a.x(), std::max(b.x(), d.x())) - 0.5)));
+            int y0 = std::max(0,    int(std::floor(std::min(a.y(), std::min(b.y(), d.y())) - 0.5)));
+            int y1 = std::min(int(h)-1, int(std::ceil (std::max(a.y(), std::max(b.y(), d.y())) - 0.5)));
+            for(int y=y0; y<=y1; ++y)
+            for(int x=x0; x<=x1; ++x)
+            {
+                vec2d p(x+0.5, y+0.5);
+                double e0 = sign*((b-a).x()*(p-a).y() - (b-a).y()*(p-a).x());
+                double e1 = sign*((d-b).x()*(p-b).y() - (d-b).y()*(p-b).x());
+                double e2 = sign*((a-d).x()*(p-d).y() - (a-d).y()*(p-d).x());
+                if(e0>=0 && e1>=0 && e2>=0) data[y*w+x] = 0xFF;
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,77 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_CAST_SHADOW_CPU_H
+#define CINO_CAST_SHADOW_CPU_H
+
+#include <cinolib/meshes/abstract_polygonmesh.h>
+
+namespace cinolib
+{
+
+/* CPU counterpart of cast_shadow, which does not require any GL context. The
+ * mesh is projected along the light direction exactly as in the GL version
+ * (i.e. centered at its centroid and scaled to fit the [-1,1]^2 square), and
+ * its triangles are scan converted into a w x h buffer, 8 bits per pixel:
+ *
+ *    0x00: background
+ *    0xff: foreground (shadow)
+ *
+ * Pixels are covered if their center falls within a projected triangle.
+ * Hidden polygons do not cast shadows. The first row of the buffer is the
+ * bottom one, as for glReadPixels.
+*/
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void cast_shadow_cpu(const AbstractPolygonMesh<M,V,E,P> & m,     // mesh to be rendered
+                     const vec3d                        & dir,   // light direction
+                     const uint                           w,     // width
+                     const uint                           h,     // height
+                           uint8_t                      * data); // w x h buffer, 8 bits per pixel
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// rotation used to look at the scene along direction dir (i.e. dir becomes +Z)
+//
+CINO_INLINE
+mat3d cast_shadow_view_rotation(const vec3d & dir);
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "cast_shadow_cpu.cpp"
+#endif
+
+#endif // CINO_CAST_SHADOW_CPU_H
@@ -34,7 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/coarse_layout.h>
-#include <cinolib/bfs.h>
+#include <cinolib/connected_components.h>
 #include <queue>
 
 namespace cinolib
@@ -78,20 +78,14 @@ void compute_coarse_quad_layout(Quadmesh<M,V,E,P> & m)
         }
     }
 
-    // flood polys
-    int patch_id = 0;
+    // flood polys (patches are numbered in order of their lowest pid)
+    std::vector<int> patch;
+    uint patch_id = connected_components_on_dual_w_edge_barriers(m, on_domain_border, patch);
     for(uint pid=0; pid<m.num_polys(); ++pid)
     {
-        if (m.poly_data(pid).flags[MARKED]) continue; // already visited
-        std::unordered_set<uint> patch;
-        bfs_on_dual_w_edge_barriers(m, pid, on_domain_border, patch);
-        for(uint p : patch)
-        {
-            m.poly_data(p).label  = patch_id;
-            m.poly_data(p).flags[MARKED] = true;
-        }
-        ++patch_id;
+        m.poly_data(pid).label = patch.at(pid);
     }
+    m.poly_set_flag(MARKED,true);
 
     std::cout << "coarse quad layout:" << std::endl;
     std::cout << "\t" << nv            << " singular vertices found" << std::endl;
@@ -142,20 +136,14 @@ void compute_coarse_hex_layout(Hexmesh<M,V,E,P> & m)
         }
     }
 
-    // flood polys
-    int patch_id = 0;
+    // flood polys (patches are numbered in order of their lowest pid)
+    std::vector<int> patch;
+    uint patch_id = connected_components_on_dual_w_face_barriers(m, on_domain_border, patch);
     for(uint pid=0; pid<m.num_polys(); ++pid)
     {
-        if (m.poly_data(pid).flags[MARKED]) continue; // already visited
-        std::unordered_set<uint> patch;
-        bfs_on_dual_w_face_barriers(m, pid, on_domain_border, patch);
-        for(uint p : patch)
-        {
-            m.poly_data(p).label  = patch_id;
-            m.poly_data(p).flags[MARKED] = true;
-        }
-        ++patch_id;
+        m.poly_data(pid).label = patch.at(pid);
     }
+    m.poly_set_flag(MARKED,true);
 
     std::cout << "coarse hex layout:" << std::endl;
     std::cout << "\t" << nv           << " singular vertices found" << std::endl;
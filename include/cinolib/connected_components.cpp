@@ -34,17 +34,47 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/connected_components.h>
-#include <cinolib/bfs.h>
+#include <cinolib/union_find.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
 
+template<class Link>
+CINO_INLINE
+uint connected_components_labeling(const uint                n,
+                                   const std::vector<bool> & mask,
+                                   const Link              & link,
+                                   std::vector<int>        & label)
+{
+    assert(mask.empty() || mask.size()==n);
+
+    UnionFind uf(n);
+    PARALLEL_FOR(0, n, 1000, [&](const uint i)
+    {
+        if(mask.empty() || !mask[i]) link(i, uf);
+    });
+
+    // roots are minimum elements, hence they come before the rest of their component
+    label.resize(n);
+    uint n_ccs = 0;
+    for(uint i=0; i<n; ++i)
+    {
+        if(!mask.empty() && mask[i]) { label[i] = -1; continue; }
+        uint r = uf.find(i);
+        label[i] = (r==i) ? int(n_ccs++) : label[r];
+    }
+    return n_ccs;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 uint connected_components(const AbstractMesh<M,V,E,P> & m)
 {
-    std::vector<std::unordered_set<uint>> ccs;
-    return connected_components(m, ccs);
+    std::vector<int> vert_label;
+    return connected_components(m, vert_label);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -54,24 +84,111 @@ CINO_INLINE
 uint connected_components(const AbstractMesh<M,V,E,P> & m,
                           std::vector<std::unordered_set<uint>> & ccs)
 {
+    std::vector<int> vert_label;
+    uint n_ccs = connected_components(m, vert_label);
+
     ccs.clear();
-    uint seed = 0;
-    std::vector<bool> visited(m.num_verts(), false);
+    ccs.resize(n_ccs);
+    for(uint vid=0; vid<m.num_verts(); ++vid)
+    {
+        ccs.at(vert_label.at(vid)).insert(vid);
+    }
+    return n_ccs;
+}
 
-    do
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components(const AbstractMesh<M,V,E,P> & m,
+                          std::vector<int>            & vert_label)
+{
+    return connected_components(m, std::vector<bool>(), vert_label);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components(const AbstractMesh<M,V,E,P> & m,
+                          const std::vector<bool>     & mask,
+                          std::vector<int>            & vert_label)
+{
+    return connected_components_labeling(m.num_verts(), mask, [&](const uint vid, UnionFind & uf)
     {
-        std::unordered_set<uint> cc;
-        bfs(m, seed, cc);
+        for(uint nbr : m.adj_v2v(vid))
+        {
+            if(nbr>vid && (mask.empty() || !mask[nbr])) uf.unite(vid,nbr);
+        }
+    },
+    vert_label);
+}
 
-        ccs.push_back(cc);
-        for(uint vid : cc) visited.at(vid) = true;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        seed = 0;
-        while (seed < m.num_verts() && visited.at(seed)) ++seed;
-    }
-    while (seed < m.num_verts());
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components_on_dual(const AbstractMesh<M,V,E,P> & m,
+                                  std::vector<int>            & poly_label)
+{
+    return connected_components_on_dual(m, std::vector<bool>(), poly_label);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components_on_dual(const AbstractMesh<M,V,E,P> & m,
+                                  const std::vector<bool>     & mask,
+                                  std::vector<int>            & poly_label)
+{
+    return connected_components_labeling(m.num_polys(), mask, [&](const uint pid, UnionFind & uf)
+    {
+        for(uint nbr : m.adj_p2p(pid))
+        {
+            if(nbr>pid && (mask.empty() || !mask[nbr])) uf.unite(pid,nbr);
+        }
+    },
+    poly_label);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components_on_dual_w_edge_barriers(const AbstractPolygonMesh<M,V,E,P> & m,
+                                                  const std::vector<bool>            & mask_edges,
+                                                  std::vector<int>                   & poly_label)
+{
+    return connected_components_labeling(m.num_polys(), std::vector<bool>(), [&](const uint pid, UnionFind & uf)
+    {
+        for(uint eid : m.adj_p2e(pid))
+        {
+            if(mask_edges.at(eid)) continue;
+            for(uint nbr : m.adj_e2p(eid)) if(nbr>pid) uf.unite(pid,nbr);
+        }
+    },
+    poly_label);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    return uint(ccs.size());
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+uint connected_components_on_dual_w_face_barriers(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                                  const std::vector<bool>                 & mask_faces,
+                                                  std::vector<int>                        & poly_label)
+{
+    return connected_components_labeling(m.num_polys(), std::vector<bool>(), [&](const uint pid, UnionFind & uf)
+    {
+        for(uint fid : m.adj_p2f(pid))
+        {
+            if(mask_faces.at(fid)) continue;
+            int nbr = m.poly_adj_through_face(pid,fid);
+            if(nbr>int(pid)) uf.unite(pid,uint(nbr));
+        }
+    },
+    poly_label);
 }
 
 }
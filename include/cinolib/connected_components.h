@@ -37,13 +37,26 @@
 #define CINO_CONNECTED_COMPONENTS_H
 
 #include <vector>
+#include <unordered_set>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
 #include <cinolib/meshes/abstract_mesh.h>
+#include <cinolib/meshes/abstract_polygonmesh.h>
+#include <cinolib/meshes/abstract_polyhedralmesh.h>
 
 namespace cinolib
 {
 
+/* Connected component labeling. Components are computed with a parallel,
+ * lock free union-find over a dense array (see union_find.h), and returned
+ * as a compact per element label in [0,#components). Components are numbered
+ * in order of their lowest element id. Masked elements do not belong to any
+ * component, and receive label -1.
+ *
+ * The variants that output one std::unordered_set per component are kept
+ * for backward compatibility, and are implemented on top of the labelers.
+*/
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 uint connected_components(const AbstractMesh<M,V,E,P> & m);
@@ -55,6 +68,67 @@ CINO_INLINE
 uint connected_components(const AbstractMesh<M,V,E,P> & m,
                           std::vector<std::unordered_set<uint>> & ccs);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// vertex components (through edges)
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components(const AbstractMesh<M,V,E,P> & m,
+                          std::vector<int>            & vert_label);
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components(const AbstractMesh<M,V,E,P> & m,
+                          const std::vector<bool>     & mask, // if mask[vid] = true, vid is not labeled
+                          std::vector<int>            & vert_label);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// polygon/polyhedron components (through edges/faces)
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components_on_dual(const AbstractMesh<M,V,E,P> & m,
+                                  std::vector<int>            & poly_label);
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components_on_dual(const AbstractMesh<M,V,E,P> & m,
+                                  const std::vector<bool>     & mask, // if mask[pid] = true, pid is not labeled
+                                  std::vector<int>            & poly_label);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// polygon components that do not cross the marked edges (e.g. patch layouts)
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components_on_dual_w_edge_barriers(const AbstractPolygonMesh<M,V,E,P> & m,
+                                                  const std::vector<bool>            & mask_edges,
+                                                  std::vector<int>                   & poly_label);
+
+// polyhedral components that do not cross the marked faces
+//
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+uint connected_components_on_dual_w_face_barriers(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                                  const std::vector<bool>                 & mask_faces,
+                                                  std::vector<int>                        & poly_label);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// generic graph labeler: link(i,uf) must unite element i with its neighbors
+// (it is enough to do it for neighbors with id greater than i). Elements for
+// which mask is true are skipped. The link function is called in parallel
+//
+template<class Link>
+CINO_INLINE
+uint connected_components_labeling(const uint                n,
+                                   const std::vector<bool> & mask,
+                                   const Link              & link,
+                                   std::vector<int>        & label);
+
 }
 
 #ifndef  CINO_STATIC_LIB
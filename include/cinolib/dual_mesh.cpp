@@ -39,6 +39,7 @@
 *********************************************************************************/
 #include <cinolib/dual_mesh.h>
 #include <cinolib/geometry/tetrahedron_utils.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -54,8 +55,28 @@ void dual_mesh(const AbstractPolyhedralMesh<M,V,E,F,P> & primal,
     std::vector<std::vector<uint>> dual_polys;
     std::vector<std::vector<bool>> dual_polys_winding;
     dual_mesh(primal, dual_verts, dual_faces, dual_polys, dual_polys_winding, with_clipped_cells);
-    dual = Polyhedralmesh<M,V,E,F,P>(dual_verts, dual_faces, dual_polys, dual_polys_winding);
-    dual.poly_fix_orientation();
+    // dual faces come already oriented, hence there is no need to fix windings
+    dual.clear();
+    dual.init_bulk(dual_verts, dual_faces, dual_polys, dual_polys_winding);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* True if walking from the primal poly pid to the next poly around edge eid through
+ * face fid turns CCW w.r.t. the edge direction (from its first to its second vertex).
+ * This happens if fid, oriented outward w.r.t. pid, traverses the edge in the same
+ * direction. If so, the dual face of eid points towards the second edge vertex
+*/
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+bool dual_face_is_CCW(const AbstractPolyhedralMesh<M,V,E,F,P> & primal,
+                      const uint                                pid,
+                      const uint                                fid,
+                      const uint                                eid)
+{
+    uint v0 = primal.edge_vert_id(eid,0);
+    uint v1 = primal.edge_vert_id(eid,1);
+    return primal.face_verts_are_CCW(fid,v1,v0) == primal.poly_face_is_CCW(pid,fid);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -74,188 +95,236 @@ void dual_mesh(const AbstractPolyhedralMesh<M,V,E,F,P> & primal,
     dual_polys.clear();
     dual_polys_winding.clear();
 
+    uint nv = primal.num_verts();
+    uint ne = primal.num_edges();
+    uint nf = primal.num_faces();
+    uint np = primal.num_polys();
+
     // add one dual vertex for each primal poly
-    dual_verts.resize(primal.num_polys());
-    for(uint pid=0; pid<primal.num_polys(); ++pid)
+    dual_verts.resize(np);
+    PARALLEL_FOR(0, np, 1000, [&](const uint pid)
     {
-        vec3d c;
         if(primal.poly_is_tetrahedron(pid))
         {
             // if the primal mesh is Delaunay, this will ensure that dual faces are planar
-            c = tetrahedron_circumcenter(primal.poly_vert(pid,0),
-                                         primal.poly_vert(pid,1),
-                                         primal.poly_vert(pid,2),
-                                         primal.poly_vert(pid,3));
+            dual_verts.at(pid) = tetrahedron_circumcenter(primal.poly_vert(pid,0),
+                                                          primal.poly_vert(pid,1),
+                                                          primal.poly_vert(pid,2),
+                                                          primal.poly_vert(pid,3));
         }
         else
         {
-            c = primal.poly_centroid(pid);
+            dual_verts.at(pid) = primal.poly_centroid(pid);
         }
-        dual_verts.at(pid) = c;
-    }
+    });
 
-    // vertex maps for clipped dual cells
-    std::vector<bool> crease_corner(primal.num_verts(),false);
-    std::unordered_map<uint,uint> pv2dv; // primal vert to dual vert : for crease corners
-    std::unordered_map<uint,uint> pe2dv; // primal edge to dual vert : for crease lines
-    std::unordered_map<uint,uint> pf2dv; // primal face to dual vert : for surface faces
-    // verts
-    for(uint vid=0; vid<primal.num_verts(); ++vid)
+    // vertex maps for clipped dual cells (-1 if there is no dual vertex). Elements
+    // are flagged in parallel, and numbered afterwards in order of primal id
+    std::vector<int> pv2dv(nv,-1); // primal vert to dual vert : for crease corners
+    std::vector<int> pe2dv(ne,-1); // primal edge to dual vert : for crease lines
+    std::vector<int> pf2dv(nf,-1); // primal face to dual vert : for surface faces
+    PARALLEL_FOR(0, nv, 1000, [&](const uint vid)
     {
-        if(!primal.vert_is_on_srf(vid)) continue;
+        if(!primal.vert_is_on_srf(vid)) return;
         uint n_creases = 0;
         for(uint eid : primal.vert_adj_srf_edges(vid))
         {
             if(primal.edge_data(eid).flags[CREASE]) ++n_creases;
         }
-        if(n_creases> 2)
+        if(n_creases>2) pv2dv.at(vid) = 0;
+    });
+    PARALLEL_FOR(0, ne, 1000, [&](const uint eid)
+    {
+        if(primal.edge_is_on_srf(eid) && primal.edge_data(eid).flags[CREASE]) pe2dv.at(eid) = 0;
+    });
+    PARALLEL_FOR(0, nf, 1000, [&](const uint fid)
+    {
+        if(primal.face_is_on_srf(fid)) pf2dv.at(fid) = 0;
+    });
+    uint n_dual_verts = np;
+    for(int & id : pv2dv) if(id==0) id = int(n_dual_verts++);
+    for(int & id : pe2dv) if(id==0) id = int(n_dual_verts++);
+    for(int & id : pf2dv) if(id==0) id = int(n_dual_verts++);
+    dual_verts.resize(n_dual_verts);
+    PARALLEL_FOR(0, nv, 1000, [&](const uint vid) { if(pv2dv.at(vid)>=0) dual_verts.at(pv2dv.at(vid)) = primal.vert(vid);              });
+    PARALLEL_FOR(0, ne, 1000, [&](const uint eid) { if(pe2dv.at(eid)>=0) dual_verts.at(pe2dv.at(eid)) = primal.edge_sample_at(eid,0.5); });
+    PARALLEL_FOR(0, nf, 1000, [&](const uint fid) { if(pf2dv.at(fid)>=0) dual_verts.at(pf2dv.at(fid)) = primal.face_centroid(fid);    });
+
+    // dual faces are of two kinds: one for each primal edge (shared by the cells of its
+    // endpoints), and the ones that clip the cells of surface vertices (one for each
+    // surface patch delimited by creases). Their ids are known in advance, hence they
+    // can all be generated independently
+    auto keep_cell = [&](const uint vid)
+    {
+        return with_clipped_cells || !primal.vert_is_on_srf(vid);
+    };
+    std::vector<int> e2df(ne,-1);
+    PARALLEL_FOR(0, ne, 1000, [&](const uint eid)
+    {
+        if(primal.adj_e2p(eid).empty()) return;
+        if(keep_cell(primal.edge_vert_id(eid,0)) || keep_cell(primal.edge_vert_id(eid,1))) e2df.at(eid) = 0;
+    });
+    uint n_edge_faces = 0;
+    for(int & id : e2df) if(id==0) id = int(n_edge_faces++);
+
+    std::vector<uint> v2df(nv+1,0); // offsets of the clipped faces of each vertex
+    PARALLEL_FOR(0, nv, 1000, [&](const uint vid)
+    {
+        if(!with_clipped_cells || !primal.vert_is_on_srf(vid)) return;
+        uint n_creases = 0;
+        for(uint eid : primal.vert_adj_srf_edges(vid))
         {
-            crease_corner.at(vid) = true;
-            pv2dv[vid] = uint(dual_verts.size());
-            dual_verts.push_back(primal.vert(vid));
+            if(primal.edge_data(eid).flags[CREASE]) ++n_creases;
         }
-    }
-    // edges
-    for(uint eid=0; eid<primal.num_edges(); ++eid)
+        v2df.at(vid+1) = std::max(n_creases, 1u);
+    });
+    v2df.front() = n_edge_faces;
+    for(uint vid=0; vid<nv; ++vid) v2df.at(vid+1) += v2df.at(vid);
+    dual_faces.resize(v2df.back());
+
+    // build the faces for the interior part, oriented CCW around the primal edge
+    std::vector<uint> e_ccw(ne,0); // not std::vector<bool>, which cannot be written concurrently
+    PARALLEL_FOR(0, ne, 1000, [&](const uint eid)
     {
-        if(primal.edge_is_on_srf(eid) && primal.edge_data(eid).flags[CREASE])
+        if(e2df.at(eid)<0) return;
+        std::vector<uint> face = primal.edge_ordered_poly_ring(eid);
+        bool ccw = true;
+        if(face.size()>1)
         {
-            pe2dv[eid] = uint(dual_verts.size());
-            dual_verts.push_back(primal.edge_sample_at(eid, 0.5));
+            // walk from the first to the second poly of the ring
+            int fid = -1;
+            for(uint f : primal.adj_e2f(eid))
+            {
+                if(primal.poly_contains_face(face.at(0),f) && primal.poly_contains_face(face.at(1),f)) fid = int(f);
+            }
+            assert(fid>=0);
+            ccw = dual_face_is_CCW(primal, face.at(0), uint(fid), eid);
         }
-    }
-    // faces
-    for(uint fid=0; fid<primal.num_faces(); ++fid)
-    {
-        if(primal.face_is_on_srf(fid))
+        // for surface edges, add the centroid of the two faces incident at it, in the right order
+        if(primal.edge_is_on_srf(eid))
         {
-            pf2dv[fid] = uint(dual_verts.size());
-            dual_verts.push_back(primal.face_centroid(fid));
+            assert(primal.edge_adj_srf_faces(eid).size() == 2);
+            uint srf_beg = primal.edge_adj_srf_faces(eid).front();
+            uint srf_end = primal.edge_adj_srf_faces(eid).back();
+            uint p_beg = face.front();
+            if(!primal.poly_contains_face(p_beg, srf_beg)) std::swap(srf_beg, srf_end);
+            assert(primal.poly_contains_face(p_beg, srf_beg));
+            assert(primal.poly_contains_face(face.back(), srf_end));
+            // the ring enters the first poly from outside, through srf_beg
+            if(face.size()==1) ccw = !dual_face_is_CCW(primal, p_beg, srf_beg, eid);
+            face.push_back(pf2dv.at(srf_end));
+            if(primal.edge_data(eid).flags[CREASE])
+            {
+                face.push_back(pe2dv.at(eid));
+            }
+            face.push_back(pf2dv.at(srf_beg));
         }
-    }
+        assert(face.size()>2);
+        dual_faces.at(e2df.at(eid)) = face;
+        e_ccw.at(eid) = ccw;
+    });
 
-    // build polyhedral cells
-    std::map<std::vector<uint>,uint> f_map;
-    for(uint vid=0; vid<primal.num_verts(); ++vid)
+    // build faces for the clipped part, oriented CCW w.r.t. the outer surface
+    std::vector<uint> v_ccw(nv,0);
+    PARALLEL_FOR(0, nv, 1000, [&](const uint vid)
     {
-        bool clipped = primal.vert_is_on_srf(vid);
-        if(clipped && !with_clipped_cells) continue;
+        if(v2df.at(vid)==v2df.at(vid+1)) return;
 
-        std::vector<std::vector<uint>> faces;
+        std::vector<uint> v_ring; // sorted list of adjacent surfaces vertices
+        std::vector<uint> e_star; // sorted list of surface edges incident to vid
+        std::vector<uint> f_ring; // sorted list of adjacent surface faces
+        primal.vert_ordered_srf_one_ring(vid, v_ring, e_star, f_ring, true);
 
-        // build the faces for the interior part
-        for(uint eid : primal.adj_v2e(vid))
+        // the ring goes from e_star[0] to e_star[1] through f_ring[0]. It is CCW w.r.t.
+        // the surface normal if f_ring[0], oriented outward, traverses e_star[0] from vid
+        uint f0 = f_ring.front();
+        uint v0 = primal.vert_opposite_to(e_star.front(), vid);
+        v_ccw.at(vid) = (primal.face_verts_are_CCW(f0,v0,vid) == primal.poly_face_is_CCW(primal.adj_f2p(f0).front(),f0));
+
+        // make sure you start tracing the face from a crease (if any)
+        for(uint i=0; i<e_star.size(); ++i)
         {
-            std::vector<uint> face = primal.edge_ordered_poly_ring(eid);
-            // for surface edges, add the centroid of the two faces incident at it, in the right order
-            if(primal.edge_is_on_srf(eid))
+            if(primal.edge_data(e_star.at(i)).flags[CREASE])
             {
-                assert(primal.edge_adj_srf_faces(eid).size() == 2);
-                uint srf_beg = primal.edge_adj_srf_faces(eid).front();
-                uint srf_end = primal.edge_adj_srf_faces(eid).back();
-                uint p_beg = face.front();
-                uint p_end = face.back();
-                if(!primal.poly_contains_face(p_beg, srf_beg)) std::swap(srf_beg, srf_end);
-                assert(primal.poly_contains_face(p_beg, srf_beg));
-                assert(primal.poly_contains_face(p_end, srf_end));
-                face.push_back(pf2dv.at(srf_end));
-                if(primal.edge_data(eid).flags[CREASE])
-                {
-                    face.push_back(pe2dv.at(eid));
-                }
-                face.push_back(pf2dv.at(srf_beg));
+                if(i==0) break;
+                std::rotate(e_star.begin(), e_star.begin()+i, e_star.end());
+                std::rotate(f_ring.begin(), f_ring.begin()+i, f_ring.end());
+                break;
             }
-            faces.push_back(face);
         }
 
-        // build faces for the clipped part
-        if(clipped)
+        // rotate around the ring, and close a face, splitting each time you hit a crease edge
+        int  corner = pv2dv.at(vid);
+        uint fid    = v2df.at(vid);
+        auto e_it   = e_star.begin();
+        auto f_it   = f_ring.begin();
+        do
         {
-            std::vector<uint> v_ring; // sorted list of adjacent surfaces vertices
-            std::vector<uint> e_star; // sorted list of surface edges incident to vid
-            std::vector<uint> f_ring; // sorted list of adjacent surface faces
-            primal.vert_ordered_srf_one_ring(vid, v_ring, e_star, f_ring, true);
+            std::vector<uint> new_face;
 
-            // make sure you start tracing the face from a crease (if any)
-            for(uint i=0; i<e_star.size(); ++i)
-            {
-                if(primal.edge_data(e_star.at(i)).flags[CREASE])
-                {
-                    if(i==0) break;
-                    std::rotate(e_star.begin(), e_star.begin()+i, e_star.end());
-                    std::rotate(f_ring.begin(), f_ring.begin()+i, f_ring.end());
-                    break;
-                }
-            }
+            // if vid is a feature corner, add it to the dual
+            if(corner>=0) new_face.push_back(corner);
+
+            // if the face starts from a crease, add a vertex for primal edge
+            if(primal.edge_data(*e_it).flags[CREASE]) new_face.push_back(pe2dv.at(*e_it));
 
-            // rotate around the ring, and close a face, splitting each time you hit a crease edge
-            int  corner = (crease_corner.at(vid)) ? pv2dv.at(vid) : -1;
-            auto e_it   = e_star.begin();
-            auto f_it   = f_ring.begin();
             do
             {
-                std::vector<uint> new_face;
-
-                // if vid is a feature corner, add it to the dual
-                if(corner>=0) new_face.push_back(corner);
-
-                // if the face starts from a crease, add a vertex for primal edge
-                if(primal.edge_data(*e_it).flags[CREASE]) new_face.push_back(pe2dv.at(*e_it));
-
-                do
-                {
-                    new_face.push_back(pf2dv.at(*f_it));
-                    ++e_it;
-                    ++f_it;
-                }
-                while(e_it!=e_star.end() && !primal.edge_data(*e_it).flags[CREASE]);
-
-                // if the previous loop stopped at a crease, add a vertex for primal edge
-                if(e_it!=e_star.end())
-                {
-                    new_face.push_back(pe2dv.at(*e_it));
-                }
-                else if(primal.edge_data(*e_star.begin()).flags[CREASE])
-                {
-                    new_face.push_back(pe2dv.at(*e_star.begin()));
-                    // happens when only one crease edge is incident to the vertex
-                    if(new_face.front()==new_face.back()) new_face.pop_back();
-                }
-
-                faces.push_back(new_face);
+                new_face.push_back(pf2dv.at(*f_it));
+                ++e_it;
+                ++f_it;
             }
-            while(e_it!=e_star.end());
-        }
+            while(e_it!=e_star.end() && !primal.edge_data(*e_it).flags[CREASE]);
 
-        // build the cell
-        std::vector<uint> poly;
-        std::vector<bool> poly_winding;
-        for(const auto & face : faces)
-        {
-            auto key = face;
-            SORT_VEC(key);
-            auto query = f_map.find(key);
-            if(query == f_map.end())
+            // if the previous loop stopped at a crease, add a vertex for primal edge
+            if(e_it!=e_star.end())
             {
-                uint fresh_id = uint(dual_faces.size());
-                f_map[key] = fresh_id;
-                dual_faces.push_back(face);
-                poly.push_back(fresh_id);
-                poly_winding.push_back(true);
+                new_face.push_back(pe2dv.at(*e_it));
             }
-            else
+            else if(primal.edge_data(*e_star.begin()).flags[CREASE])
             {
-                poly.push_back(query->second);
-                poly_winding.push_back(false);
+                new_face.push_back(pe2dv.at(*e_star.begin()));
+                // happens when only one crease edge is incident to the vertex
+                if(new_face.front()==new_face.back()) new_face.pop_back();
             }
+
+            dual_faces.at(fid++) = new_face;
         }
-        // this may happen if the mesh contains dangling vertices
-        if(!poly.empty())
+        while(e_it!=e_star.end());
+        assert(fid==v2df.at(vid+1));
+    });
+
+    // build the cells. Empty cells may happen if the mesh contains dangling vertices
+    std::vector<int> v2dp(nv,-1);
+    PARALLEL_FOR(0, nv, 1000, [&](const uint vid)
+    {
+        if(!keep_cell(vid)) return;
+        bool empty = (v2df.at(vid)==v2df.at(vid+1));
+        for(uint eid : primal.adj_v2e(vid)) if(e2df.at(eid)>=0) empty = false;
+        if(!empty) v2dp.at(vid) = 0;
+    });
+    uint n_dual_polys = 0;
+    for(int & id : v2dp) if(id==0) id = int(n_dual_polys++);
+    dual_polys.resize(n_dual_polys);
+    dual_polys_winding.resize(n_dual_polys);
+    PARALLEL_FOR(0, nv, 1000, [&](const uint vid)
+    {
+        if(v2dp.at(vid)<0) return;
+        std::vector<uint> & poly         = dual_polys.at(v2dp.at(vid));
+        std::vector<bool> & poly_winding = dual_polys_winding.at(v2dp.at(vid));
+        for(uint eid : primal.adj_v2e(vid))
         {
-            dual_polys.push_back(poly);
-            dual_polys_winding.push_back(poly_winding);
+            if(e2df.at(eid)<0) continue;
+            // edge faces point towards the second vertex of the primal edge if CCW
+            poly.push_back(e2df.at(eid));
+            poly_winding.push_back((e_ccw.at(eid)!=0) == (primal.edge_vert_id(eid,0)==vid));
         }
-    }
+        for(uint fid=v2df.at(vid); fid<v2df.at(vid+1); ++fid)
+        {
+            poly.push_back(fid);
+            poly_winding.push_back(v_ccw.at(vid)!=0);
+        }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -284,44 +353,49 @@ void dual_mesh(const AbstractPolygonMesh<M,V,E,P>   & primal,
     dual_verts.clear();
     dual_polys.clear();
 
+    uint nv = primal.num_verts();
+    uint ne = primal.num_edges();
+    uint np = primal.num_polys();
+
     // Initialize vertices with face centroids
-    dual_verts.resize(primal.num_polys());
-    for(uint pid=0; pid<primal.num_polys(); ++pid)
+    dual_verts.resize(np);
+    PARALLEL_FOR(0, np, 1000, [&](const uint pid)
     {
         dual_verts.at(pid) = primal.poly_centroid(pid);
-    }
+    });
 
     // For clipped dual cells: add boundary vertices
-    // and boundary edges midpoints
+    // and boundary edges midpoints (-1 if there is
+    // no dual vertex)
     //
-    std::map<uint,uint> e2verts;
-    std::map<uint,uint> v2verts;
-    for(uint vid=0; vid<primal.num_verts(); ++vid)
-    {
-        if(primal.vert_is_boundary(vid))
-        {
-            v2verts[vid] = uint(dual_verts.size());
-            dual_verts.push_back(primal.vert(vid));
-        }
-    }
-    for(uint eid=0; eid<primal.num_edges(); ++eid)
-    {
-        if(primal.edge_is_boundary(eid))
-        {
-            e2verts[eid] = uint(dual_verts.size());
-            dual_verts.push_back(primal.edge_sample_at(eid, 0.5));
-        }
-    }
+    std::vector<int> e2verts(ne,-1);
+    std::vector<int> v2verts(nv,-1);
+    PARALLEL_FOR(0, nv, 1000, [&](const uint vid) { if(primal.vert_is_boundary(vid)) v2verts.at(vid) = 0; });
+    PARALLEL_FOR(0, ne, 1000, [&](const uint eid) { if(primal.edge_is_boundary(eid)) e2verts.at(eid) = 0; });
+    uint n_dual_verts = np;
+    for(int & id : v2verts) if(id==0) id = int(n_dual_verts++);
+    for(int & id : e2verts) if(id==0) id = int(n_dual_verts++);
+    dual_verts.resize(n_dual_verts);
+    PARALLEL_FOR(0, nv, 1000, [&](const uint vid) { if(v2verts.at(vid)>=0) dual_verts.at(v2verts.at(vid)) = primal.vert(vid);              });
+    PARALLEL_FOR(0, ne, 1000, [&](const uint eid) { if(e2verts.at(eid)>=0) dual_verts.at(e2verts.at(eid)) = primal.edge_sample_at(eid,0.5); });
 
     // Make dual polygonal cells
-    for(uint vid=0; vid<primal.num_verts(); ++vid)
+    std::vector<int> v2poly(nv,-1);
+    uint n_dual_polys = 0;
+    for(uint vid=0; vid<nv; ++vid)
     {
-        bool clipped_cell = primal.vert_is_boundary(vid);
+        bool clipped_cell = (v2verts.at(vid)>=0);
         if (clipped_cell && !with_clipped_cells) continue;
+        v2poly.at(vid) = int(n_dual_polys++);
+    }
+    dual_polys.resize(n_dual_polys);
+    PARALLEL_FOR(0, nv, 1000, [&](const uint vid)
+    {
+        if(v2poly.at(vid)<0) return;
 
         std::vector<uint> poly = primal.vert_ordered_polys_star(vid);
 
-        if (clipped_cell) // add boundary portion (vertex vid + boundary edges' midpoints)
+        if (v2verts.at(vid)>=0) // add boundary portion (vertex vid + boundary edges' midpoints)
         {
             std::vector<uint> e_star = primal.vert_ordered_edges_star(vid);
             poly.push_back(e2verts.at(e_star.back()));
@@ -329,9 +403,8 @@ void dual_mesh(const AbstractPolygonMesh<M,V,E,P>   & primal,
             poly.push_back(e2verts.at(e_star.front()));
         }
 
-        dual_polys.push_back(poly);
-    }
+        dual_polys.at(v2poly.at(vid)) = poly;
+    });
 }
 
 }
-
@@ -37,6 +37,8 @@
 #include <cinolib/meshes/trimesh.h>
 #include <cinolib/meshes/quadmesh.h>
 #include <cinolib/meshes/polygonmesh.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/profiler_zones.h>
 
 namespace cinolib
 {
@@ -60,53 +62,93 @@ void export_surface(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
                           std::unordered_map<uint,uint>     & m2srf_vmap,
                           std::unordered_map<uint,uint>     & srf2m_vmap)
 {
+    std::vector<int>  m2srf;
+    std::vector<uint> srf2m;
+    export_surface(m, srf, m2srf, srf2m);
+
     m2srf_vmap.clear();
     srf2m_vmap.clear();
+    m2srf_vmap.reserve(srf2m.size());
+    srf2m_vmap.reserve(srf2m.size());
+    for(uint vsrf=0; vsrf<srf2m.size(); ++vsrf)
+    {
+        m2srf_vmap[srf2m.at(vsrf)] = vsrf;
+        srf2m_vmap[vsrf] = srf2m.at(vsrf);
+    }
+}
 
-    std::vector<vec3d>             verts;
-    std::vector<std::vector<uint>> polys;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    uint fresh_id = 0;
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void export_surface(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                          AbstractPolygonMesh<M,V,E,F>      & srf,
+                          std::vector<int>                  & m2srf_vmap,
+                          std::vector<uint>                 & srf2m_vmap)
+{
+    CINO_PROFILE_ZONE("export_surface");
 
+    // flag surface faces and vertices
+    std::vector<uint> f_offset(m.num_faces()+1, 0);
+    PARALLEL_FOR(0, m.num_faces(), 1000, [&](const uint fid)
+    {
+        f_offset.at(fid+1) = (m.face_is_on_srf(fid)) ? 1 : 0;
+    });
+    m2srf_vmap.assign(m.num_verts(), 0);
     for(uint fid=0; fid<m.num_faces(); ++fid)
     {
-        if (m.face_is_on_srf(fid))
-        {
-            std::vector<uint> p;
-            for(uint off=0; off<m.verts_per_face(fid); ++off)
-            {
-                uint vid   = m.face_vert_id(fid,off);
-                uint vsrf  = fresh_id++;
-
-                auto query = m2srf_vmap.find(vid);
-                if (query == m2srf_vmap.end())
-                {
-                    verts.push_back(m.vert(vid));
+        if(f_offset.at(fid+1)==0) continue;
+        for(uint vid : m.adj_f2v(fid)) m2srf_vmap.at(vid) = 1;
+    }
 
-                    m2srf_vmap[vid] = vsrf;
-                    srf2m_vmap[vsrf] = vid;
-                }
-                else
-                {
-                    vsrf = query->second;
-                    --fresh_id;
-                }
+    // prefix sums: position of each surface face/vertex in the output mesh
+    for(uint fid=0; fid<m.num_faces(); ++fid) f_offset.at(fid+1) += f_offset.at(fid);
+    uint nv = 0;
+    for(uint vid=0; vid<m.num_verts(); ++vid) m2srf_vmap.at(vid) = (m2srf_vmap.at(vid)==1) ? int(nv++) : -1;
 
-                p.push_back(vsrf);
-            }
-            polys.push_back(p);
+    // fill output arrays
+    std::vector<vec3d>             verts(nv);
+    std::vector<std::vector<uint>> polys(f_offset.back());
+    srf2m_vmap.resize(nv);
+    PARALLEL_FOR(0, m.num_verts(), 1000, [&](const uint vid)
+    {
+        int vsrf = m2srf_vmap.at(vid);
+        if(vsrf<0) return;
+        verts.at(vsrf)      = m.vert(vid);
+        srf2m_vmap.at(vsrf) = vid;
+    });
+    PARALLEL_FOR(0, m.num_faces(), 1000, [&](const uint fid)
+    {
+        if(f_offset.at(fid)==f_offset.at(fid+1)) return; // not on the surface
+        std::vector<uint> & p = polys.at(f_offset.at(fid));
+        p.resize(m.verts_per_face(fid));
+        for(uint off=0; off<p.size(); ++off)
+        {
+            p.at(off) = uint(m2srf_vmap.at(m.face_vert_id(fid,off)));
         }
-    }
+    });
 
-    switch (m.mesh_type())
-    {
-        case TETMESH        : srf = Trimesh<M,V,E,F>(verts, polys);     break;
-        case HEXMESH        : srf = Quadmesh<M,V,E,F>(verts, polys);    break;
-        case POLYHEDRALMESH : srf = Polygonmesh<M,V,E,F>(verts, polys); break;
-        default             : assert(false);
-    }
+    // build the surface in place (output type is the one of srf)
+    srf.clear();
+    srf.init_bulk(verts, polys);
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void export_surface_positions(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                    AbstractPolygonMesh<M,V,E,F>      & srf,
+                              const std::vector<uint>                 & srf2m_vmap)
+{
+    CINO_PROFILE_ZONE("export_surface_positions");
+    assert(srf.num_verts()==srf2m_vmap.size());
+    PARALLEL_FOR(0, srf.num_verts(), 1000, [&](const uint vid)
+    {
+        srf.vert(vid) = m.vert(srf2m_vmap.at(vid));
+    });
+    if(srf.mesh_data().update_bbox)    srf.update_bbox();
+    if(srf.mesh_data().update_normals) srf.update_normals();
 }
 
+}
@@ -60,6 +60,31 @@ void export_surface(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
                           std::unordered_map<uint,uint>     & m2srf_vmap,
                           std::unordered_map<uint,uint>     & srf2m_vmap);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same as above, but with dense vertex maps: m2srf_vmap has one entry per vertex
+// in m (-1 for vertices not on the surface), srf2m_vmap has one entry per vertex
+// in srf. Surface faces are detected and converted in parallel, and surface
+// vertices are numbered in the same order they have in m. This is the fastest
+// way to export the surface of large volume meshes
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void export_surface(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                          AbstractPolygonMesh<M,V,E,F>      & srf,
+                          std::vector<int>                  & m2srf_vmap,
+                          std::vector<uint>                 & srf2m_vmap);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// updates the vertex positions of a surface previously exported with export_surface,
+// without rebuilding it. Use it when the geometry of m changes but its connectivity
+// does not (e.g. inside an optimization loop). Normals and bounding box are updated too
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void export_surface_positions(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                    AbstractPolygonMesh<M,V,E,F>      & srf,
+                              const std::vector<uint>                 & srf2m_vmap);
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -0,0 +1,121 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/feature_projector.h>
+#include <cinolib/parallel_for.h>
+
+namespace cinolib
+{
+
+CINO_INLINE
+bool FeatureProjector::has_creases() const
+{
+    return !o[PROJ_CREASE].items.empty();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool FeatureProjector::has_corners() const
+{
+    return !o[PROJ_CORNER].items.empty();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void FeatureProjector::closest_point(const int type, const vec3d & p, uint & id, vec3d & pos, double & dist) const
+{
+    assert(type>=PROJ_SURFACE && type<=PROJ_CORNER);
+    o[type].closest_point(p, id, pos, dist);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+vec3d FeatureProjector::closest_point(const int type, const vec3d & p) const
+{
+    assert(type>=PROJ_SURFACE && type<=PROJ_CORNER);
+    return o[type].closest_point(p);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void FeatureProjector::closest_points(const std::vector<vec3d>  & p,
+                                      const std::vector<int>    & types,
+                                            std::vector<vec3d>  & pos,
+                                            std::vector<uint>   & ids,
+                                            std::vector<double> & dist) const
+{
+    assert(p.size()==types.size());
+    pos.resize(p.size());
+    ids.resize(p.size());
+    dist.resize(p.size());
+
+    PARALLEL_FOR(0, p.size(), 1000, [&](const uint i)
+    {
+        if(types.at(i)==PROJ_NONE)
+        {
+            pos.at(i)  = p.at(i);
+            ids.at(i)  = 0;
+            dist.at(i) = 0.0;
+        }
+        else closest_point(types.at(i), p.at(i), ids.at(i), pos.at(i), dist.at(i));
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void FeatureProjector::closest_points(const std::vector<vec3d>  & p,
+                                      const std::vector<int>    & types,
+                                            std::vector<vec3d>  & pos) const
+{
+    std::vector<uint>   ids;
+    std::vector<double> dist;
+    closest_points(p, types, pos, ids, dist);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+const Octree & FeatureProjector::octree(const int type) const
+{
+    assert(type>=PROJ_SURFACE && type<=PROJ_CORNER);
+    return o[type];
+}
+
+}
@@ -0,0 +1,142 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_FEATURE_PROJECTOR_H
+#define CINO_FEATURE_PROJECTOR_H
+
+#include <cinolib/octree.h>
+
+namespace cinolib
+{
+
+/* Feature aware projection onto a target surface. Target elements are grouped in 3 categories,
+ * each one indexed by its own spatial data structure:
+ *
+ *  - SURFACE: all the polygons of the target mesh
+ *  - CREASE : edges flagged as sharp features (with a user defined flag, e.g. MARKED or CREASE)
+ *  - CORNER : vertices where feature lines meet or terminate (i.e. incident to a number
+ *             of feature edges other than 0 or 2)
+ *
+ * Queries are typed, so that surface points map to the surface, feature lines to feature
+ * lines, and corners to corners. Batched queries process all points in parallel, and are
+ * the preferred way to reproject a whole mesh (see e.g. cinolib/smoother.h and
+ * cinolib/grid_projector.h)
+*/
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+enum
+{
+    PROJ_SURFACE = 0,
+    PROJ_CREASE  = 1,
+    PROJ_CORNER  = 2,
+    PROJ_NONE    = 3, // batched queries leave these points where they are
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class FeatureProjector
+{
+    public:
+
+        template<class M, class V, class E, class P>
+        explicit FeatureProjector(const AbstractPolygonMesh<M,V,E,P> & target,
+                                  const int                            feature_flag = MARKED)
+        {
+            for(uint eid=0; eid<target.num_edges(); ++eid)
+            {
+                if(target.edge_data(eid).flags[feature_flag])
+                {
+                    o[PROJ_CREASE].push_segment(eid, target.edge_vert(eid,0), target.edge_vert(eid,1));
+                }
+            }
+            for(uint vid=0; vid<target.num_verts(); ++vid)
+            {
+                uint count = 0;
+                for(uint eid : target.adj_v2e(vid))
+                {
+                    if(target.edge_data(eid).flags[feature_flag]) ++count;
+                }
+                if(count>0 && count!=2)
+                {
+                    o[PROJ_CORNER].push_point(vid, target.vert(vid));
+                }
+            }
+            o[PROJ_SURFACE].build_from_mesh_polys(target);
+            o[PROJ_CREASE].build();
+            o[PROJ_CORNER].build();
+        }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool has_creases() const;
+        bool has_corners() const;
+
+        // QUERIES :::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // returns pos, id and distance of the closest item of a given type (PROJ_SURFACE,
+        // PROJ_CREASE or PROJ_CORNER). Ids are poly, edge and vertex ids of the target mesh
+        void  closest_point(const int type, const vec3d & p, uint & id, vec3d & pos, double & dist) const;
+        vec3d closest_point(const int type, const vec3d & p) const;
+
+        // batched version of the query above. Points are processed in parallel, and
+        // each point is projected onto the items of type types[i]. Points of type
+        // PROJ_NONE are copied as they are, with zero distance
+        void closest_points(const std::vector<vec3d>  & p,
+                            const std::vector<int>    & types,
+                                  std::vector<vec3d>  & pos,
+                                  std::vector<uint>   & ids,
+                                  std::vector<double> & dist) const;
+
+        void closest_points(const std::vector<vec3d>  & p,
+                            const std::vector<int>    & types,
+                                  std::vector<vec3d>  & pos) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        const Octree & octree(const int type) const;
+
+    protected:
+
+        Octree o[3]; // one per type (surface, creases, corners)
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "feature_projector.cpp"
+#endif
+
+#endif // CINO_FEATURE_PROJECTOR_H
@@ -480,7 +480,7 @@ void SurfaceMeshControls<Mesh>::header_debug(const bool open)
                 {
                     if(m->vert_is_visible(vid))
                     {
-                        vec3d n = m->vert_data(vid).normal;
+                        vec3d n = m->vert_normal(vid);
                         vec3d p = m->vert(vid);
                         vert_normals.push_seg(p, p+(n*l));
                     }
@@ -504,7 +504,7 @@ void SurfaceMeshControls<Mesh>::header_debug(const bool open)
                 {
                     if(!m->poly_data(pid).flags[HIDDEN])
                     {
-                        vec3d n = m->poly_data(pid).normal;
+                        vec3d n = m->poly_normal(pid);
                         vec3d c = m->poly_centroid(pid);
                         poly_normals.push_seg(c, c+(n*l));
                     }
@@ -710,7 +710,7 @@ void VolumeMeshControls<Mesh>::header_debug(const bool open)
                 {
                     if(m->vert_is_visible(vid))
                     {
-                        vec3d n = m->vert_data(vid).normal;
+                        vec3d n = m->vert_normal(vid);
                         vec3d p = m->vert(vid);
                         vert_normals.push_seg(p, p+(n*l));
                     }
@@ -62,7 +62,7 @@ Eigen::SparseMatrix<double> gradient_matrix(const AbstractPolygonMesh<M,V,E,P> &
         for(uint pid=0; pid<m.num_polys(); ++pid)
         {
             double area = std::max(m.poly_area(pid), 1e-5) * 2.0; // (2 is the average term : two verts for each edge)
-            vec3d n     = m.poly_data(pid).normal;
+            vec3d n     = m.poly_normal(pid);
 
             for(uint off=0; off<m.verts_per_poly(pid); ++off)
             {
@@ -99,7 +99,7 @@ Eigen::SparseMatrix<double> gradient_matrix(const AbstractPolygonMesh<M,V,E,P> &
             for(uint pid : m.adj_v2p(vid))
             {
                 area   += std::max(m.poly_area(pid), 1e-5) * 2.0;
-                vec3d n = m.poly_data(pid).normal;
+                vec3d n = m.poly_normal(pid);
 
                 for(uint off=0; off<m.verts_per_poly(pid); ++off)
                 {
@@ -34,7 +34,8 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/grid_projector.h>
-#include <cinolib/octree.h>
+#include <cinolib/feature_projector.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -54,34 +55,8 @@ double grid_projector(      Hexmesh<M1,V1,E1,F1,P1> & m,
     };
     std::vector<Proj> targets;
 
-    // prepare octrees for projection
-    Octree o_srf;
-    Octree o_corners;
-    Octree o_lines;
-    for(uint vid=0; vid<srf.num_verts(); ++vid)
-    {
-        uint count = 0;
-        for(uint eid : srf.adj_v2e(vid))
-        {
-            if(srf.edge_data(eid).flags[CREASE]) ++count;
-        }
-        switch(count)
-        {
-            case 0  : break;
-            case 2  : break;
-            default : o_corners.push_point(vid, srf.vert(vid));
-        }
-    }
-    for(uint eid=0; eid<srf.num_edges(); ++eid)
-    {
-        if(srf.edge_data(eid).flags[CREASE])
-        {
-            o_lines.push_segment(eid, srf.edge_vert(eid,0), srf.edge_vert(eid,1));
-        }
-    }
-    o_srf.build_from_mesh_polys(srf);
-    o_corners.build();
-    o_lines.build();
+    // prepare spatial index for projection (surface, feature lines and corners)
+    FeatureProjector proj(srf, CREASE);
 
     // lavel mesh elements to set the target octree for projection
     enum { CORNER, LINE, REGULAR };
@@ -103,20 +78,35 @@ double grid_projector(      Hexmesh<M1,V1,E1,F1,P1> & m,
         }
     }
 
+    // type of projection for each vertex (interior vertices are not projected)
+    std::vector<int> proj_type(m.num_verts());
+    for(uint vid=0; vid<m.num_verts(); ++vid)
+    {
+        switch(m.vert_data(vid).label)
+        {
+            case REGULAR : proj_type.at(vid) = (m.vert_is_on_srf(vid)) ? PROJ_SURFACE : PROJ_NONE; break;
+            case CORNER  : proj_type.at(vid) = PROJ_CORNER; break;
+            case LINE    : proj_type.at(vid) = PROJ_CREASE; break;
+        }
+    }
+
     //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
     //:::::::::::::::::::::::::   LAMBDA UTILITIES   :::::::::::::::::::::::::
     //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
     // for each surface point, find the closest point on srf
+    std::vector<vec3d> verts, tmp, proj_pos; // buffers reused across iterations
     auto update_targets = [&](const uint smooth_iters, const bool sort_by_dist)
     {
-        // pre smooth the surface
-        std::vector<vec3d> verts = m.vector_verts();
+        // pre smooth the surface (reading from verts and writing into tmp, so that the
+        // result does not depend on the order in which threads process the vertices)
+        verts = m.vector_verts();
+        tmp.resize(verts.size());
         for(uint i=0; i<smooth_iters; ++i)
         {
             PARALLEL_FOR(0, m.num_verts(), 1000,[&](const uint vid)
             {
-                vec3d p;
+                vec3d p(0,0,0);
                 if(m.vert_is_on_srf(vid))
                 {
                     for(uint nbr : m.vert_adj_srf_verts(vid)) p += verts.at(nbr);
@@ -133,23 +123,20 @@ double grid_projector(      Hexmesh<M1,V1,E1,F1,P1> & m,
                     }
                     p /= sum;
                 }
-                verts.at(vid) = p;
+                tmp.at(vid) = p;
             });
+            std::swap(verts, tmp);
         }
 
-        targets.clear();
+        proj.closest_points(verts, proj_type, proj_pos);
+
+        targets.resize(m.num_verts());
         for(uint vid=0; vid<m.num_verts(); ++vid)
         {
-            Proj proj;
-            proj.vid    = vid;
-            switch(m.vert_data(vid).label)
-            {
-                case REGULAR : proj.target = (m.vert_is_on_srf(vid)) ? o_srf.closest_point(verts.at(vid)) : verts.at(vid); break;
-                case CORNER  : proj.target = o_corners.closest_point(verts.at(vid)); break;
-                case LINE    : proj.target = o_lines.closest_point(verts.at(vid)); break;
-            }
-            proj.dist   = (m.vert_is_on_srf(vid)) ? 1/verts.at(vid).dist(proj.target) : -verts.at(vid).dist(proj.target);
-            targets.push_back(proj);
+            Proj & t = targets.at(vid);
+            t.vid    = vid;
+            t.target = proj_pos.at(vid);
+            t.dist   = (m.vert_is_on_srf(vid)) ? 1/verts.at(vid).dist(t.target) : -verts.at(vid).dist(t.target);
         }
 
         if(sort_by_dist)
@@ -39,6 +39,9 @@
 *********************************************************************************/
 #include <cinolib/hex_transition_install.h>
 #include <cinolib/hex_transition_orient.h>
+#include <cinolib/weld_points.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/meshes/id_hash_table.h>
 
 namespace cinolib
 {
@@ -797,65 +800,230 @@ void cut_flats(const Polyhedralmesh<M,V,E,F,P>     & m,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-template<class M, class V, class E, class F, class P>
-CINO_INLINE
-void merge_schemes_into_mesh(Polyhedralmesh<M,V,E,F,P>           & m,
-                             std::unordered_map<uint,SchemeInfo> & poly2scheme)
+// geometry and connectivity of a scheme, positioned in the grid
+struct SchemeMesh
 {
-    std::map<vec3d, uint, vert_compare> v_map;
-    std::map<uint, uint> f_map;
-    for(uint vid=0; vid<m.num_verts(); ++vid) v_map[m.vert(vid)] = vid;
+    std::vector<vec3d>             verts;
+    std::vector<std::vector<uint>> faces;
+    std::vector<std::vector<uint>> polys;
+    std::vector<std::vector<bool>> winding;
+};
 
-    for(const auto &p : poly2scheme)
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// signed volume of a poly (divergence theorem over a fan triangulation of its faces)
+template<class FaceVerts>
+CINO_INLINE
+double signed_volume(const std::vector<vec3d> & verts,
+                     const std::vector<uint>  & poly_faces,
+                     const std::vector<bool>  & poly_winding,
+                     const FaceVerts          & face_verts)
+{
+    double vol = 0;
+    for(uint i=0; i<poly_faces.size(); ++i)
     {
-        std::vector<vec3d>             verts;
-        std::vector<std::vector<uint>> faces;
-        std::vector<std::vector<uint>> polys;
-        std::vector<std::vector<bool>> winding;
+        const std::vector<uint> & f = face_verts(poly_faces.at(i));
+        const vec3d & o = verts.at(f.at(0));
+        for(uint j=2; j<f.size(); ++j)
+        {
+            double v = o.dot(verts.at(f.at(j-1)).cross(verts.at(f.at(j))));
+            vol += (poly_winding.at(i)) ? v : -v;
+        }
+    }
+    return vol/6.0;
+}
 
-        vec3d poly_centroid = m.poly_centroid(p.first);
-        SchemeInfo info = p.second;
-        hex_transition_orient(verts, faces, polys, winding, info, poly_centroid);
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        //merge vertices
-        for(auto & v : verts)
+/* Replaces the polys in poly2scheme with their transition schemes, in two phases:
+ *
+ *   1 - all schemes are instantiated in parallel, each one in its own buffers
+ *   2 - the verts of the grid and of all the schemes are welded in one go with a
+ *       spatial hash, coincident faces are merged, and the output mesh is built
+ *       in bulk from the polys of the grid that are kept and those of the schemes
+ *
+ * Schemes are positioned by reflections, hence their polys may come out inside out.
+ * Each scheme poly is oriented as the grid poly it replaces (i.e. with a signed volume
+ * of the same sign), so that the output is consistently oriented as long as the input
+ * grid is, and no global re-orientation is needed afterwards
+*/
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void merge_schemes_into_mesh(const Polyhedralmesh<M,V,E,F,P>           & m,
+                             const std::unordered_map<uint,SchemeInfo> & poly2scheme,
+                                   Polyhedralmesh<M,V,E,F,P>           & m_out)
+{
+    // phase 1: instantiate schemes. Polys are sorted to make the output deterministic
+    std::vector<uint> scheme_pids;
+    for(const auto & p : poly2scheme) scheme_pids.push_back(p.first);
+    std::sort(scheme_pids.begin(), scheme_pids.end());
+    uint n_schemes = uint(scheme_pids.size());
+
+    std::vector<SchemeMesh> schemes(n_schemes);
+    PARALLEL_FOR(0, n_schemes, 16, [&](const uint i)
+    {
+        uint         pid  = scheme_pids.at(i);
+        SchemeInfo   info = poly2scheme.at(pid); // orientation may query missing cuts (i.e. insert them)
+        SchemeMesh & s    = schemes.at(i);
+        hex_transition_orient(s.verts, s.faces, s.polys, s.winding, info, m.poly_centroid(pid));
+
+        bool grid_sign = signed_volume(m.vector_verts(), m.adj_p2f(pid), m.poly_faces_winding(pid),
+                                       [&](const uint fid) -> const std::vector<uint> & { return m.adj_f2v(fid); }) > 0;
+        for(uint j=0; j<s.polys.size(); ++j)
         {
-            if(v_map.find(v) == v_map.end())
+            bool sign = signed_volume(s.verts, s.polys.at(j), s.winding.at(j),
+                                      [&](const uint fid) -> const std::vector<uint> & { return s.faces.at(fid); }) > 0;
+            if(sign!=grid_sign) s.winding.at(j).flip();
+        }
+    });
+
+    // phase 2: weld verts. Grid verts come first, so that each cluster
+    // is represented by a grid vertex, if there is any
+    std::vector<uint> v_off(n_schemes+1, m.num_verts());
+    for(uint i=0; i<n_schemes; ++i) v_off.at(i+1) = v_off.at(i) + uint(schemes.at(i).verts.size());
+    std::vector<vec3d> points(v_off.back());
+    std::copy(m.vector_verts().begin(), m.vector_verts().end(), points.begin());
+    PARALLEL_FOR(0, n_schemes, 16, [&](const uint i)
+    {
+        std::copy(schemes.at(i).verts.begin(), schemes.at(i).verts.end(), points.begin()+v_off.at(i));
+    });
+    std::vector<uint> cluster;
+    uint n_clusters = weld_points(points, 1e-6, cluster);
+
+    // merge faces, indexing them by their vertex sets
+    std::vector<std::vector<uint>> faces;
+    std::vector<std::vector<uint>> polys;
+    std::vector<std::vector<bool>> winding;
+    IdHashTable f_index;
+    f_index.reserve(m.num_faces());
+    auto face_add = [&](const std::vector<uint> & f, bool & flipped) -> uint
+    {
+        uint64_t key = vert_set_key(f);
+        int fid = f_index.find(key, [&](const uint id)
+        {
+            const std::vector<uint> & g = faces.at(id);
+            if(g.size()!=f.size()) return false;
+            for(uint vid : f) if(DOES_NOT_CONTAIN_VEC(g,vid)) return false;
+            return true;
+        });
+        if(fid==-1)
+        {
+            fid = int(faces.size());
+            faces.push_back(f);
+            f_index.insert(key, uint(fid));
+            flipped = false;
+            return uint(fid);
+        }
+        // the face already exists: does it have the same orientation?
+        const std::vector<uint> & g = faces.at(fid);
+        uint off = 0;
+        while(g.at(off)!=f.front()) ++off;
+        flipped = (g.at((off+1)%g.size())!=f.at(1));
+        return uint(fid);
+    };
+
+    // grid polys that are not replaced by a scheme
+    std::vector<int> f_map(m.num_faces(),-1);
+    std::vector<int> p_map(m.num_polys(),-1);
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        if(poly2scheme.find(pid)!=poly2scheme.end()) continue;
+        std::vector<uint> p;
+        std::vector<bool> w;
+        for(uint fid : m.adj_p2f(pid))
+        {
+            if(f_map.at(fid)<0)
             {
-                uint fresh_vid = m.vert_add(v);
-                v_map[v] = fresh_vid;
+                std::vector<uint> f;
+                for(uint vid : m.adj_f2v(fid)) f.push_back(cluster.at(vid));
+                bool flipped;
+                f_map.at(fid) = int(face_add(f, flipped));
+                assert(!flipped);
             }
+            p.push_back(f_map.at(fid));
+            w.push_back(m.poly_face_winding(pid,fid));
         }
+        p_map.at(pid) = int(polys.size());
+        polys.push_back(p);
+        winding.push_back(w);
+    }
 
-        //merge faces
-        for(uint fid=0; fid<faces.size(); fid++)
+    // scheme polys (skipping duplicates)
+    IdHashTable p_index;
+    p_index.reserve(4*n_schemes);
+    for(uint i=0; i<n_schemes; ++i)
+    {
+        const SchemeMesh & s = schemes.at(i);
+        std::vector<uint> fids(s.faces.size());
+        std::vector<bool> flip(s.faces.size());
+        for(uint fid=0; fid<s.faces.size(); ++fid)
+        {
+            std::vector<uint> f;
+            for(uint vid : s.faces.at(fid)) f.push_back(cluster.at(v_off.at(i)+vid));
+            bool flipped;
+            fids.at(fid) = face_add(f, flipped);
+            flip.at(fid) = flipped;
+        }
+        for(uint pid=0; pid<s.polys.size(); ++pid)
         {
-            auto f = faces[fid];
-            for(uint &v : f) v = v_map[verts.at(v)];
-            int test_id = m.face_id(f);
-            if(test_id>=0)
+            std::vector<uint> p;
+            std::vector<bool> w;
+            for(uint j=0; j<s.polys.at(pid).size(); ++j)
             {
-                f_map[fid] = test_id;
+                uint fid = s.polys.at(pid).at(j);
+                p.push_back(fids.at(fid));
+                w.push_back(s.winding.at(pid).at(j) != flip.at(fid));
             }
-            else
+            uint64_t key = vert_set_key(p);
+            int dup = p_index.find(key, [&](const uint id)
             {
-                uint fresh_fid = m.face_add(f);
-                f_map[fid] = fresh_fid;
-            }
+                const std::vector<uint> & q = polys.at(id);
+                if(q.size()!=p.size()) return false;
+                for(uint fid : p) if(DOES_NOT_CONTAIN_VEC(q,fid)) return false;
+                return true;
+            });
+            if(dup>=0) continue;
+            p_index.insert(key, uint(polys.size()));
+            polys.push_back(p);
+            winding.push_back(w);
         }
+    }
 
-        //merge_polys
-        for(uint pid=0; pid<polys.size(); ++pid)
-        {
-            auto p = polys.at(pid);
-            for(auto & fid : p) fid = f_map.at(fid);
+    // keep only the verts that are referenced by some face, preserving their order
+    std::vector<int> v_map(n_clusters,-1);
+    for(const auto & f : faces) for(uint vid : f) v_map.at(vid) = 0;
+    std::vector<vec3d> verts;
+    for(uint vid=0; vid<n_clusters; ++vid)
+    {
+        if(v_map.at(vid)==0) v_map.at(vid) = int(verts.size()), verts.push_back(vec3d());
+    }
+    for(uint i=points.size(); i-->0;)
+    {
+        int vid = v_map.at(cluster.at(i));
+        if(vid>=0) verts.at(vid) = points.at(i); // lowest point id wins
+    }
+    PARALLEL_FOR(0, uint(faces.size()), 10000, [&](const uint fid)
+    {
+        for(uint & vid : faces.at(fid)) vid = uint(v_map.at(vid));
+    });
 
-            int test_id = m.poly_id(p);
-            if(test_id==-1)
-            {
-                m.poly_add(p, winding[pid]);
-            }
-        }
+    m_out.clear();
+    m_out.mesh_data() = m.mesh_data();
+    m_out.init_bulk(verts, faces, polys, winding);
+
+    // attributes of grid elements
+    for(uint vid=0; vid<m.num_verts(); ++vid)
+    {
+        int id = v_map.at(cluster.at(vid));
+        if(id>=0) m_out.vert_copy_attributes(id, m, vid);
+    }
+    for(uint fid=0; fid<m.num_faces(); ++fid)
+    {
+        if(f_map.at(fid)>=0) m_out.face_copy_attributes(f_map.at(fid), m, fid);
+    }
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        if(p_map.at(pid)>=0) m_out.poly_copy_attributes(p_map.at(pid), m, pid);
     }
 }
 
@@ -869,8 +1037,6 @@ void hex_transition_install(const Polyhedralmesh<M,V,E,F,P> & m_in,
                             const std::vector<bool>         & transition_verts,
                                   Polyhedralmesh<M,V,E,F,P> & m_out)
 {
-    m_out = m_in;
-
     std::vector<uint> transition_verts_direction;
     get_transition_verts_direction(m_in, transition_verts, transition_verts_direction);
 
@@ -965,22 +1131,13 @@ void hex_transition_install(const Polyhedralmesh<M,V,E,F,P> & m_in,
     }
 
     std::unordered_map<uint, SchemeInfo> poly2scheme;
-    for(const auto &corner : corners)   mark_concave_vert(m_out, corner, transition_verts_direction, poly2scheme);
-    for(const auto &concave : concaves) mark_concave_edge(m_out, concave, transition_verts_direction, poly2scheme);
-    for(const auto &convex : convexes)  mark_convex(m_out, convex, transition_verts_direction, poly2scheme);
-    for(uint flat : flats)              mark_flat(m_out, flat, transition_verts_direction, poly2scheme);
-
-    cut_flats(m_out, poly2scheme);
-    merge_schemes_into_mesh(m_out, poly2scheme);
-
-    std::vector<uint> polys_to_remove;
-    for(auto p : poly2scheme)
-    {
-        polys_to_remove.push_back(p.first);
-    }
+    for(const auto &corner : corners)   mark_concave_vert(m_in, corner, transition_verts_direction, poly2scheme);
+    for(const auto &concave : concaves) mark_concave_edge(m_in, concave, transition_verts_direction, poly2scheme);
+    for(const auto &convex : convexes)  mark_convex(m_in, convex, transition_verts_direction, poly2scheme);
+    for(uint flat : flats)              mark_flat(m_in, flat, transition_verts_direction, poly2scheme);
 
-    m_out.polys_remove(polys_to_remove);
-    m_out.poly_fix_orientation();
+    cut_flats(m_in, poly2scheme);
+    merge_schemes_into_mesh(m_in, poly2scheme, m_out);
 }
 
 }
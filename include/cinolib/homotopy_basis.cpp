@@ -37,6 +37,12 @@
 #include <cinolib/shortest_path_tree.h>
 #include <cinolib/mst.h>
 #include <cinolib/stl_container_utilities.h>
+#include <cinolib/dijkstra.h>
+#include <cinolib/parallel_for.h>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <thread>
 
 namespace cinolib
 {
@@ -50,6 +56,15 @@ std::ostream & operator<<(std::ostream & in, const HomotopyBasisData & data)
     in << "Root              : " << data.root                      << "\n";
     in << "Globally shortest : " << data.globally_shortest         << "\n";
     in << "Length            : " << data.length                    << "\n";
+    if(data.globally_shortest)
+    {
+        in << "Roots abandoned   : " << data.roots_abandoned           << "\n";
+        if(data.root_samples>0)
+        {
+            in << "Root samples      : " << data.root_samples          << "\n";
+            in << "Max length error  : " << data.root_samples_error    << "\n";
+        }
+    }
     in << "Detach basis loops: " << data.detach_loops              << "\n";
     if(data.detach_loops)
     {
@@ -87,51 +102,103 @@ double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
                       std::vector<std::vector<uint>> & basis,
                       std::vector<bool>              & tree,
                       std::vector<bool>              & cotree)
+{
+    HomotopyBasisWorkspace ws;
+    double length = homotopy_basis_length(m, root, inf_double, ws);
+    homotopy_basis_loops(m, root, ws, basis);
+    std::swap(tree,   ws.tree);
+    std::swap(cotree, ws.cotree);
+    return length;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double homotopy_basis_length(const AbstractPolygonMesh<M,V,E,P> & m,
+                             const uint                           root,
+                             const double                         max_length,
+                                   HomotopyBasisWorkspace       & ws)
 {
     assert(root<m.num_verts());
 
-    shortest_path_tree(m, root, tree);
+    shortest_path_tree(m, root, ws.tree, ws.dist, ws.parent);
+
+    // The loop generated by a non tree edge (v0,v1) goes from v0 to the root and from
+    // the root to v1 along the tree, hence its length is len(v0,v1) + dist(v0) + dist(v1)
+    uint n_gen = m.genus()*2;
+    ws.loop_len.clear();
+    for(uint eid=0; eid<m.num_edges(); ++eid)
+    {
+        if(ws.tree.at(eid)) continue;
+        ws.loop_len.push_back(m.edge_length(eid) +
+                              ws.dist.at(m.edge_vert_id(eid,0)) +
+                              ws.dist.at(m.edge_vert_id(eid,1)));
+    }
+
+    // Any basis is made of n_gen such loops, hence the sum of the n_gen shortest
+    // ones is a lower bound to its length. If it is already too long there is
+    // no need to compute the cotree
+    if(n_gen>0 && n_gen<=ws.loop_len.size() && max_length<inf_double)
+    {
+        std::nth_element(ws.loop_len.begin(), ws.loop_len.begin()+n_gen-1, ws.loop_len.end());
+        double lower_bound = 0.0;
+        for(uint i=0; i<n_gen; ++i) lower_bound += ws.loop_len.at(i);
+        if(lower_bound > max_length) return inf_double;
+    }
 
     // Compute the cotree as the Maximum Spanning Tree of the dual of M,
     // without considering dual edges that cross edges of primal tree.
     //
     // I'm using a classical Minimum Spanning Tree algorithm (Prim's) with negative weights
-    std::vector<float> edge_weights(m.num_edges(),0);
-    std::vector<bool>  edge_mask(m.num_edges()); // restrict Dijkstra to the edges in tree only
-    for(uint eid=0; eid<m.num_edges(); ++eid) edge_mask.at(eid) = !tree.at(eid);
+    ws.weights.assign(m.num_edges(),0);
     for(uint eid=0; eid<m.num_edges(); ++eid)
     {
-        if(tree.at(eid)) continue;
-        std::vector<uint> tmp;
-        edge_weights.at(eid) -= float(m.edge_length(eid));
-        edge_weights.at(eid) -= float(dijkstra_mask_on_edges(m, m.edge_vert_id(eid,0), root, edge_mask, tmp));
-        edge_weights.at(eid) -= float(dijkstra_mask_on_edges(m, m.edge_vert_id(eid,1), root, edge_mask, tmp));
+        if(ws.tree.at(eid)) continue;
+        ws.weights.at(eid) -= float(m.edge_length(eid));
+        ws.weights.at(eid) -= float(ws.dist.at(m.edge_vert_id(eid,0)));
+        ws.weights.at(eid) -= float(ws.dist.at(m.edge_vert_id(eid,1)));
     }
-    MST_on_dual_mask_on_edges(m, edge_weights, tree, cotree); // use tree as edge mask
+    MST_on_dual_mask_on_edges(m, ws.weights, ws.tree, ws.cotree); // use tree as edge mask
 
     // Find the edges neither in tree, nor in cotree
-    std::vector<uint> generators;
+    ws.generators.clear();
+    double length = 0.0;
     for(uint eid=0; eid<m.num_edges(); ++eid)
     {
-        if(!tree.at(eid) && !cotree.at(eid)) generators.push_back(eid);
+        if(ws.tree.at(eid) || ws.cotree.at(eid)) continue;
+        ws.generators.push_back(eid);
+        length += m.edge_length(eid);
+        length += ws.dist.at(m.edge_vert_id(eid,0));
+        length += ws.dist.at(m.edge_vert_id(eid,1));
+        if(length > max_length) return inf_double;
     }
-    assert(m.genus()*2 == (int)generators.size());
+    assert(n_gen == ws.generators.size());
+    return length;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    // Start from each such edge, and close a loop with its two endpoints
+template<class M, class V, class E, class P>
+CINO_INLINE
+void homotopy_basis_loops(const AbstractPolygonMesh<M,V,E,P>   & m,
+                          const uint                             root,
+                          const HomotopyBasisWorkspace         & ws,
+                                std::vector<std::vector<uint>> & basis)
+{
+    // Start from each generator, and close a loop with its two endpoints
+    // (v0 -> root -> v1)
     basis.clear();
-    double length = 0.0;
-    for(uint eid : generators)
+    basis.reserve(ws.generators.size());
+    for(uint eid : ws.generators)
     {
-        std::vector<uint> e0_to_root, e1_to_root;
-        length += m.edge_length(eid);
-        length += dijkstra_mask_on_edges(m, m.edge_vert_id(eid,0), root, edge_mask, e0_to_root);
-        length += dijkstra_mask_on_edges(m, m.edge_vert_id(eid,1), root, edge_mask, e1_to_root);
-        e1_to_root.pop_back();
-        std::reverse(e1_to_root.begin(), e1_to_root.end());
-        std::copy(e1_to_root.begin(), e1_to_root.end(), std::back_inserter(e0_to_root));
-        basis.push_back(e0_to_root);
+        std::vector<uint> loop;
+        for(int vid=m.edge_vert_id(eid,0); vid>=0; vid=ws.parent.at(vid)) loop.push_back(vid);
+        std::vector<uint> e1_to_root;
+        for(int vid=m.edge_vert_id(eid,1); vid!=(int)root; vid=ws.parent.at(vid)) e1_to_root.push_back(vid);
+        std::copy(e1_to_root.rbegin(), e1_to_root.rend(), std::back_inserter(loop));
+        basis.push_back(loop);
     }
-    return length;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -146,36 +213,76 @@ void homotopy_basis(AbstractPolygonMesh<M,V,E,P> & m,
     //
     if(data.globally_shortest)
     {
+        // Candidate roots: either all vertices, or a farthest point sampling of them.
+        // Any basis rooted at r can be turned into a basis rooted at a sample s by
+        // connecting each loop to s (back and forth), and the greedy basis at s is the
+        // shortest among the bases rooted at s. Hence, the error w.r.t. the globally
+        // shortest basis is bounded by 4*genus*(max distance from the closest sample)
+        std::vector<uint> roots;
+        data.root_samples_error = 0.0;
+        if(data.root_samples>0 && data.root_samples<m.num_verts())
+        {
+            std::vector<double> min_dist(m.num_verts(), inf_double), dist;
+            uint vid = data.root;
+            while(roots.size()<data.root_samples)
+            {
+                roots.push_back(vid);
+                dijkstra_exhaustive(m, vid, dist);
+                for(uint i=0; i<m.num_verts(); ++i) min_dist.at(i) = std::min(min_dist.at(i), dist.at(i));
+                vid = std::max_element(min_dist.begin(), min_dist.end()) - min_dist.begin();
+            }
+            data.root_samples_error = 4.0 * m.genus() * min_dist.at(vid);
+        }
+        else
+        {
+            roots.resize(m.num_verts());
+            std::iota(roots.begin(), roots.end(), 0);
+        }
+
+        // Roots are fetched dynamically by a pool of workers, each with its own buffers.
+        // The length of the best basis found so far is shared, and roots that are proven
+        // to generate longer bases are abandoned. Ties are broken by lowest vertex ID,
+        // so that the result does not depend on the scheduling of the threads
+        uint n_workers = std::thread::hardware_concurrency();
+        if(n_workers==0) n_workers = 8;
+        n_workers = std::min(n_workers, (uint)roots.size());
+
+        std::vector<HomotopyBasisWorkspace> ws(n_workers);
+        std::atomic<uint>   next(0);
+        std::atomic<uint>   abandoned(0);
+        std::atomic<double> bound(inf_double);
+        std::mutex          mutex;
         double best_length = inf_double;
-        uint   best_root;
-        std::vector<std::vector<uint>> best_basis;
-        std::vector<bool>              best_tree;
-        std::vector<bool>              best_cotree;
+        uint   best_root   = roots.front();
 
-        for(uint vid=0; vid<m.num_verts(); ++vid)
+        PARALLEL_FOR(0, n_workers, 0, [&](uint w)
         {
-            double length = homotopy_basis(m, vid, data.loops, data.tree, data.cotree);
-
-            if(length < best_length)
+            for(uint i=next++; i<roots.size(); i=next++)
             {
-                best_root   = vid;
-                best_length = length;
-                best_basis  = data.loops;
-                best_tree   = data.tree;
-                best_cotree = data.cotree;
+                uint   vid    = roots.at(i);
+                double length = homotopy_basis_length(m, vid, bound.load(), ws.at(w));
+                if(length==inf_double)
+                {
+                    ++abandoned;
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                if(length < best_length || (length == best_length && vid < best_root))
+                {
+                    best_length = length;
+                    best_root   = vid;
+                    bound.store(length);
+                }
             }
-        }
-        data.loops  = best_basis;
-        data.root   = best_root;
-        data.length = best_length;
-        data.tree   = best_tree;
-        data.cotree = best_cotree;
-    }
-    else
-    {
-        data.length = homotopy_basis(m, data.root, data.loops, data.tree, data.cotree);
+        });
+        ws.clear();
+
+        data.root            = best_root;
+        data.roots_abandoned = abandoned;
     }
 
+    data.length = homotopy_basis(m, data.root, data.loops, data.tree, data.cotree);
+
     if(data.detach_loops) detach_loops(dynamic_cast<Trimesh<M,V,E,P>&>(m), data);
 }
 
@@ -666,7 +773,7 @@ bool polys_are_planar(const Trimesh<M,V,E,P>  & m,
 
     std::vector<vec3d> n;
     n.reserve(poly_fan.size());
-    for(uint pid : poly_fan) n.push_back(m.poly_data(pid).normal);
+    for(uint pid : poly_fan) n.push_back(m.poly_normal(pid));
 
     for(auto i=n.begin(); i<n.end(); ++i)
     for(auto j=i+1;       j<n.end(); ++j)
@@ -708,7 +815,7 @@ bool find_position_within_fan(const Trimesh<M,V,E,P>  & m,
         bool reject = false;
         for(uint pid : poly_fan)
         {
-            vec3d n1 = m.poly_data(pid).normal;
+            vec3d n1 = m.poly_normal(pid);
             auto  v  = m.poly_verts(pid);
             if(m.poly_vert_id(pid,0)==v_mid) v.at(0) = pos; else
             if(m.poly_vert_id(pid,1)==v_mid) v.at(1) = pos; else
@@ -731,7 +838,7 @@ bool find_position_within_fan(const Trimesh<M,V,E,P>  & m,
             if(m.poly_vert_id(pid,1)==v_tmp) v.at(1) = pos; else
             if(m.poly_vert_id(pid,2)==v_tmp) v.at(2) = pos; else
             assert(false);
-            vec3d n1 = m.poly_data(pid).normal;
+            vec3d n1 = m.poly_normal(pid);
             vec3d n2 = triangle_normal(v.at(0), v.at(1), v.at(2));
             if(n2.is_deg() || n1.dot(n2) <= 0) reject = true;
         }
@@ -745,7 +852,7 @@ bool find_position_within_fan(const Trimesh<M,V,E,P>  & m,
             if(m.poly_vert_id(pid,1)==v_tmp) v.at(1) = pos; else
             if(m.poly_vert_id(pid,2)==v_tmp) v.at(2) = pos; else
             assert(false);
-            vec3d n1 = m.poly_data(pid).normal;
+            vec3d n1 = m.poly_normal(pid);
             vec3d n2 = triangle_normal(v.at(0), v.at(1), v.at(2));
             if(n2.is_deg() || n1.dot(n2) <= 0) reject = true;
         }
@@ -116,6 +116,7 @@ struct HomotopyBasisData
     // INPUT: SETTINGS
     bool  globally_shortest  = false; // cost for globally shortest is O(n^2 log n). When this is set to true, root will contain the root of the globally shortest basis
     uint  root               = 0;     // cost for a base centered at root is O(n log n)
+    uint  root_samples       = 0;     // if >0, the globally shortest search only tries this many roots, sampled with farthest point sampling starting from root
 
     // INPUT: REFINEMENT OPTIONS AND STATISTICS
     bool  detach_loops       = false;                 // refine mesh topology to detach loops traversing the same edges
@@ -127,6 +128,10 @@ struct HomotopyBasisData
     std::vector<std::vector<uint>> loops;
     double length = 0.0; // length of the basis
 
+    // OUTPUT: GLOBALLY SHORTEST SEARCH STATISTICS
+    uint   roots_abandoned    = 0;   // roots discarded before completion because their basis was already longer than the best one
+    double root_samples_error = 0.0; // with root_samples>0, upper bound to the gap between length and the length of the globally shortest basis
+
     // OUTPUT: AUXILIARY DATA (may be useful for visual inspection/debugging)
     // note: tree and cotree reference the input mesh. If loops are detached they are useless
     std::vector<bool> tree;   // one element per edge. True if it is part of the tree, false otherwise
@@ -138,6 +143,21 @@ std::ostream & operator<<(std::ostream & in, const HomotopyBasisData & data);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// Buffers used to compute the basis rooted at a given vertex. The globally shortest
+// search keeps one workspace per thread, and reuses it for all the roots it visits
+struct HomotopyBasisWorkspace
+{
+    std::vector<double> dist;       // per vertex distance from the root
+    std::vector<int>    parent;     // per vertex parent in the shortest path tree
+    std::vector<bool>   tree;       // per edge, true if in the shortest path tree
+    std::vector<bool>   cotree;     // per edge, true if in the cotree
+    std::vector<float>  weights;    // per edge weights for the cotree computation
+    std::vector<double> loop_len;   // per edge length of the loop it generates
+    std::vector<uint>   generators; // edges neither in tree nor in cotree
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void homotopy_basis(AbstractPolygonMesh<M,V,E,P> & m,
@@ -155,6 +175,28 @@ double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// computes tree, cotree and generators of the basis rooted at root, and returns its length.
+// If the basis is proven to be longer than max_length its computation is abandoned, and
+// inf_double is returned
+template<class M, class V, class E, class P>
+CINO_INLINE
+double homotopy_basis_length(const AbstractPolygonMesh<M,V,E,P> & m,
+                             const uint                           root,
+                             const double                         max_length,
+                                   HomotopyBasisWorkspace       & ws);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// closes a loop for each generator in the workspace, walking the shortest path tree up to the root
+template<class M, class V, class E, class P>
+CINO_INLINE
+void homotopy_basis_loops(const AbstractPolygonMesh<M,V,E,P>   & m,
+                          const uint                             root,
+                          const HomotopyBasisWorkspace         & ws,
+                                std::vector<std::vector<uint>> & basis);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 // globally detaches loops in the homotopy basis
 template<class M, class V, class E, class P>
 CINO_INLINE
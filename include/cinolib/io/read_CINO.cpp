@@ -0,0 +1,275 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/read_CINO.h>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <assert.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace cinolib
+{
+
+// https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
+//
+CINO_INLINE
+uint64_t fnv1a_checksum(const void * data, const size_t bytes)
+{
+    const unsigned char * p = static_cast<const unsigned char*>(data);
+    uint64_t h = 0xcbf29ce484222325ull;
+    for(size_t i=0; i<bytes; ++i)
+    {
+        h ^= p[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool ids_in_range(const std::vector<uint> & ids, const size_t n)
+{
+    for(uint id : ids) if(id>=n) return false;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool ids_in_range(const std::vector<std::vector<uint>> & ids, const size_t n)
+{
+    for(const auto & list : ids) if(!ids_in_range(list, n)) return false;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+CinoBinaryReader::CinoBinaryReader(const char * filename, const bool verify_checksums)
+{
+#ifndef _WIN32
+    int fd = open(filename, O_RDONLY);
+    if(fd>=0)
+    {
+        struct stat st;
+        if(fstat(fd, &st)==0 && st.st_size>0)
+        {
+            void * ptr = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if(ptr!=MAP_FAILED)
+            {
+                data      = static_cast<const char*>(ptr);
+                size      = size_t(st.st_size);
+                is_mapped = true;
+            }
+        }
+        close(fd);
+    }
+#endif
+    if(!is_mapped)
+    {
+        FILE *fp = fopen(filename, "rb");
+        if(fp)
+        {
+            fseek(fp, 0, SEEK_END);
+            buffer.resize(size_t(ftell(fp)));
+            rewind(fp);
+            if(fread(buffer.data(), 1, buffer.size(), fp)!=buffer.size()) buffer.clear();
+            fclose(fp);
+        }
+        data = buffer.data();
+        size = buffer.size();
+    }
+
+    CinoBinaryHeader h;
+    if(size<sizeof(CinoBinaryHeader))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_CINO() : couldn't open input file " << filename << std::endl;
+        exit(-1);
+    }
+    memcpy(&h, data, sizeof(CinoBinaryHeader));
+
+    if(strncmp(h.magic, "CINOMESH", 8)!=0)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_CINO() : " << filename << " is not a CinoLib binary file" << std::endl;
+        exit(-1);
+    }
+    if(h.version>CINO_BINARY_VERSION)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_CINO() : unsupported file version " << h.version << std::endl;
+        exit(-1);
+    }
+    if(h.table_offset > size || h.n_sections > (size - h.table_offset)/sizeof(CinoBinarySection))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_CINO() : truncated file " << filename << std::endl;
+        exit(-1);
+    }
+    file_version   = h.version;
+    file_mesh_type = h.mesh_type;
+
+    table.resize(h.n_sections);
+    memcpy(table.data(), data + h.table_offset, h.n_sections*sizeof(CinoBinarySection));
+
+    for(const auto & s : table)
+    {
+        if(s.offset > size || s.bytes > size - s.offset ||
+           (verify_checksums && fnv1a_checksum(data + s.offset, s.bytes)!=s.checksum))
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_CINO() : corrupted section " << std::string(s.tag, strnlen(s.tag,16)) << std::endl;
+            exit(-1);
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+CinoBinaryReader::~CinoBinaryReader()
+{
+#ifndef _WIN32
+    if(is_mapped) munmap(const_cast<char*>(data), size);
+#endif
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool CinoBinaryReader::has(const std::string & tag) const
+{
+    size_t bytes;
+    return section(tag, bytes)!=nullptr;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+const void * CinoBinaryReader::section(const std::string & tag, size_t & bytes) const
+{
+    assert(tag.size()<=16);
+    for(const auto & s : table)
+    {
+        if(strncmp(s.tag, tag.c_str(), 16)==0)
+        {
+            bytes = size_t(s.bytes);
+            return data + s.offset;
+        }
+    }
+    bytes = 0;
+    return nullptr;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+bool CinoBinaryReader::read(const std::string & tag, std::vector<T> & v) const
+{
+    size_t bytes;
+    const void * ptr = section(tag, bytes);
+    if(ptr==nullptr) return false;
+    v.resize(bytes/sizeof(T));
+    if(bytes>0) memcpy(v.data(), ptr, bytes);
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+bool CinoBinaryReader::read_nested(const std::string & tag, std::vector<std::vector<T>> & v) const
+{
+    size_t bytes_off, bytes_val;
+    const uint64_t * off = static_cast<const uint64_t*>(section(tag + ".o", bytes_off));
+    const T        * val = static_cast<const T*>       (section(tag,        bytes_val));
+    if(off==nullptr || val==nullptr || bytes_off<sizeof(uint64_t)) return false;
+
+    // offsets come straight from the file: make sure they are sorted and do
+    // not point outside of the values section before dereferencing them
+    size_t n     = bytes_off/sizeof(uint64_t) - 1;
+    size_t n_val = bytes_val/sizeof(T);
+    if(off[0]!=0 || off[n]>n_val) return false;
+    for(size_t i=0; i<n; ++i) if(off[i]>off[i+1]) return false;
+
+    v.resize(n);
+    for(size_t i=0; i<n; ++i) v[i].assign(val + off[i], val + off[i+1]);
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool CinoBinaryReader::read_nested(const std::string & tag, std::vector<std::vector<bool>> & v) const
+{
+    std::vector<std::vector<uint8_t>> tmp;
+    if(!read_nested(tag, tmp)) return false;
+    v.resize(tmp.size());
+    for(size_t i=0; i<tmp.size(); ++i) v[i].assign(tmp[i].begin(), tmp[i].end());
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool CinoBinaryReader::read(const std::string & tag, std::vector<vec3d> & v) const
+{
+    size_t bytes;
+    const double * ptr = static_cast<const double*>(section(tag, bytes));
+    if(ptr==nullptr) return false;
+    v.resize(bytes/(3*sizeof(double)));
+    for(size_t i=0; i<v.size(); ++i) v[i] = vec3d(ptr[3*i], ptr[3*i+1], ptr[3*i+2]);
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool CinoBinaryReader::read(const std::string & tag, std::vector<Color> & v) const
+{
+    size_t bytes;
+    const float * ptr = static_cast<const float*>(section(tag, bytes));
+    if(ptr==nullptr) return false;
+    v.resize(bytes/(4*sizeof(float)));
+    for(size_t i=0; i<v.size(); ++i) v[i] = Color(ptr[4*i], ptr[4*i+1], ptr[4*i+2], ptr[4*i+3]);
+    return true;
+}
+
+}
@@ -0,0 +1,153 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_READ_CINO_H
+#define CINO_READ_CINO_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
+#include <cinolib/color.h>
+
+namespace cinolib
+{
+
+/* CinoLib native binary mesh container (.cino files).
+ *
+ * A .cino file is a sequence of named sections preceded by a fixed size header
+ * and followed by a section table:
+ *
+ *    [header][section 0][section 1]...[section n-1][table]
+ *
+ * header  : magic "CINOMESH", format version, mesh type, number of sections, table offset
+ * table   : for each section a 16 chars tag, offset, size in bytes and a FNV-1a checksum
+ *           (checksums are verified on load only if explicitly requested)
+ * section : raw little endian data, aligned to 8 bytes
+ *
+ * Flat arrays (vertex coordinates, labels, colors...) are stored as a single
+ * section. Vectors of vectors (polygons, polyhedra, adjacency relations) are
+ * stored as two sections: a flat list of ids and a list of offsets (CSR layout).
+ * Readers look sections up by tag, therefore new sections can be added in the
+ * future without breaking backward compatibility.
+ *
+ * Files are memory mapped on load (plain fread on platforms without mmap),
+ * so data is copied straight from the page cache into the mesh containers,
+ * without parsing.
+ *
+ * Meshes read and write .cino files through their load/save methods. The
+ * precomputed adjacency is stored by default, so that loading does not need
+ * to derive the mesh topology again.
+*/
+
+static const uint32_t CINO_BINARY_VERSION = 1;
+
+struct CinoBinaryHeader
+{
+    char     magic[8];     // "CINOMESH"
+    uint32_t version;
+    uint32_t mesh_type;    // see MeshType
+    uint64_t n_sections;
+    uint64_t table_offset;
+};
+
+struct CinoBinarySection
+{
+    char     tag[16];
+    uint64_t offset;
+    uint64_t bytes;
+    uint64_t checksum;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t fnv1a_checksum(const void * data, const size_t bytes);
+
+// true if all ids are smaller than n. Used to validate connectivity read from
+// file before it is used to index other containers
+CINO_INLINE
+bool ids_in_range(const std::vector<uint> & ids, const size_t n);
+
+CINO_INLINE
+bool ids_in_range(const std::vector<std::vector<uint>> & ids, const size_t n);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class CinoBinaryReader
+{
+    public:
+
+        // section bounds are always validated. Checksums are verified only upon
+        // request, as it requires a full pass over the file
+        explicit CinoBinaryReader(const char * filename, const bool verify_checksums = false);
+                ~CinoBinaryReader();
+
+        // the reader owns the file mapping (or buffer), hence it cannot be copied
+        CinoBinaryReader(const CinoBinaryReader &) = delete;
+        CinoBinaryReader & operator=(const CinoBinaryReader &) = delete;
+
+        uint32_t version()   const { return file_version; }
+        uint32_t mesh_type() const { return file_mesh_type; }
+
+        bool         has    (const std::string & tag) const;
+        const void * section(const std::string & tag, size_t & bytes) const;
+
+        template<typename T> bool read       (const std::string & tag, std::vector<T>              & v) const;
+        template<typename T> bool read_nested(const std::string & tag, std::vector<std::vector<T>> & v) const;
+                             bool read_nested(const std::string & tag, std::vector<std::vector<bool>> & v) const;
+                             bool read       (const std::string & tag, std::vector<vec3d>          & v) const;
+                             bool read       (const std::string & tag, std::vector<Color>          & v) const;
+
+    private:
+
+        const char                    * data      = nullptr;
+        size_t                          size      = 0;
+        bool                            is_mapped = false;
+        std::vector<char>               buffer;   // used where mmap is not available
+        std::vector<CinoBinarySection>  table;
+        uint32_t                        file_version   = 0;
+        uint32_t                        file_mesh_type = 0;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "read_CINO.cpp"
+#endif
+
+#endif // CINO_READ_CINO_H
@@ -46,6 +46,8 @@
 #include <cinolib/io/write_OFF.h>
 #include <cinolib/io/write_STL.h>
 #include <cinolib/io/write_NODE_ELE.h>
+// SURFACE STREAMING (OUT-OF-CORE) READERS/WRITERS
+#include <cinolib/io/stream_triangles.h>
 
 
 // VOLUME READERS
@@ -65,6 +67,11 @@
 #include <cinolib/io/write_OVM.h>
 
 
+// NATIVE BINARY FORMAT (ANY MESH)
+#include <cinolib/io/read_CINO.h>
+#include <cinolib/io/write_CINO.h>
+
+
 // SKELETON READERS
 #include <cinolib/io/read_LIVESU2012.h>
 #include <cinolib/io/read_TAGLIASACCHI2012.h>
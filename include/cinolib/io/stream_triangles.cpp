@@ -0,0 +1,482 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/stream_triangles.h>
+#include <cinolib/io/io_utilities.h>
+#include <cinolib/geometry/triangle_utils.h>
+#include <cinolib/string_utilities.h>
+#include <fstream>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <assert.h>
+
+namespace cinolib
+{
+
+// 64 bit safe file positioning (vertex files of huge meshes easily exceed 2GB)
+CINO_INLINE
+int ooc_fseek(FILE * fp, const size_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(fp, (__int64)offset, SEEK_SET);
+#else
+    return fseeko(fp, (off_t)offset, SEEK_SET);
+#endif
+}
+
+// parses the vertex index of an OBJ face corner (e.g. "12", "12/3", "12//4", "12/3/4")
+CINO_INLINE
+long obj_corner_index(const char * s, const size_t nv)
+{
+    long vid = strtol(s, nullptr, 10);
+    return (vid<0) ? long(nv)+vid : vid-1; // negative ids are relative to the last vertex
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Func>
+CINO_INLINE
+void stream_triangles(const char   * filename,
+                      const uint     chunk_size,
+                      const Func   & func,
+                      const size_t   cache_bytes)
+{
+    std::string ext = get_file_extension(std::string(filename));
+    for(auto & c : ext) c = char(tolower(c));
+
+         if(ext.compare("off")==0) stream_triangles_OFF(filename, chunk_size, func, cache_bytes);
+    else if(ext.compare("obj")==0) stream_triangles_OBJ(filename, chunk_size, func, cache_bytes);
+    else if(ext.compare("stl")==0) stream_triangles_STL(filename, chunk_size, func);
+    else
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : stream_triangles() : file format not supported yet " << std::endl;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Func>
+CINO_INLINE
+void stream_triangles_OFF(const char   * filename,
+                          const uint     chunk_size,
+                          const Func   & func,
+                          const size_t   cache_bytes)
+{
+    assert(chunk_size>0);
+    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
+
+    std::ifstream f(filename);
+    if(!f.is_open())
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : stream_triangles_OFF() : couldn't open input file " << filename << std::endl;
+        exit(-1);
+    }
+
+    std::string line;
+    uint nv, np, ne;
+
+    // read header and number of elements
+    do getline(f, line, '\n'); while(line.find("OFF")==std::string::npos && !f.eof());
+    do getline(f, line, '\n'); while(sscanf(line.c_str(), "%u %u %u", &nv, &np, &ne)!=3 && !f.eof());
+
+    // spill verts to disk
+    OOCVertexArray verts(cache_bytes);
+    for(uint i=0; i<nv && getline(f, line, '\n');)
+    {
+        double x, y, z;
+        if(sscanf(line.c_str(), "%lf %lf %lf", &x, &y, &z)==3)
+        {
+            verts.push_back(vec3d(x,y,z));
+            ++i;
+        }
+    }
+
+    // stream polys, fan triangulating them
+    std::vector<double> chunk;
+    chunk.reserve(size_t(chunk_size)*9);
+    std::vector<long> p;
+    for(uint i=0; i<np && getline(f, line, '\n');)
+    {
+        const char * s = line.c_str();
+        char * end;
+        long n_corners = strtol(s, &end, 10);
+        if(end==s) continue; // empty or comment line
+        ++i;
+
+        p.clear();
+        for(long j=0; j<n_corners; ++j)
+        {
+            s = end;
+            p.push_back(strtol(s, &end, 10));
+        }
+        for(size_t j=2; j<p.size(); ++j)
+        {
+            vec3d v[3] = { verts.at(p[0]), verts.at(p[j-1]), verts.at(p[j]) };
+            for(int k=0; k<3; ++k) chunk.insert(chunk.end(), v[k].ptr(), v[k].ptr()+3);
+            if(chunk.size()/9 >= chunk_size)
+            {
+                func(static_cast<const std::vector<double>&>(chunk));
+                chunk.clear();
+            }
+        }
+    }
+    if(!chunk.empty()) func(static_cast<const std::vector<double>&>(chunk));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Func>
+CINO_INLINE
+void stream_triangles_OBJ(const char   * filename,
+                          const uint     chunk_size,
+                          const Func   & func,
+                          const size_t   cache_bytes)
+{
+    assert(chunk_size>0);
+    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
+
+    std::ifstream f(filename);
+    if(!f.is_open())
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : stream_triangles_OBJ() : couldn't open input file " << filename << std::endl;
+        exit(-1);
+    }
+
+    // OBJ faces can only refer to vertices defined before them,
+    // hence both verts and polys can be processed in a single pass
+    OOCVertexArray verts(cache_bytes);
+    std::vector<double> chunk;
+    chunk.reserve(size_t(chunk_size)*9);
+    std::vector<long> p;
+
+    std::string line;
+    while(std::getline(f,line))
+    {
+        if(line.size()<2) continue;
+
+        if(line[0]=='v' && (line[1]==' ' || line[1]=='\t'))
+        {
+            double x, y, z;
+            if(sscanf(line.c_str()+1, "%lf %lf %lf", &x, &y, &z)==3) verts.push_back(vec3d(x,y,z));
+        }
+        else if(line[0]=='f' && (line[1]==' ' || line[1]=='\t'))
+        {
+            p.clear();
+            const char * s = line.c_str()+1;
+            while(*s)
+            {
+                while(*s==' ' || *s=='\t' || *s=='\r') ++s;
+                if(!*s) break;
+                p.push_back(obj_corner_index(s, verts.size()));
+                while(*s && *s!=' ' && *s!='\t' && *s!='\r') ++s;
+            }
+            for(size_t j=2; j<p.size(); ++j)
+            {
+                vec3d v[3] = { verts.at(p[0]), verts.at(p[j-1]), verts.at(p[j]) };
+                for(int k=0; k<3; ++k) chunk.insert(chunk.end(), v[k].ptr(), v[k].ptr()+3);
+                if(chunk.size()/9 >= chunk_size)
+                {
+                    func(static_cast<const std::vector<double>&>(chunk));
+                    chunk.clear();
+                }
+            }
+        }
+    }
+    if(!chunk.empty()) func(static_cast<const std::vector<double>&>(chunk));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Func>
+CINO_INLINE
+void stream_triangles_STL(const char   * filename,
+                          const uint     chunk_size,
+                          const Func   & func)
+{
+    // https://en.wikipedia.org/wiki/STL_(file_format)
+
+    assert(chunk_size>0);
+    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
+
+    FILE *fp = fopen(filename, "rb");
+    if(!fp)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : stream_triangles_STL() : couldn't open input file " << filename << std::endl;
+        exit(-1);
+    }
+
+    // Many ASCII-looking files (e.g. in Thingi10K) are actually binary. Rather than
+    // scanning the whole file for keywords (see read_STL), a file is considered
+    // binary if its size matches the triangle count stored in its header
+    char header[80];
+    unsigned int nt = 0;
+    bool is_binary = false;
+    if(fread(header, 1, 80, fp)==80 && fread(&nt, sizeof(unsigned int), 1, fp)==1)
+    {
+        fseek(fp, 0, SEEK_END);
+        long long fsize = (long long)ftell(fp);
+        is_binary = (fsize == 84 + 50*(long long)nt);
+    }
+
+    std::vector<double> chunk;
+    chunk.reserve(size_t(chunk_size)*9);
+
+    if(is_binary)
+    {
+        fseek(fp, 84, SEEK_SET);
+        char buf[50];
+        for(unsigned int i=0; i<nt; ++i)
+        {
+            if(fread(buf, 1, 50, fp)!=50) assert(false && "error reading STL triangle");
+            float vf[9];
+            memcpy(vf, buf+12, 9*sizeof(float)); // skip normal, discard attribute
+            for(int j=0; j<9; ++j) chunk.push_back(vf[j]);
+            if(chunk.size()/9 >= chunk_size)
+            {
+                func(static_cast<const std::vector<double>&>(chunk));
+                chunk.clear();
+            }
+        }
+    }
+    else
+    {
+        fclose(fp);
+        fp = fopen(filename, "r");
+        if(!fp)
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : stream_triangles_STL() : couldn't open input file " << filename << std::endl;
+            exit(-1);
+        }
+        while(seek_keyword(fp, "facet"))
+        {
+            if(!seek_keyword(fp, "outer")) assert(false && "could not find keyword OUTER");
+            if(!seek_keyword(fp, "loop"))  assert(false && "could not find keyword LOOP");
+            for(int i=0; i<3; ++i)
+            {
+                double x, y, z;
+                if(!seek_keyword(fp, "vertex")) assert(false && "could not find keyword VERTEX");
+                if(!eat_double(fp, x))          assert(false && "could not parse x coord");
+                if(!eat_double(fp, y))          assert(false && "could not parse y coord");
+                if(!eat_double(fp, z))          assert(false && "could not parse z coord");
+                chunk.push_back(x);
+                chunk.push_back(y);
+                chunk.push_back(z);
+            }
+            if(!seek_keyword(fp, "endfacet")) assert(false && "could not find keyword ENDFACET");
+            if(chunk.size()/9 >= chunk_size)
+            {
+                func(static_cast<const std::vector<double>&>(chunk));
+                chunk.clear();
+            }
+        }
+    }
+    fclose(fp);
+    if(!chunk.empty()) func(static_cast<const std::vector<double>&>(chunk));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+OOCVertexArray::OOCVertexArray(const size_t cache_bytes)
+{
+    fp = tmpfile();
+    if(!fp)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : OOCVertexArray() : couldn't create temporary file " << std::endl;
+        exit(-1);
+    }
+    size_t n_slots = std::max(size_t(1), cache_bytes/(page_size*3*sizeof(double)));
+    pages.resize(n_slots);
+    page_ids.resize(n_slots, size_t(-1));
+    write_buf.reserve(page_size*3);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+OOCVertexArray::~OOCVertexArray()
+{
+    if(fp) fclose(fp); // temporary files are removed automatically
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void OOCVertexArray::push_back(const vec3d & p)
+{
+    write_buf.push_back(p.x());
+    write_buf.push_back(p.y());
+    write_buf.push_back(p.z());
+    ++n_verts;
+    if(write_buf.size()==page_size*3) flush();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// only full pages are flushed, hence any page read from disk is complete
+CINO_INLINE
+void OOCVertexArray::flush()
+{
+    size_t n_flushed = n_verts - write_buf.size()/3;
+    ooc_fseek(fp, n_flushed*3*sizeof(double));
+    if(fwrite(write_buf.data(), sizeof(double), write_buf.size(), fp)!=write_buf.size())
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : OOCVertexArray::flush() : couldn't write to temporary file " << std::endl;
+        exit(-1);
+    }
+    write_buf.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+vec3d OOCVertexArray::at(const size_t vid)
+{
+    if(vid>=n_verts)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : OOCVertexArray::at() : vertex id out of range " << vid << std::endl;
+        exit(-1);
+    }
+
+    size_t n_flushed = n_verts - write_buf.size()/3;
+    if(vid>=n_flushed)
+    {
+        const double * p = write_buf.data() + (vid-n_flushed)*3;
+        return vec3d(p[0], p[1], p[2]);
+    }
+
+    size_t page = vid/page_size;
+    size_t slot = page%pages.size();
+    if(page_ids[slot]!=page)
+    {
+        pages[slot].resize(page_size*3);
+        ooc_fseek(fp, page*page_size*3*sizeof(double));
+        if(fread(pages[slot].data(), sizeof(double), page_size*3, fp)!=page_size*3)
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : OOCVertexArray::at() : couldn't read from temporary file " << std::endl;
+            exit(-1);
+        }
+        page_ids[slot] = page;
+    }
+    const double * p = pages[slot].data() + (vid%page_size)*3;
+    return vec3d(p[0], p[1], p[2]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+STLStreamWriter::STLStreamWriter(const char * filename)
+{
+    fp = fopen(filename, "wb");
+    if(!fp)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : STLStreamWriter() : couldn't save file " << filename << std::endl;
+        exit(-1);
+    }
+    char header[80];
+    memset(header, 0, 80);
+    snprintf(header, 80, "cinolib_mesh");
+    fwrite(header, 1, 80, fp);
+    fwrite(&n_tris, sizeof(unsigned int), 1, fp); // patched in close()
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+STLStreamWriter::~STLStreamWriter()
+{
+    close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void STLStreamWriter::append(const std::vector<double> & tris)
+{
+    std::vector<double> normals(tris.size()/3);
+    for(size_t i=0, j=0; i<tris.size(); i+=9, j+=3)
+    {
+        vec3d n = triangle_normal(vec3d(&tris[i  ]),
+                                  vec3d(&tris[i+3]),
+                                  vec3d(&tris[i+6]));
+        normals[j  ] = n.x();
+        normals[j+1] = n.y();
+        normals[j+2] = n.z();
+    }
+    append(tris, normals);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void STLStreamWriter::append(const std::vector<double> & tris, const std::vector<double> & normals)
+{
+    assert(fp);
+    assert(tris.size()%9==0);
+    assert(normals.size()*3==tris.size());
+
+    std::vector<char> buf(tris.size()/9*50, 0);
+    char * b = buf.data();
+    for(size_t i=0, j=0; i<tris.size(); i+=9, j+=3, b+=50)
+    {
+        float f[12] = { float(normals[j]), float(normals[j+1]), float(normals[j+2]),
+                        float(tris[i  ]),  float(tris[i+1]),    float(tris[i+2]),
+                        float(tris[i+3]),  float(tris[i+4]),    float(tris[i+5]),
+                        float(tris[i+6]),  float(tris[i+7]),    float(tris[i+8]) };
+        memcpy(b, f, 12*sizeof(float)); // the trailing attribute is left to zero
+    }
+    fwrite(buf.data(), 1, buf.size(), fp);
+    n_tris += uint(tris.size()/9);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void STLStreamWriter::close()
+{
+    if(!fp) return;
+    fseek(fp, 80, SEEK_SET);
+    unsigned int nt = n_tris;
+    fwrite(&nt, sizeof(unsigned int), 1, fp);
+    fclose(fp);
+    fp = nullptr;
+}
+
+}
@@ -0,0 +1,182 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_STREAM_TRIANGLES_H
+#define CINO_STREAM_TRIANGLES_H
+
+#include <cstdio>
+#include <vector>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
+
+namespace cinolib
+{
+
+/* Out-of-core access to meshes that do not fit in memory.
+ *
+ * All the routines in this file operate on triangle soups serialized as flat
+ * vectors of doubles (9 coordinates per triangle: x0 y0 z0 x1 y1 z1 x2 y2 z2),
+ * which are handed to a user defined callback in windows of at most chunk_size
+ * triangles. Peak memory is therefore bounded by the chunk size (plus a vertex
+ * cache for indexed formats), regardless of the size of the input mesh.
+ *
+ * Supported formats are OFF, OBJ, and both ASCII and binary STL. For indexed
+ * formats (OFF/OBJ) vertices are first spilled to a temporary binary file, and
+ * polygons are resolved through a bounded page cache (see OOCVertexArray).
+ * General polygons are fan triangulated.
+ *
+ * Example of usage: compute the total area of a huge mesh
+ *
+ * double area = 0;
+ * stream_triangles("huge.obj", 1000000, [&](const std::vector<double> & tris)
+ * {
+ *     for(size_t i=0; i<tris.size(); i+=9) area += ...
+ * });
+*/
+
+template<class Func>
+CINO_INLINE
+void stream_triangles(const char   * filename,
+                      const uint     chunk_size,
+                      const Func   & func,
+                      const size_t   cache_bytes = 256*1024*1024);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Func>
+CINO_INLINE
+void stream_triangles_OFF(const char   * filename,
+                          const uint     chunk_size,
+                          const Func   & func,
+                          const size_t   cache_bytes = 256*1024*1024);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Func>
+CINO_INLINE
+void stream_triangles_OBJ(const char   * filename,
+                          const uint     chunk_size,
+                          const Func   & func,
+                          const size_t   cache_bytes = 256*1024*1024);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Func>
+CINO_INLINE
+void stream_triangles_STL(const char   * filename,
+                          const uint     chunk_size,
+                          const Func   & func);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// 64 bit safe absolute positioning in (temporary) files
+CINO_INLINE
+int ooc_fseek(FILE * fp, const size_t offset);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Disk backed array of vertex positions. Vertices are appended sequentially
+ * and then accessed randomly through a direct mapped cache of fixed size.
+ * Used by the out-of-core readers to dereference vertex ids of indexed formats
+ * without holding the whole vertex list in memory.
+*/
+
+class OOCVertexArray
+{
+    public:
+
+        explicit OOCVertexArray(const size_t cache_bytes = 256*1024*1024);
+                ~OOCVertexArray();
+
+        // owns an open FILE, hence it cannot be copied
+        OOCVertexArray(const OOCVertexArray &) = delete;
+        OOCVertexArray & operator=(const OOCVertexArray &) = delete;
+
+        void   push_back(const vec3d & p);
+        vec3d  at(const size_t vid);
+        size_t size() const { return n_verts; }
+
+    private:
+
+        void flush();
+
+        static const size_t page_size = 4096; // verts per page
+
+        FILE                           * fp      = nullptr;
+        size_t                           n_verts = 0;
+        std::vector<double>              write_buf;
+        std::vector<std::vector<double>> pages;     // cached pages
+        std::vector<size_t>              page_ids;  // page currently hosted by each cache slot
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Incremental writer for binary STL files. Triangles are appended in chunks
+ * (same serialization used by stream_triangles) and the triangle count in the
+ * header is patched when the file is closed. If per triangle normals are not
+ * provided, they are computed on the fly.
+*/
+
+class STLStreamWriter
+{
+    public:
+
+        explicit STLStreamWriter(const char * filename);
+                ~STLStreamWriter();
+
+        // owns an open FILE, hence it cannot be copied
+        STLStreamWriter(const STLStreamWriter &) = delete;
+        STLStreamWriter & operator=(const STLStreamWriter &) = delete;
+
+        void append(const std::vector<double> & tris);
+        void append(const std::vector<double> & tris, const std::vector<double> & normals);
+        void close();
+
+        uint num_tris() const { return n_tris; }
+
+    private:
+
+        FILE * fp     = nullptr;
+        uint   n_tris = 0;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "stream_triangles.cpp"
+#endif
+
+#endif // CINO_STREAM_TRIANGLES_H
@@ -0,0 +1,188 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/write_CINO.h>
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <assert.h>
+
+namespace cinolib
+{
+
+CINO_INLINE
+CinoBinaryWriter::CinoBinaryWriter(const char * filename, const uint32_t mesh_type)
+    : mesh_type(mesh_type)
+{
+    fp = fopen(filename, "wb");
+    if(!fp)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write_CINO() : couldn't save file " << filename << std::endl;
+        exit(-1);
+    }
+    // the header is written (again) in close(), once the table offset is known
+    CinoBinaryHeader h;
+    memset(&h, 0, sizeof(CinoBinaryHeader));
+    fwrite(&h, sizeof(CinoBinaryHeader), 1, fp);
+    pos = sizeof(CinoBinaryHeader);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+CinoBinaryWriter::~CinoBinaryWriter()
+{
+    close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void CinoBinaryWriter::write(const std::string & tag, const void * data, const size_t bytes)
+{
+    assert(fp);
+    assert(tag.size()<=16);
+
+    CinoBinarySection s;
+    memset(&s, 0, sizeof(CinoBinarySection));
+    memcpy(s.tag, tag.c_str(), tag.size());
+    s.offset   = pos;
+    s.bytes    = bytes;
+    s.checksum = fnv1a_checksum(data, bytes);
+    table.push_back(s);
+
+    if(bytes>0) fwrite(data, 1, bytes, fp);
+    pos += bytes;
+
+    // keep sections 8-bytes aligned, so that mapped data can be accessed directly
+    static const char pad[8] = {0,0,0,0,0,0,0,0};
+    size_t n_pad = (8 - pos%8)%8;
+    fwrite(pad, 1, n_pad, fp);
+    pos += n_pad;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void CinoBinaryWriter::close()
+{
+    if(!fp) return;
+
+    fwrite(table.data(), sizeof(CinoBinarySection), table.size(), fp);
+
+    CinoBinaryHeader h;
+    memset(&h, 0, sizeof(CinoBinaryHeader));
+    memcpy(h.magic, "CINOMESH", 8);
+    h.version      = CINO_BINARY_VERSION;
+    h.mesh_type    = mesh_type;
+    h.n_sections   = table.size();
+    h.table_offset = pos;
+    rewind(fp);
+    fwrite(&h, sizeof(CinoBinaryHeader), 1, fp);
+
+    fclose(fp);
+    fp = nullptr;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+void CinoBinaryWriter::write(const std::string & tag, const std::vector<T> & v)
+{
+    write(tag, v.data(), v.size()*sizeof(T));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+void CinoBinaryWriter::write_nested(const std::string & tag, const std::vector<std::vector<T>> & v)
+{
+    std::vector<uint64_t> off;
+    off.reserve(v.size()+1);
+    off.push_back(0);
+    for(const auto & l : v) off.push_back(off.back() + l.size());
+
+    std::vector<T> val;
+    val.reserve(off.back());
+    for(const auto & l : v) val.insert(val.end(), l.begin(), l.end());
+
+    write(tag + ".o", off);
+    write(tag, val);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void CinoBinaryWriter::write_nested(const std::string & tag, const std::vector<std::vector<bool>> & v)
+{
+    std::vector<std::vector<uint8_t>> tmp(v.size());
+    for(size_t i=0; i<v.size(); ++i) tmp[i].assign(v[i].begin(), v[i].end());
+    write_nested(tag, tmp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void CinoBinaryWriter::write(const std::string & tag, const std::vector<vec3d> & v)
+{
+    std::vector<double> tmp(v.size()*3);
+    for(size_t i=0; i<v.size(); ++i)
+    {
+        tmp[3*i  ] = v[i].x();
+        tmp[3*i+1] = v[i].y();
+        tmp[3*i+2] = v[i].z();
+    }
+    write(tag, tmp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void CinoBinaryWriter::write(const std::string & tag, const std::vector<Color> & v)
+{
+    std::vector<float> tmp(v.size()*4);
+    for(size_t i=0; i<v.size(); ++i)
+    {
+        tmp[4*i  ] = v[i].r;
+        tmp[4*i+1] = v[i].g;
+        tmp[4*i+2] = v[i].b;
+        tmp[4*i+3] = v[i].a;
+    }
+    write(tag, tmp);
+}
+
+}
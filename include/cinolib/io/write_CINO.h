@@ -0,0 +1,82 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_WRITE_CINO_H
+#define CINO_WRITE_CINO_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/io/read_CINO.h>
+
+namespace cinolib
+{
+
+// see read_CINO.h for a description of the file format
+//
+class CinoBinaryWriter
+{
+    public:
+
+        explicit CinoBinaryWriter(const char * filename, const uint32_t mesh_type);
+                ~CinoBinaryWriter();
+
+        void write(const std::string & tag, const void * data, const size_t bytes);
+        void close();
+
+        template<typename T> void write       (const std::string & tag, const std::vector<T>              & v);
+        template<typename T> void write_nested(const std::string & tag, const std::vector<std::vector<T>> & v);
+                             void write_nested(const std::string & tag, const std::vector<std::vector<bool>> & v);
+                             void write       (const std::string & tag, const std::vector<vec3d>          & v);
+                             void write       (const std::string & tag, const std::vector<Color>          & v);
+
+    private:
+
+        FILE                          * fp = nullptr;
+        uint32_t                        mesh_type;
+        uint64_t                        pos = 0;
+        std::vector<CinoBinarySection>  table;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "write_CINO.cpp"
+#endif
+
+#endif // CINO_WRITE_CINO_H
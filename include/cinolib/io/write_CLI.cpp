@@ -0,0 +1,120 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/write_CLI.h>
+#include <iostream>
+#include <algorithm>
+
+namespace cinolib
+{
+
+CINO_INLINE
+void write_CLI(const char                                         * filename,
+               const std::vector<std::vector<std::vector<vec3d>>> & internal_polylines,
+               const std::vector<std::vector<std::vector<vec3d>>> & external_polylines,
+               const std::vector<std::vector<std::vector<vec3d>>> & open_polylines,
+               const std::vector<std::vector<std::vector<vec3d>>> & hatches,
+               const double                                         units)
+{
+    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
+
+    FILE *fp = fopen(filename, "w");
+
+    if(!fp)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write_CLI() : couldn't save file " << filename << std::endl;
+        exit(-1);
+    }
+
+    size_t n_layers = std::max(std::max(internal_polylines.size(), external_polylines.size()),
+                               std::max(open_polylines.size(),     hatches.size()));
+
+    fprintf(fp, "$$HEADERSTART\n");
+    fprintf(fp, "$$ASCII\n");
+    fprintf(fp, "$$UNITS/%.17g\n", units);
+    fprintf(fp, "$$VERSION/200\n");
+    fprintf(fp, "$$LAYERS/%zu\n", n_layers);
+    fprintf(fp, "$$HEADEREND\n");
+    fprintf(fp, "$$GEOMETRYSTART\n");
+
+    // CLI polyline directions: 0 = clockwise (internal), 1 = counter-clockwise (external), 2 = open
+    auto write_polyline = [&](const std::vector<vec3d> & pl, const uint dir, const uint id)
+    {
+        if(pl.empty()) return;
+        bool closed = (dir!=2);
+        fprintf(fp, "$$POLYLINE/%u,%u,%zu", id, dir, pl.size() + (closed ? 1 : 0));
+        for(const vec3d & p : pl) fprintf(fp, ",%.17g,%.17g", p.x(), p.y());
+        if(closed) fprintf(fp, ",%.17g,%.17g", pl.front().x(), pl.front().y()); // CLI closed loops repeat the first point
+        fprintf(fp, "\n");
+    };
+
+    double z = 0;
+    for(size_t l=0; l<n_layers; ++l)
+    {
+        // fetch the layer height from the first available point
+        bool found = false;
+        for(auto * layers : { &external_polylines, &internal_polylines, &open_polylines, &hatches })
+        {
+            if(found || l>=layers->size()) continue;
+            for(const auto & pl : layers->at(l))
+            {
+                if(!pl.empty()) { z = pl.front().z(); found = true; break; }
+            }
+        }
+        fprintf(fp, "$$LAYER/%.17g\n", z);
+
+        if(l<external_polylines.size()) for(const auto & pl : external_polylines.at(l)) write_polyline(pl, 1, 1);
+        if(l<internal_polylines.size()) for(const auto & pl : internal_polylines.at(l)) write_polyline(pl, 0, 1);
+        if(l<open_polylines.size())     for(const auto & pl : open_polylines.at(l))     write_polyline(pl, 2, 1);
+        if(l<hatches.size())
+        {
+            for(const auto & h : hatches.at(l))
+            {
+                if(h.size()<2) continue;
+                fprintf(fp, "$$HATCHES/1,%zu", h.size()/2);
+                for(size_t i=0; i+1<h.size(); i+=2)
+                {
+                    fprintf(fp, ",%.17g,%.17g,%.17g,%.17g", h[i].x(), h[i].y(), h[i+1].x(), h[i+1].y());
+                }
+                fprintf(fp, "\n");
+            }
+        }
+    }
+
+    fprintf(fp, "$$GEOMETRYEND\n");
+    fclose(fp);
+}
+
+}
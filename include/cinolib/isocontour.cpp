@@ -63,9 +63,9 @@ Isocontour<M,V,E,P>::Isocontour(AbstractPolygonMesh<M,V,E,P> & m, double iso_val
         uint   vid1 = m.poly_tessellation(pid).at(3*i+1);
         uint   vid2 = m.poly_tessellation(pid).at(3*i+2);
 
-        double f0   = m.vert_data(vid0).uvw[0];
-        double f1   = m.vert_data(vid1).uvw[0];
-        double f2   = m.vert_data(vid2).uvw[0];
+        double f0   = m.vert_uvw(vid0)[0];
+        double f1   = m.vert_uvw(vid1)[0];
+        double f2   = m.vert_uvw(vid2)[0];
 
         // There are seven possible cases:
         // 1) the curve coincides with (v0,v1)
@@ -133,8 +133,8 @@ std::vector<uint> Isocontour<M,V,E,P>::tessellate(Trimesh<M,V,E,P> & m) const
 
     for(uint eid=0; eid<m.num_edges(); ++eid)
     {
-        double f0 = m.vert_data(m.edge_vert_id(eid,0)).uvw[0];
-        double f1 = m.vert_data(m.edge_vert_id(eid,1)).uvw[0];
+        double f0 = m.vert_uvw(m.edge_vert_id(eid,0))[0];
+        double f1 = m.vert_uvw(m.edge_vert_id(eid,1))[0];
 
         if (is_into_interval<double>(iso_value, f0, f1))
         {
@@ -147,7 +147,7 @@ std::vector<uint> Isocontour<M,V,E,P>::tessellate(Trimesh<M,V,E,P> & m) const
     for(auto e : edges_to_split)
     {
         uint vid = m.edge_split(e.first, e.second);
-        m.vert_data(vid).uvw[0] = iso_value;
+        m.vert_uvw(vid)[0] = iso_value;
         new_vids.push_back(vid);
     }
 
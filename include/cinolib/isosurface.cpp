@@ -73,8 +73,8 @@ std::vector<uint> Isosurface<M,V,E,F,P>::tessellate(Tetmesh<M,V,E,F,P> & m) cons
     {
         uint   v0 = m.edge_vert_id(eid,0);
         uint   v1 = m.edge_vert_id(eid,1);
-        double f0 = m.vert_data(v0).uvw[0];
-        double f1 = m.vert_data(v1).uvw[0];
+        double f0 = m.vert_uvw(v0)[0];
+        double f1 = m.vert_uvw(v1)[0];
         if(is_into_interval<double>(iso_value, f0, f1)) splits.emplace_back(v0,v1);
     }
 
@@ -86,12 +86,12 @@ std::vector<uint> Isosurface<M,V,E,F,P>::tessellate(Tetmesh<M,V,E,F,P> & m) cons
         int  eid = m.edge_id(v0,v1);
         assert(eid>=0);
         if(m.edge_vert_id(eid,0)==v1) std::swap(v0,v1);
-        double f0 = m.vert_data(v0).uvw[0];
-        double f1 = m.vert_data(v1).uvw[0];
+        double f0 = m.vert_uvw(v0)[0];
+        double f1 = m.vert_uvw(v1)[0];
         assert(is_into_interval<double>(iso_value, f0, f1));
         double alpha = std::fabs(iso_value - f0)/fabs(f1 - f0);
         uint vid = m.edge_split(eid, alpha);
-        m.vert_data(vid).uvw[0] = iso_value;
+        m.vert_uvw(vid)[0] = iso_value;
         new_vids.push_back(vid);
     }
 
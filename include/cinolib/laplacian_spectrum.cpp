@@ -0,0 +1,609 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/laplacian_spectrum.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/min_max_inf.h>
+#include <cinolib/io/read_CINO.h>
+#include <cinolib/io/write_CINO.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <random>
+
+namespace cinolib
+{
+
+CINO_INLINE
+LaplacianSpectrum::LaplacianSpectrum(const Eigen::SparseMatrix<double> & L,
+                                     const Eigen::SparseMatrix<double> & M,
+                                     const uint                          band_size,
+                                     const double                        tolerance)
+    : nv(uint(L.rows()))
+    , band_size(std::max(band_size,1u))
+    , tolerance(tolerance)
+{
+    assert(L.rows()==L.cols());
+    assert(M.rows()==L.rows() && M.cols()==L.cols());
+
+    Eigen::SparseMatrix<double> K_in = -L;
+    Eigen::SparseMatrix<double> M_in =  M;
+    K_in.makeCompressed();
+    M_in.makeCompressed();
+
+    std::vector<uint64_t> h =
+    {
+        uint64_t(nv),
+        fnv1a_checksum(K_in.valuePtr(),      sizeof(double)*size_t(K_in.nonZeros())),
+        fnv1a_checksum(K_in.innerIndexPtr(), sizeof(int)   *size_t(K_in.nonZeros())),
+        fnv1a_checksum(K_in.outerIndexPtr(), sizeof(int)   *size_t(K_in.outerSize()+1)),
+        fnv1a_checksum(M_in.valuePtr(),      sizeof(double)*size_t(M_in.nonZeros())),
+        fnv1a_checksum(M_in.innerIndexPtr(), sizeof(int)   *size_t(M_in.nonZeros())),
+        fnv1a_checksum(M_in.outerIndexPtr(), sizeof(int)   *size_t(M_in.outerSize()+1)),
+    };
+    fingerprint = fnv1a_checksum(h.data(), sizeof(uint64_t)*h.size());
+
+    // K - sigma M has the same pattern for any sigma, hence the fill reducing
+    // ordering is computed once, and matrices are permuted accordingly
+    Eigen::SparseMatrix<double> S = K_in + M_in;
+    Eigen::PermutationMatrix<Eigen::Dynamic,Eigen::Dynamic,int> P_inv;
+    Eigen::AMDOrdering<int> amd;
+    amd(S, P_inv);
+    P  = P_inv.inverse();
+    K  = K_in.twistedBy(P);
+    MM = M_in.twistedBy(P);
+
+    // K is singular (constant functions are in its kernel), hence the first band is
+    // centered slightly below zero. The ratios between the diagonals of K and M give
+    // the order of magnitude of the largest eigenvalues
+    double scale = 0;
+    uint   count = 0;
+    Eigen::VectorXd dK = K_in.diagonal();
+    Eigen::VectorXd dM = M_in.diagonal();
+    for(uint i=0; i<nv; ++i)
+    {
+        if(dM[i]>0) { scale += dK[i]/dM[i]; ++count; }
+    }
+    sigma0  = (count>0 && scale>0) ? -1e-6*scale/count : -1e-6;
+    covered = sigma0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool LaplacianSpectrum::compute(const uint nev)
+{
+    uint n = std::min(nev, nv);
+    if(evals.size()>=n) return true;
+
+    if(nv<=1000)
+    {
+        solve_dense();
+        return true;
+    }
+
+    const uint max_rounds = 32;
+    for(uint round=0; evals.size()<n; ++round)
+    {
+        if(round==max_rounds) return false;
+
+        std::vector<double> shifts = next_shifts(n);
+        std::vector<Band>   bands(shifts.size());
+        uint seed = n_bands;
+        n_bands += uint(shifts.size());
+        PARALLEL_FOR(0, uint(shifts.size()), 2, [&](const uint i)
+        {
+            bands.at(i) = solve_band(shifts.at(i), band_size, seed+i);
+        });
+        for(Band & b : bands) pending.push_back(std::move(b));
+        merge_bands();
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool LaplacianSpectrum::compute_band(const double sigma, const uint nev, std::vector<double> & evals, Eigen::MatrixXd & evecs)
+{
+    uint n = std::min(nev, nv);
+
+    if(nv<=1000)
+    {
+        solve_dense();
+        std::vector<uint> ids(nv);
+        std::iota(ids.begin(), ids.end(), 0);
+        std::partial_sort(ids.begin(), ids.begin()+n, ids.end(), [&](const uint a, const uint b)
+        {
+            return std::fabs(this->evals.at(a)-sigma) < std::fabs(this->evals.at(b)-sigma);
+        });
+        ids.resize(n);
+        std::sort(ids.begin(), ids.end());
+        evals.resize(n);
+        evecs.resize(nv,n);
+        for(uint i=0; i<n; ++i)
+        {
+            evals.at(i)  = this->evals.at(ids.at(i));
+            evecs.col(i) = this->evecs.col(ids.at(i));
+        }
+        return true;
+    }
+
+    Band b = solve_band(sigma, n, n_bands++);
+    evals.swap(b.evals);
+    evecs.swap(b.evecs);
+    return evals.size()==n;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void LaplacianSpectrum::solve_shifted(const double sigma, const Eigen::VectorXd & b, Eigen::VectorXd & x)
+{
+    const ShiftInvertSolver & F = factorization(sigma);
+    assert(F.info()==Eigen::Success);
+    Eigen::VectorXd y = F.solve(P * b);
+    x = P.transpose() * y;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void LaplacianSpectrum::release_factorizations()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    factorizations.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void LaplacianSpectrum::save(const char * filename) const
+{
+    std::vector<uint64_t> header = { fingerprint, uint64_t(nv), uint64_t(evals.size()) };
+    std::vector<double>   range  = { covered };
+
+    CinoBinaryWriter w(filename, 0); // not a mesh
+    w.write("SPECTRUM_HEADER", header);
+    w.write("SPECTRUM_RANGE",  range);
+    w.write("EIGENVALUES",     evals);
+    w.write("EIGENVECTORS",    evecs.data(), sizeof(double)*size_t(evecs.size()));
+    w.close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool LaplacianSpectrum::load(const char * filename)
+{
+    FILE *fp = fopen(filename, "rb");
+    if(!fp) return false;
+    fclose(fp);
+
+    CinoBinaryReader r(filename);
+    std::vector<uint64_t> header;
+    std::vector<double>   range;
+    std::vector<double>   tmp_evals;
+    if(!r.read("SPECTRUM_HEADER", header) || header.size()!=3) return false;
+    if(header.at(0)!=fingerprint || header.at(1)!=nv)          return false;
+    if(!r.read("SPECTRUM_RANGE", range) || range.size()!=1)    return false;
+    if(!r.read("EIGENVALUES", tmp_evals) || tmp_evals.size()!=header.at(2)) return false;
+
+    size_t bytes;
+    const void * data = r.section("EIGENVECTORS", bytes);
+    if(data==nullptr || bytes!=sizeof(double)*nv*tmp_evals.size()) return false;
+
+    evals.swap(tmp_evals);
+    evecs.resize(nv, evals.size());
+    if(bytes>0) memcpy(evecs.data(), data, bytes);
+    covered = range.front();
+    pending.clear();
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// eigenvectors are defined up to their sign. To make the output reproducible,
+// the entry with the largest magnitude of each eigenvector is made positive
+CINO_INLINE
+void LaplacianSpectrum::normalize_signs(Eigen::MatrixXd & evecs)
+{
+    for(int i=0; i<evecs.cols(); ++i)
+    {
+        Eigen::Index id;
+        evecs.col(i).cwiseAbs().maxCoeff(&id);
+        if(evecs(id,i)<0) evecs.col(i) *= -1;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Block Lanczos (with full re-orthogonalization in the M-inner product) on the operator
+// A = (K - sigma M)^-1 M, which is self adjoint w.r.t. the M-inner product. The Ritz values
+// theta of A with largest magnitude correspond to the eigenvalues lambda = sigma + 1/theta
+// closest to sigma. Blocks make the solver robust to multiple eigenvalues, which are
+// common in Laplacian spectra (e.g. of symmetric shapes). When the basis is full, the
+// solver is thick restarted from the Ritz vectors closest to sigma
+//
+CINO_INLINE
+LaplacianSpectrum::Band LaplacianSpectrum::solve_band(const double sigma, const uint nev, const uint seed)
+{
+    Band band;
+    band.sigma = sigma;
+    band.lo    = sigma;
+    band.hi    = sigma;
+    band.evecs.resize(nv,0);
+
+    const ShiftInvertSolver & F = factorization(sigma);
+    if(F.info()!=Eigen::Success) return band;
+
+    const uint max_restarts = 100;
+
+    uint k       = std::min(nev, nv);
+    uint b       = std::min(k, 8u);                          // block size
+    uint max_dim = std::min(nv, 2*k + 2*b);                  // max size of the Krylov basis
+    uint n_keep  = std::min(k + b, max_dim - b);             // Ritz vectors kept at restarts
+    uint n_restarts = 0;
+
+    std::mt19937                     rng(seed);
+    std::normal_distribution<double> gauss;
+    auto random_vector = [&](Eigen::Ref<Eigen::VectorXd> x)
+    {
+        for(uint i=0; i<nv; ++i) x[i] = gauss(rng);
+    };
+
+    Eigen::MatrixXd V(nv, max_dim);                             // M-orthonormal basis of the Krylov space
+    Eigen::MatrixXd H = Eigen::MatrixXd::Zero(max_dim,max_dim); // A projected onto V
+    uint m = 0;
+
+    // M-orthonormalizes the columns of X against the current basis and among themselves.
+    // Columns that are (numerically) linearly dependent are replaced by random vectors
+    auto orthonormalize = [&](Eigen::MatrixXd & X)
+    {
+        for(int pass=0; pass<2 && m>0; ++pass)
+        {
+            X -= V.leftCols(m) * (V.leftCols(m).transpose() * (MM * X));
+        }
+        for(int j=0; j<X.cols(); ++j)
+        {
+            double norm0 = std::sqrt(X.col(j).dot(MM * X.col(j)));
+            for(int attempt=0; attempt<4; ++attempt)
+            {
+                for(int pass=0; pass<2; ++pass)
+                {
+                    Eigen::VectorXd Mx = MM * X.col(j);
+                    if(attempt>0 && m>0) X.col(j) -= V.leftCols(m) * (V.leftCols(m).transpose() * Mx);
+                    if(j>0)              X.col(j) -= X.leftCols(j) * (X.leftCols(j).transpose() * Mx);
+                }
+                double norm = std::sqrt(X.col(j).dot(MM * X.col(j)));
+                if(norm>1e-8*norm0 && norm>0)
+                {
+                    X.col(j) /= norm;
+                    break;
+                }
+                random_vector(X.col(j));
+                norm0 = std::sqrt(X.col(j).dot(MM * X.col(j)));
+            }
+        }
+    };
+
+    Eigen::MatrixXd X(nv, b);
+    for(uint j=0; j<b; ++j) random_vector(X.col(j));
+    orthonormalize(X);
+
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> ritz;
+    std::vector<uint> wanted;    // Ritz pairs closest to sigma
+    std::vector<bool> converged;
+    while(true)
+    {
+        V.middleCols(m,b) = X;
+        Eigen::MatrixXd W  = F.solve(MM * X);
+        Eigen::MatrixXd MW = MM * W;
+        H.block(0,m,m+b,b) = V.leftCols(m+b).transpose() * MW;
+        H.block(m,0,b,m)   = H.block(0,m,m,b).transpose();
+        H.block(m,m,b,b)   = 0.5 * (H.block(m,m,b,b) + H.block(m,m,b,b).transpose()).eval();
+
+        // W = V H + R: only the last block contributes to the residuals of the Ritz pairs
+        Eigen::MatrixXd R = W - V.leftCols(m+b) * H.block(0,m,m+b,b);
+        m += b;
+
+        if(m>=k || m+b>max_dim)
+        {
+            ritz.compute(H.topLeftCorner(m,m));
+            const Eigen::VectorXd & theta = ritz.eigenvalues();
+
+            wanted.resize(m);
+            std::iota(wanted.begin(), wanted.end(), 0);
+            std::sort(wanted.begin(), wanted.end(), [&](const uint i, const uint j)
+            {
+                return std::fabs(theta[i]) > std::fabs(theta[j]);
+            });
+            wanted.resize(std::min(k,m));
+
+            Eigen::MatrixXd RtMR = R.transpose() * (MM * R);
+            converged.assign(wanted.size(), false);
+            bool done = true;
+            for(uint i=0; i<wanted.size(); ++i)
+            {
+                Eigen::VectorXd s = ritz.eigenvectors().col(wanted.at(i)).tail(b);
+                double res = std::sqrt(std::max(0.0, s.dot(RtMR * s)));
+                converged.at(i) = (res <= tolerance * std::fabs(theta[wanted.at(i)]));
+                if(!converged.at(i)) done = false;
+            }
+            if(done) break;
+        }
+
+        if(m+b>max_dim)
+        {
+            if(n_restarts==max_restarts) break;
+            ++n_restarts;
+
+            // thick restart: A Y = Y Theta + R C for the Ritz vectors Y, hence the
+            // Krylov relation holds for the basis [Y,R], with H = diag(Theta)
+            std::vector<uint> keep(m);
+            std::iota(keep.begin(), keep.end(), 0);
+            std::sort(keep.begin(), keep.end(), [&](const uint i, const uint j)
+            {
+                return std::fabs(ritz.eigenvalues()[i]) > std::fabs(ritz.eigenvalues()[j]);
+            });
+            keep.resize(n_keep);
+            Eigen::MatrixXd S(m, n_keep);
+            for(uint i=0; i<n_keep; ++i) S.col(i) = ritz.eigenvectors().col(keep.at(i));
+            V.leftCols(n_keep) = (V.leftCols(m) * S).eval();
+            H.setZero();
+            for(uint i=0; i<n_keep; ++i) H(i,i) = ritz.eigenvalues()[keep.at(i)];
+            m = n_keep;
+        }
+
+        X = R;
+        orthonormalize(X);
+    }
+
+    // the band can be trusted up to the first Ritz pair that did not converge
+    // (the farthest pair is excluded too, as it may be part of a cluster that
+    // exceeds the band)
+    double radius = 0;
+    for(uint i=0; i<wanted.size() && converged.at(i); ++i)
+    {
+        radius = std::fabs(1.0/ritz.eigenvalues()[wanted.at(i)]);
+    }
+    radius   *= 1.0 - 1e-6;
+    band.lo   = sigma - radius;
+    band.hi   = sigma + radius;
+
+    std::vector<std::pair<double,uint>> pairs;
+    for(uint i=0; i<wanted.size(); ++i)
+    {
+        if(converged.at(i)) pairs.push_back(std::make_pair(sigma + 1.0/ritz.eigenvalues()[wanted.at(i)], wanted.at(i)));
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    Eigen::MatrixXd S(m, pairs.size());
+    band.evals.resize(pairs.size());
+    for(uint i=0; i<pairs.size(); ++i)
+    {
+        band.evals.at(i) = pairs.at(i).first;
+        S.col(i)         = ritz.eigenvectors().col(pairs.at(i).second);
+    }
+    Eigen::MatrixXd Y = V.leftCols(m) * S;
+    band.evecs = P.transpose() * Y;
+    normalize_signs(band.evecs);
+    return band;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void LaplacianSpectrum::solve_dense()
+{
+    if(covered==max_double) return; // already done
+
+    Eigen::MatrixXd Kd = K;
+    Eigen::MatrixXd Md = MM;
+    Eigen::GeneralizedSelfAdjointEigenSolver<Eigen::MatrixXd> eig(Kd, Md);
+    assert(eig.info()==Eigen::Success);
+
+    evals.assign(eig.eigenvalues().data(), eig.eigenvalues().data() + nv);
+    evecs = P.transpose() * eig.eigenvectors();
+    normalize_signs(evecs);
+    covered = max_double;
+    pending.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Appends to the spectrum the eigenpairs of the pending bands, for as long as bands
+// overlap with the range already covered. Consecutive bands are cut at the widest gap
+// between eigenvalues in their overlap, to avoid splitting clusters of (almost) equal
+// eigenvalues between different bands
+//
+CINO_INLINE
+void LaplacianSpectrum::merge_bands()
+{
+    while(true)
+    {
+        int curr = -1;
+        for(uint i=0; i<pending.size(); ++i)
+        {
+            const Band & b = pending.at(i);
+            if(b.lo<covered && b.hi>covered && (curr<0 || b.hi>pending.at(curr).hi)) curr = int(i);
+        }
+        if(curr<0) break;
+        const Band & b = pending.at(curr);
+
+        int next = -1;
+        for(uint i=0; i<pending.size(); ++i)
+        {
+            const Band & c = pending.at(i);
+            if(int(i)!=curr && c.lo<b.hi && c.hi>b.hi && (next<0 || c.hi>pending.at(next).hi)) next = int(i);
+        }
+
+        double cut = b.hi;
+        if(next>=0)
+        {
+            double prev = std::max(covered, pending.at(next).lo);
+            double gap  = 0;
+            for(uint i=0; i<=b.evals.size(); ++i)
+            {
+                double val = (i<b.evals.size()) ? b.evals.at(i) : b.hi;
+                if(val<=prev) continue;
+                if(val>b.hi)  val = b.hi;
+                if(val-prev>gap)
+                {
+                    gap = val-prev;
+                    cut = 0.5*(val+prev);
+                }
+                prev = val;
+                if(val==b.hi) break;
+            }
+        }
+
+        std::vector<uint> ids;
+        for(uint i=0; i<b.evals.size(); ++i)
+        {
+            if(b.evals.at(i)>=covered && b.evals.at(i)<cut) ids.push_back(i);
+        }
+        uint n = uint(evals.size());
+        evecs.conservativeResize(nv, n+ids.size());
+        for(uint i=0; i<ids.size(); ++i)
+        {
+            evals.push_back(b.evals.at(ids.at(i)));
+            evecs.col(n+i) = b.evecs.col(ids.at(i));
+        }
+        covered = cut;
+
+        pending.erase(std::remove_if(pending.begin(), pending.end(), [&](const Band & b)
+        {
+            return b.hi<=covered;
+        }), pending.end());
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Shifts for the next round of bands: if a band beyond the covered range is already
+// available, the gap in between is filled. Otherwise, enough bands to reach nev are
+// placed by extrapolating the distribution of the eigenvalues computed so far. Bands
+// are spaced by 2/3 of their size, so that consecutive bands overlap
+//
+CINO_INLINE
+std::vector<double> LaplacianSpectrum::next_shifts(const uint nev) const
+{
+    if(evals.empty()) return { sigma0 };
+
+    uint   stride = std::max(2*band_size/3, 1u);
+    uint   n0     = uint(evals.size());
+    double slope  = std::max(predicted_eigenvalue(n0+1) - predicted_eigenvalue(n0), 1e-12*std::fabs(sigma0));
+
+    const Band * next = nullptr;
+    for(const Band & b : pending)
+    {
+        if(b.lo>=covered && (next==nullptr || b.lo<next->lo)) next = &b;
+    }
+
+    std::vector<double> shifts;
+    if(next!=nullptr)
+    {
+        double gap = next->lo - covered;
+        uint   nb  = std::max(1u, uint(std::ceil(gap/slope/stride)));
+        for(uint i=0; i<nb; ++i) shifts.push_back(covered + gap*(i+0.5)/nb);
+    }
+    else
+    {
+        uint nb = std::max(1u, (nev-n0+stride-1)/stride);
+        for(uint i=0; i<nb; ++i) shifts.push_back(std::max(covered, predicted_eigenvalue(n0 + (i+0.5)*stride)));
+    }
+    return shifts;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Weyl's law states that the k-th eigenvalue grows as k (surfaces) or k^(2/3) (volumes).
+// The growth rate p is fitted to the eigenvalues computed so far, and the prediction is
+// anchored to the last one: lambda_k = lambda_n * (k/n)^p
+//
+CINO_INLINE
+double LaplacianSpectrum::predicted_eigenvalue(const double k) const
+{
+    assert(!evals.empty());
+    double last = evals.back();
+    double n    = double(evals.size());
+    if(last<=0) return covered + (k-n) * (covered-sigma0) / n;
+
+    double sx=0, sy=0, sxx=0, sxy=0;
+    uint   count=0;
+    for(uint i=0; i<evals.size(); ++i)
+    {
+        if(evals.at(i)<=1e-8*last) continue; // kernel
+        double x = std::log(double(i+1));
+        double y = std::log(evals.at(i));
+        sx  += x;
+        sy  += y;
+        sxx += x*x;
+        sxy += x*y;
+        ++count;
+    }
+    double p = 1.0;
+    if(count>=2 && count*sxx-sx*sx>0)
+    {
+        p = (count*sxy - sx*sy) / (count*sxx - sx*sx);
+        p = std::min(std::max(p, 0.5), 2.0);
+    }
+    return last * std::pow(k/n, p);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+const LaplacianSpectrum::ShiftInvertSolver & LaplacianSpectrum::factorization(const double sigma)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = factorizations.find(sigma);
+        if(it!=factorizations.end()) return *it->second;
+    }
+
+    // factorize outside of the lock, so that bands can do it in parallel
+    std::unique_ptr<ShiftInvertSolver> F(new ShiftInvertSolver);
+    Eigen::SparseMatrix<double> A = K - sigma*MM;
+    F->compute(A);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = factorizations.insert(std::make_pair(sigma, std::move(F))).first;
+    return *it->second;
+}
+
+}
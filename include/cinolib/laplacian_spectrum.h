@@ -0,0 +1,174 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_LAPLACIAN_SPECTRUM_H
+#define CINO_LAPLACIAN_SPECTRUM_H
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <stdint.h>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/symbols.h>
+#include <cinolib/laplacian.h>
+#include <cinolib/vertex_mass.h>
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+namespace cinolib
+{
+
+/* Laplace-Beltrami spectrum engine. It computes the eigenpairs with smallest eigenvalues
+ * of the generalized eigenproblem
+ *
+ *                  K x = lambda M x
+ *
+ * where K = -L is the stiffness matrix (L being the negative semi definite Laplacian
+ * returned by laplacian()) and M is the mass matrix. Eigenvectors are M-orthonormal,
+ * therefore they form the Manifold Harmonics Basis described in
+ *
+ * Spectral Geometry Processing with Manifold Harmonics
+ * BRUNO VALLET and BRUNO LEVY
+ * Computer Graphics Forum, 2008
+ *
+ * The spectrum is computed band by band. Each band extracts the eigenpairs closest to
+ * a shift sigma with a block Lanczos solver applied to (K - sigma M)^-1 M, hence it does
+ * not depend on external eigensolvers. After the first band, shifts are placed by
+ * extrapolating the distribution of the eigenvalues found so far, and all the bands of
+ * a round are computed in parallel. Overlapping bands are merged, and gaps left by bad
+ * predictions are filled in the following rounds.
+ *
+ * The engine keeps its state across calls: computing more eigenpairs extends the bands
+ * already available. The fill reducing ordering of K - sigma M does not depend on sigma,
+ * and is computed once. Numeric factorizations are cached per shift, and can be reused
+ * (e.g. with solve_shifted) until release_factorizations() is called. Computed bases can
+ * be saved to disk and loaded back, provided the matrices they refer to did not change.
+ *
+ * Small problems (up to 1000 dofs) are solved with a dense solver.
+*/
+
+class LaplacianSpectrum
+{
+    public:
+
+        explicit LaplacianSpectrum(const Eigen::SparseMatrix<double> & L,  // Laplacian (negative semi definite)
+                                   const Eigen::SparseMatrix<double> & M,  // mass matrix
+                                   const uint                          band_size = 64,
+                                   const double                        tolerance = 1e-8);
+
+        template<class M, class V, class E, class P>
+        explicit LaplacianSpectrum(const AbstractMesh<M,V,E,P> & m,
+                                   const int                     laplacian_mode = COTANGENT,
+                                   const uint                    band_size      = 64,
+                                   const double                  tolerance      = 1e-8)
+        : LaplacianSpectrum(laplacian(m, laplacian_mode), mass_matrix(m), band_size, tolerance) {}
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // makes sure that (at least) the first nev eigenpairs are available. Returns
+        // false if the solver did not converge within the maximum number of rounds
+        bool compute(const uint nev);
+
+        // the nev eigenpairs closest to sigma (sorted by increasing eigenvalue).
+        // Eigenpairs that did not converge are discarded
+        bool compute_band(const double sigma, const uint nev, std::vector<double> & evals, Eigen::MatrixXd & evecs);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint                        size()         const { return uint(evals.size()); }
+        const std::vector<double> & eigenvalues()  const { return evals; }
+        const Eigen::MatrixXd     & eigenvectors() const { return evecs; } // one per column
+        double                      eigenvalue (const uint i) const { return evals.at(i); }
+        Eigen::VectorXd             eigenvector(const uint i) const { return evecs.col(i); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // solves (K - sigma M) x = b, using (and caching) the factorization for sigma
+        void solve_shifted(const double sigma, const Eigen::VectorXd & b, Eigen::VectorXd & x);
+        void release_factorizations();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // spectra are stored in the .cino binary container (see io/read_CINO.h),
+        // together with a fingerprint of K and M. Load fails (returning false)
+        // if the file does not exist, or if it was computed for other matrices
+        void save(const char * filename) const;
+        bool load(const char * filename);
+
+    protected:
+
+        typedef Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>,Eigen::Lower,Eigen::NaturalOrdering<int>> ShiftInvertSolver;
+
+        struct Band
+        {
+            double              sigma;
+            double              lo, hi;  // all the eigenvalues in (lo,hi) are in the band
+            std::vector<double> evals;   // sorted by increasing eigenvalue
+            Eigen::MatrixXd     evecs;   // in the original vertex ordering
+        };
+
+        static void               normalize_signs(Eigen::MatrixXd & evecs);
+        Band                      solve_band(const double sigma, const uint nev, const uint seed);
+        void                      solve_dense();
+        void                      merge_bands();
+        std::vector<double>       next_shifts(const uint nev) const;
+        double                    predicted_eigenvalue(const double k) const;
+        const ShiftInvertSolver & factorization(const double sigma);
+
+        uint                                                      nv;
+        uint                                                      band_size;
+        double                                                    tolerance;
+        double                                                    sigma0;       // shift of the first band (slightly negative)
+        uint64_t                                                  fingerprint;  // of K and M, to validate saved spectra
+        Eigen::SparseMatrix<double>                               K, MM;        // permuted with a fill reducing ordering
+        Eigen::PermutationMatrix<Eigen::Dynamic,Eigen::Dynamic,int> P;
+        std::vector<double>                                       evals;
+        Eigen::MatrixXd                                           evecs;
+        double                                                    covered;      // all the eigenvalues below this are in evals
+        std::vector<Band>                                         pending;      // bands not merged yet
+        uint                                                      n_bands = 0;  // seeds the starting block of each band
+        std::map<double,std::unique_ptr<ShiftInvertSolver>>       factorizations;
+        std::mutex                                                mutex;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "laplacian_spectrum.cpp"
+#endif
+
+#endif // CINO_LAPLACIAN_SPECTRUM_H
@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/linear_solvers.h>
+#include <cinolib/profiler_zones.h>
 #include <cinolib/stl_container_utilities.h>
 
 namespace cinolib
@@ -49,6 +50,7 @@ void solve_square_system(const Eigen::SparseMatrix<double> & A,
                                Eigen::VectorXd             & x,
                          int   solver)
 {
+    CINO_PROFILE_ZONE("solve_square_system");
     assert(A.rows() == A.cols());
 
     switch (solver)
@@ -104,6 +106,7 @@ void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
                                  const std::map<uint,double>       & bc, // Dirichlet boundary conditions
                                  int   solver)
 {
+    CINO_PROFILE_ZONE("solve_square_system_with_bc");
     std::vector<int> col_map(A.rows(), 0);
     for(const auto & obj : bc)
     {
@@ -185,6 +188,7 @@ void solve_least_squares(const Eigen::SparseMatrix<double> & A,
                                Eigen::VectorXd             & x,
                          int   solver)
 {
+    CINO_PROFILE_ZONE("solve_least_squares");
     Eigen::SparseMatrix<double> At  = A.transpose();
     Eigen::SparseMatrix<double> AtA = At * A;
     Eigen::VectorXd             Atb = At * b;
@@ -201,6 +205,7 @@ void solve_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
                                  const std::map<uint,double>       & bc, // Dirichlet boundary conditions
                                  int   solver)
 {
+    CINO_PROFILE_ZONE("solve_least_squares_with_bc");
     Eigen::SparseMatrix<double> At  = A.transpose();
     Eigen::SparseMatrix<double> AtA = At * A;
     Eigen::VectorXd             Atb = At * b;
@@ -217,6 +222,7 @@ void solve_weighted_least_squares(const Eigen::SparseMatrix<double> & A,
                                         Eigen::VectorXd             & x,
                                   int   solver)
 {
+    CINO_PROFILE_ZONE("solve_weighted_least_squares");
     Eigen::SparseMatrix<double> At   = A.transpose();
     Eigen::SparseMatrix<double> AtWA = At * w.asDiagonal() * A;
     Eigen::VectorXd             AtWb = At * w.asDiagonal() * b;
@@ -234,6 +240,7 @@ void solve_weighted_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
                                           const std::map<uint,double>       & bc, // Dirichlet boundary conditions
                                           int   solver)
 {
+    CINO_PROFILE_ZONE("solve_weighted_least_squares_with_bc");
     Eigen::SparseMatrix<double> At   = A.transpose();
     Eigen::SparseMatrix<double> AtWA = At * w.asDiagonal() * A;
     Eigen::VectorXd             AtWb = At * w.asDiagonal() * b;
@@ -110,10 +110,10 @@ void marching_tets(const Tetmesh<M,V,E,F,P> & m,
     {
         double func[] =
         {
-            m.vert_data(m.poly_vert_id(pid,0)).uvw[0],
-            m.vert_data(m.poly_vert_id(pid,1)).uvw[0],
-            m.vert_data(m.poly_vert_id(pid,2)).uvw[0],
-            m.vert_data(m.poly_vert_id(pid,3)).uvw[0]
+            m.vert_uvw(m.poly_vert_id(pid,0))[0],
+            m.vert_uvw(m.poly_vert_id(pid,1))[0],
+            m.vert_uvw(m.poly_vert_id(pid,2))[0],
+            m.vert_uvw(m.poly_vert_id(pid,3))[0]
         };
 
         if (isovalue >= func[0]) c.at(pid) |= C_1000;
@@ -165,10 +165,10 @@ void marching_tets(const Tetmesh<M,V,E,F,P> & m,
 
         double func[] =
         {
-            m.vert_data(vids[0]).uvw[0],
-            m.vert_data(vids[1]).uvw[0],
-            m.vert_data(vids[2]).uvw[0],
-            m.vert_data(vids[3]).uvw[0]
+            m.vert_uvw(vids[0])[0],
+            m.vert_uvw(vids[1])[0],
+            m.vert_uvw(vids[2])[0],
+            m.vert_uvw(vids[3])[0]
         };
 
         bool v_on_iso[] =
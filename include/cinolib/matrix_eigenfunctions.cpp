@@ -34,11 +34,18 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/matrix_eigenfunctions.h>
+#include <cinolib/min_max_inf.h>
+#ifdef CINOLIB_USES_SPECTRA
 #include <Spectra/MatOp/SparseSymShiftSolve.h>
 #include <Spectra/MatOp/SparseGenRealShiftSolve.h>
 #include <Spectra/GenEigsRealShiftSolver.h>
 #include <Spectra/SymEigsShiftSolver.h>
-#include <cinolib/min_max_inf.h>
+#else
+#include <cinolib/laplacian_spectrum.h>
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#endif
 
 namespace cinolib
 {
@@ -56,6 +63,7 @@ bool matrix_eigenfunctions(const Eigen::SparseMatrix<double> & m,
     f_min.resize(nf);
     f_max.resize(nf);
 
+#ifdef CINOLIB_USES_SPECTRA
     if(sym) // symmetric real matrix
     {
         // https://github.com/yixuan/spectra/issues/149#issuecomment-1398594081
@@ -108,6 +116,40 @@ bool matrix_eigenfunctions(const Eigen::SparseMatrix<double> & m,
             f_max.at(off) = max;
         }
     }
+#else
+    if(!sym)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : matrix_eigenfunctions() : non symmetric matrices require Spectra" << std::endl;
+        return false;
+    }
+    // same as above: the nf eigenpairs closest to -0.001, sorted by distance
+    Eigen::SparseMatrix<double> I(nc,nc);
+    I.setIdentity();
+    LaplacianSpectrum   engine(-m, I);
+    std::vector<double> evals;
+    Eigen::MatrixXd     basis_func;
+    if(!engine.compute_band(-0.001, uint(nf), evals, basis_func) || int(evals.size())<nf) return false;
+    std::vector<int> order(nf);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](const int a, const int b)
+    {
+        return std::fabs(evals.at(a)+0.001) < std::fabs(evals.at(b)+0.001);
+    });
+    for(int fid=0; fid<nf; ++fid)
+    {
+        double min = max_double;
+        double max = min_double;
+        for(int i=0; i<nc; ++i)
+        {
+            auto coeff = basis_func(i,order.at(fid));
+            f.at(fid*nc+i) = coeff;
+            max = std::max(max, std::fabs(coeff));
+            min = std::min(min, -max);
+        }
+        f_min.at(fid) = min;
+        f_max.at(fid) = max;
+    }
+#endif
     return true;
 }
 
@@ -36,7 +36,6 @@
 #ifndef CINO_MATRIX_EIGENFUNCTIONS_H
 #define CINO_MATRIX_EIGENFUNCTIONS_H
 
-#ifdef CINOLIB_USES_SPECTRA
 #include <cinolib/cino_inline.h>
 #include <Eigen/Sparse>
 
@@ -44,6 +43,12 @@ namespace cinolib
 {
 /* This function computes the nf smallest eigenfunctions of a sparse real matrix.
  * It relies on the shift-and-invert solver of Spectra (https://spectralib.org).
+ * If CinoLib is compiled without Spectra, symmetric matrices are handled by the
+ * block Lanczos solver of LaplacianSpectrum (see laplacian_spectrum.h), whereas
+ * non symmetric matrices are not supported (the function returns false).
+ *
+ * To compute Manifold Harmonics, or many eigenfunctions of the same Laplacian
+ * across multiple calls, use LaplacianSpectrum directly.
  *
  *       m: input (sparse) matrix
  *     sym: true if the matrix is symmetric, false otherwise
@@ -69,5 +74,4 @@ bool matrix_eigenfunctions(const Eigen::SparseMatrix<double> & m,
 #include "matrix_eigenfunctions.cpp"
 #endif
 
-#endif // CINOLIB_USES_SPECTRA
 #endif // CINO_MATRIX_EIGENFUNCTIONS_H
@@ -54,6 +54,7 @@
 
 #ifdef __APPLE__
 #include <mach/mach.h>
+#include <sys/resource.h>
 #include <iostream>
 #endif
 
@@ -129,4 +130,32 @@ float memory_usage_in_giga_bytes()
     return memory_usage_in_bytes() / GByte;
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t memory_peak_usage_in_bytes()
+{
+#ifdef _WIN32
+    assert(false && "THIS CODE HASN'T BEEN TESTED YET!");
+    return 0;
+    //PROCESS_MEMORY_COUNTERS_EX pmc;
+    //GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+    //return (size_t) pmc.PeakWorkingSetSize;
+#endif
+
+#if defined(__linux__) || defined(__APPLE__)
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage)!=0)
+    {
+        std::cout << "Cinolib::memory_peak_usage_in_bytes() => Failed to query OS!" << std::endl;
+        return (size_t)0L;
+    }
+#ifdef __APPLE__
+    return (size_t)usage.ru_maxrss; // bytes on MacOS
+#else
+    return (size_t)usage.ru_maxrss * (size_t)1024; // kilobytes on Linux
+#endif
+#endif
+}
+
 }
@@ -47,6 +47,9 @@ CINO_INLINE float  memory_usage_in_kilo_bytes();
 CINO_INLINE float  memory_usage_in_mega_bytes();
 CINO_INLINE float  memory_usage_in_giga_bytes();
 
+// peak resident set size reached so far by the process
+CINO_INLINE size_t memory_peak_usage_in_bytes();
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -34,7 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/merge_meshes_at_coincident_vertices.h>
-#include <cinolib/octree.h>
+#include <cinolib/weld_points.h>
 
 namespace cinolib
 {
@@ -46,46 +46,25 @@ void merge_meshes_at_coincident_vertices(const AbstractPolyhedralMesh<M,V,E,F,P>
                                                AbstractPolyhedralMesh<M,V,E,F,P> & res,
                                          const double                              proximity_thresh)
 {
-    Octree o;
-    for(uint vid=0; vid<m1.num_verts(); ++vid) o.push_sphere(vid, m1.vert(vid), proximity_thresh);
-    o.build();
+    std::vector<int> match;
+    match_points(m1.vector_verts(), m2.vector_verts(), proximity_thresh, match);
 
     res = m1;
 
-    std::map<uint,uint> vmap;
+    std::vector<uint> vmap(m2.num_verts());
     for(uint vid=0; vid<m2.num_verts(); ++vid)
     {
-        vec3d p = m2.vert(vid);
-        std::unordered_set<uint> ids;
-        if(o.contains(p, false, ids))
-        {
-            // WARNING: I am assuming that the mapping is one to one at most
-            assert(ids.size()==1);
-            vmap[vid] = *ids.begin();
-        }
-        else
-        {
-            uint fresh_id = res.vert_add(p);
-            vmap[vid] = fresh_id;
-        }
+        vmap.at(vid) = (match.at(vid)>=0) ? uint(match.at(vid)) : res.vert_add(m2.vert(vid));
     }
 
-    std::map<uint,uint> fmap;
+    std::vector<uint> fmap(m2.num_faces());
     for(uint fid=0; fid<m2.num_faces(); ++fid)
     {
         auto f = m2.face_verts_id(fid);
         for(auto & vid : f) vid = vmap.at(vid);
 
         int test_id = res.face_id(f);
-        if(test_id>=0)
-        {
-            fmap[fid] = test_id;
-        }
-        else
-        {
-            uint fresh_id = res.face_add(f);
-            fmap[fid] = fresh_id;
-        }
+        fmap.at(fid) = (test_id>=0) ? uint(test_id) : res.face_add(f);
     }
 
     for(uint pid=0; pid<m2.num_polys(); ++pid)
@@ -101,4 +80,33 @@ void merge_meshes_at_coincident_vertices(const AbstractPolyhedralMesh<M,V,E,F,P>
     }
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void merge_meshes_at_coincident_vertices(const AbstractPolygonMesh<M,V,E,P> & m1,
+                                         const AbstractPolygonMesh<M,V,E,P> & m2,
+                                               AbstractPolygonMesh<M,V,E,P> & res,
+                                         const double                         proximity_thresh)
+{
+    std::vector<int> match;
+    match_points(m1.vector_verts(), m2.vector_verts(), proximity_thresh, match);
+
+    res = m1;
+
+    std::vector<uint> vmap(m2.num_verts());
+    for(uint vid=0; vid<m2.num_verts(); ++vid)
+    {
+        vmap.at(vid) = (match.at(vid)>=0) ? uint(match.at(vid)) : res.vert_add(m2.vert(vid));
+    }
+
+    for(uint pid=0; pid<m2.num_polys(); ++pid)
+    {
+        auto p = m2.poly_verts_id(pid);
+        for(auto & vid : p) vid = vmap.at(vid);
+
+        if(res.poly_id(p)==-1) res.poly_add(p);
+    }
+}
+
 }
@@ -41,12 +41,27 @@
 namespace cinolib
 {
 
+/* Appends m2 to m1, welding the vertices of m2 that are closer than
+ * proximity_thresh to a vertex of m1 (the closest one is chosen).
+ * Elements of m2 that already exist in m1 after welding are not duplicated.
+ * Vertex matching is based on spatial hashing (see weld_points.h)
+*/
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void merge_meshes_at_coincident_vertices(const AbstractPolyhedralMesh<M,V,E,F,P> & m1,
                                          const AbstractPolyhedralMesh<M,V,E,F,P> & m2,
                                                AbstractPolyhedralMesh<M,V,E,F,P> & res,
                                          const double proximity_thresh);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void merge_meshes_at_coincident_vertices(const AbstractPolygonMesh<M,V,E,P> & m1,
+                                         const AbstractPolygonMesh<M,V,E,P> & m2,
+                                               AbstractPolygonMesh<M,V,E,P> & res,
+                                         const double proximity_thresh);
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/meshes/abstract_drawable_polygonmesh.h>
+#include <cinolib/profiler_zones.h>
 #include <cinolib/cino_inline.h>
 #include <cinolib/gl/draw_lines_tris.h>
 #include <cinolib/gl/load_texture.h>
@@ -86,6 +87,7 @@ template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::updateGL_marked()
 {
+    CINO_PROFILE_ZONE("AbstractDrawablePolygonMesh::updateGL_marked");
     drawlist_marked.segs.clear();
     drawlist_marked.seg_coords.clear();
     drawlist_marked.seg_colors.clear();
@@ -136,6 +138,7 @@ template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::updateGL_mesh()
 {
+    CINO_PROFILE_ZONE("AbstractDrawablePolygonMesh::updateGL_mesh");
     drawlist.material = material_;
     drawlist.tri_coords.clear();
     drawlist.tris.clear();
@@ -168,7 +171,7 @@ void AbstractDrawablePolygonMesh<Mesh>::updateGL_mesh()
         {
             if (this->poly_data(pid).flags[HIDDEN]) continue;
 
-            vec3d n = this->poly_data(pid).normal;
+            vec3d n = this->poly_normal(pid);
 
             for(uint i=0; i<this->poly_tessellation(pid).size()/3; ++i)
             {
@@ -183,9 +186,9 @@ void AbstractDrawablePolygonMesh<Mesh>::updateGL_mesh()
                 float AO_vid0 = 0.f;
                 float AO_vid1 = 0.f;
                 float AO_vid2 = 0.f;
-                for(uint pid : vid0_vis_pids) AO_vid0 += this->poly_data(pid).AO*AO_alpha + (1.f - AO_alpha);
-                for(uint pid : vid1_vis_pids) AO_vid1 += this->poly_data(pid).AO*AO_alpha + (1.f - AO_alpha);
-                for(uint pid : vid2_vis_pids) AO_vid2 += this->poly_data(pid).AO*AO_alpha + (1.f - AO_alpha);
+                for(uint pid : vid0_vis_pids) AO_vid0 += this->poly_AO(pid)*AO_alpha + (1.f - AO_alpha);
+                for(uint pid : vid1_vis_pids) AO_vid1 += this->poly_AO(pid)*AO_alpha + (1.f - AO_alpha);
+                for(uint pid : vid2_vis_pids) AO_vid2 += this->poly_AO(pid)*AO_alpha + (1.f - AO_alpha);
                 AO_vid0 /= static_cast<float>(vid0_vis_pids.size());
                 AO_vid1 /= static_cast<float>(vid1_vis_pids.size());
                 AO_vid2 /= static_cast<float>(vid2_vis_pids.size());
@@ -212,9 +215,9 @@ void AbstractDrawablePolygonMesh<Mesh>::updateGL_mesh()
                     vec3d n_vid0(0,0,0);
                     vec3d n_vid1(0,0,0);
                     vec3d n_vid2(0,0,0);
-                    for(uint pid : vid0_vis_pids) n_vid0 += this->poly_data(pid).normal;
-                    for(uint pid : vid1_vis_pids) n_vid1 += this->poly_data(pid).normal;
-                    for(uint pid : vid2_vis_pids) n_vid2 += this->poly_data(pid).normal;
+                    for(uint pid : vid0_vis_pids) n_vid0 += this->poly_normal(pid);
+                    for(uint pid : vid1_vis_pids) n_vid1 += this->poly_normal(pid);
+                    for(uint pid : vid2_vis_pids) n_vid2 += this->poly_normal(pid);
                     n_vid0 /= static_cast<double>(vid0_vis_pids.size());
                     n_vid1 /= static_cast<double>(vid1_vis_pids.size());
                     n_vid2 /= static_cast<double>(vid2_vis_pids.size());
@@ -244,18 +247,18 @@ void AbstractDrawablePolygonMesh<Mesh>::updateGL_mesh()
 
                 if (drawlist.draw_mode & DRAW_TRI_TEXTURE1D)
                 {
-                    drawlist.tri_text.push_back(float(this->vert_data(vid0).uvw[0]));
-                    drawlist.tri_text.push_back(float(this->vert_data(vid1).uvw[0]));
-                    drawlist.tri_text.push_back(float(this->vert_data(vid2).uvw[0]));
+                    drawlist.tri_text.push_back(float(this->vert_uvw(vid0)[0]));
+                    drawlist.tri_text.push_back(float(this->vert_uvw(vid1)[0]));
+                    drawlist.tri_text.push_back(float(this->vert_uvw(vid2)[0]));
                 }
                 else if (drawlist.draw_mode & DRAW_TRI_TEXTURE2D)
                 {
-                    drawlist.tri_text.push_back(float(this->vert_data(vid0).uvw[0]*drawlist.texture.scaling_factor));
-                    drawlist.tri_text.push_back(float(this->vert_data(vid0).uvw[1]*drawlist.texture.scaling_factor));
-                    drawlist.tri_text.push_back(float(this->vert_data(vid1).uvw[0]*drawlist.texture.scaling_factor));
-                    drawlist.tri_text.push_back(float(this->vert_data(vid1).uvw[1]*drawlist.texture.scaling_factor));
-                    drawlist.tri_text.push_back(float(this->vert_data(vid2).uvw[0]*drawlist.texture.scaling_factor));
-                    drawlist.tri_text.push_back(float(this->vert_data(vid2).uvw[1]*drawlist.texture.scaling_factor));
+                    drawlist.tri_text.push_back(float(this->vert_uvw(vid0)[0]*drawlist.texture.scaling_factor));
+                    drawlist.tri_text.push_back(float(this->vert_uvw(vid0)[1]*drawlist.texture.scaling_factor));
+                    drawlist.tri_text.push_back(float(this->vert_uvw(vid1)[0]*drawlist.texture.scaling_factor));
+                    drawlist.tri_text.push_back(float(this->vert_uvw(vid1)[1]*drawlist.texture.scaling_factor));
+                    drawlist.tri_text.push_back(float(this->vert_uvw(vid2)[0]*drawlist.texture.scaling_factor));
+                    drawlist.tri_text.push_back(float(this->vert_uvw(vid2)[1]*drawlist.texture.scaling_factor));
                 }
 
                 if (drawlist.draw_mode & DRAW_TRI_FACECOLOR) // replicate f color on each vertex
@@ -290,7 +293,7 @@ void AbstractDrawablePolygonMesh<Mesh>::updateGL_mesh()
                 }
                 else if (drawlist.draw_mode & DRAW_TRI_QUALITY)
                 {
-                    float q = this->poly_data(pid).quality;
+                    float q = this->poly_quality(pid);
                     Color c = Color::red_white_blue_ramp_01(q);
                     drawlist.tri_v_colors.push_back(c.r*AO_vid0);
                     drawlist.tri_v_colors.push_back(c.g*AO_vid0);
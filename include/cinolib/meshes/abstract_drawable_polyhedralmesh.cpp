@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/meshes/abstract_drawable_polyhedralmesh.h>
+#include <cinolib/profiler_zones.h>
 #include <cinolib/cino_inline.h>
 #include <cinolib/gl/draw_lines_tris.h>
 #include <cinolib/gl/load_texture.h>
@@ -90,6 +91,7 @@ template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_marked()
 {
+    CINO_PROFILE_ZONE("AbstractDrawablePolyhedralMesh::updateGL_marked");
     drawlist_marked.tris.clear();
     drawlist_marked.tri_coords.clear();
     drawlist_marked.tri_v_norms.clear();
@@ -124,15 +126,15 @@ void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_marked()
             drawlist_marked.tri_coords.push_back(float(this->vert(vid2).y()));
             drawlist_marked.tri_coords.push_back(float(this->vert(vid2).z()));
 
-            drawlist_marked.tri_v_norms.push_back(float(this->face_data(fid).normal.x()));
-            drawlist_marked.tri_v_norms.push_back(float(this->face_data(fid).normal.y()));
-            drawlist_marked.tri_v_norms.push_back(float(this->face_data(fid).normal.z()));
-            drawlist_marked.tri_v_norms.push_back(float(this->face_data(fid).normal.x()));
-            drawlist_marked.tri_v_norms.push_back(float(this->face_data(fid).normal.y()));
-            drawlist_marked.tri_v_norms.push_back(float(this->face_data(fid).normal.z()));
-            drawlist_marked.tri_v_norms.push_back(float(this->face_data(fid).normal.x()));
-            drawlist_marked.tri_v_norms.push_back(float(this->face_data(fid).normal.y()));
-            drawlist_marked.tri_v_norms.push_back(float(this->face_data(fid).normal.z()));
+            drawlist_marked.tri_v_norms.push_back(float(this->face_normal(fid).x()));
+            drawlist_marked.tri_v_norms.push_back(float(this->face_normal(fid).y()));
+            drawlist_marked.tri_v_norms.push_back(float(this->face_normal(fid).z()));
+            drawlist_marked.tri_v_norms.push_back(float(this->face_normal(fid).x()));
+            drawlist_marked.tri_v_norms.push_back(float(this->face_normal(fid).y()));
+            drawlist_marked.tri_v_norms.push_back(float(this->face_normal(fid).z()));
+            drawlist_marked.tri_v_norms.push_back(float(this->face_normal(fid).x()));
+            drawlist_marked.tri_v_norms.push_back(float(this->face_normal(fid).y()));
+            drawlist_marked.tri_v_norms.push_back(float(this->face_normal(fid).z()));
 
             drawlist_marked.tri_v_colors.push_back(marked_face_color.r);
             drawlist_marked.tri_v_colors.push_back(marked_face_color.g);
@@ -184,6 +186,7 @@ template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_out()
 {
+    CINO_PROFILE_ZONE("AbstractDrawablePolyhedralMesh::updateGL_out");
     drawlist_out.material = material_;
     drawlist_out.tris.clear();
     drawlist_out.tri_coords.clear();
@@ -218,9 +221,9 @@ void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_out()
             float AO_vid0 = 0.f;
             float AO_vid1 = 0.f;
             float AO_vid2 = 0.f;
-            for(auto fp : vid0_vis_fids) AO_vid0 += this->face_data(fp.first).AO*AO_alpha + (1.f - AO_alpha);
-            for(auto fp : vid1_vis_fids) AO_vid1 += this->face_data(fp.first).AO*AO_alpha + (1.f - AO_alpha);
-            for(auto fp : vid2_vis_fids) AO_vid2 += this->face_data(fp.first).AO*AO_alpha + (1.f - AO_alpha);
+            for(auto fp : vid0_vis_fids) AO_vid0 += this->face_AO(fp.first)*AO_alpha + (1.f - AO_alpha);
+            for(auto fp : vid1_vis_fids) AO_vid1 += this->face_AO(fp.first)*AO_alpha + (1.f - AO_alpha);
+            for(auto fp : vid2_vis_fids) AO_vid2 += this->face_AO(fp.first)*AO_alpha + (1.f - AO_alpha);
             AO_vid0 /= static_cast<float>(vid0_vis_fids.size());
             AO_vid1 /= static_cast<float>(vid1_vis_fids.size());
             AO_vid2 /= static_cast<float>(vid2_vis_fids.size());
@@ -279,18 +282,18 @@ void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_out()
 
             if (drawlist_out.draw_mode & DRAW_TRI_TEXTURE1D)
             {
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid0).uvw[0]));
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid1).uvw[0]));
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid2).uvw[0]));
+                drawlist_out.tri_text.push_back(float(this->vert_uvw(vid0)[0]));
+                drawlist_out.tri_text.push_back(float(this->vert_uvw(vid1)[0]));
+                drawlist_out.tri_text.push_back(float(this->vert_uvw(vid2)[0]));
             }
             else if (drawlist_out.draw_mode & DRAW_TRI_TEXTURE2D)
             {
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid0).uvw[0]*drawlist_out.texture.scaling_factor));
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid0).uvw[1]*drawlist_out.texture.scaling_factor));
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid1).uvw[0]*drawlist_out.texture.scaling_factor));
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid1).uvw[1]*drawlist_out.texture.scaling_factor));
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid2).uvw[0]*drawlist_out.texture.scaling_factor));
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid2).uvw[1]*drawlist_out.texture.scaling_factor));
+                drawlist_out.tri_text.push_back(float(this->vert_uvw(vid0)[0]*drawlist_out.texture.scaling_factor));
+                drawlist_out.tri_text.push_back(float(this->vert_uvw(vid0)[1]*drawlist_out.texture.scaling_factor));
+                drawlist_out.tri_text.push_back(float(this->vert_uvw(vid1)[0]*drawlist_out.texture.scaling_factor));
+                drawlist_out.tri_text.push_back(float(this->vert_uvw(vid1)[1]*drawlist_out.texture.scaling_factor));
+                drawlist_out.tri_text.push_back(float(this->vert_uvw(vid2)[0]*drawlist_out.texture.scaling_factor));
+                drawlist_out.tri_text.push_back(float(this->vert_uvw(vid2)[1]*drawlist_out.texture.scaling_factor));
             }
 
             if (drawlist_out.draw_mode & DRAW_TRI_FACECOLOR) // replicate f color on each vertex
@@ -325,7 +328,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_out()
             }
             else if (drawlist_out.draw_mode & DRAW_TRI_QUALITY)
             {
-                float q = this->poly_data(pid_beneath).quality;
+                float q = this->poly_quality(pid_beneath);
                 Color c = Color::red_white_blue_ramp_01(q);
                 drawlist_out.tri_v_colors.push_back(c.r*AO_vid0);
                 drawlist_out.tri_v_colors.push_back(c.g*AO_vid0);
@@ -413,6 +416,7 @@ template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_in()
 {
+    CINO_PROFILE_ZONE("AbstractDrawablePolyhedralMesh::updateGL_in");
     drawlist_in.material = material_;
     drawlist_in.tris.clear();
     drawlist_in.tri_coords.clear();
@@ -456,9 +460,9 @@ void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_in()
             float AO_vid0 = 0.f;
             float AO_vid1 = 0.f;
             float AO_vid2 = 0.f;
-            for(auto fp : vid0_vis_fids) AO_vid0 += this->face_data(fp.first).AO*AO_alpha + (1.f - AO_alpha);
-            for(auto fp : vid1_vis_fids) AO_vid1 += this->face_data(fp.first).AO*AO_alpha + (1.f - AO_alpha);
-            for(auto fp : vid2_vis_fids) AO_vid2 += this->face_data(fp.first).AO*AO_alpha + (1.f - AO_alpha);
+            for(auto fp : vid0_vis_fids) AO_vid0 += this->face_AO(fp.first)*AO_alpha + (1.f - AO_alpha);
+            for(auto fp : vid1_vis_fids) AO_vid1 += this->face_AO(fp.first)*AO_alpha + (1.f - AO_alpha);
+            for(auto fp : vid2_vis_fids) AO_vid2 += this->face_AO(fp.first)*AO_alpha + (1.f - AO_alpha);
             AO_vid0 /= static_cast<float>(vid0_vis_fids.size());
             AO_vid1 /= static_cast<float>(vid1_vis_fids.size());
             AO_vid2 /= static_cast<float>(vid2_vis_fids.size());
@@ -517,18 +521,18 @@ void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_in()
 
             if (drawlist_in.draw_mode & DRAW_TRI_TEXTURE1D)
             {
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid0).uvw[0]));
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid1).uvw[0]));
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid2).uvw[0]));
+                drawlist_in.tri_text.push_back(float(this->vert_uvw(vid0)[0]));
+                drawlist_in.tri_text.push_back(float(this->vert_uvw(vid1)[0]));
+                drawlist_in.tri_text.push_back(float(this->vert_uvw(vid2)[0]));
             }
             else if (drawlist_in.draw_mode & DRAW_TRI_TEXTURE2D)
             {
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid0).uvw[0]*drawlist_in.texture.scaling_factor));
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid0).uvw[1]*drawlist_in.texture.scaling_factor));
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid1).uvw[0]*drawlist_in.texture.scaling_factor));
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid1).uvw[1]*drawlist_in.texture.scaling_factor));
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid2).uvw[0]*drawlist_in.texture.scaling_factor));
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid2).uvw[1]*drawlist_in.texture.scaling_factor));
+                drawlist_in.tri_text.push_back(float(this->vert_uvw(vid0)[0]*drawlist_in.texture.scaling_factor));
+                drawlist_in.tri_text.push_back(float(this->vert_uvw(vid0)[1]*drawlist_in.texture.scaling_factor));
+                drawlist_in.tri_text.push_back(float(this->vert_uvw(vid1)[0]*drawlist_in.texture.scaling_factor));
+                drawlist_in.tri_text.push_back(float(this->vert_uvw(vid1)[1]*drawlist_in.texture.scaling_factor));
+                drawlist_in.tri_text.push_back(float(this->vert_uvw(vid2)[0]*drawlist_in.texture.scaling_factor));
+                drawlist_in.tri_text.push_back(float(this->vert_uvw(vid2)[1]*drawlist_in.texture.scaling_factor));
             }
 
             if (drawlist_in.draw_mode & DRAW_TRI_FACECOLOR) // replicate f color on each vertex
@@ -563,7 +567,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_in()
             }
             else if (drawlist_in.draw_mode & DRAW_TRI_QUALITY)
             {
-                float q = this->poly_data(pid_beneath).quality;
+                float q = this->poly_quality(pid_beneath);
                 Color c = Color::red_white_blue_ramp_01(q);
                 drawlist_in.tri_v_colors.push_back(c.r*AO_vid0);
                 drawlist_in.tri_v_colors.push_back(c.g*AO_vid0);
@@ -37,6 +37,7 @@
 #include <cinolib/meshes/mesh_attributes.h>
 #include <cinolib/stl_container_utilities.h>
 #include <cinolib/min_max_inf.h>
+#include <cinolib/parallel_for.h>
 #include <map>
 #include <unordered_set>
 #include <unordered_map>
@@ -101,6 +102,9 @@ void AbstractMesh<M,V,E,P>::clear()
     v_data.clear();
     e_data.clear();
     p_data.clear();
+    v_props.clear();
+    e_props.clear();
+    p_props.clear();
     //
     v2v.clear();
     v2e.clear();
@@ -108,6 +112,172 @@ void AbstractMesh<M,V,E,P>::clear()
     e2p.clear();
     p2e.clear();
     p2p.clear();
+    //
+    e_index.clear(); // the index stays enabled, and will be filled by the next init
+    batch_reset();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::hash_index_enable(const bool b)
+{
+    hash_index = b;
+    e_index    = IdHashTable();
+    if(!b) return;
+    e_index.reserve(num_edges());
+    for(uint eid=0; eid<num_edges(); ++eid) if(!edge_is_removed(eid)) e_index_insert(eid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::e_index_insert(const uint eid)
+{
+    if(hash_index) e_index.insert(vert_pair_key(edges.at(2*eid), edges.at(2*eid+1)), eid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::e_index_erase(const uint eid)
+{
+    if(hash_index) e_index.erase(vert_pair_key(edges.at(2*eid), edges.at(2*eid+1)), eid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::e_index_switch(const uint eid0, const uint eid1)
+{
+    if(!hash_index) return;
+    // an edge being removed may have been erased from the index already (replace is a no-op then)
+    e_index.replace(vert_pair_key(edges.at(2*eid0), edges.at(2*eid0+1)), eid0, eid1);
+    e_index.replace(vert_pair_key(edges.at(2*eid1), edges.at(2*eid1+1)), eid1, eid0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::batch_begin()
+{
+    batch = true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::batch_reset()
+{
+    batch = false;
+    v_dead.clear();
+    e_dead.clear();
+    p_dead.clear();
+    n_dead_verts = 0;
+    n_dead_edges = 0;
+    n_dead_polys = 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::vert_mark_removed(const uint vid)
+{
+    assert(batch && !vert_is_removed(vid));
+    if(v_dead.size()<num_verts()) v_dead.resize(num_verts(), false);
+    v_dead.at(vid) = true;
+    ++n_dead_verts;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::edge_mark_removed(const uint eid)
+{
+    assert(batch && !edge_is_removed(eid));
+    if(e_dead.size()<num_edges()) e_dead.resize(num_edges(), false);
+    e_dead.at(eid) = true;
+    ++n_dead_edges;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::poly_mark_removed(const uint pid)
+{
+    assert(batch && !poly_is_removed(pid));
+    if(p_dead.size()<num_polys()) p_dead.resize(num_polys(), false);
+    p_dead.at(pid) = true;
+    ++n_dead_polys;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::compact_ids(const std::vector<bool> & dead,
+                                        const uint                n,
+                                              std::vector<uint> & keep,
+                                              std::vector<uint> & new_id)
+{
+    keep.clear();
+    keep.reserve(n);
+    new_id.resize(n);
+    for(uint id=0; id<n; ++id)
+    {
+        if(id<dead.size() && dead[id]) new_id[id] = max_uint; else
+        {
+            new_id[id] = uint(keep.size());
+            keep.push_back(id);
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::compact_adj(      std::vector<std::vector<uint>> & adj,
+                                        const std::vector<uint>              & keep,
+                                        const std::vector<uint>              & new_id)
+{
+    // lists are moved (not copied) into the new array, so the gather is cheap and
+    // most of the time goes in remapping the ids, which is done in parallel
+    std::vector<std::vector<uint>> tmp(keep.size());
+    PARALLEL_FOR(0, uint(keep.size()), 1000, [&](const uint i)
+    {
+        tmp[i] = std::move(adj[keep[i]]);
+        for(uint & id : tmp[i])
+        {
+            assert(new_id.at(id)!=max_uint);
+            id = new_id[id];
+        }
+    });
+    adj.swap(tmp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+template<class T>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::compact_vec(std::vector<T> & vec, const std::vector<uint> & keep)
+{
+    // keep is sorted, hence keep[i]>=i and the gather can be done in place
+    for(size_t i=0; i<keep.size(); ++i)
+    {
+        if(keep[i]!=i) vec[i] = std::move(vec[keep[i]]);
+    }
+    vec.erase(vec.begin()+keep.size(), vec.end());
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -239,7 +409,7 @@ std::vector<vec3d> AbstractMesh<M,V,E,P>::vector_vert_normals() const
     normals.reserve(num_verts());
     for(uint vid=0; vid<num_verts(); ++vid)
     {
-        normals.push_back(vert_data(vid).normal);
+        normals.push_back(vert_normal(vid));
     }
     return normals;
 }
@@ -314,7 +484,7 @@ std::vector<vec3d> AbstractMesh<M,V,E,P>::vector_poly_normals() const
     normals.reserve(num_polys());
     for(uint pid=0; pid<num_polys(); ++pid)
     {
-        normals.push_back(poly_data(pid).normal);
+        normals.push_back(p_props.normal.at(pid)); // only meaningful for surface meshes
     }
     return normals;
 }
@@ -383,18 +553,18 @@ std::vector<double> AbstractMesh<M,V,E,P>::serialize_uvw(const int mode) const
     {
         switch (mode)
         {
-            case U_param  : uvw.push_back(vert_data(vid).uvw[0]); break;
-            case V_param  : uvw.push_back(vert_data(vid).uvw[1]); break;
-            case W_param  : uvw.push_back(vert_data(vid).uvw[2]); break;
-            case UV_param : uvw.push_back(vert_data(vid).uvw[0]);
-                            uvw.push_back(vert_data(vid).uvw[1]); break;
-            case UW_param : uvw.push_back(vert_data(vid).uvw[0]);
-                            uvw.push_back(vert_data(vid).uvw[2]); break;
-            case VW_param : uvw.push_back(vert_data(vid).uvw[1]);
-                            uvw.push_back(vert_data(vid).uvw[2]); break;
-            case UVW_param: uvw.push_back(vert_data(vid).uvw[0]);
-                            uvw.push_back(vert_data(vid).uvw[1]);
-                            uvw.push_back(vert_data(vid).uvw[2]); break;
+            case U_param  : uvw.push_back(vert_uvw(vid)[0]); break;
+            case V_param  : uvw.push_back(vert_uvw(vid)[1]); break;
+            case W_param  : uvw.push_back(vert_uvw(vid)[2]); break;
+            case UV_param : uvw.push_back(vert_uvw(vid)[0]);
+                            uvw.push_back(vert_uvw(vid)[1]); break;
+            case UW_param : uvw.push_back(vert_uvw(vid)[0]);
+                            uvw.push_back(vert_uvw(vid)[2]); break;
+            case VW_param : uvw.push_back(vert_uvw(vid)[1]);
+                            uvw.push_back(vert_uvw(vid)[2]); break;
+            case UVW_param: uvw.push_back(vert_uvw(vid)[0]);
+                            uvw.push_back(vert_uvw(vid)[1]);
+                            uvw.push_back(vert_uvw(vid)[2]); break;
             default: assert(false);
         }
     }
@@ -410,7 +580,7 @@ void AbstractMesh<M,V,E,P>::deserialize_uvw(const std::vector<vec3d> & uvw)
     assert(uvw.size()==num_verts());
     for(uint vid=0; vid<num_verts(); ++vid)
     {
-        vert_data(vid).uvw = uvw.at(vid);
+        vert_uvw(vid) = uvw.at(vid);
     }
 }
 
@@ -424,18 +594,18 @@ void AbstractMesh<M,V,E,P>::copy_xyz_to_uvw(const int mode)
     {
         switch (mode)
         {
-            case U_param  : vert_data(vid).uvw[0] = vert(vid).x(); break;
-            case V_param  : vert_data(vid).uvw[1] = vert(vid).y(); break;
-            case W_param  : vert_data(vid).uvw[2] = vert(vid).z(); break;
-            case UV_param : vert_data(vid).uvw[0] = vert(vid).x();
-                            vert_data(vid).uvw[1] = vert(vid).y(); break;
-            case UW_param : vert_data(vid).uvw[0] = vert(vid).x();
-                            vert_data(vid).uvw[2] = vert(vid).z(); break;
-            case VW_param : vert_data(vid).uvw[1] = vert(vid).y();
-                            vert_data(vid).uvw[2] = vert(vid).z(); break;
-            case UVW_param: vert_data(vid).uvw[0] = vert(vid).x();
-                            vert_data(vid).uvw[1] = vert(vid).y();
-                            vert_data(vid).uvw[2] = vert(vid).z(); break;
+            case U_param  : vert_uvw(vid)[0] = vert(vid).x(); break;
+            case V_param  : vert_uvw(vid)[1] = vert(vid).y(); break;
+            case W_param  : vert_uvw(vid)[2] = vert(vid).z(); break;
+            case UV_param : vert_uvw(vid)[0] = vert(vid).x();
+                            vert_uvw(vid)[1] = vert(vid).y(); break;
+            case UW_param : vert_uvw(vid)[0] = vert(vid).x();
+                            vert_uvw(vid)[2] = vert(vid).z(); break;
+            case VW_param : vert_uvw(vid)[1] = vert(vid).y();
+                            vert_uvw(vid)[2] = vert(vid).z(); break;
+            case UVW_param: vert_uvw(vid)[0] = vert(vid).x();
+                            vert_uvw(vid)[1] = vert(vid).y();
+                            vert_uvw(vid)[2] = vert(vid).z(); break;
             default: assert(false);
         }
     }
@@ -451,18 +621,18 @@ void AbstractMesh<M,V,E,P>::copy_uvw_to_xyz(const int mode)
     {
         switch (mode)
         {
-            case U_param  : vert(vid).x() = vert_data(vid).uvw[0]; break;
-            case V_param  : vert(vid).y() = vert_data(vid).uvw[1]; break;
-            case W_param  : vert(vid).z() = vert_data(vid).uvw[2]; break;
-            case UV_param : vert(vid).x() = vert_data(vid).uvw[0];
-                            vert(vid).y() = vert_data(vid).uvw[1]; break;
-            case UW_param : vert(vid).x() = vert_data(vid).uvw[0];
-                            vert(vid).z() = vert_data(vid).uvw[2]; break;
-            case VW_param : vert(vid).y() = vert_data(vid).uvw[1];
-                            vert(vid).z() = vert_data(vid).uvw[2]; break;
-            case UVW_param: vert(vid).x() = vert_data(vid).uvw[0];
-                            vert(vid).y() = vert_data(vid).uvw[1];
-                            vert(vid).z() = vert_data(vid).uvw[2]; break;
+            case U_param  : vert(vid).x() = vert_uvw(vid)[0]; break;
+            case V_param  : vert(vid).y() = vert_uvw(vid)[1]; break;
+            case W_param  : vert(vid).z() = vert_uvw(vid)[2]; break;
+            case UV_param : vert(vid).x() = vert_uvw(vid)[0];
+                            vert(vid).y() = vert_uvw(vid)[1]; break;
+            case UW_param : vert(vid).x() = vert_uvw(vid)[0];
+                            vert(vid).z() = vert_uvw(vid)[2]; break;
+            case VW_param : vert(vid).y() = vert_uvw(vid)[1];
+                            vert(vid).z() = vert_uvw(vid)[2]; break;
+            case UVW_param: vert(vid).x() = vert_uvw(vid)[0];
+                            vert(vid).y() = vert_uvw(vid)[1];
+                            vert(vid).z() = vert_uvw(vid)[2]; break;
             default: assert(false);
         }
     }
@@ -477,7 +647,7 @@ void AbstractMesh<M,V,E,P>::swap_xyz_uvw(const bool normals, const bool bbox)
 {
     for(uint vid=0; vid<num_verts(); ++vid)
     {
-        std::swap(vert(vid),vert_data(vid).uvw);
+        std::swap(vert(vid),vert_uvw(vid));
     }
     if(normals) update_normals();
     if(bbox)    update_bbox();
@@ -607,9 +777,9 @@ bool AbstractMesh<M,V,E,P>::vert_is_local_min(const uint vid, const int tex_coor
     {
         switch (tex_coord)
         {
-            case U_param : if (vert_data(nbr).uvw[0] < vert_data(vid).uvw[0]) return false; break;
-            case V_param : if (vert_data(nbr).uvw[1] < vert_data(vid).uvw[1]) return false; break;
-            case W_param : if (vert_data(nbr).uvw[2] < vert_data(vid).uvw[2]) return false; break;
+            case U_param : if (vert_uvw(nbr)[0] < vert_uvw(vid)[0]) return false; break;
+            case V_param : if (vert_uvw(nbr)[1] < vert_uvw(vid)[1]) return false; break;
+            case W_param : if (vert_uvw(nbr)[2] < vert_uvw(vid)[2]) return false; break;
             default: assert(false);
         }
     }
@@ -626,9 +796,9 @@ bool AbstractMesh<M,V,E,P>::vert_is_local_max(const uint vid, const int tex_coor
     {
         switch (tex_coord)
         {
-            case U_param : if (vert_data(nbr).uvw[0] > vert_data(vid).uvw[0]) return false; break;
-            case V_param : if (vert_data(nbr).uvw[1] > vert_data(vid).uvw[1]) return false; break;
-            case W_param : if (vert_data(nbr).uvw[2] > vert_data(vid).uvw[2]) return false; break;
+            case U_param : if (vert_uvw(nbr)[0] > vert_uvw(vid)[0]) return false; break;
+            case V_param : if (vert_uvw(nbr)[1] > vert_uvw(vid)[1]) return false; break;
+            case W_param : if (vert_uvw(nbr)[2] > vert_uvw(vid)[2]) return false; break;
             default: assert(false);
         }
     }
@@ -694,9 +864,9 @@ double AbstractMesh<M,V,E,P>::vert_min_uvw_value(const int tex_coord) const
     {
         switch (tex_coord)
         {
-            case U_param : min = std::min(min, vert_data(vid).uvw[0]); break;
-            case V_param : min = std::min(min, vert_data(vid).uvw[1]); break;
-            case W_param : min = std::min(min, vert_data(vid).uvw[2]); break;
+            case U_param : min = std::min(min, vert_uvw(vid)[0]); break;
+            case V_param : min = std::min(min, vert_uvw(vid)[1]); break;
+            case W_param : min = std::min(min, vert_uvw(vid)[2]); break;
             default: assert(false);
         }
     }
@@ -714,9 +884,9 @@ double AbstractMesh<M,V,E,P>::vert_max_uvw_value(const int tex_coord) const
     {
         switch (tex_coord)
         {
-            case U_param : max = std::max(max, vert_data(vid).uvw[0]); break;
-            case V_param : max = std::max(max, vert_data(vid).uvw[1]); break;
-            case W_param : max = std::max(max, vert_data(vid).uvw[2]); break;
+            case U_param : max = std::max(max, vert_uvw(vid)[0]); break;
+            case V_param : max = std::max(max, vert_uvw(vid)[1]); break;
+            case W_param : max = std::max(max, vert_uvw(vid)[2]); break;
             default: assert(false);
         }
     }
@@ -782,6 +952,7 @@ CINO_INLINE
 int AbstractMesh<M,V,E,P>::edge_id(const uint vid0, const uint vid1) const
 {
     assert(vid0 != vid1);
+    if(hash_index) return e_index.find(vert_pair_key(vid0,vid1));
     for(uint eid : adj_v2e(vid0))
     {
         if(edge_contains_vert(eid,vid0) && edge_contains_vert(eid,vid1))
@@ -1013,9 +1184,9 @@ double AbstractMesh<M,V,E,P>::poly_sample_param_at(const uint pid, const double
     {
         switch(tex_coord)
         {
-            case U_param : val += bc[off] * this->vert_data(this->poly_vert_id(pid,off)).uvw[0]; break;
-            case V_param : val += bc[off] * this->vert_data(this->poly_vert_id(pid,off)).uvw[1]; break;
-            case W_param : val += bc[off] * this->vert_data(this->poly_vert_id(pid,off)).uvw[2]; break;
+            case U_param : val += bc[off] * this->vert_uvw(this->poly_vert_id(pid,off))[0]; break;
+            case V_param : val += bc[off] * this->vert_uvw(this->poly_vert_id(pid,off))[1]; break;
+            case W_param : val += bc[off] * this->vert_uvw(this->poly_vert_id(pid,off))[2]; break;
             default: assert(false);
         }
     }
@@ -1476,4 +1647,162 @@ void AbstractMesh<M,V,E,P>::poly_set_flag(const int flag, const bool b, const st
         this->poly_data(pid).flags[flag] = b;
     }
 }
- }
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::write_CINO_topology(CinoBinaryWriter & w, const bool with_adjacency) const
+{
+    w.write       ("verts", verts);
+    w.write_nested("polys", polys);
+    if(with_adjacency)
+    {
+        w.write       ("edges", edges);
+        w.write_nested("v2v",   v2v);
+        w.write_nested("v2e",   v2e);
+        w.write_nested("v2p",   v2p);
+        w.write_nested("e2p",   e2p);
+        w.write_nested("p2e",   p2e);
+        w.write_nested("p2p",   p2p);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool AbstractMesh<M,V,E,P>::read_CINO_topology(const CinoBinaryReader & r)
+{
+    if(!r.has("edges")) return false;
+
+    bool ok = r.read       ("verts", verts) &&
+              r.read_nested("polys", polys) &&
+              r.read       ("edges", edges) &&
+              r.read_nested("v2v",   v2v)   &&
+              r.read_nested("v2e",   v2e)   &&
+              r.read_nested("v2p",   v2p)   &&
+              r.read_nested("e2p",   e2p)   &&
+              r.read_nested("p2e",   p2e)   &&
+              r.read_nested("p2p",   p2p);
+
+    // ids index other containers: make sure they are in range. Poly ids are
+    // checked by the callers, as they refer to verts (polygon meshes) or faces
+    // (polyhedral meshes)
+    size_t nv = verts.size();
+    size_t ne = edges.size()/2;
+    size_t np = polys.size();
+    ok = ok && edges.size()%2==0   && ids_in_range(edges, nv) &&
+         v2v.size()==nv && ids_in_range(v2v, nv) &&
+         v2e.size()==nv && ids_in_range(v2e, ne) &&
+         v2p.size()==nv && ids_in_range(v2p, np) &&
+         e2p.size()==ne && ids_in_range(e2p, np) &&
+         p2e.size()==np && ids_in_range(p2e, ne) &&
+         p2p.size()==np && ids_in_range(p2p, np);
+    if(!ok)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_CINO_topology() : missing or corrupted adjacency " << std::endl;
+        exit(-1);
+    }
+
+    v_data.resize(num_verts());
+    e_data.resize(num_edges());
+    p_data.resize(num_polys());
+    v_props.resize(num_verts());
+    e_props.resize(num_edges());
+    p_props.resize(num_polys());
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::write_CINO_attributes(CinoBinaryWriter & w) const
+{
+    // lazily allocated attributes are stored only if they have been used
+    if(v_props.normal.allocated())  w.write("v.normal",  v_props.normal.data);
+    if(v_props.uvw.allocated())     w.write("v.uvw",     v_props.uvw.data);
+    if(v_props.quality.allocated()) w.write("v.quality", v_props.quality.data);
+
+    uint nv = num_verts();
+    std::vector<Color>   v_col(nv);
+    std::vector<int>     v_lab(nv);
+    std::vector<uint8_t> v_flg(nv);
+    for(uint vid=0; vid<nv; ++vid)
+    {
+        v_col[vid] = vert_data(vid).color;
+        v_lab[vid] = vert_data(vid).label;
+        v_flg[vid] = uint8_t(vert_data(vid).flags.to_ulong());
+    }
+    w.write("v.color",   v_col);
+    w.write("v.label",   v_lab);
+    w.write("v.flags",   v_flg);
+
+    uint ne = num_edges();
+    std::vector<Color>   e_col(ne);
+    std::vector<int>     e_lab(ne);
+    std::vector<uint8_t> e_flg(ne);
+    for(uint eid=0; eid<ne; ++eid)
+    {
+        e_col[eid] = edge_data(eid).color;
+        e_lab[eid] = edge_data(eid).label;
+        e_flg[eid] = uint8_t(edge_data(eid).flags.to_ulong());
+    }
+    w.write("e.color", e_col);
+    w.write("e.label", e_lab);
+    w.write("e.flags", e_flg);
+
+    if(p_props.quality.allocated()) w.write("p.quality", p_props.quality.data);
+
+    uint np = num_polys();
+    std::vector<Color>   p_col(np);
+    std::vector<int>     p_lab(np);
+    std::vector<uint8_t> p_flg(np);
+    for(uint pid=0; pid<np; ++pid)
+    {
+        p_col[pid] = poly_data(pid).color;
+        p_lab[pid] = poly_data(pid).label;
+        p_flg[pid] = uint8_t(poly_data(pid).flags.to_ulong());
+    }
+    w.write("p.color",   p_col);
+    w.write("p.label",   p_lab);
+    w.write("p.flags",   p_flg);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::read_CINO_attributes(const CinoBinaryReader & r)
+{
+    // attributes are optional: only the ones found in the file (and
+    // consistent with the number of mesh elements) are applied
+
+    std::vector<vec3d>   vec;
+    std::vector<Color>   col;
+    std::vector<int>     lab;
+    std::vector<float>   qlt;
+    std::vector<uint8_t> flg;
+
+    uint nv = num_verts();
+    if(r.read("v.normal",  vec) && vec.size()==nv) for(uint vid=0; vid<nv; ++vid) vert_normal(vid)  = vec[vid];
+    if(r.read("v.uvw",     vec) && vec.size()==nv) for(uint vid=0; vid<nv; ++vid) vert_uvw(vid)     = vec[vid];
+    if(r.read("v.color",   col) && col.size()==nv) for(uint vid=0; vid<nv; ++vid) vert_data(vid).color   = col[vid];
+    if(r.read("v.label",   lab) && lab.size()==nv) for(uint vid=0; vid<nv; ++vid) vert_data(vid).label   = lab[vid];
+    if(r.read("v.quality", qlt) && qlt.size()==nv) for(uint vid=0; vid<nv; ++vid) vert_quality(vid) = qlt[vid];
+    if(r.read("v.flags",   flg) && flg.size()==nv) for(uint vid=0; vid<nv; ++vid) vert_data(vid).flags   = flg[vid];
+
+    uint ne = num_edges();
+    if(r.read("e.color", col) && col.size()==ne) for(uint eid=0; eid<ne; ++eid) edge_data(eid).color = col[eid];
+    if(r.read("e.label", lab) && lab.size()==ne) for(uint eid=0; eid<ne; ++eid) edge_data(eid).label = lab[eid];
+    if(r.read("e.flags", flg) && flg.size()==ne) for(uint eid=0; eid<ne; ++eid) edge_data(eid).flags = flg[eid];
+
+    uint np = num_polys();
+    if(r.read("p.color",   col) && col.size()==np) for(uint pid=0; pid<np; ++pid) poly_data(pid).color   = col[pid];
+    if(r.read("p.label",   lab) && lab.size()==np) for(uint pid=0; pid<np; ++pid) poly_data(pid).label   = lab[pid];
+    if(r.read("p.quality", qlt) && qlt.size()==np) for(uint pid=0; pid<np; ++pid) poly_quality(pid) = qlt[pid];
+    if(r.read("p.flags",   flg) && flg.size()==np) for(uint pid=0; pid<np; ++pid) poly_data(pid).flags   = flg[pid];
+}
+
+}
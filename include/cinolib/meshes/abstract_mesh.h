@@ -45,6 +45,10 @@
 #include <cinolib/color.h>
 #include <cinolib/symbols.h>
 #include <cinolib/ipair.h>
+#include <cinolib/io/read_CINO.h>
+#include <cinolib/io/write_CINO.h>
+#include <cinolib/meshes/mesh_properties.h>
+#include <cinolib/meshes/id_hash_table.h>
 
 typedef enum
 {
@@ -75,11 +79,17 @@ class AbstractMesh
         std::vector<uint>              edges;
         std::vector<std::vector<uint>> polys; // either polygons or polyhedra
 
+        // standard attributes (array of structures, allocated for every element).
+        // Normals, uvw, quality and AO are instead stored in the property containers
         M              m_data;
         std::vector<V> v_data;
         std::vector<E> e_data;
         std::vector<P> p_data;
 
+        PropertyContainer v_props; // per vertex properties (user defined + heavy std attributes), allocated on first use (see mesh_properties.h)
+        PropertyContainer e_props; // per edge   properties
+        PropertyContainer p_props; // per poly   properties
+
         std::vector<std::vector<uint>> v2v; // vert to vert adjacency
         std::vector<std::vector<uint>> v2e; // vert to edge adjacency
         std::vector<std::vector<uint>> v2p; // vert to poly adjacency
@@ -87,6 +97,40 @@ class AbstractMesh
         std::vector<std::vector<uint>> p2e; // poly to edge adjacency
         std::vector<std::vector<uint>> p2p; // poly to poly adjacency
 
+        // optional index for constant time edge_id queries (see hash_index_enable).
+        // The helpers below are no-ops if the index is disabled
+        bool        hash_index = false;
+        IdHashTable e_index;
+        void        e_index_insert(const uint eid);
+        void        e_index_erase (const uint eid);
+        void        e_index_switch(const uint eid0, const uint eid1); // call it before swapping the edges
+
+        // transaction mode (see batch_begin). Removed elements are only marked as dead,
+        // and are physically deleted all at once by compact()
+        bool              batch = false;
+        std::vector<bool> v_dead;
+        std::vector<bool> e_dead;
+        std::vector<bool> p_dead;
+        uint              n_dead_verts = 0;
+        uint              n_dead_edges = 0;
+        uint              n_dead_polys = 0;
+        void              vert_mark_removed(const uint vid);
+        void              edge_mark_removed(const uint eid);
+        void              poly_mark_removed(const uint pid);
+        void              batch_reset();
+
+        // helpers for compact(). keep is the sorted list of surviving ids, new_id maps old ids to new ids
+        static void compact_ids(const std::vector<bool> & dead, const uint n, std::vector<uint> & keep, std::vector<uint> & new_id);
+        static void compact_adj(std::vector<std::vector<uint>> & adj, const std::vector<uint> & keep, const std::vector<uint> & new_id);
+        template<class T>
+        static void compact_vec(std::vector<T> & vec, const std::vector<uint> & keep);
+
+        // helpers for the CinoLib native binary format (see io/read_CINO.h)
+        void write_CINO_topology  (CinoBinaryWriter       & w, const bool with_adjacency) const;
+        bool read_CINO_topology   (const CinoBinaryReader & r); // returns false if adjacency is not stored
+        void write_CINO_attributes(CinoBinaryWriter       & w) const;
+        void read_CINO_attributes (const CinoBinaryReader & r);
+
     public:
 
         typedef M M_type;
@@ -108,6 +152,10 @@ class AbstractMesh
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        // removes all elements and attributes. User defined properties are removed as well
+        // (both their data and their registration, hence they must be accessed again
+        // with vert_property<T>(name) etc.), and the memory of the lazily allocated
+        // standard attributes is released
         virtual void clear();
         virtual void load(const char * filename) = 0;
         virtual void save(const char * filename) const = 0;
@@ -131,6 +179,35 @@ class AbstractMesh
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        // When enabled, edge_id (and poly_id, for surface meshes) are answered with a hash
+        // lookup rather than scanning the star of a vertex, which pays off in tight loops and
+        // around high valence vertices. The index costs a few tens of bytes per element, and
+        // is kept in sync by all the topological editing operators. Code that edits the mesh
+        // directly through vector_edges() or vector_polys() must call hash_index_enable()
+        // again afterwards, to rebuild it
+        virtual void hash_index_enable (const bool b = true);
+                bool hash_index_enabled() const { return hash_index; }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // Transaction mode for mass topological editing. Between batch_begin() and batch_end()
+        // removed elements are not replaced with the last element of their array (which costs
+        // an update of all its adjacencies), but are marked as dead, and ids remain stable for
+        // the whole batch. batch_end() (or compact()) deletes all the dead elements in a single
+        // parallel pass, preserving the relative order of the survivors. Final ids therefore
+        // differ from the ones obtained by removing elements one by one. During a batch the
+        // num_verts(), num_edges()... counters include dead elements, which have no adjacency
+        // and can be recognized with vert_is_removed(), edge_is_removed()...
+                void batch_begin();
+                void batch_end() { compact(); }
+                bool batch_is_active() const { return batch; }
+        virtual void compact() = 0;
+                bool vert_is_removed(const uint vid) const { return vid<v_dead.size() && v_dead[vid]; }
+                bool edge_is_removed(const uint eid) const { return eid<e_dead.size() && e_dead[eid]; }
+                bool poly_is_removed(const uint pid) const { return pid<p_dead.size() && p_dead[pid]; }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         virtual int genus() const = 0;
         virtual int Euler_characteristic() const = 0;
 
@@ -206,6 +283,48 @@ class AbstractMesh
         const P & poly_data(const uint pid) const { return p_data.at(pid); }
               P & poly_data(const uint pid)       { return p_data.at(pid); }
 
+        // heavy standard attributes, stored in lazily allocated arrays (see mesh_properties.h).
+        // The non const accessors allocate the array on first use, the const ones return the
+        // default value (zero, or 1 for AO) if the attribute has never been set
+        const vec3d & vert_normal (const uint vid) const { return v_props.normal.at(vid);                 }
+              vec3d & vert_normal (const uint vid)       { return v_props.normal.at(vid, num_verts());    }
+        const vec3d & vert_uvw    (const uint vid) const { return v_props.uvw.at(vid);                    }
+              vec3d & vert_uvw    (const uint vid)       { return v_props.uvw.at(vid, num_verts());       }
+        const float & vert_quality(const uint vid) const { return v_props.quality.at(vid);                }
+              float & vert_quality(const uint vid)       { return v_props.quality.at(vid, num_verts());   }
+        const float & poly_quality(const uint pid) const { return p_props.quality.at(pid);                }
+              float & poly_quality(const uint pid)       { return p_props.quality.at(pid, num_polys());   }
+
+        // copies all the attributes of element src of mesh m (both the per element struct
+        // and the lazily allocated ones that are in use) onto element dst of this mesh
+        void vert_copy_attributes(const uint dst, const AbstractMesh & m, const uint src) { v_data.at(dst) = m.v_data.at(src); v_props.copy_std(dst, m.v_props, src, num_verts()); }
+        void poly_copy_attributes(const uint dst, const AbstractMesh & m, const uint src) { p_data.at(dst) = m.p_data.at(src); p_props.copy_std(dst, m.p_props, src, num_polys()); }
+        void vert_copy_attributes(const uint dst, const uint src) { vert_copy_attributes(dst, *this, src); }
+        void poly_copy_attributes(const uint dst, const uint src) { poly_copy_attributes(dst, *this, src); }
+
+        // read only access to the property containers (e.g. to check which standard attributes are in use)
+        const PropertyContainer & vert_properties() const { return v_props; }
+        const PropertyContainer & edge_properties() const { return e_props; }
+        const PropertyContainer & poly_properties() const { return p_props; }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // dynamic properties, stored as one array per property (see mesh_properties.h).
+        // Properties are created on first access, and are kept aligned with element
+        // ids by all the topological editing operators
+        template<typename T> std::vector<T> & vert_property(const std::string & name, const T & def = T()) { return v_props.template get<T>(name, num_verts(), def); }
+        template<typename T> std::vector<T> & edge_property(const std::string & name, const T & def = T()) { return e_props.template get<T>(name, num_edges(), def); }
+        template<typename T> std::vector<T> & poly_property(const std::string & name, const T & def = T()) { return p_props.template get<T>(name, num_polys(), def); }
+        template<typename T> const std::vector<T> & vert_property(const std::string & name) const { return v_props.template get<T>(name); }
+        template<typename T> const std::vector<T> & edge_property(const std::string & name) const { return e_props.template get<T>(name); }
+        template<typename T> const std::vector<T> & poly_property(const std::string & name) const { return p_props.template get<T>(name); }
+        bool vert_property_exists(const std::string & name) const { return v_props.exists(name); }
+        bool edge_property_exists(const std::string & name) const { return e_props.exists(name); }
+        bool poly_property_exists(const std::string & name) const { return p_props.exists(name); }
+        void vert_property_remove(const std::string & name)       { v_props.remove(name);        }
+        void edge_property_remove(const std::string & name)       { e_props.remove(name);        }
+        void poly_property_remove(const std::string & name)       { p_props.remove(name);        }
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         // useful for GUIs with mouse picking
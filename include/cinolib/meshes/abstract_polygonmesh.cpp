@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/meshes/abstract_polygonmesh.h>
+#include <cinolib/profiler_zones.h>
 #include <cinolib/to_openGL_unified_verts.h>
 #include <cinolib/io/read_write.h>
 #include <cinolib/quality.h>
@@ -41,6 +42,8 @@
 #include <cinolib/geometry/polygon_utils.h>
 #include <cinolib/vector_serialization.h>
 #include <cinolib/how_many_seconds.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/string_utilities.h>
 #include <cinolib/deg_rad.h>
 #include <unordered_set>
 #include <cinolib/ANSI_color_codes.h>
@@ -70,7 +73,13 @@ void AbstractPolygonMesh<M,V,E,P>::load(const char * filename)
     std::string str(filename);
     std::string filetype = str.substr(str.size()-4,4);
 
-    if (filetype.compare(".off") == 0 ||
+    if (get_file_extension(str).compare("cino") == 0 ||
+        get_file_extension(str).compare("CINO") == 0)
+    {
+        load_CINO(filename);
+        return;
+    }
+    else if (filetype.compare(".off") == 0 ||
         filetype.compare(".OFF") == 0)
     {
         read_OFF(filename, pos, poly_pos, poly_col);
@@ -107,7 +116,12 @@ void AbstractPolygonMesh<M,V,E,P>::save(const char * filename) const
     std::string str(filename);
     std::string filetype = str.substr(str.size()-3,3);
 
-    if (filetype.compare("off") == 0 ||
+    if (get_file_extension(str).compare("cino") == 0 ||
+        get_file_extension(str).compare("CINO") == 0)
+    {
+        save_CINO(filename);
+    }
+    else if (filetype.compare("off") == 0 ||
         filetype.compare("OFF") == 0)
     {
         write_OFF(filename, coords, this->polys);
@@ -128,9 +142,9 @@ void AbstractPolygonMesh<M,V,E,P>::save(const char * filename) const
         normals.reserve(3*this->num_polys());
         for (uint pid=0; pid<this->num_polys(); ++pid)
         {
-            normals.push_back(this->poly_data(pid).normal.x());
-            normals.push_back(this->poly_data(pid).normal.y());
-            normals.push_back(this->poly_data(pid).normal.z());
+            normals.push_back(this->poly_normal(pid).x());
+            normals.push_back(this->poly_normal(pid).y());
+            normals.push_back(this->poly_normal(pid).z());
         }
 
         write_STL(filename, serialized_xyz_from_vec3d(this->vector_verts()), this->polys, normals);
@@ -143,12 +157,196 @@ void AbstractPolygonMesh<M,V,E,P>::save(const char * filename) const
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::load_CINO(const char * filename)
+{
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    this->clear();
+    this->mesh_data().filename = std::string(filename);
+
+    CinoBinaryReader r(filename);
+    if(r.mesh_type()!=uint32_t(this->mesh_type()) && this->mesh_type()!=POLYGONMESH)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load_CINO() : mesh type mismatch " << std::endl;
+        exit(-1);
+    }
+    if(r.mesh_type()>POLYGONMESH)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load_CINO() : file does not contain a surface mesh " << std::endl;
+        exit(-1);
+    }
+
+    bool has_adjacency = this->read_CINO_topology(r);
+    if(has_adjacency)
+    {
+        if(!ids_in_range(this->polys, this->num_verts()))
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load_CINO() : missing or corrupted adjacency " << std::endl;
+            exit(-1);
+        }
+        // the tessellation is cheap to recompute: do it if it is missing or corrupted
+        if(!r.read_nested("p_tris", poly_triangles) ||
+           poly_triangles.size()!=this->num_polys() ||
+           !ids_in_range(poly_triangles, this->num_verts()))
+        {
+            update_p_tessellations();
+        }
+        if(this->mesh_data().update_bbox) this->update_bbox();
+        if(this->hash_index) hash_index_enable(true);
+    }
+    else
+    {
+        // no adjacency in the file: build it from scratch
+        std::vector<vec3d>             verts;
+        std::vector<std::vector<uint>> polys;
+        bool ok = r.read       ("verts", verts) &&
+                  r.read_nested("polys", polys) &&
+                  ids_in_range(polys, verts.size());
+        if(!ok)
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load_CINO() : missing or corrupted topology " << std::endl;
+            exit(-1);
+        }
+        init(verts, polys);
+    }
+
+    this->read_CINO_attributes(r);
+    std::vector<vec3d> p_nor;
+    std::vector<float> p_AO;
+    if(r.read("p.normal", p_nor) && p_nor.size()==this->num_polys()) for(uint pid=0; pid<this->num_polys(); ++pid) this->poly_normal(pid) = p_nor[pid];
+    if(r.read("p.AO",     p_AO ) && p_AO.size() ==this->num_polys()) for(uint pid=0; pid<this->num_polys(); ++pid) this->poly_AO(pid)     = p_AO [pid];
+
+    if(has_adjacency)
+    {
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+        std::cout << "load mesh\t"     <<
+                     this->num_verts() << "V / " <<
+                     this->num_edges() << "E / " <<
+                     this->num_polys() << "P  [" <<
+                     how_many_seconds(t0,t1) << "s]" << std::endl;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::save_CINO(const char * filename, const bool with_adjacency) const
+{
+    CinoBinaryWriter w(filename, uint32_t(this->mesh_type()));
+    this->write_CINO_topology(w, with_adjacency);
+    if(with_adjacency) w.write_nested("p_tris", poly_triangles);
+    this->write_CINO_attributes(w);
+    if(this->p_props.normal.allocated()) w.write("p.normal", this->p_props.normal.data);
+    if(this->p_props.AO.allocated())     w.write("p.AO",     this->p_props.AO.data);
+    w.close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::clear()
 {
     AbstractMesh<M,V,E,P>::clear();
     poly_triangles.clear();
+    p_index.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::hash_index_enable(const bool b)
+{
+    AbstractMesh<M,V,E,P>::hash_index_enable(b);
+    p_index = IdHashTable();
+    if(!b) return;
+    p_index.reserve(this->num_polys());
+    for(uint pid=0; pid<this->num_polys(); ++pid) if(!this->poly_is_removed(pid)) p_index_insert(pid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::compact()
+{
+    if(this->n_dead_verts==0 && this->n_dead_edges==0 && this->n_dead_polys==0)
+    {
+        this->batch_reset();
+        return;
+    }
+
+    std::vector<uint> v_keep, v_map;
+    std::vector<uint> e_keep, e_map;
+    std::vector<uint> p_keep, p_map;
+    this->compact_ids(this->v_dead, this->num_verts(), v_keep, v_map);
+    this->compact_ids(this->e_dead, this->num_edges(), e_keep, e_map);
+    this->compact_ids(this->p_dead, this->num_polys(), p_keep, p_map);
+
+    // vertices
+    this->compact_vec(this->verts,  v_keep);
+    this->compact_vec(this->v_data, v_keep);
+    this->v_props.compact(v_keep);
+    this->compact_adj(this->v2v, v_keep, v_map);
+    this->compact_adj(this->v2e, v_keep, e_map);
+    this->compact_adj(this->v2p, v_keep, p_map);
+
+    // edges
+    for(uint i=0; i<e_keep.size(); ++i)
+    {
+        this->edges[2*i  ] = v_map.at(this->edges[2*e_keep[i]  ]);
+        this->edges[2*i+1] = v_map.at(this->edges[2*e_keep[i]+1]);
+    }
+    this->edges.resize(2*e_keep.size());
+    this->compact_vec(this->e_data, e_keep);
+    this->e_props.compact(e_keep);
+    this->compact_adj(this->e2p, e_keep, p_map);
+
+    // polygons
+    this->compact_adj(this->polys,    p_keep, v_map);
+    this->compact_adj(poly_triangles, p_keep, v_map);
+    this->compact_vec(this->p_data,   p_keep);
+    this->p_props.compact(p_keep);
+    this->compact_adj(this->p2e, p_keep, e_map);
+    this->compact_adj(this->p2p, p_keep, p_map);
+
+    this->batch_reset();
+    if(this->hash_index) hash_index_enable(true);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::p_index_insert(const uint pid)
+{
+    if(this->hash_index) p_index.insert(vert_set_key(this->polys.at(pid)), pid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::p_index_erase(const uint pid)
+{
+    if(this->hash_index) p_index.erase(vert_set_key(this->polys.at(pid)), pid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::p_index_switch(const uint pid0, const uint pid1)
+{
+    if(!this->hash_index) return;
+    // a poly being removed has been erased from the index already (replace is a no-op then)
+    p_index.replace(vert_set_key(this->polys.at(pid0)), pid0, pid1);
+    p_index.replace(vert_set_key(this->polys.at(pid1)), pid1, pid0);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -158,6 +356,8 @@ CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::init(const std::vector<vec3d>             & verts,
                                         const std::vector<std::vector<uint>> & polys)
 {
+    CINO_PROFILE_ZONE("AbstractPolygonMesh::init");
+    CINO_PROFILE_COUNTER("AbstractPolygonMesh::init polys", polys.size());
     std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
 
     // pre-allocate memory
@@ -202,6 +402,135 @@ void AbstractPolygonMesh<M,V,E,P>::init(const std::vector<vec3d>             & v
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::init_bulk(const std::vector<vec3d>             & verts,
+                                             const std::vector<std::vector<uint>> & polys)
+{
+    CINO_PROFILE_ZONE("AbstractPolygonMesh::init_bulk");
+    CINO_PROFILE_COUNTER("AbstractPolygonMesh::init_bulk polys", polys.size());
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    assert(this->num_verts()==0 && this->num_polys()==0);
+
+    // vertices
+    uint nv = uint(verts.size());
+    uint np = uint(polys.size());
+    this->verts = verts;
+    this->v_data.resize(nv);
+    this->v_props.resize(nv);
+    this->v2v.resize(nv);
+    this->v2e.resize(nv);
+    this->v2p.resize(nv);
+    if(this->mesh_data().update_bbox)
+    {
+        for(const vec3d & pos : verts)
+        {
+            this->bb.min = this->bb.min.min(pos);
+            this->bb.max = this->bb.max.max(pos);
+        }
+    }
+
+    // polygons
+    uint ne = uint(1.5*np);
+    this->polys = polys;
+    this->p_data.resize(np);
+    this->p_props.resize(np);
+    this->p2e.resize(np);
+    this->p2p.resize(np);
+    this->poly_triangles.resize(np);
+    this->edges.reserve(ne*2);
+    this->e2p.reserve(ne);
+    this->e_data.reserve(ne);
+
+    // pre-allocate adjacency lists, so that they do not grow one element at a time
+    // (in a manifold mesh the number of edges incident to a vertex is at most the
+    // number of incident polygons plus one)
+    std::vector<uint> v_valence(nv, 0);
+    for(const auto & vlist : polys) for(uint vid : vlist) ++v_valence.at(vid);
+    for(uint vid=0; vid<nv; ++vid)
+    {
+        this->v2v.at(vid).reserve(v_valence.at(vid)+1);
+        this->v2e.at(vid).reserve(v_valence.at(vid)+1);
+        this->v2p.at(vid).reserve(v_valence.at(vid));
+    }
+
+    // connectivity. Same logic (and order) of poly_add, but edges are searched directly
+    // in the vertex stars and adjacent polygons in the list of the polygon being added,
+    // which avoids all the temporary vectors of edge_id, poly_id and polys_are_adjacent
+    for(uint pid=0; pid<np; ++pid)
+    {
+        const std::vector<uint> & vlist = polys.at(pid);
+        for(uint vid : vlist)
+        {
+            assert(vid < nv);
+            this->v2p.at(vid).push_back(pid);
+        }
+        this->p2e.at(pid).reserve(vlist.size());
+        this->p2p.at(pid).reserve(vlist.size());
+        for(uint i=0; i<vlist.size(); ++i)
+        {
+            uint vid0 = vlist.at(i);
+            uint vid1 = vlist.at((i+1)%vlist.size());
+            int  eid  = -1;
+            for(uint e : this->v2e.at(vid0))
+            {
+                if(this->edges.at(2*e)==vid1 || this->edges.at(2*e+1)==vid1)
+                {
+                    eid = e;
+                    break;
+                }
+            }
+            if(eid == -1)
+            {
+                eid = this->edge_add(vid0, vid1);
+                this->e2p.at(eid).reserve(2);
+            }
+
+            for(uint nbr : this->e2p.at(eid))
+            {
+                assert(nbr!=pid);
+                if(CONTAINS_VEC(this->p2p.at(pid), nbr)) continue;
+                this->p2p.at(nbr).push_back(pid);
+                this->p2p.at(pid).push_back(nbr);
+            }
+            this->e2p.at(eid).push_back(pid);
+            this->p2e.at(pid).push_back(eid);
+        }
+    }
+
+    if(this->hash_index)
+    {
+        p_index.reserve(np);
+        for(uint pid=0; pid<np; ++pid) p_index_insert(pid);
+    }
+
+    // normals and tessellations only depend on the polygon itself
+    PARALLEL_FOR(0, np, 1000, [&](const uint pid)
+    {
+        if(this->mesh_data().update_normals) this->update_p_normal(pid);
+        update_p_tessellation(pid);
+    });
+
+    if(this->mesh_data().update_normals) this->update_v_normals();
+
+    this->copy_xyz_to_uvw(UVW_param);
+
+    for(uint eid=0; eid<this->num_edges(); ++eid)
+    {
+        this->edge_data(eid).flags[MARKED] = (this->edge_is_boundary(eid) || !this->edge_is_manifold(eid));
+    }
+
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+    std::cout << "load mesh\t"     <<
+                 this->num_verts() << "V / " <<
+                 this->num_edges() << "E / " <<
+                 this->num_polys() << "P  [" <<
+                 how_many_seconds(t0,t1) << "s]" << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::init(      std::vector<vec3d>             & pos,       // vertex xyz positions
@@ -255,7 +584,7 @@ void AbstractPolygonMesh<M,V,E,P>::init(      std::vector<vec3d>             & p
         std::cout << "load textures" << std::endl;
         for(uint vid=0; vid<this->num_verts(); ++vid)
         {
-            this->vert_data(vid).uvw = tex.at(vid);
+            this->vert_uvw(vid) = tex.at(vid);
         }
     }
     else this->copy_xyz_to_uvw(UVW_param);
@@ -266,7 +595,7 @@ void AbstractPolygonMesh<M,V,E,P>::init(      std::vector<vec3d>             & p
         std::cout << "load normals" << std::endl;
         for(uint vid=0; vid<this->num_verts(); ++vid)
         {
-            this->vert_data(vid).normal = nor.at(vid);
+            this->vert_normal(vid) = nor.at(vid);
         }
     }
 
@@ -347,10 +676,10 @@ void AbstractPolygonMesh<M,V,E,P>::update_v_normal(const uint vid)
     vec3d n(0,0,0);
     for(uint pid : this->adj_v2p(vid))
     {
-        n += this->poly_data(pid).normal;
+        n += this->poly_normal(pid);
     }
     if (n.norm()>0) n.normalize();
-    this->vert_data(vid).normal = n;
+    this->vert_normal(vid) = n;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -362,7 +691,7 @@ void AbstractPolygonMesh<M,V,E,P>::update_p_normal(const uint pid)
     // compute the best fitting plane
     std::vector<vec3d> points;
     for(uint off=0; off<this->verts_per_poly(pid); ++off) points.push_back(this->poly_vert(pid,off));
-    this->poly_data(pid).normal = polygon_normal(points);
+    this->poly_normal(pid) = polygon_normal(points);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -407,6 +736,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::update_normals()
 {
+    CINO_PROFILE_ZONE("AbstractPolygonMesh::update_normals");
     this->update_p_normals();
     this->update_v_normals();
 }
@@ -417,9 +747,9 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 int AbstractPolygonMesh<M,V,E,P>::Euler_characteristic() const
 {
-    uint nv = this->num_verts();
-    uint ne = this->num_edges();
-    uint np = this->num_polys();
+    uint nv = this->num_verts() - this->n_dead_verts;
+    uint ne = this->num_edges() - this->n_dead_edges;
+    uint np = this->num_polys() - this->n_dead_polys;
     return nv - ne + np;
 }
 
@@ -478,7 +808,7 @@ double AbstractPolygonMesh<M,V,E,P>::mesh_volume() const
             vec3d C    = this->vert(this->poly_tessellation(pid).at(3*i+2));
 
             vec3d OA   = A - O;
-            vec3d n    = this->poly_data(pid).normal;
+            vec3d n    = this->poly_normal(pid);
 
             vol += (n.dot(OA) > 0) ?  tet_unsigned_volume(A,B,C,O)
                                    : -tet_unsigned_volume(A,B,C,O);
@@ -503,9 +833,9 @@ bool AbstractPolygonMesh<M,V,E,P>::vert_is_saddle(const uint vid, const int tex_
         //
         switch (tex_coord)
         {
-            case U_param : if (this->vert_data(nbr).uvw[0] != this->vert_data(vid).uvw[0]) signs.push_back(this->vert_data(nbr).uvw[0] > this->vert_data(vid).uvw[0]); break;
-            case V_param : if (this->vert_data(nbr).uvw[1] != this->vert_data(vid).uvw[1]) signs.push_back(this->vert_data(nbr).uvw[1] > this->vert_data(vid).uvw[1]); break;
-            case W_param : if (this->vert_data(nbr).uvw[2] != this->vert_data(vid).uvw[2]) signs.push_back(this->vert_data(nbr).uvw[2] > this->vert_data(vid).uvw[2]); break;
+            case U_param : if (this->vert_uvw(nbr)[0] != this->vert_uvw(vid)[0]) signs.push_back(this->vert_uvw(nbr)[0] > this->vert_uvw(vid)[0]); break;
+            case V_param : if (this->vert_uvw(nbr)[1] != this->vert_uvw(vid)[1]) signs.push_back(this->vert_uvw(nbr)[1] > this->vert_uvw(vid)[1]); break;
+            case W_param : if (this->vert_uvw(nbr)[2] != this->vert_uvw(vid)[2]) signs.push_back(this->vert_uvw(nbr)[2] > this->vert_uvw(vid)[2]); break;
             default: assert(false);
         }
     }
@@ -857,7 +1187,7 @@ std::vector<uint> AbstractPolygonMesh<M,V,E,P>::vert_adj_visible_polys(const uin
     {
         if(!this->poly_data(pid).flags[HIDDEN])
         {
-            vec3d n = this->poly_data(pid).normal;
+            vec3d n = this->poly_normal(pid);
             if(dir.angle_deg(n) < ang_thresh) nbrs.push_back(pid);
         }
     }
@@ -876,6 +1206,7 @@ uint AbstractPolygonMesh<M,V,E,P>::vert_add(const vec3d & pos)
     //
     V data;
     this->v_data.push_back(data);
+    this->v_props.push_back();
     //
     this->v2v.push_back(std::vector<uint>());
     this->v2e.push_back(std::vector<uint>());
@@ -926,6 +1257,7 @@ void AbstractPolygonMesh<M,V,E,P>::vert_switch_id(const uint vid0, const uint vi
 
     std::swap(this->verts.at(vid0),  this->verts.at(vid1));
     std::swap(this->v_data.at(vid0), this->v_data.at(vid1));
+    this->v_props.swap(vid0, vid1);
     std::swap(this->v2v.at(vid0),    this->v2v.at(vid1));
     std::swap(this->v2e.at(vid0),    this->v2e.at(vid1));
     std::swap(this->v2p.at(vid0),    this->v2p.at(vid1));
@@ -951,6 +1283,10 @@ void AbstractPolygonMesh<M,V,E,P>::vert_switch_id(const uint vid0, const uint vi
         }
     }
 
+    // keys of the hash index depend on vertex ids: re-insert the elements being renamed
+    for(uint eid : edges_to_update) this->e_index_erase(eid);
+    for(uint pid : polys_to_update) p_index_erase(pid);
+
     for(uint eid : edges_to_update)
     {
         for(uint i=0; i<2; ++i)
@@ -974,6 +1310,9 @@ void AbstractPolygonMesh<M,V,E,P>::vert_switch_id(const uint vid0, const uint vi
             if (vid == vid1) vid = vid0;
         }
     }
+
+    for(uint eid : edges_to_update) this->e_index_insert(eid);
+    for(uint pid : polys_to_update) p_index_insert(pid);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -994,9 +1333,15 @@ void AbstractPolygonMesh<M,V,E,P>::vert_remove_unreferenced(const uint vid)
     this->v2v.at(vid).clear();
     this->v2e.at(vid).clear();
     this->v2p.at(vid).clear();
+    if(this->batch)
+    {
+        this->vert_mark_removed(vid);
+        return;
+    }
     vert_switch_id(vid, this->num_verts()-1);
     this->verts.pop_back();
     this->v_data.pop_back();
+    this->v_props.pop_back();
     this->v2v.pop_back();
     this->v2e.pop_back();
     this->v2p.pop_back();
@@ -1023,8 +1368,8 @@ double AbstractPolygonMesh<M,V,E,P>::edge_dihedral_angle(const uint eid) const
 
     uint   pid0 = this->adj_e2p(eid).front();
     uint   pid1 = this->adj_e2p(eid).back();
-    vec3d  n0   = this->poly_data(pid0).normal;
-    vec3d  n1   = this->poly_data(pid1).normal;
+    vec3d  n0   = this->poly_normal(pid0);
+    vec3d  n1   = this->poly_normal(pid1);
 
     return n0.angle_rad(n1);
 }
@@ -1103,6 +1448,7 @@ uint AbstractPolygonMesh<M,V,E,P>::edge_add(const uint vid0, const uint vid1)
     //
     E data;
     this->e_data.push_back(data);
+    this->e_props.push_back();
     //
     this->v2v.at(vid1).push_back(vid0);
     this->v2v.at(vid0).push_back(vid1);
@@ -1110,6 +1456,8 @@ uint AbstractPolygonMesh<M,V,E,P>::edge_add(const uint vid0, const uint vid1)
     this->v2e.at(vid0).push_back(eid);
     this->v2e.at(vid1).push_back(eid);
     //
+    this->e_index_insert(eid);
+    //
     return eid;
 }
 
@@ -1123,10 +1471,12 @@ void AbstractPolygonMesh<M,V,E,P>::edge_switch_id(const uint eid0, const uint ei
 
     if (eid0 == eid1) return;
 
+    this->e_index_switch(eid0, eid1);
     for(uint off=0; off<2; ++off) std::swap(this->edges.at(2*eid0+off), this->edges.at(2*eid1+off));
 
     std::swap(this->e2p.at(eid0),    this->e2p.at(eid1));
     std::swap(this->e_data.at(eid0), this->e_data.at(eid1));
+    this->e_props.swap(eid0, eid1);
 
     std::unordered_set<uint> verts_to_update;
     verts_to_update.insert(this->edge_vert_id(eid0,0));
@@ -1173,9 +1523,16 @@ CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::edge_remove_unreferenced(const uint eid)
 {
     this->e2p.at(eid).clear();
+    this->e_index_erase(eid);
+    if(this->batch)
+    {
+        this->edge_mark_removed(eid);
+        return;
+    }
     edge_switch_id(eid, this->num_edges()-1);
     this->edges.resize(this->edges.size()-2);
     this->e_data.pop_back();
+    this->e_props.pop_back();
     this->e2p.pop_back();
 }
 
@@ -1251,7 +1608,7 @@ double AbstractPolygonMesh<M,V,E,P>::poly_angle_at_vert(const uint pid, const ui
     vec3d  v      = this->poly_vert(pid, next) - p;
     double angle  = u.angle_rad(v);
 
-    if((-u).cross(v).dot(this->poly_data(pid).normal)<0)
+    if((-u).cross(v).dot(this->poly_normal(pid))<0)
     {
         angle = 2*M_PI - angle;
     }
@@ -1287,6 +1644,14 @@ int AbstractPolygonMesh<M,V,E,P>::poly_id(const std::vector<uint> & vlist) const
     assert(!vlist.empty());
     std::vector<uint> query = SORT_VEC(vlist);
 
+    if(this->hash_index)
+    {
+        return p_index.find(vert_set_key(vlist), [&](const uint pid)
+        {
+            return this->verts_per_poly(pid)==query.size() && this->poly_verts_id(pid,true)==query;
+        });
+    }
+
     uint vid = vlist.front();
     for(uint pid : this->adj_v2p(vid))
     {
@@ -1393,8 +1758,10 @@ void AbstractPolygonMesh<M,V,E,P>::poly_switch_id(const uint pid0, const uint pi
 
     if (pid0 == pid1) return;
 
+    p_index_switch(pid0, pid1);
     std::swap(this->polys.at(pid0),          this->polys.at(pid1));
     std::swap(this->p_data.at(pid0),         this->p_data.at(pid1));
+    this->p_props.swap(pid0, pid1);
     std::swap(this->p2e.at(pid0),            this->p2e.at(pid1));
     std::swap(this->p2p.at(pid0),            this->p2p.at(pid1));
     std::swap(this->poly_triangles.at(pid0), this->poly_triangles.at(pid1));
@@ -1456,9 +1823,11 @@ uint AbstractPolygonMesh<M,V,E,P>::poly_add(const std::vector<uint> & vlist)
 
     uint pid = this->num_polys();
     this->polys.push_back(vlist);
+    p_index_insert(pid);
 
     P data;
     this->p_data.push_back(data);
+    this->p_props.push_back();
 
     this->p2e.push_back(std::vector<uint>());
     this->p2p.push_back(std::vector<uint>());
@@ -1578,12 +1947,20 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::poly_remove_unreferenced(const uint pid)
 {
+    p_index_erase(pid);
     this->polys.at(pid).clear();
     this->p2e.at(pid).clear();
     this->p2p.at(pid).clear();
+    if(this->batch)
+    {
+        this->poly_triangles.at(pid).clear();
+        this->poly_mark_removed(pid);
+        return;
+    }
     poly_switch_id(pid, this->num_polys()-1);
     this->polys.pop_back();
     this->p_data.pop_back();
+    this->p_props.pop_back();
     this->p2e.pop_back();
     this->p2p.pop_back();
     this->poly_triangles.pop_back();
@@ -1732,6 +2109,17 @@ void AbstractPolygonMesh<M,V,E,P>::operator+=(const AbstractPolygonMesh<M,V,E,P>
         this->v2v.push_back(tmp);
     }
 
+    // user defined properties are not merged: appended elements get default values.
+    // Standard attributes (normals, uvw, quality, AO) are merged
+    this->v_props.resize(this->num_verts());
+    this->e_props.resize(this->num_edges());
+    this->p_props.resize(this->num_polys());
+    this->v_props.append_std(m.v_props, nv, this->num_verts());
+    this->p_props.append_std(m.p_props, np, this->num_polys());
+
+    for(uint eid=ne; eid<this->num_edges(); ++eid) this->e_index_insert(eid);
+    for(uint pid=np; pid<this->num_polys(); ++pid) p_index_insert(pid);
+
     if(this->mesh_data().update_bbox) this->update_bbox();
 
     std::cout << "Appended " << m.mesh_data().filename << " to mesh " << this->mesh_data().filename << std::endl;
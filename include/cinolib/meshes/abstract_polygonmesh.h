@@ -55,6 +55,12 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
         std::vector<std::vector<uint>> poly_triangles; // triangles covering each quad. Useful for
                                                        // robust normal estimation and rendering
 
+        // optional index for constant time poly_id queries (see AbstractMesh::hash_index_enable)
+        IdHashTable p_index;
+        void        p_index_insert(const uint pid);
+        void        p_index_erase (const uint pid);
+        void        p_index_switch(const uint pid0, const uint pid1); // call it before swapping the polys
+
     public:
 
         explicit AbstractPolygonMesh() : AbstractMesh<M,V,E,P>() {}
@@ -65,9 +71,23 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
         void load(const char * filename) override;
         void save(const char * filename) const override;
 
+        // CinoLib native binary format (see io/read_CINO.h)
+        void load_CINO(const char * filename);
+        void save_CINO(const char * filename, const bool with_adjacency = true) const;
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         void clear() override;
+        void hash_index_enable(const bool b = true) override;
+        void compact() override;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // lazily allocated standard attributes (see AbstractMesh::vert_normal)
+        const vec3d & poly_normal(const uint pid) const { return this->p_props.normal.at(pid);                    }
+              vec3d & poly_normal(const uint pid)       { return this->p_props.normal.at(pid, this->num_polys()); }
+        const float & poly_AO    (const uint pid) const { return this->p_props.AO.at(pid);                        }
+              float & poly_AO    (const uint pid)       { return this->p_props.AO.at(pid, this->num_polys());     }
         void init(const std::vector<vec3d>             & verts,
                   const std::vector<std::vector<uint>> & polys);
         void init(      std::vector<vec3d>             & pos,       // vertex xyz positions
@@ -78,6 +98,11 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
                   const std::vector<std::vector<uint>> & poly_nor,  // polygons with references to nor
                   const std::vector<Color>             & poly_col,  // per polygon colors
                   const std::vector<int>               & poly_lab); // per polygon labels
+        // same as init(verts,polys), but builds the whole connectivity in one go instead of
+        // adding polygons one by one. Element ids and adjacency orders are the same, but the
+        // mesh must be empty and polygons are assumed to be unique (duplicates are not detected)
+        void init_bulk(const std::vector<vec3d>             & verts,
+                       const std::vector<std::vector<uint>> & polys);
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -204,4 +229,13 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
 #include "abstract_polygonmesh.cpp"
 #endif
 
+#ifdef CINOLIB_COMPILED_LIB
+// the default specializations are compiled once in src/polygon_meshes.cpp
+namespace cinolib
+{
+extern template class AbstractMesh<Mesh_std_attributes,Vert_std_attributes,Edge_std_attributes,Polygon_std_attributes>;
+extern template class AbstractPolygonMesh<>;
+}
+#endif
+
 #endif //CINO_ABSTRACT_POLYGON_MESH_H
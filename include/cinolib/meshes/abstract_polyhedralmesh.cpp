@@ -34,6 +34,8 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/meshes/abstract_polyhedralmesh.h>
+#include <cinolib/profiler_zones.h>
+#include <cinolib/parallel_for.h>
 #include <cinolib/geometry/triangle.h>
 #include <cinolib/geometry/polygon_utils.h>
 #include <cinolib/how_many_seconds.h>
@@ -56,6 +58,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::clear()
     polys_face_winding.clear();
     //
     f_data.clear();
+    f_props.clear();
     //
     v2f.clear();
     e2f.clear();
@@ -63,6 +66,228 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::clear()
     f2f.clear();
     f2p.clear();
     p2v.clear();
+    //
+    f_dead.clear();
+    n_dead_faces = 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::compact()
+{
+    if(this->n_dead_verts==0 && this->n_dead_edges==0 && n_dead_faces==0 && this->n_dead_polys==0)
+    {
+        this->batch_reset();
+        return;
+    }
+
+    std::vector<uint> v_keep, v_map;
+    std::vector<uint> e_keep, e_map;
+    std::vector<uint> f_keep, f_map;
+    std::vector<uint> p_keep, p_map;
+    this->compact_ids(this->v_dead, this->num_verts(), v_keep, v_map);
+    this->compact_ids(this->e_dead, this->num_edges(), e_keep, e_map);
+    this->compact_ids(f_dead,       this->num_faces(), f_keep, f_map);
+    this->compact_ids(this->p_dead, this->num_polys(), p_keep, p_map);
+
+    // vertices
+    this->compact_vec(this->verts,  v_keep);
+    this->compact_vec(this->v_data, v_keep);
+    this->v_props.compact(v_keep);
+    this->compact_adj(this->v2v, v_keep, v_map);
+    this->compact_adj(this->v2e, v_keep, e_map);
+    this->compact_adj(v2f,       v_keep, f_map);
+    this->compact_adj(this->v2p, v_keep, p_map);
+
+    // edges
+    for(uint i=0; i<e_keep.size(); ++i)
+    {
+        this->edges[2*i  ] = v_map.at(this->edges[2*e_keep[i]  ]);
+        this->edges[2*i+1] = v_map.at(this->edges[2*e_keep[i]+1]);
+    }
+    this->edges.resize(2*e_keep.size());
+    this->compact_vec(this->e_data, e_keep);
+    this->e_props.compact(e_keep);
+    this->compact_adj(e2f,       e_keep, f_map);
+    this->compact_adj(this->e2p, e_keep, p_map);
+
+    // faces
+    this->compact_adj(faces,          f_keep, v_map);
+    this->compact_adj(face_triangles, f_keep, v_map);
+    this->compact_vec(f_data,         f_keep);
+    f_props.compact(f_keep);
+    this->compact_adj(f2e, f_keep, e_map);
+    this->compact_adj(f2f, f_keep, f_map);
+    this->compact_adj(f2p, f_keep, p_map);
+
+    // polyhedra
+    this->compact_adj(this->polys, p_keep, f_map);
+    this->compact_adj(p2v,         p_keep, v_map);
+    this->compact_vec(polys_face_winding, p_keep);
+    this->compact_vec(this->p_data,       p_keep);
+    this->p_props.compact(p_keep);
+    this->compact_adj(this->p2e, p_keep, e_map);
+    this->compact_adj(this->p2p, p_keep, p_map);
+
+    this->batch_reset();
+    f_dead.clear();
+    n_dead_faces = 0;
+    if(this->hash_index) this->hash_index_enable(true);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::load_CINO(const char * filename)
+{
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    this->clear();
+    this->mesh_data().filename = std::string(filename);
+
+    CinoBinaryReader r(filename);
+    if(r.mesh_type()!=uint32_t(this->mesh_type()) && this->mesh_type()!=POLYHEDRALMESH)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load_CINO() : mesh type mismatch " << std::endl;
+        exit(-1);
+    }
+    if(r.mesh_type()<TETMESH)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load_CINO() : file does not contain a volume mesh " << std::endl;
+        exit(-1);
+    }
+
+    bool has_adjacency = this->read_CINO_topology(r);
+    if(has_adjacency)
+    {
+        bool ok = r.read_nested("faces",   faces)              &&
+                  r.read_nested("winding", polys_face_winding) &&
+                  r.read_nested("v2f",     v2f)                &&
+                  r.read_nested("e2f",     e2f)                &&
+                  r.read_nested("f2e",     f2e)                &&
+                  r.read_nested("f2f",     f2f)                &&
+                  r.read_nested("f2p",     f2p)                &&
+                  r.read_nested("p2v",     p2v)                &&
+                  r.read_nested("f_tris",  face_triangles);
+
+        // ids index other containers: make sure they are in range
+        size_t nv = this->num_verts();
+        size_t ne = this->num_edges();
+        size_t nf = faces.size();
+        size_t np = this->num_polys();
+        ok = ok && ids_in_range(faces, nv) && ids_in_range(this->polys, nf) &&
+             polys_face_winding.size()==np &&
+             v2f.size()==nv && ids_in_range(v2f, nf) &&
+             e2f.size()==ne && ids_in_range(e2f, nf) &&
+             f2e.size()==nf && ids_in_range(f2e, ne) &&
+             f2f.size()==nf && ids_in_range(f2f, nf) &&
+             f2p.size()==nf && ids_in_range(f2p, np) &&
+             p2v.size()==np && ids_in_range(p2v, nv) &&
+             face_triangles.size()==nf && ids_in_range(face_triangles, nv);
+        for(size_t pid=0; ok && pid<np; ++pid) ok = polys_face_winding[pid].size()==this->polys[pid].size();
+        if(!ok)
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load_CINO() : missing or corrupted adjacency " << std::endl;
+            exit(-1);
+        }
+        f_data.resize(faces.size());
+        f_props.resize(faces.size());
+        if(this->mesh_data().update_bbox) this->update_bbox();
+        if(this->hash_index) this->hash_index_enable(true);
+    }
+    else
+    {
+        // no adjacency in the file: build it from scratch
+        std::vector<vec3d>             verts;
+        std::vector<std::vector<uint>> faces, polys;
+        std::vector<std::vector<bool>> winding;
+        bool ok = r.read       ("verts",   verts)   &&
+                  r.read_nested("faces",   faces)   &&
+                  r.read_nested("polys",   polys)   &&
+                  r.read_nested("winding", winding) &&
+                  ids_in_range(faces, verts.size()) &&
+                  ids_in_range(polys, faces.size()) &&
+                  winding.size()==polys.size();
+        for(size_t pid=0; ok && pid<polys.size(); ++pid) ok = winding[pid].size()==polys[pid].size();
+        if(!ok)
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load_CINO() : missing or corrupted topology " << std::endl;
+            exit(-1);
+        }
+        init(verts, faces, polys, winding);
+    }
+
+    this->read_CINO_attributes(r);
+
+    uint nf = num_faces();
+    std::vector<vec3d>   vec;
+    std::vector<Color>   col;
+    std::vector<int>     lab;
+    std::vector<float>   flt;
+    std::vector<uint8_t> flg;
+    if(r.read("f.normal",  vec) && vec.size()==nf) for(uint fid=0; fid<nf; ++fid) face_normal(fid)  = vec[fid];
+    if(r.read("f.color",   col) && col.size()==nf) for(uint fid=0; fid<nf; ++fid) face_data(fid).color   = col[fid];
+    if(r.read("f.label",   lab) && lab.size()==nf) for(uint fid=0; fid<nf; ++fid) face_data(fid).label   = lab[fid];
+    if(r.read("f.quality", flt) && flt.size()==nf) for(uint fid=0; fid<nf; ++fid) face_quality(fid) = flt[fid];
+    if(r.read("f.AO",      flt) && flt.size()==nf) for(uint fid=0; fid<nf; ++fid) face_AO(fid)      = flt[fid];
+    if(r.read("f.flags",   flg) && flg.size()==nf) for(uint fid=0; fid<nf; ++fid) face_data(fid).flags   = flg[fid];
+
+    if(has_adjacency)
+    {
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+        std::cout << "load mesh\t"     <<
+                     this->num_verts() << "V / " <<
+                     this->num_edges() << "E / " <<
+                     this->num_faces() << "F / " <<
+                     this->num_polys() << "P  [" <<
+                     how_many_seconds(t0,t1) << "s]" << std::endl;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::save_CINO(const char * filename, const bool with_adjacency) const
+{
+    CinoBinaryWriter w(filename, uint32_t(this->mesh_type()));
+    this->write_CINO_topology(w, with_adjacency);
+    w.write_nested("faces",   faces);
+    w.write_nested("winding", polys_face_winding);
+    if(with_adjacency)
+    {
+        w.write_nested("v2f",    v2f);
+        w.write_nested("e2f",    e2f);
+        w.write_nested("f2e",    f2e);
+        w.write_nested("f2f",    f2f);
+        w.write_nested("f2p",    f2p);
+        w.write_nested("p2v",    p2v);
+        w.write_nested("f_tris", face_triangles);
+    }
+    this->write_CINO_attributes(w);
+
+    if(f_props.normal.allocated())  w.write("f.normal",  f_props.normal.data);
+    if(f_props.quality.allocated()) w.write("f.quality", f_props.quality.data);
+    if(f_props.AO.allocated())      w.write("f.AO",      f_props.AO.data);
+
+    uint nf = num_faces();
+    std::vector<Color>   f_col(nf);
+    std::vector<int>     f_lab(nf);
+    std::vector<uint8_t> f_flg(nf);
+    for(uint fid=0; fid<nf; ++fid)
+    {
+        f_col[fid] = face_data(fid).color;
+        f_lab[fid] = face_data(fid).label;
+        f_flg[fid] = uint8_t(face_data(fid).flags.to_ulong());
+    }
+    w.write("f.color",   f_col);
+    w.write("f.label",   f_lab);
+    w.write("f.flags",   f_flg);
+    w.close();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -74,6 +299,8 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>
                                              const std::vector<std::vector<uint>> & polys,
                                              const std::vector<std::vector<bool>> & polys_face_winding)
 {
+    CINO_PROFILE_ZONE("AbstractPolyhedralMesh::init");
+    CINO_PROFILE_COUNTER("AbstractPolyhedralMesh::init polys", polys.size());
     std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
 
     // pre-allocate memory
@@ -128,6 +355,8 @@ CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>             & verts,
                                              const std::vector<std::vector<uint>> & polys)
 {
+    CINO_PROFILE_ZONE("AbstractPolyhedralMesh::init");
+    CINO_PROFILE_COUNTER("AbstractPolyhedralMesh::init polys", polys.size());
     std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
 
     // pre-allocate memory
@@ -195,6 +424,231 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::init_bulk(const std::vector<vec3d>             & verts,
+                                                  const std::vector<std::vector<uint>> & faces,
+                                                  const std::vector<std::vector<uint>> & polys,
+                                                  const std::vector<std::vector<bool>> & polys_face_winding)
+{
+    CINO_PROFILE_ZONE("AbstractPolyhedralMesh::init_bulk");
+    CINO_PROFILE_COUNTER("AbstractPolyhedralMesh::init_bulk polys", polys.size());
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    assert(this->num_verts()==0 && this->num_faces()==0 && this->num_polys()==0);
+    assert(polys.size()==polys_face_winding.size());
+
+    // vertices
+    uint nv = uint(verts.size());
+    uint nf = uint(faces.size());
+    uint np = uint(polys.size());
+    this->verts = verts;
+    this->v_data.resize(nv);
+    this->v_props.resize(nv);
+    this->v2v.resize(nv);
+    this->v2e.resize(nv);
+    this->v2f.resize(nv);
+    this->v2p.resize(nv);
+    if(this->mesh_data().update_bbox)
+    {
+        for(const vec3d & pos : verts)
+        {
+            this->bb.min = this->bb.min.min(pos);
+            this->bb.max = this->bb.max.max(pos);
+        }
+    }
+
+    // pre-allocate vert to face adjacency, so that lists do not grow one element at a time
+    std::vector<uint> v_valence(nv, 0);
+    for(const auto & f : faces) for(uint vid : f) ++v_valence.at(vid);
+    for(uint vid=0; vid<nv; ++vid) this->v2f.at(vid).reserve(v_valence.at(vid));
+
+    // faces. Same logic (and order) of face_add, but edges are searched directly in the
+    // vertex stars, and there is no check for duplicated faces
+    uint ne = uint(1.5*nf);
+    this->faces = faces;
+    this->f_data.resize(nf);
+    this->f_props.resize(nf);
+    this->f2e.resize(nf);
+    this->f2f.resize(nf);
+    this->f2p.resize(nf);
+    this->face_triangles.resize(nf);
+    this->edges.reserve(ne*2);
+    this->e2f.reserve(ne);
+    this->e2p.reserve(ne);
+    this->e_data.reserve(ne);
+    for(uint fid=0; fid<nf; ++fid)
+    {
+        const std::vector<uint> & f = faces.at(fid);
+        for(uint vid : f)
+        {
+            assert(vid < nv);
+            this->v2f.at(vid).push_back(fid);
+        }
+        this->f2e.at(fid).reserve(f.size());
+        for(uint i=0; i<f.size(); ++i)
+        {
+            uint vid0 = f.at(i);
+            uint vid1 = f.at((i+1)%f.size());
+            int  eid  = -1;
+            for(uint e : this->v2e.at(vid0))
+            {
+                if(this->edges.at(2*e)==vid1 || this->edges.at(2*e+1)==vid1)
+                {
+                    eid = e;
+                    break;
+                }
+            }
+            if(eid == -1) eid = this->edge_add(vid0, vid1);
+
+            for(uint nbr : this->e2f.at(eid))
+            {
+                assert(nbr!=fid);
+                if(CONTAINS_VEC(this->f2f.at(fid), nbr)) continue;
+                this->f2f.at(nbr).push_back(fid);
+                this->f2f.at(fid).push_back(nbr);
+            }
+            this->e2f.at(eid).push_back(fid);
+            this->f2e.at(fid).push_back(eid);
+        }
+    }
+
+    // face normals and tessellations only depend on the face itself
+    PARALLEL_FOR(0, nf, 1000, [&](const uint fid)
+    {
+        this->update_f_normal(fid);
+        update_f_tessellation(fid);
+    });
+
+    // polyhedra. Same logic (and order) of poly_add. The i-th edge in f2e joins the
+    // i-th and (i+1)-th vertex of the face, hence there is no need to search for it
+    this->polys = polys;
+    this->polys_face_winding = polys_face_winding;
+    this->p_data.resize(np);
+    this->p_props.resize(np);
+    this->p2v.resize(np);
+    this->p2e.resize(np);
+    this->p2p.resize(np);
+    for(uint pid=0; pid<np; ++pid)
+    {
+        for(uint fid : polys.at(pid))
+        {
+            assert(fid < nf);
+            const std::vector<uint> & f = faces.at(fid);
+            for(uint i=0; i<f.size(); ++i)
+            {
+                uint vid = f.at(i);
+                uint eid = this->f2e.at(fid).at(i);
+                if(DOES_NOT_CONTAIN_VEC(this->p2e.at(pid), eid))
+                {
+                    this->e2p.at(eid).push_back(pid);
+                    this->p2e.at(pid).push_back(eid);
+                }
+                if(DOES_NOT_CONTAIN_VEC(this->p2v.at(pid), vid))
+                {
+                    this->p2v.at(pid).push_back(vid);
+                    this->v2p.at(vid).push_back(pid);
+                }
+            }
+            for(uint nbr : this->f2p.at(fid))
+            {
+                if(DOES_NOT_CONTAIN_VEC(this->p2p.at(pid), nbr))
+                {
+                    this->p2p.at(pid).push_back(nbr);
+                    this->p2p.at(nbr).push_back(pid);
+                }
+            }
+            this->f2p.at(fid).push_back(pid);
+        }
+    }
+
+    // standard vertex ordering only depends on the poly itself
+    PARALLEL_FOR(0, np, 1000, [&](const uint pid)
+    {
+        if(this->poly_is_hexahedron(pid) || this->poly_is_tetrahedron(pid)) poly_reorder_p2v(pid);
+    });
+
+    if(this->mesh_data().update_normals) this->update_v_normals();
+
+    this->copy_xyz_to_uvw(UVW_param);
+
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+    std::cout << "load mesh\t"     <<
+                 this->num_verts() << "V / " <<
+                 this->num_edges() << "E / " <<
+                 this->num_faces() << "F / " <<
+                 this->num_polys() << "P  [" <<
+                 how_many_seconds(t0,t1) << "s]" << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::init_bulk(const std::vector<vec3d>             & verts,
+                                                  const std::vector<std::vector<uint>> & polys)
+{
+    for(const auto & p : polys)
+    {
+        if(p.size()!=4 && p.size()!=8)
+        {
+            init(verts, polys);
+            return;
+        }
+    }
+
+    // split elements into faces, as poly_add does for tets and hexes, but find
+    // the faces that already exist with a hash of their vertex set
+    std::vector<std::vector<uint>> faces;
+    std::vector<std::vector<uint>> flists(polys.size());
+    std::vector<std::vector<bool>> winding(polys.size());
+    IdHashTable f_index;
+    f_index.reserve(4*polys.size());
+    for(uint pid=0; pid<polys.size(); ++pid)
+    {
+        const std::vector<uint> & vlist = polys.at(pid);
+        bool is_tet = (vlist.size()==4);
+        uint n_f    = is_tet ? 4 : 6;
+        uint n_fv   = is_tet ? 3 : 4;
+        flists.at(pid).resize(n_f);
+        winding.at(pid).resize(n_f);
+        for(uint i=0; i<n_f; ++i)
+        {
+            std::vector<uint> f(n_fv);
+            for(uint j=0; j<n_fv; ++j) f[j] = vlist.at(is_tet ? TET_FACES[i][j] : HEXA_FACES[i][j]);
+
+            uint64_t key = vert_set_key(f);
+            int fid = f_index.find(key, [&](const uint id)
+            {
+                const std::vector<uint> & g = faces.at(id);
+                if(g.size()!=f.size()) return false;
+                for(uint vid : f) if(DOES_NOT_CONTAIN_VEC(g,vid)) return false;
+                return true;
+            });
+            if(fid==-1)
+            {
+                fid = int(faces.size());
+                faces.push_back(f);
+                f_index.insert(key, uint(fid));
+            }
+            // the face is CCW for the poly if it has the same orientation it has in the poly
+            const std::vector<uint> & g = faces.at(fid);
+            uint off = 0;
+            while(g.at(off)!=f[0]) ++off;
+            flists.at(pid).at(i)  = uint(fid);
+            winding.at(pid).at(i) = (g.at((off+1)%n_fv)==f[1]);
+        }
+    }
+
+    init_bulk(verts, faces, flists, winding);
+    PARALLEL_FOR(0, this->num_polys(), 1000, [&](const uint pid)
+    {
+        update_p_quality(pid);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 double AbstractPolyhedralMesh<M,V,E,F,P>::mesh_srf_area() const
@@ -441,14 +895,14 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::update_p_quality(const uint pid)
 {
     if(this->poly_is_tetrahedron(pid))
     {
-        this->poly_data(pid).quality = float(tet_scaled_jacobian(this->poly_vert(pid,0),
+        this->poly_quality(pid) = float(tet_scaled_jacobian(this->poly_vert(pid,0),
                                                                  this->poly_vert(pid,1),
                                                                  this->poly_vert(pid,2),
                                                                  this->poly_vert(pid,3)));
     }
     else if(this->poly_is_hexahedron(pid))
     {
-        this->poly_data(pid).quality = float(hex_scaled_jacobian(this->poly_vert(pid,0),
+        this->poly_quality(pid) = float(hex_scaled_jacobian(this->poly_vert(pid,0),
                                                                  this->poly_vert(pid,1),
                                                                  this->poly_vert(pid,2),
                                                                  this->poly_vert(pid,3),
@@ -465,10 +919,10 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::update_quality()
 {
-    for(uint pid=0; pid<this->num_polys(); ++pid)
+    PARALLEL_FOR(0, this->num_polys(), 1000, [&](const uint pid)
     {
         update_p_quality(pid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -488,7 +942,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::update_v_normal(const uint vid)
         }
     }
     if (n.norm()>0) n.normalize();
-    this->vert_data(vid).normal = n;
+    this->vert_normal(vid) = n;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -498,10 +952,10 @@ CINO_INLINE
 int AbstractPolyhedralMesh<M,V,E,F,P>::Euler_characteristic() const
 {
     // https://math.stackexchange.com/questions/1680607/eulers-formula-for-tetrahedral-mesh
-    uint nv = this->num_verts();
-    uint ne = this->num_edges();
-    uint nf = this->num_faces();
-    uint np = this->num_polys();
+    uint nv = this->num_verts() - this->n_dead_verts;
+    uint ne = this->num_edges() - this->n_dead_edges;
+    uint nf = this->num_faces() - n_dead_faces;
+    uint np = this->num_polys() - this->n_dead_polys;
     return nv - ne + nf - np;
 }
 
@@ -931,7 +1385,7 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::edge_split(const uint eid, const vec3d &
         VEC_INSERT_AFTER(f, v1, new_vid);
         uint new_fid = this->face_add(f);
         fmap[fid] = new_fid;
-        this->face_data(new_fid) = this->face_data(fid);
+        this->face_copy_attributes(new_fid, fid);
     }
 
     // update the polys incident to eid
@@ -944,7 +1398,7 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::edge_split(const uint eid, const vec3d &
             if(CONTAINS(fmap,fid)) fid = fmap.at(fid);
         }
         uint new_pid = this->poly_add(f,w);
-        this->poly_data(new_pid) = this->poly_data(pid);
+        this->poly_copy_attributes(new_pid, pid);
     }
 
     // remove the old elements
@@ -1140,8 +1594,8 @@ CINO_INLINE
 vec3d AbstractPolyhedralMesh<M,V,E,F,P>::poly_face_normal(const uint pid, const uint fid) const
 {
     assert(poly_contains_face(pid,fid));
-    if (poly_face_is_CCW(pid,fid)) return this->face_data(fid).normal;
-    return -this->face_data(fid).normal;
+    if (poly_face_is_CCW(pid,fid)) return this->face_normal(fid);
+    return -this->face_normal(fid);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1978,6 +2432,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::vert_switch_id(const uint vid0, const ui
     std::swap(this->v2f.at(vid0),     this->v2f.at(vid1));
     std::swap(this->v2p.at(vid0),     this->v2p.at(vid1));
     std::swap(this->v_data.at(vid0),  this->v_data.at(vid1));
+    this->v_props.swap(vid0, vid1);
 
     std::unordered_set<uint> verts_to_update;
     verts_to_update.insert(this->adj_v2v(vid0).begin(), this->adj_v2v(vid0).end());
@@ -2004,6 +2459,8 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::vert_switch_id(const uint vid0, const ui
         }
     }
 
+    // keys of the hash index depend on vertex ids: re-insert the edges being renamed
+    for(uint eid : edges_to_update) this->e_index_erase(eid);
     for(uint eid : edges_to_update)
     {
         for(uint i=0; i<2; ++i)
@@ -2013,6 +2470,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::vert_switch_id(const uint vid0, const ui
             if (vid == vid1) vid = vid0;
         }
     }
+    for(uint eid : edges_to_update) this->e_index_insert(eid);
 
     for(uint fid : faces_to_update)
     {
@@ -2057,9 +2515,15 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::vert_remove_unreferenced(const uint vid)
     this->v2e.at(vid).clear();
     this->v2f.at(vid).clear();
     this->v2p.at(vid).clear();
+    if(this->batch)
+    {
+        this->vert_mark_removed(vid);
+        return;
+    }
     vert_switch_id(vid, this->num_verts()-1);
     this->verts.pop_back();
     this->v_data.pop_back();
+    this->v_props.pop_back();
     this->v2v.pop_back();
     this->v2e.pop_back();
     this->v2f.pop_back();
@@ -2078,6 +2542,7 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::vert_add(const vec3d & pos)
     //
     V data;
     this->v_data.push_back(data);
+    this->v_props.push_back();
     assert(this->verts.size() == this->v_data.size());
     //
     this->v2v.push_back(std::vector<uint>());
@@ -2099,11 +2564,13 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::edge_switch_id(const uint eid0, const ui
 {
     if (eid0 == eid1) return;
 
+    this->e_index_switch(eid0, eid1);
     for(uint off=0; off<2; ++off) std::swap(this->edges.at(2*eid0+off), this->edges.at(2*eid1+off));
 
     std::swap(this->e2f.at(eid0),     this->e2f.at(eid1));
     std::swap(this->e2p.at(eid0),     this->e2p.at(eid1));
     std::swap(this->e_data.at(eid0),  this->e_data.at(eid1));
+    this->e_props.swap(eid0, eid1);
 
     std::unordered_set<uint> verts_to_update;
     verts_to_update.insert(this->edge_vert_id(eid0,0));
@@ -2169,6 +2636,7 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::edge_add(const uint vid0, const uint vid
     //
     E data;
     this->e_data.push_back(data);
+    this->e_props.push_back();
     assert(this->edges.size()/2 == this->e_data.size());
     //
     this->v2v.at(vid1).push_back(vid0);
@@ -2177,6 +2645,8 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::edge_add(const uint vid0, const uint vid
     this->v2e.at(vid0).push_back(eid);
     this->v2e.at(vid1).push_back(eid);
     //
+    this->e_index_insert(eid);
+    //
     return eid;
 }
 
@@ -2197,9 +2667,16 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::edge_remove_unreferenced(const uint eid)
 {
     this->e2f.at(eid).clear();
     this->e2p.at(eid).clear();
+    this->e_index_erase(eid);
+    if(this->batch)
+    {
+        this->edge_mark_removed(eid);
+        return;
+    }
     edge_switch_id(eid, this->num_edges()-1);
     this->edges.resize(this->edges.size()-2);
     this->e_data.pop_back();
+    this->e_props.pop_back();
     this->e2f.pop_back();
     this->e2p.pop_back();
 }
@@ -2216,6 +2693,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::face_switch_id(const uint fid0, const ui
 
     std::swap(this->faces.at(fid0),          this->faces.at(fid1));
     std::swap(this->f_data.at(fid0),         this->f_data.at(fid1));
+    this->f_props.swap(fid0, fid1);
     std::swap(this->f2e.at(fid0),            this->f2e.at(fid1));
     std::swap(this->f2f.at(fid0),            this->f2f.at(fid1));
     std::swap(this->f2p.at(fid0),            this->f2p.at(fid1));
@@ -2294,6 +2772,7 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::face_add(const std::vector<uint> & f)
 
     F data;
     this->f_data.push_back(data);
+    this->f_props.push_back();
     assert(this->faces.size() == this->f_data.size());
 
     this->f2e.push_back(std::vector<uint>());
@@ -2361,9 +2840,18 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::face_remove_unreferenced(const uint fid)
     this->f2f.at(fid).clear();
     this->f2p.at(fid).clear();
     this->face_triangles.at(fid).clear();
+    if(this->batch)
+    {
+        assert(!face_is_removed(fid));
+        if(f_dead.size()<this->num_faces()) f_dead.resize(this->num_faces(), false);
+        f_dead.at(fid) = true;
+        ++n_dead_faces;
+        return;
+    }
     face_switch_id(fid, this->num_faces()-1);
     this->faces.pop_back();
     this->f_data.pop_back();
+    this->f_props.pop_back();
     this->f2e.pop_back();
     this->f2f.pop_back();
     this->f2p.pop_back();
@@ -2380,6 +2868,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::poly_switch_id(const uint pid0, const ui
 
     std::swap(this->polys.at(pid0),              this->polys.at(pid1));
     std::swap(this->p_data.at(pid0),             this->p_data.at(pid1));
+    this->p_props.swap(pid0, pid1);
     std::swap(this->p2v.at(pid0),                this->p2v.at(pid1));
     std::swap(this->p2e.at(pid0),                this->p2e.at(pid1));
     std::swap(this->p2p.at(pid0),                this->p2p.at(pid1));
@@ -2461,6 +2950,7 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::poly_add(const std::vector<uint> & flist
 
     P data;
     this->p_data.push_back(data);
+    this->p_props.push_back();
     assert(this->polys.size() == this->p_data.size());
 
     this->p2v.push_back(std::vector<uint>());
@@ -2726,9 +3216,15 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::poly_remove_unreferenced(const uint pid)
     this->p2e.at(pid).clear();
     this->p2p.at(pid).clear();
     this->polys_face_winding.at(pid).clear();
+    if(this->batch)
+    {
+        this->poly_mark_removed(pid);
+        return;
+    }
     poly_switch_id(pid, this->num_polys()-1);
     this->polys.pop_back();
     this->p_data.pop_back();
+    this->p_props.pop_back();
     this->p2v.pop_back();
     this->p2e.pop_back();
     this->p2p.pop_back();
@@ -57,6 +57,8 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
 
         std::vector<F> f_data;
 
+        PropertyContainer f_props; // user defined per face properties (see mesh_properties.h)
+
         std::vector<std::vector<uint>> v2f; // vert to face adjacency
         std::vector<std::vector<uint>> e2f; // edge to face adjacency
         std::vector<std::vector<uint>> f2e; // face to edge adjacency
@@ -66,6 +68,9 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
 
         std::vector<std::vector<uint>> face_triangles; // per face serialized triangulation (e.g., for rendering)
 
+        std::vector<bool> f_dead; // dead faces in transaction mode (see AbstractMesh::batch_begin)
+        uint              n_dead_faces = 0;
+
     public:
 
         typedef F F_type;
@@ -76,6 +81,11 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         void clear() override;
+        void compact() override;
+
+        // CinoLib native binary format (see io/read_CINO.h)
+        void load_CINO(const char * filename);
+        void save_CINO(const char * filename, const bool with_adjacency = true) const;
 
         void init(const std::vector<vec3d>             & verts,
                   const std::vector<std::vector<uint>> & faces,
@@ -90,6 +100,19 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
                   const std::vector<int>               & vert_labels,
                   const std::vector<int>               & poly_labels);
 
+        // same as the init methods above, but the whole connectivity is built in one go
+        // rather than adding faces and polys one by one. Element ids and adjacency orders
+        // are the same, but the mesh must be empty and faces (or polys) are assumed to be
+        // unique. The second variant finds shared faces with a hash table and only handles
+        // tetrahedra and hexahedra (other elements fall back to the standard init)
+        void init_bulk(const std::vector<vec3d>             & verts,
+                       const std::vector<std::vector<uint>> & faces,
+                       const std::vector<std::vector<uint>> & polys,
+                       const std::vector<std::vector<bool>> & polys_face_winding);
+
+        void init_bulk(const std::vector<vec3d>             & verts,
+                       const std::vector<std::vector<uint>> & polys);
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         double mesh_srf_area() const;
@@ -135,6 +158,8 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
         uint num_srf_polys() const;
         uint num_faces()     const { return uint(faces.size()); }
 
+        bool face_is_removed(const uint fid) const { return fid<f_dead.size() && f_dead[fid]; }
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         const std::vector<std::vector<uint>> & vector_faces() const { return faces; }
@@ -169,6 +194,23 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
         const F & face_data(const uint fid) const { return f_data.at(fid); }
               F & face_data(const uint fid)       { return f_data.at(fid); }
 
+        // lazily allocated standard attributes (see AbstractMesh::vert_normal)
+        const vec3d & face_normal (const uint fid) const { return f_props.normal.at(fid);               }
+              vec3d & face_normal (const uint fid)       { return f_props.normal.at(fid, num_faces());  }
+        const float & face_quality(const uint fid) const { return f_props.quality.at(fid);              }
+              float & face_quality(const uint fid)       { return f_props.quality.at(fid, num_faces()); }
+        const float & face_AO     (const uint fid) const { return f_props.AO.at(fid);                   }
+              float & face_AO     (const uint fid)       { return f_props.AO.at(fid, num_faces());      }
+
+        void face_copy_attributes(const uint dst, const AbstractPolyhedralMesh & m, const uint src) { f_data.at(dst) = m.f_data.at(src); f_props.copy_std(dst, m.f_props, src, num_faces()); }
+        void face_copy_attributes(const uint dst, const uint src) { face_copy_attributes(dst, *this, src); }
+        const PropertyContainer & face_properties() const { return f_props; }
+
+        template<typename T> std::vector<T> & face_property(const std::string & name, const T & def = T()) { return f_props.template get<T>(name, num_faces(), def); }
+        template<typename T> const std::vector<T> & face_property(const std::string & name) const { return f_props.template get<T>(name); }
+        bool face_property_exists(const std::string & name) const { return f_props.exists(name); }
+        void face_property_remove(const std::string & name)       { f_props.remove(name);        }
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         // useful for GUIs with mouse picking
@@ -318,4 +360,12 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
 #include "abstract_polyhedralmesh.cpp"
 #endif
 
+#ifdef CINOLIB_COMPILED_LIB
+// the default specialization is compiled once in src/polyhedral_meshes.cpp
+namespace cinolib
+{
+extern template class AbstractPolyhedralMesh<>;
+}
+#endif
+
 #endif // CINO_ABSTRACT_POLYHEDRAL_MESH_H
@@ -106,8 +106,14 @@ void Hexmesh<M,V,E,F,P>::load(const char * filename)
     std::string str(filename);
     std::string filetype = "." + get_file_extension(str);
 
-    if (filetype.compare(".mesh") == 0 ||
-        filetype.compare(".MESH") == 0)
+    if (filetype.compare(".cino") == 0 ||
+        filetype.compare(".CINO") == 0)
+    {
+        this->load_CINO(filename);
+        return;
+    }
+    else if (filetype.compare(".mesh") == 0 ||
+             filetype.compare(".MESH") == 0)
     {
         read_MESH(filename, tmp_verts, tmp_polys, vert_labels, poly_labels);
     }
@@ -138,8 +144,13 @@ void Hexmesh<M,V,E,F,P>::save(const char * filename) const
     std::string str(filename);
     std::string filetype = get_file_extension(str);
 
-    if (filetype.compare("mesh") == 0 ||
-        filetype.compare("MESH") == 0)
+    if (filetype.compare("cino") == 0 ||
+        filetype.compare("CINO") == 0)
+    {
+        this->save_CINO(filename);
+    }
+    else if (filetype.compare("mesh") == 0 ||
+             filetype.compare("MESH") == 0)
     {
         if(this->polys_are_labeled())
         {
@@ -188,7 +199,7 @@ void Hexmesh<M,V,E,F,P>::update_f_normal(const uint fid)
     vec3d v = v2 - v0;     if(!v.is_deg()) v.normalize();
     vec3d n = u.cross(v);  if(!n.is_deg()) n.normalize();
 
-    this->face_data(fid).normal = n;
+    this->face_normal(fid) = n;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -205,7 +216,7 @@ void Hexmesh<M,V,E,F,P>::print_quality(const bool list_folded_elements)
 
     for(uint pid=0; pid<this->num_polys(); ++pid)
     {
-        double q = this->poly_data(pid).quality;
+        double q = this->poly_quality(pid);
 
         asj += q;
         msj = std::min(msj, q);
@@ -422,7 +433,7 @@ bool Hexmesh<M,V,E,F,P>::poly_fix_orientation()
         {
             this->poly_reorder_p2v(pid);
             this->update_p_quality(pid);
-            if(this->poly_data(pid).quality < 0.0) ++bad;
+            if(this->poly_quality(pid) < 0.0) ++bad;
         }
         if(bad > 0.5*this->num_polys())
         {
@@ -127,4 +127,12 @@ class Hexmesh : public AbstractPolyhedralMesh<M,V,E,F,P>
 #include "hexmesh.cpp"
 #endif
 
+#ifdef CINOLIB_COMPILED_LIB
+// the default specialization is compiled once in src/polyhedral_meshes.cpp
+namespace cinolib
+{
+extern template class Hexmesh<>;
+}
+#endif
+
 #endif // CINO_HEXMESH_H
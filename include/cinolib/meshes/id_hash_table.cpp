@@ -0,0 +1,193 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/meshes/id_hash_table.h>
+#include <algorithm>
+#include <cassert>
+
+namespace cinolib
+{
+
+CINO_INLINE
+uint64_t hash_mix(uint64_t x)
+{
+    // splitmix64 finalizer
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t vert_pair_key(const uint vid0, const uint vid1)
+{
+    return (vid0<vid1) ? (uint64_t(vid0)<<32 | vid1)
+                       : (uint64_t(vid1)<<32 | vid0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t vert_set_key(const std::vector<uint> & vids)
+{
+    // sum of the mixed ids does not depend on the order of the vertices
+    uint64_t key = vids.size();
+    for(uint vid : vids) key += hash_mix(vid+1);
+    return key;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void IdHashTable::clear()
+{
+    for(Slot & s : slots) s.id = EMPTY;
+    n_items = 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void IdHashTable::reserve(const size_t n)
+{
+    // keep the load factor below 1/2
+    size_t capacity = 16;
+    while(capacity < 2*n) capacity <<= 1;
+    if(capacity > slots.size()) rehash(capacity);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t IdHashTable::home(const uint64_t key) const
+{
+    return size_t(hash_mix(key)) & mask;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void IdHashTable::rehash(const size_t capacity)
+{
+    std::vector<Slot> old;
+    old.swap(slots);
+    slots.resize(capacity, Slot{0,EMPTY});
+    mask    = capacity-1;
+    n_items = 0;
+    for(const Slot & s : old) if(s.id!=EMPTY) insert(s.key, s.id);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t IdHashTable::locate(const uint64_t key, const uint id) const
+{
+    if(n_items==0) return slots.size();
+    for(size_t i=home(key); slots[i].id!=EMPTY; i=(i+1)&mask)
+    {
+        if(slots[i].key==key && slots[i].id==id) return i;
+    }
+    return slots.size();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void IdHashTable::insert(const uint64_t key, const uint id)
+{
+    assert(id!=EMPTY);
+    if(2*(n_items+1) > slots.size()) rehash(std::max(size_t(16), 2*slots.size()));
+    size_t i = home(key);
+    while(slots[i].id!=EMPTY) i = (i+1)&mask;
+    slots[i].key = key;
+    slots[i].id  = id;
+    ++n_items;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool IdHashTable::erase(const uint64_t key, const uint id)
+{
+    size_t i = locate(key, id);
+    if(i==slots.size()) return false;
+
+    // backward shift: move back the entries of the cluster that
+    // would no longer be reachable from their home slot
+    size_t j = i;
+    while(true)
+    {
+        j = (j+1)&mask;
+        if(slots[j].id==EMPTY) break;
+        size_t k = home(slots[j].key);
+        bool   movable = (i<=j) ? (k<=i || k>j) : (k<=i && k>j);
+        if(movable)
+        {
+            slots[i] = slots[j];
+            i = j;
+        }
+    }
+    slots[i].id = EMPTY;
+    --n_items;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool IdHashTable::replace(const uint64_t key, const uint old_id, const uint new_id)
+{
+    size_t i = locate(key, old_id);
+    if(i==slots.size()) return false;
+    slots[i].id = new_id;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int IdHashTable::find(const uint64_t key) const
+{
+    if(n_items==0) return -1;
+    for(size_t i=home(key); slots[i].id!=EMPTY; i=(i+1)&mask)
+    {
+        if(slots[i].key==key) return int(slots[i].id);
+    }
+    return -1;
+}
+
+}
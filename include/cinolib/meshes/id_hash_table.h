@@ -0,0 +1,120 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_ID_HASH_TABLE_H
+#define CINO_ID_HASH_TABLE_H
+
+#include <vector>
+#include <stdint.h>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+/* Open addressing (linear probing) hash table that maps 64 bit keys to
+ * element ids. It is the optional index that meshes use to answer edge_id
+ * and poly_id queries in constant time (see AbstractMesh::hash_index_enable).
+ *
+ * Keys need not be unique: polygons are indexed by a hash of their vertex
+ * set, and colliding entries are told apart by the predicate passed to find().
+ * Each (key,id) pair is instead unique, and it is what insert/erase/replace
+ * operate on. Deletions use backward shifting, so there are no tombstones
+ * and lookups never degrade after long sequences of local edits.
+*/
+
+class IdHashTable
+{
+    public:
+
+        explicit IdHashTable() {}
+
+        void   clear();
+        void   reserve(const size_t n);
+        size_t size() const { return n_items; }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void insert (const uint64_t key, const uint id);
+        bool erase  (const uint64_t key, const uint id);
+        bool replace(const uint64_t key, const uint old_id, const uint new_id);
+
+        // first id stored with the given key (-1 if none)
+        int find(const uint64_t key) const;
+
+        // first id stored with the given key for which pred(id) is true (-1 if none)
+        template<typename Pred>
+        int find(const uint64_t key, const Pred & pred) const
+        {
+            if(n_items==0) return -1;
+            for(size_t i=home(key); slots[i].id!=EMPTY; i=(i+1)&mask)
+            {
+                if(slots[i].key==key && pred(slots[i].id)) return int(slots[i].id);
+            }
+            return -1;
+        }
+
+    private:
+
+        static const uint EMPTY = 0xFFFFFFFF;
+
+        struct Slot
+        {
+            uint64_t key;
+            uint     id;
+        };
+
+        std::vector<Slot> slots;
+        size_t            mask    = 0;
+        size_t            n_items = 0;
+
+        size_t home(const uint64_t key) const;
+        void   rehash(const size_t capacity);
+        size_t locate(const uint64_t key, const uint id) const; // slot of (key,id), or slots.size()
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// keys of unordered vertex pairs (exact) and vertex sets (order independent hash)
+CINO_INLINE uint64_t vert_pair_key(const uint vid0, const uint vid1);
+CINO_INLINE uint64_t vert_set_key (const std::vector<uint> & vids);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "id_hash_table.cpp"
+#endif
+
+#endif // CINO_ID_HASH_TABLE_H
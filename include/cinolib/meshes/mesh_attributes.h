@@ -131,13 +131,15 @@ struct Mesh_std_attributes
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// NOTE: normals, uvw, quality and AO are not stored here, but in lazily
+// allocated arrays (see mesh_properties.h), so that meshes do not waste
+// memory for attributes that are never used. They are accessed through
+// dedicated methods, e.g. m.vert_uvw(vid), m.poly_normal(pid), m.face_AO(fid)
+
 struct Vert_std_attributes
 {
-    vec3d          normal  = vec3d(0,0,0);
     Color          color   = Color::WHITE();
-    vec3d          uvw     = vec3d(0,0,0);
     int            label   = -1;
-    float          quality = 0.0;
     std::bitset<8> flags   = 0x00;
 };
 
@@ -154,11 +156,8 @@ struct Edge_std_attributes
 
 struct Polygon_std_attributes
 {
-    vec3d          normal  = vec3d(0,0,0);
     Color          color   = Color::WHITE();
     int            label   = -1;
-    float          quality = 0.0;
-    float          AO      = 1.0;
     std::bitset<8> flags   = 0x00;
 };
 
@@ -168,7 +167,6 @@ struct Polyhedron_std_attributes
 {
     Color          color   = Color::WHITE();
     int            label   = -1;
-    float          quality = 0.0;
     std::bitset<8> flags   = 0x00;
 };
 
@@ -0,0 +1,321 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/meshes/mesh_properties.h>
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <assert.h>
+
+namespace cinolib
+{
+
+template<typename T>
+CINO_INLINE
+void PropertyArray<T>::swap(const size_t i, const size_t j)
+{
+    // not std::swap, to support std::vector<bool> proxies too
+    T tmp   = data[i];
+    data[i] = data[j];
+    data[j] = tmp;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+void PropertyArray<T>::compact(const std::vector<uint> & keep)
+{
+    // keep is sorted, hence keep[i]>=i and the gather can be done in place
+    for(size_t i=0; i<keep.size(); ++i)
+    {
+        assert(keep[i]>=i);
+        if(keep[i]!=i) data[i] = data[keep[i]];
+    }
+    data.resize(keep.size());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+LazyPropertyArray<T>::LazyPropertyArray(const LazyPropertyArray & a) : PropertyArray<T>(a)
+{
+    on.store(a.allocated());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+LazyPropertyArray<T> & LazyPropertyArray<T>::operator=(const LazyPropertyArray & a)
+{
+    if(this==&a) return *this;
+    this->data = a.data;
+    this->def  = a.def;
+    on.store(a.allocated());
+    return *this;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+void LazyPropertyArray<T>::allocate(const size_t n)
+{
+    // double checked: the lock is only taken the first time the array is accessed
+    static std::mutex m;
+    std::lock_guard<std::mutex> lock(m);
+    if(allocated()) return;
+    this->data.assign(n, this->def);
+    on.store(true, std::memory_order_release);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+void LazyPropertyArray<T>::release()
+{
+    std::vector<T>().swap(this->data);
+    on.store(false);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+void LazyPropertyArray<T>::copy_from(const LazyPropertyArray & a, const size_t offset, const size_t n)
+{
+    if(!a.allocated()) return;
+    allocate(n);
+    assert(offset + a.data.size() <= this->data.size());
+    std::copy(a.data.begin(), a.data.end(), this->data.begin()+offset);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+void LazyPropertyArray<T>::copy_from(const LazyPropertyArray & a, const size_t dst, const size_t src, const size_t n)
+{
+    if(!a.allocated()) return;
+    allocate(n);
+    this->data.at(dst) = a.data.at(src);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+PropertyContainer::PropertyContainer(const PropertyContainer & c)
+{
+    *this = c;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+PropertyContainer & PropertyContainer::operator=(const PropertyContainer & c)
+{
+    if(this==&c) return *this;
+    props.clear();
+    for(const auto & p : c.props) props[p.first].reset(p.second->clone());
+    normal  = c.normal;
+    uvw     = c.uvw;
+    quality = c.quality;
+    AO      = c.AO;
+    return *this;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+std::vector<T> & PropertyContainer::get(const std::string & name, const size_t n, const T & def)
+{
+    auto it = props.find(name);
+    if(it==props.end())
+    {
+        it = props.emplace(name, std::unique_ptr<AbstractPropertyArray>(new PropertyArray<T>(n,def))).first;
+    }
+    PropertyArray<T> * p = dynamic_cast<PropertyArray<T>*>(it->second.get());
+    if(p==nullptr)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : property " << name << " exists with a different type" << std::endl;
+        exit(-1);
+    }
+    assert(p->data.size()==n);
+    return p->data;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+const std::vector<T> & PropertyContainer::get(const std::string & name) const
+{
+    auto it = props.find(name);
+    const PropertyArray<T> * p = (it==props.end()) ? nullptr : dynamic_cast<const PropertyArray<T>*>(it->second.get());
+    if(p==nullptr)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : property " << name << " does not exist (or has a different type)" << std::endl;
+        exit(-1);
+    }
+    return p->data;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool PropertyContainer::exists(const std::string & name) const
+{
+    return props.find(name)!=props.end();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertyContainer::remove(const std::string & name)
+{
+    props.erase(name);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<std::string> PropertyContainer::names() const
+{
+    std::vector<std::string> res;
+    for(const auto & p : props) res.push_back(p.first);
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertyContainer::clear()
+{
+    props.clear();
+    normal.release();
+    uvw.release();
+    quality.release();
+    AO.release();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertyContainer::resize(const size_t n)
+{
+    for(auto & p : props) p.second->resize(n);
+    normal.resize(n);
+    uvw.resize(n);
+    quality.resize(n);
+    AO.resize(n);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertyContainer::push_back()
+{
+    for(auto & p : props) p.second->push_back();
+    normal.push_back();
+    uvw.push_back();
+    quality.push_back();
+    AO.push_back();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertyContainer::pop_back()
+{
+    for(auto & p : props) p.second->pop_back();
+    normal.pop_back();
+    uvw.pop_back();
+    quality.pop_back();
+    AO.pop_back();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertyContainer::swap(const size_t i, const size_t j)
+{
+    if(i==j) return;
+    for(auto & p : props) p.second->swap(i,j);
+    normal.swap(i,j);
+    uvw.swap(i,j);
+    quality.swap(i,j);
+    AO.swap(i,j);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertyContainer::compact(const std::vector<uint> & keep)
+{
+    for(auto & p : props) p.second->compact(keep);
+    normal.compact(keep);
+    uvw.compact(keep);
+    quality.compact(keep);
+    AO.compact(keep);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertyContainer::append_std(const PropertyContainer & c, const size_t offset, const size_t n)
+{
+    normal.copy_from (c.normal,  offset, n);
+    uvw.copy_from    (c.uvw,     offset, n);
+    quality.copy_from(c.quality, offset, n);
+    AO.copy_from     (c.AO,      offset, n);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PropertyContainer::copy_std(const size_t dst, const PropertyContainer & c, const size_t src, const size_t n)
+{
+    normal.copy_from (c.normal,  dst, src, n);
+    uvw.copy_from    (c.uvw,     dst, src, n);
+    quality.copy_from(c.quality, dst, src, n);
+    AO.copy_from     (c.AO,      dst, src, n);
+}
+
+}
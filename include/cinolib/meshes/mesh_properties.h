@@ -0,0 +1,229 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_MESH_PROPERTIES_H
+#define CINO_MESH_PROPERTIES_H
+
+#include <map>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
+
+namespace cinolib
+{
+
+/* Dynamic, user defined per element properties.
+ *
+ * Standard attributes (see mesh_attributes.h) are stored as an array of
+ * structures, and extending them requires to re-template the mesh. Properties
+ * are instead stored as a structure of arrays: each property is a typed array
+ * with one entry per mesh element, identified by a name and attached/detached
+ * at runtime. Algorithms that touch a single field only stream that field
+ * through the cache, and memory is allocated only for the properties that are
+ * actually used (properties are created lazily, on first access).
+ *
+ * Meshes own one container per element kind, and keep it aligned with the
+ * element ids across insertions, removals and id switches. Example of usage:
+ *
+ *     std::vector<float> & curv = m.vert_property<float>("curvature");
+ *     for(uint vid=0; vid<m.num_verts(); ++vid) curv[vid] = ...
+ *     ...
+ *     m.vert_property_remove("curvature");
+ *
+ * NOTE: the reference returned by the accessor is invalidated by any
+ * operation that adds or removes mesh elements.
+ *
+ * The heaviest standard attributes (normals, uvw, quality and AO) are stored
+ * in the same way, in lazily allocated arrays owned by the container (see
+ * LazyPropertyArray). Meshes expose them through dedicated accessors (e.g.
+ * m.vert_uvw(vid), m.poly_quality(pid)), whereas the lighter ones (color,
+ * label, flags) are still part of the per element structs (mesh_attributes.h)
+ * and are accessed as m.vert_data(vid).label
+ *
+ * NOTE: clearing a container (e.g. with AbstractMesh::clear) drops both the
+ * data and the registration of all the properties, and releases the memory
+ * of the standard attributes.
+*/
+
+class AbstractPropertyArray
+{
+    public:
+
+        virtual ~AbstractPropertyArray() {}
+
+        virtual AbstractPropertyArray * clone()                          const = 0;
+        virtual size_t                  size()                           const = 0;
+        virtual void                    resize   (const size_t n)              = 0;
+        virtual void                    push_back()                            = 0;
+        virtual void                    pop_back ()                            = 0;
+        virtual void                    swap     (const size_t i, const size_t j) = 0;
+        virtual void                    compact  (const std::vector<uint> & keep) = 0;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+class PropertyArray : public AbstractPropertyArray
+{
+    public:
+
+        explicit PropertyArray(const size_t n, const T & def) : data(n,def), def(def) {}
+
+        AbstractPropertyArray * clone()                          const override { return new PropertyArray<T>(*this); }
+        size_t                  size()                           const override { return data.size();   }
+        void                    resize   (const size_t n)              override { data.resize(n,def);   }
+        void                    push_back()                            override { data.push_back(def);  }
+        void                    pop_back ()                            override { data.pop_back();      }
+        void                    swap     (const size_t i, const size_t j) override;
+        void                    compact  (const std::vector<uint> & keep) override;
+
+        std::vector<T> data;
+        T              def;  // value assigned to new elements
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Property array that is not allocated until it is first accessed for
+ * writing. Until then it takes no memory, reads return the default value, and
+ * all the alignment operations are no-ops. Allocation is thread safe, hence
+ * arrays can be first accessed from within a PARALLEL_FOR.
+*/
+
+template<typename T>
+class LazyPropertyArray : public PropertyArray<T>
+{
+    public:
+
+        explicit LazyPropertyArray(const T & def = T()) : PropertyArray<T>(0,def) {}
+
+        LazyPropertyArray(const LazyPropertyArray & a);
+        LazyPropertyArray & operator=(const LazyPropertyArray & a);
+
+        bool allocated() const { return on.load(std::memory_order_acquire); }
+        void allocate(const size_t n);
+        void release();
+
+        // copies the values of a (if allocated) at positions [offset, offset+a.size()),
+        // allocating this array (with n elements) if needed
+        void copy_from(const LazyPropertyArray & a, const size_t offset, const size_t n);
+        void copy_from(const LazyPropertyArray & a, const size_t dst, const size_t src, const size_t n);
+
+        // the non const access allocates the array (with n elements) if needed
+              T & at(const size_t i, const size_t n) { if(!allocated()) allocate(n); return this->data[i]; }
+        const T & at(const size_t i) const           { return allocated() ? this->data[i] : this->def; }
+
+        AbstractPropertyArray * clone()                            const override { return new LazyPropertyArray<T>(*this); }
+        void                    resize   (const size_t n)                override { if(allocated()) PropertyArray<T>::resize(n);    }
+        void                    push_back()                              override { if(allocated()) PropertyArray<T>::push_back();  }
+        void                    pop_back ()                              override { if(allocated()) PropertyArray<T>::pop_back();   }
+        void                    swap     (const size_t i, const size_t j)   override { if(allocated()) PropertyArray<T>::swap(i,j);    }
+        void                    compact  (const std::vector<uint> & keep)   override { if(allocated()) PropertyArray<T>::compact(keep); }
+
+    private:
+
+        std::atomic<bool> on{false};
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class PropertyContainer
+{
+    public:
+
+        explicit PropertyContainer() {}
+                ~PropertyContainer() {}
+
+        PropertyContainer(const PropertyContainer & c);
+        PropertyContainer & operator=(const PropertyContainer & c);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // returns the property with the given name, creating it (with n elements
+        // set to def) if it does not exist yet. Aborts if the property exists
+        // with a different type
+        template<typename T>
+        std::vector<T> & get(const std::string & name, const size_t n, const T & def = T());
+
+        template<typename T>
+        const std::vector<T> & get(const std::string & name) const;
+
+        bool                     exists(const std::string & name) const;
+        void                     remove(const std::string & name);
+        std::vector<std::string> names() const;
+        bool                     empty() const { return props.empty(); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // used by meshes to keep properties aligned with element ids
+        void clear();
+        void resize   (const size_t n);
+        void push_back();
+        void pop_back ();
+        void swap     (const size_t i, const size_t j);
+        void compact  (const std::vector<uint> & keep); // keep: sorted list of surviving ids
+
+        // used when meshes are merged: copies the standard attributes of c (the
+        // ones that are allocated) at positions [offset, offset + #elements in c).
+        // User defined properties are not copied
+        void append_std(const PropertyContainer & c, const size_t offset, const size_t n);
+
+        // copies the standard attributes of element src of c (the ones that are
+        // allocated) onto element dst. n is the number of elements in this container
+        void copy_std(const size_t dst, const PropertyContainer & c, const size_t src, const size_t n);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // heavy standard attributes (not all of them are meaningful for all
+        // element kinds: arrays that are never accessed take no memory)
+        LazyPropertyArray<vec3d> normal  = LazyPropertyArray<vec3d>(vec3d(0,0,0));
+        LazyPropertyArray<vec3d> uvw     = LazyPropertyArray<vec3d>(vec3d(0,0,0));
+        LazyPropertyArray<float> quality = LazyPropertyArray<float>(0.f);
+        LazyPropertyArray<float> AO      = LazyPropertyArray<float>(1.f);
+
+    private:
+
+        std::map<std::string,std::unique_ptr<AbstractPropertyArray>> props;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "mesh_properties.cpp"
+#endif
+
+#endif // CINO_MESH_PROPERTIES_H
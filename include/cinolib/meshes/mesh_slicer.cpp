@@ -107,7 +107,7 @@ void MeshSlicer::slice(AbstractMesh<M,V,E,P> & m)
     for(uint pid=0; pid<m.num_polys(); ++pid)
     {
         vec3d c = m.poly_centroid(pid);
-        float q = m.poly_data(pid).quality;
+        float q = m.poly_quality(pid);
         int   l = m.poly_data(pid).label;
 
         bool pass_X = (X_leq) ? (c.x() <= X_abs_thresh) : (c.x() >= X_abs_thresh);
@@ -76,4 +76,12 @@ class Polygonmesh : public AbstractPolygonMesh<M,V,E,P>
 #include "polygonmesh.cpp"
 #endif
 
+#ifdef CINOLIB_COMPILED_LIB
+// the default specialization is compiled once in src/polygon_meshes.cpp
+namespace cinolib
+{
+extern template class Polygonmesh<>;
+}
+#endif
+
 #endif // CINO_POLYGONMESH_H
@@ -89,8 +89,14 @@ void Polyhedralmesh<M,V,E,F,P>::load(const char * filename)
     std::string str(filename);
     std::string filetype = "." + get_file_extension(str);
 
-    if (filetype.compare(".hybrid") == 0 ||
-        filetype.compare(".HYBRID") == 0)
+    if (filetype.compare(".cino") == 0 ||
+        filetype.compare(".CINO") == 0)
+    {
+        this->load_CINO(filename);
+        return;
+    }
+    else if (filetype.compare(".hybrid") == 0 ||
+             filetype.compare(".HYBRID") == 0)
     {
         read_HYBDRID(filename, tmp_verts, tmp_faces, tmp_polys, tmp_polys_face_winding);
         this->init(tmp_verts, tmp_faces, tmp_polys, tmp_polys_face_winding);
@@ -134,8 +140,13 @@ void Polyhedralmesh<M,V,E,F,P>::save(const char * filename) const
     std::string str(filename);
     std::string filetype = get_file_extension(str);
 
-    if (filetype.compare("mesh") == 0 ||
-        filetype.compare("MESH") == 0)
+    if (filetype.compare("cino") == 0 ||
+        filetype.compare("CINO") == 0)
+    {
+        this->save_CINO(filename);
+    }
+    else if (filetype.compare("mesh") == 0 ||
+             filetype.compare("MESH") == 0)
     {
         if(this->polys_are_labeled())
         {
@@ -168,7 +179,7 @@ void Polyhedralmesh<M,V,E,F,P>::update_f_normal(const uint fid)
     assert(this->verts_per_face(fid)>2);
     std::vector<vec3d> points;
     for(uint off=0; off<this->verts_per_face(fid); ++off) points.push_back(this->face_vert(fid,off));
-    this->face_data(fid).normal = polygon_normal(points);
+    this->face_normal(fid) = polygon_normal(points);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
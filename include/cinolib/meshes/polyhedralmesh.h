@@ -88,4 +88,12 @@ class Polyhedralmesh : public AbstractPolyhedralMesh<M,V,E,F,P>
 #include "polyhedralmesh.cpp"
 #endif
 
+#ifdef CINOLIB_COMPILED_LIB
+// the default specialization is compiled once in src/polyhedral_meshes.cpp
+namespace cinolib
+{
+extern template class Polyhedralmesh<>;
+}
+#endif
+
 #endif // CINO_POLYHEDRALMESH_H
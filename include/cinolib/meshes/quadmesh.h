@@ -108,4 +108,12 @@ class Quadmesh : public AbstractPolygonMesh<M,V,E,P>
 #include "quadmesh.cpp"
 #endif
 
+#ifdef CINOLIB_COMPILED_LIB
+// the default specialization is compiled once in src/polygon_meshes.cpp
+namespace cinolib
+{
+extern template class Quadmesh<>;
+}
+#endif
+
 #endif // CINO_QUADMESH_H
@@ -154,4 +154,12 @@ class Tetmesh : public AbstractPolyhedralMesh<M,V,E,F,P>
 #include "tetmesh.cpp"
 #endif
 
+#ifdef CINOLIB_COMPILED_LIB
+// the default specialization is compiled once in src/polyhedral_meshes.cpp
+namespace cinolib
+{
+extern template class Tetmesh<>;
+}
+#endif
+
 #endif // CINO_TETMESH_H
@@ -135,4 +135,12 @@ class Trimesh : public AbstractPolygonMesh<M,V,E,P>
 #include "trimesh.cpp"
 #endif
 
+#ifdef CINOLIB_COMPILED_LIB
+// the default specialization is compiled once in src/polygon_meshes.cpp
+namespace cinolib
+{
+extern template class Trimesh<>;
+}
+#endif
+
 #endif // CINO_TRIMESH_H
@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/octree.h>
+#include <cinolib/profiler_zones.h>
 #include <cinolib/how_many_seconds.h>
 #include <cinolib/parallel_for.h>
 #include <cinolib/geometry/point.h>
@@ -91,6 +92,8 @@ Octree::~Octree()
 CINO_INLINE
 void Octree::build()
 {
+    CINO_PROFILE_ZONE("Octree::build");
+    CINO_PROFILE_COUNTER("Octree::build items", items.size());
     typedef std::chrono::steady_clock Time;
     Time::time_point t0 = Time::now();
 
@@ -304,6 +307,7 @@ void Octree::closest_point(const vec3d  & p,          // query point
                                  vec3d  & pos,        // point in T closest to p
                                  double & dist) const // distance between pos and p
 {
+    CINO_PROFILE_ZONE("Octree::closest_point");
     assert(root != nullptr);
 
     typedef std::chrono::steady_clock Time;
@@ -475,49 +479,50 @@ bool Octree::contains(const vec3d & p, const bool strict, std::unordered_set<uin
 CINO_INLINE
 bool Octree::intersects_ray(const vec3d & p, const vec3d & dir, double & min_t, uint & id) const
 {
+    CINO_PROFILE_ZONE("Octree::intersects_ray (first hit)");
     typedef std::chrono::steady_clock Time;
     Time::time_point t0 = Time::now();
 
+    // depth first traversal, visiting children front to back and pruning
+    // all nodes that start beyond the closest hit found so far
+    Ray ray(p, dir);
     vec3d  pos;
-    double t=0.0;
-    if(root && !root->bbox.intersects_ray(p, dir, t, pos)) return false;
-    Obj obj;
-    obj.node = root;
-    obj.dist = t;
-
-    PrioQueue q;
-    q.push(obj);
-
-    while(!q.empty() && q.top().node->is_inner())
+    double t;
+    bool   found = false;
+    min_t = inf_double;
+    std::vector<std::pair<double,const OctreeNode*>> stack;
+    if(root && ray.hits(root->bbox, t)) stack.push_back(std::make_pair(t,root));
+    while(!stack.empty())
     {
-        Obj obj = q.top();
-        q.pop();
+        auto top = stack.back();
+        stack.pop_back();
+        if(top.first>=min_t) continue;
 
-        for(int i=0; i<8; ++i)
+        const OctreeNode *node = top.second;
+        if(node->is_inner())
         {
-            OctreeNode *child = obj.node->children[i];
-            if(child->bbox.intersects_ray(p, dir, t, pos))
+            size_t beg = stack.size();
+            for(int i=0; i<8; ++i)
             {
-                if(child->is_inner())
+                if(ray.hits(node->children[i]->bbox, t) && t<min_t) stack.push_back(std::make_pair(t,node->children[i]));
+            }
+            // farthest first, so that the closest child is popped next
+            std::sort(stack.begin()+beg, stack.end(), [](const std::pair<double,const OctreeNode*> & a,
+                                                         const std::pair<double,const OctreeNode*> & b)
+            {
+                return a.first > b.first;
+            });
+        }
+        else
+        {
+            for(uint i : node->item_indices)
+            {
+                const SpatialDataStructureItem *it = items.at(i);
+                if(ray.hits(it->aabb, t) && t<min_t && it->intersects_ray(p, dir, t, pos) && t<min_t)
                 {
-                    Obj obj;
-                    obj.node = child;
-                    obj.dist = t;
-                    q.push(obj);
-                }
-                else
-                {
-                    for(uint i : child->item_indices)
-                    {
-                        if(items.at(i)->intersects_ray(p, dir, t, pos))
-                        {
-                            Obj obj;
-                            obj.node  = child;
-                            obj.index = items.at(i)->id;
-                            obj.dist  = t;
-                            q.push(obj);
-                        }
-                    }
+                    min_t = t;
+                    id    = it->id;
+                    found = true;
                 }
             }
         }
@@ -529,11 +534,42 @@ bool Octree::intersects_ray(const vec3d & p, const vec3d & dir, double & min_t,
         std::cout << "Intersects ray\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
     }
 
-    if(q.empty()) return false;
-    assert(q.top().index>=0);
-    id    = items.at(q.top().index)->id;
-    min_t = q.top().dist;
-    return true;
+    return found;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool Octree::intersects_ray(const vec3d & p, const vec3d & dir) const
+{
+    // depth first traversal, no need to sort nodes along the ray
+    Ray ray(p, dir);
+    vec3d  pos;
+    double t;
+    std::vector<const OctreeNode*> stack;
+    if(root && ray.hits(root->bbox, t)) stack.push_back(root);
+    while(!stack.empty())
+    {
+        const OctreeNode *node = stack.back();
+        stack.pop_back();
+
+        if(node->is_inner())
+        {
+            for(int i=0; i<8; ++i)
+            {
+                if(ray.hits(node->children[i]->bbox, t)) stack.push_back(node->children[i]);
+            }
+        }
+        else
+        {
+            for(uint i : node->item_indices)
+            {
+                const SpatialDataStructureItem *it = items.at(i);
+                if(ray.hits(it->aabb, t) && it->intersects_ray(p, dir, t, pos)) return true;
+            }
+        }
+    }
+    return false;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
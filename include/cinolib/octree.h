@@ -201,6 +201,10 @@ class Octree
         bool intersects_ray(const vec3d & p, const vec3d & dir, double & min_t, uint & id) const; // first hit
         bool intersects_ray(const vec3d & p, const vec3d & dir, std::set<std::pair<double,uint>> & all_hits) const;
 
+        // returns true as soon as any item in the octree intersects the ray R(t) := p + t * dir
+        // (cheaper than the queries above, useful for visibility tests such as shadows and AO)
+        bool intersects_ray(const vec3d & p, const vec3d & dir) const;
+
         // note: these queries become exact if CINOLIB_USES_SHEWCHUK_PREDICATES is defined
         bool intersects_segment (const vec3d s[], const bool ignore_if_valid_complex, std::unordered_set<uint> & ids) const;
         bool intersects_triangle(const vec3d t[], const bool ignore_if_valid_complex, std::unordered_set<uint> & ids) const;
@@ -244,6 +248,42 @@ class Octree
             }
         };
         typedef std::priority_queue<Obj,std::vector<Obj>,Greater> PrioQueue;
+
+        // ray with precomputed inverse direction, for fast slab tests against
+        // the nodes of the tree (same logic of AABB::intersects_ray)
+        struct Ray
+        {
+            Ray(const vec3d & p, const vec3d & dir) : p(p)
+            {
+                for(int i=0; i<3; ++i)
+                {
+                    parallel[i] = std::fabs(dir[i]) < 1e-15;
+                    inv_dir[i]  = parallel[i] ? 0.0 : 1.0/dir[i];
+                }
+            }
+            bool hits(const AABB & b, double & t_min) const
+            {
+                t_min = 0.0;
+                double t_max = inf_double;
+                for(int i=0; i<3; ++i)
+                {
+                    if(parallel[i])
+                    {
+                        if(p[i]<b.min[i] || p[i]>b.max[i]) return false;
+                        continue;
+                    }
+                    double t_near = (b.min[i] - p[i]) * inv_dir[i];
+                    double t_far  = (b.max[i] - p[i]) * inv_dir[i];
+                    if(t_near > t_far) std::swap(t_near, t_far);
+                    t_min = std::max(t_min, t_near);
+                    t_max = std::min(t_max, t_far);
+                    if(t_min>t_max) return false;
+                }
+                return true;
+            }
+            vec3d p, inv_dir;
+            bool  parallel[3];
+        };
 };
 
 }
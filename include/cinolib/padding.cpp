@@ -55,7 +55,7 @@ void padding(AbstractPolyhedralMesh<M,V,E,F,P> & m, const bool inwards)
         if(m.vert_is_on_srf(vid))
         {
             uint  new_vid = m.vert_add(m.vert(vid));       // update position;
-            vec3d off     = m.vert_data(vid).normal*l*0.5;
+            vec3d off     = m.vert_normal(vid)*l*0.5;
             if(inwards) m.vert(  vid  ) -= off;
             else        m.vert(new_vid) += off;
             vmap[vid] = new_vid;
@@ -0,0 +1,423 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/profiler_zones.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace cinolib
+{
+
+// All the thread logs ever allocated. Logs are never deleted: when a thread
+// terminates its log goes in the free list, and is handed over (with all its
+// events) to the next thread that enters a profiler zone
+//
+struct ProfilerRegistry
+{
+    std::mutex                       mutex;
+    std::vector<ProfilerThreadLog*>  logs;
+    std::vector<ProfilerThreadLog*>  free_logs;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+struct ProfilerThreadHandle
+{
+    ProfilerThreadLog * log = nullptr;
+
+    ~ProfilerThreadHandle();
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+ProfilerRegistry & profiler_registry()
+{
+    static ProfilerRegistry registry;
+    return registry;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+ProfilerThreadHandle::~ProfilerThreadHandle()
+{
+    if(log==nullptr) return;
+    ProfilerRegistry & r = profiler_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    log->depth = 0;
+    r.free_logs.push_back(log);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t profiler_now_ns()
+{
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+ProfilerThreadLog & profiler_thread_log()
+{
+    static thread_local ProfilerThreadHandle handle;
+    if(handle.log==nullptr)
+    {
+        ProfilerRegistry & r = profiler_registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if(!r.free_logs.empty())
+        {
+            handle.log = r.free_logs.back();
+            r.free_logs.pop_back();
+        }
+        else
+        {
+            handle.log = new ProfilerThreadLog;
+            handle.log->ring.resize(ProfilerThreadLog::capacity);
+            handle.log->thread_id = uint32_t(r.logs.size());
+            r.logs.push_back(handle.log);
+        }
+    }
+    return *handle.log;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+ProfilerZone::ProfilerZone(const char * name) : log(&profiler_thread_log()), name(name)
+{
+    ++log->depth;
+    start_ns = profiler_now_ns();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+ProfilerZone::~ProfilerZone()
+{
+    uint64_t stop_ns = profiler_now_ns();
+    --log->depth;
+
+    // single writer: only the owner thread appends to its own ring
+    uint64_t i = log->n_events.load(std::memory_order_relaxed);
+    ProfilerZoneEvent & e = log->ring[i & (ProfilerThreadLog::capacity-1)];
+    e.name     = name;
+    e.start_ns = start_ns;
+    e.stop_ns  = stop_ns;
+    e.depth    = log->depth;
+    log->n_events.store(i+1, std::memory_order_release);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void profiler_add_to_counter(const char * name, const uint64_t n)
+{
+    ProfilerThreadLog & log = profiler_thread_log();
+    for(auto & c : log.counters)
+    {
+        if(c.first==name)
+        {
+            c.second += n;
+            return;
+        }
+    }
+    log.counters.push_back(std::make_pair(name,n));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Events still in the ring of a log, in completion order (i.e. nested zones
+// come before their parent), and their exclusive durations
+//
+CINO_INLINE
+void profiler_log_events(const ProfilerThreadLog              & log,
+                               std::vector<ProfilerZoneEvent> & events,
+                               std::vector<uint64_t>          & self_ns)
+{
+    uint64_t n   = log.n_events.load(std::memory_order_acquire);
+    uint64_t beg = (n>ProfilerThreadLog::capacity) ? n-ProfilerThreadLog::capacity : 0;
+    events.clear();
+    self_ns.clear();
+    std::vector<uint64_t> children_ns; // time spent in completed children, per depth
+    for(uint64_t i=beg; i<n; ++i)
+    {
+        const ProfilerZoneEvent & e = log.ring[i & (ProfilerThreadLog::capacity-1)];
+        if(children_ns.size()<e.depth+2) children_ns.resize(e.depth+2,0);
+        uint64_t dur  = e.stop_ns - e.start_ns;
+        uint64_t nest = std::min(dur, children_ns[e.depth+1]);
+        children_ns[e.depth+1] = 0;
+        children_ns[e.depth]  += dur;
+        events.push_back(e);
+        self_ns.push_back(dur-nest);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<ProfilerZoneStats> profiler_zones_stats()
+{
+    ProfilerRegistry & r = profiler_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    std::map<std::string,ProfilerZoneStats> stats;
+    std::vector<ProfilerZoneEvent> events;
+    std::vector<uint64_t>          self_ns;
+    for(const ProfilerThreadLog * log : r.logs)
+    {
+        profiler_log_events(*log, events, self_ns);
+
+        // names are literals: resolve each pointer to its entry only once
+        std::unordered_map<const char*,ProfilerZoneStats*> cache;
+        for(uint i=0; i<events.size(); ++i)
+        {
+            auto it = cache.find(events[i].name);
+            if(it==cache.end())
+            {
+                ProfilerZoneStats & s = stats[events[i].name];
+                s.name = events[i].name;
+                it = cache.insert(std::make_pair(events[i].name,&s)).first;
+            }
+            ProfilerZoneStats & s = *it->second;
+            double t = double(events[i].stop_ns - events[i].start_ns)*1e-9;
+            s.calls   += 1;
+            s.total_s += t;
+            s.self_s  += double(self_ns[i])*1e-9;
+            s.min_s    = std::min(s.min_s, t);
+            s.max_s    = std::max(s.max_s, t);
+        }
+    }
+
+    std::vector<ProfilerZoneStats> res;
+    for(const auto & obj : stats) res.push_back(obj.second);
+    std::sort(res.begin(), res.end(), [](const ProfilerZoneStats & a, const ProfilerZoneStats & b)
+    {
+        return a.total_s > b.total_s;
+    });
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<std::pair<std::string,uint64_t>> profiler_zones_counters()
+{
+    ProfilerRegistry & r = profiler_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    std::map<std::string,uint64_t> counters;
+    for(const ProfilerThreadLog * log : r.logs)
+    {
+        for(const auto & c : log->counters) counters[c.first] += c.second;
+    }
+    return std::vector<std::pair<std::string,uint64_t>>(counters.begin(), counters.end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void profiler_zones_report()
+{
+    std::cout << "::::::::::::::: PROFILER ZONES ::::::::::::::::::::" << std::endl;
+    std::cout << std::setw(12) << "total(s)"
+              << std::setw(12) << "self(s)"
+              << std::setw(10) << "calls"
+              << std::setw(12) << "avg(ms)"
+              << std::setw(12) << "max(ms)" << "  zone" << std::endl;
+    for(const ProfilerZoneStats & s : profiler_zones_stats())
+    {
+        std::cout << std::setw(12) << s.total_s
+                  << std::setw(12) << s.self_s
+                  << std::setw(10) << s.calls
+                  << std::setw(12) << 1000.0*s.total_s/s.calls
+                  << std::setw(12) << 1000.0*s.max_s << "  " << s.name << std::endl;
+    }
+    auto counters = profiler_zones_counters();
+    if(!counters.empty())
+    {
+        std::cout << "::::::::::::::: PROFILER COUNTERS :::::::::::::::::" << std::endl;
+        for(const auto & c : counters) std::cout << std::setw(12) << c.second << "  " << c.first << std::endl;
+    }
+    std::cout << "::::::::::::::::::::::::::::::::::::::::::::::::::::\n" << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::string profiler_json_escape(const std::string & s)
+{
+    std::string res;
+    for(char c : s)
+    {
+        if(c=='"' || c=='\\') res += '\\';
+        res += c;
+    }
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void profiler_zones_write_chrome_trace(const char * filename)
+{
+    std::ofstream f(filename);
+    if(!f.is_open())
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : profiler_zones_write_chrome_trace() : couldn't open output file " << filename << std::endl;
+        exit(-1);
+    }
+
+    auto counters = profiler_zones_counters();
+
+    ProfilerRegistry & r = profiler_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    // timestamps are relative to the first recorded event
+    std::vector<std::vector<ProfilerZoneEvent>> events(r.logs.size());
+    std::vector<uint64_t> self_ns;
+    uint64_t t0 = ~uint64_t(0);
+    uint64_t t1 = 0;
+    for(uint i=0; i<r.logs.size(); ++i)
+    {
+        profiler_log_events(*r.logs.at(i), events.at(i), self_ns);
+        for(const auto & e : events.at(i))
+        {
+            t0 = std::min(t0, e.start_ns);
+            t1 = std::max(t1, e.stop_ns);
+        }
+    }
+    if(t0>t1) t0 = t1 = 0;
+
+    f << std::fixed << std::setprecision(3);
+    f << "{\"traceEvents\":[\n";
+    bool first = true;
+    for(uint i=0; i<r.logs.size(); ++i)
+    {
+        for(const auto & e : events.at(i))
+        {
+            f << (first ? "" : ",\n")
+              << "{\"name\":\"" << profiler_json_escape(e.name) << "\",\"ph\":\"X\""
+              << ",\"ts\":"  << double(e.start_ns-t0)*1e-3
+              << ",\"dur\":" << double(e.stop_ns-e.start_ns)*1e-3
+              << ",\"pid\":0,\"tid\":" << r.logs.at(i)->thread_id << "}";
+            first = false;
+        }
+    }
+    if(!counters.empty())
+    {
+        f << (first ? "" : ",\n") << "{\"name\":\"counters\",\"ph\":\"C\",\"ts\":" << double(t1-t0)*1e-3 << ",\"pid\":0,\"args\":{";
+        for(uint i=0; i<counters.size(); ++i)
+        {
+            f << (i>0 ? "," : "") << "\"" << profiler_json_escape(counters.at(i).first) << "\":" << counters.at(i).second;
+        }
+        f << "}}";
+    }
+    f << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void profiler_zones_write_folded_stacks(const char * filename)
+{
+    std::ofstream f(filename);
+    if(!f.is_open())
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : profiler_zones_write_folded_stacks() : couldn't open output file " << filename << std::endl;
+        exit(-1);
+    }
+
+    ProfilerRegistry & r = profiler_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    std::map<std::string,uint64_t> stacks;
+    std::vector<ProfilerZoneEvent> events;
+    std::vector<uint64_t>          self_ns;
+    for(const ProfilerThreadLog * log : r.logs)
+    {
+        profiler_log_events(*log, events, self_ns);
+
+        // visit zones in opening order: the parent of a zone at depth d is
+        // the last zone at depth d-1 opened before it
+        std::vector<uint> order(events.size());
+        for(uint i=0; i<order.size(); ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [&](const uint a, const uint b)
+        {
+            if(events[a].start_ns!=events[b].start_ns) return events[a].start_ns < events[b].start_ns;
+            return events[a].depth < events[b].depth;
+        });
+
+        std::vector<std::string> stack;
+        for(uint i : order)
+        {
+            // zones whose parent was overwritten in the ring are attached to the root
+            while(stack.size()<events[i].depth)
+            {
+                stack.push_back(stack.empty() ? std::string("[unknown]") : stack.back() + ";[unknown]");
+            }
+            stack.resize(events[i].depth);
+            stack.push_back(stack.empty() ? std::string(events[i].name) : stack.back() + ";" + events[i].name);
+            stacks[stack.back()] += self_ns[i]/1000;
+        }
+    }
+
+    for(const auto & s : stacks) if(s.second>0) f << s.first << " " << s.second << "\n";
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void profiler_zones_reset()
+{
+    ProfilerRegistry & r = profiler_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for(ProfilerThreadLog * log : r.logs)
+    {
+        log->n_events.store(0, std::memory_order_release);
+        for(auto & c : log->counters) c.second = 0;
+    }
+}
+
+}
@@ -0,0 +1,202 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_PROFILER_ZONES_H
+#define CINO_PROFILER_ZONES_H
+
+/* Library-wide instrumentation. Differently from cinolib::Profiler, which is
+ * meant for explicit push/pop timings in user code, profiler zones are cheap
+ * RAII markers that are spread across the hot paths of the library (mesh
+ * initialization, GPU buffer updates, octree construction, linear solvers,
+ * remeshing...) and are COMPILED OUT unless symbol CINOLIB_PROFILING is
+ * defined (e.g. with the homonymous option in cinolib-config.cmake).
+ *
+ * When enabled, each thread appends its events to a private ring buffer,
+ * with no locks nor allocations along the way (names are string literals,
+ * stored by pointer). Buffers are recycled when threads terminate, so that
+ * the temporary threads spawned by PARALLEL_FOR do not accumulate memory.
+ * Events can be aggregated across threads and exported in Chrome trace
+ * format (chrome://tracing, https://ui.perfetto.dev) or as folded stacks,
+ * which is the input format of flamegraph.pl and speedscope.
+ *
+ * Example of usage:
+ *
+ *     void my_function(...)
+ *     {
+ *         CINO_PROFILE_ZONE("my_function");
+ *         ...
+ *         CINO_PROFILE_COUNTER("elements processed", n);
+ *     }
+ *     ...
+ *     profiler_zones_report();
+ *     profiler_zones_write_chrome_trace("trace.json");
+ *
+ * NOTE: aggregation and export read the buffers of all threads, and should
+ * therefore be called when no other thread is inside an instrumented zone.
+*/
+
+#ifdef CINOLIB_PROFILING
+
+#include <cinolib/cino_inline.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cinolib
+{
+
+struct ProfilerZoneEvent
+{
+    const char * name;
+    uint64_t     start_ns;
+    uint64_t     stop_ns;
+    uint32_t     depth;    // nesting level within the thread (0 for top level zones)
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+struct ProfilerThreadLog
+{
+    static const uint64_t capacity = 1 << 16; // events kept per thread (the oldest are overwritten)
+
+    std::vector<ProfilerZoneEvent>                   ring;
+    std::atomic<uint64_t>                            n_events{0}; // total number of events ever written
+    std::vector<std::pair<const char*,uint64_t>>     counters;
+    uint32_t                                         thread_id = 0; // slot id, inherited when the log is recycled
+    uint32_t                                         depth     = 0;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+struct ProfilerZoneStats
+{
+    std::string name;
+    uint64_t    calls   = 0;
+    double      total_s = 0;      // inclusive time, summed over all threads
+    double      self_s  = 0;      // exclusive time (i.e. not spent in nested zones)
+    double      min_s   = 1e+300;
+    double      max_s   = 0;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class ProfilerZone
+{
+    public:
+
+        explicit ProfilerZone(const char * name);
+                ~ProfilerZone();
+
+    private:
+
+        ProfilerThreadLog * log;
+        const char        * name;
+        uint64_t            start_ns;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+ProfilerThreadLog & profiler_thread_log();
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void profiler_add_to_counter(const char * name, const uint64_t n);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// per zone statistics, sorted by decreasing inclusive time
+CINO_INLINE
+std::vector<ProfilerZoneStats> profiler_zones_stats();
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// counters summed across all threads
+CINO_INLINE
+std::vector<std::pair<std::string,uint64_t>> profiler_zones_counters();
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void profiler_zones_report();
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void profiler_zones_write_chrome_trace(const char * filename);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// one line per call stack, with the self time spent in it (in microseconds)
+CINO_INLINE
+void profiler_zones_write_folded_stacks(const char * filename);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void profiler_zones_reset();
+
+}
+
+#define CINO_PROFILE_CONCAT_(a,b) a##b
+#define CINO_PROFILE_CONCAT(a,b)  CINO_PROFILE_CONCAT_(a,b)
+
+// the empty strings around name only accept string literals
+#define CINO_PROFILE_ZONE(name)         cinolib::ProfilerZone CINO_PROFILE_CONCAT(cino_profile_zone_,__LINE__)("" name "")
+#define CINO_PROFILE_COUNTER(name,n)    cinolib::profiler_add_to_counter("" name "", uint64_t(n))
+
+#ifndef  CINO_STATIC_LIB
+#include "profiler_zones.cpp"
+#endif
+
+#else // CINOLIB_PROFILING
+
+#define CINO_PROFILE_ZONE(name)
+#define CINO_PROFILE_COUNTER(name,n)
+
+// reporting stubs, so that user code does not need to be guarded
+namespace cinolib
+{
+inline void profiler_zones_report() {}
+inline void profiler_zones_write_chrome_trace (const char *) {}
+inline void profiler_zones_write_folded_stacks(const char *) {}
+inline void profiler_zones_reset() {}
+}
+
+#endif // CINOLIB_PROFILING
+
+#endif // CINO_PROFILER_ZONES_H
@@ -0,0 +1,660 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/quality_stats.h>
+#include <cinolib/quality.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <cmath>
+
+namespace cinolib
+{
+
+static const uint QUALITY_BATCH_SIZE = 64;   // elements per SoA batch
+static const uint QUALITY_CHUNK_SIZE = 4096; // elements per parallel task
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::string quality_metric_name(const int metric)
+{
+    switch(metric)
+    {
+        case QUALITY_SCALED_JACOBIAN : return "Scaled Jacobian";
+        case QUALITY_JACOBIAN        : return "Jacobian";
+        case QUALITY_VOLUME          : return "Volume";
+        case QUALITY_DIAGONAL        : return "Diagonal";
+        case QUALITY_EDGE_RATIO      : return "Edge Ratio";
+        case QUALITY_MAX_EDGE_RATIO  : return "Max Edge Ratio";
+        case QUALITY_MAX_ASPECT_FROB : return "Max Aspect Frobenius";
+        case QUALITY_MEAN_ASPECT_FROB: return "Mean Aspect Frobenius";
+        case QUALITY_ODDY            : return "Oddy";
+        case QUALITY_SHAPE           : return "Shape";
+        case QUALITY_SHEAR           : return "Shear";
+        case QUALITY_SKEW            : return "Skew";
+        case QUALITY_STRETCH         : return "Stretch";
+        case QUALITY_TAPER           : return "Taper";
+        default: assert(false);
+    }
+    return "";
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// metrics with a natural range get their histogram in the same pass that evaluates them
+CINO_INLINE
+bool quality_metric_range(const int metric, double & lo, double & hi)
+{
+    switch(metric)
+    {
+        case QUALITY_SCALED_JACOBIAN : lo = -1; hi = 1; return true;
+        case QUALITY_SHAPE           :
+        case QUALITY_SHEAR           :
+        case QUALITY_SKEW            :
+        case QUALITY_STRETCH         : lo =  0; hi = 1; return true;
+        default: return false;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint quality_bin(const double v, const double lo, const double hi, const uint n_bins)
+{
+    if(!(hi>lo)) return 0;
+    double t = (v-lo)/(hi-lo)*n_bins;
+    if(t<=0) return 0;
+    if(t>=n_bins) return n_bins-1;
+    return uint(t);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::ostream & operator<<(std::ostream & in, const QualityStats & stats)
+{
+    in << quality_metric_name(stats.metric) << " : "
+       << "min " << stats.min << " (poly " << stats.argmin << "), "
+       << "max " << stats.max << " (poly " << stats.argmax << "), "
+       << "avg " << stats.avg << " (" << stats.count << " polys)\n";
+    if(stats.hist.empty() || stats.count==0) return in;
+    double step = (stats.hist_hi - stats.hist_lo)/stats.hist.size();
+    for(uint i=0; i<stats.hist.size(); ++i)
+    {
+        in << "    [" << stats.hist_lo + i*step << ", " << stats.hist_lo + (i+1)*step << ") : "
+           << stats.hist.at(i) << "\t(" << 100.0*stats.hist.at(i)/stats.count << "%)\n";
+    }
+    return in;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::ostream & operator<<(std::ostream & in, const MeshQuality & q)
+{
+    in << ":::::::::::::::::::::: MESH QUALITY ::::::::::::::::::::::::\n";
+    for(const QualityStats & s : q.stats) in << s;
+    in << "::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::\n";
+    return in;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+const QualityStats & MeshQuality::operator[](const int metric) const
+{
+    for(const QualityStats & s : stats) if(s.metric==metric) return s;
+    assert(false && "metric was not evaluated");
+    return stats.front();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+const std::vector<double> & MeshQuality::per_poly(const int metric) const
+{
+    for(uint i=0; i<stats.size(); ++i) if(stats.at(i).metric==metric) return values.at(i);
+    assert(false && "metric was not evaluated");
+    return values.front();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::: SoA KERNELS ::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// corners of up to QUALITY_BATCH_SIZE tets or hexes, plus scratch space for the kernels.
+// Each kernel is a sequence of loops over the lanes of the batch, which the compiler
+// can vectorize. Operations are done in the same order as in quality_tet/quality_hex,
+// so results are bitwise identical to the scalar routines (unless the compiler is
+// allowed to contract them into FMAs)
+struct QualityBatch
+{
+    uint   n = 0;
+    uint   pid[QUALITY_BATCH_SIZE];
+    double x[8][QUALITY_BATCH_SIZE];
+    double y[8][QUALITY_BATCH_SIZE];
+    double z[8][QUALITY_BATCH_SIZE];
+    // scratch
+    double Lx[12][QUALITY_BATCH_SIZE], Ly[12][QUALITY_BATCH_SIZE], Lz[12][QUALITY_BATCH_SIZE];
+    double Xx[ 3][QUALITY_BATCH_SIZE], Xy[ 3][QUALITY_BATCH_SIZE], Xz[ 3][QUALITY_BATCH_SIZE];
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// a.dot(b.cross(c)), with the same operation order of vec3d
+CINO_INLINE
+double soa_det(const double ax, const double ay, const double az,
+               const double bx, const double by, const double bz,
+               const double cx, const double cy, const double cz)
+{
+    return ax*(by*cz - bz*cy) + ay*(bz*cx - bx*cz) + az*(bx*cy - by*cx);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// mimics vec3d::normalize() guarded by is_null(), as in hex_edges and hex_principal_axes
+CINO_INLINE
+void soa_normalize(double * x, double * y, double * z, const uint n)
+{
+    for(uint i=0; i<n; ++i)
+    {
+        double len = std::sqrt(x[i]*x[i] + y[i]*y[i] + z[i]*z[i]);
+        double div = (x[i]==0 && y[i]==0 && z[i]==0) ? 1.0 : len;
+        x[i] /= div;
+        y[i] /= div;
+        z[i] /= div;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void tet_batch_scaled_jacobian(const QualityBatch & b, double * out)
+{
+    static const double sqrt_2 = 1.414213562373095;
+    for(uint i=0; i<b.n; ++i)
+    {
+        double L0x = b.x[1][i]-b.x[0][i], L0y = b.y[1][i]-b.y[0][i], L0z = b.z[1][i]-b.z[0][i];
+        double L1x = b.x[2][i]-b.x[1][i], L1y = b.y[2][i]-b.y[1][i], L1z = b.z[2][i]-b.z[1][i];
+        double L2x = b.x[0][i]-b.x[2][i], L2y = b.y[0][i]-b.y[2][i], L2z = b.z[0][i]-b.z[2][i];
+        double L3x = b.x[3][i]-b.x[0][i], L3y = b.y[3][i]-b.y[0][i], L3z = b.z[3][i]-b.z[0][i];
+        double L4x = b.x[3][i]-b.x[1][i], L4y = b.y[3][i]-b.y[1][i], L4z = b.z[3][i]-b.z[1][i];
+        double L5x = b.x[3][i]-b.x[2][i], L5y = b.y[3][i]-b.y[2][i], L5z = b.z[3][i]-b.z[2][i];
+
+        double l0 = std::sqrt(L0x*L0x + L0y*L0y + L0z*L0z);
+        double l1 = std::sqrt(L1x*L1x + L1y*L1y + L1z*L1z);
+        double l2 = std::sqrt(L2x*L2x + L2y*L2y + L2z*L2z);
+        double l3 = std::sqrt(L3x*L3x + L3y*L3y + L3z*L3z);
+        double l4 = std::sqrt(L4x*L4x + L4y*L4y + L4z*L4z);
+        double l5 = std::sqrt(L5x*L5x + L5y*L5y + L5z*L5z);
+
+        // (L2 x L0) . L3
+        double J = soa_det(L3x, L3y, L3z, L2x, L2y, L2z, L0x, L0y, L0z);
+
+        double max = l0 * l2 * l3;
+        double tmp;
+        tmp = l0 * l1 * l4; max = (max<tmp) ? tmp : max;
+        tmp = l1 * l2 * l5; max = (max<tmp) ? tmp : max;
+        tmp = l3 * l4 * l5; max = (max<tmp) ? tmp : max;
+        max = (max<J) ? J : max;
+
+        out[i] = J * sqrt_2 / max;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void tet_batch_volume(const QualityBatch & b, double * out)
+{
+    for(uint i=0; i<b.n; ++i)
+    {
+        double L0x = b.x[1][i]-b.x[0][i], L0y = b.y[1][i]-b.y[0][i], L0z = b.z[1][i]-b.z[0][i];
+        double L2x = b.x[0][i]-b.x[2][i], L2y = b.y[0][i]-b.y[2][i], L2z = b.z[0][i]-b.z[2][i];
+        double L3x = b.x[3][i]-b.x[0][i], L3y = b.y[3][i]-b.y[0][i], L3z = b.z[3][i]-b.z[0][i];
+        out[i] = soa_det(L3x, L3y, L3z, L2x, L2y, L2z, L0x, L0y, L0z) / 6.0;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_batch_principal_axes(QualityBatch & b, const bool normalized)
+{
+    const uint n = b.n;
+    for(uint i=0; i<n; ++i)
+    {
+        b.Xx[0][i] = (b.x[1][i]-b.x[0][i]) + (b.x[2][i]-b.x[3][i]) + (b.x[5][i]-b.x[4][i]) + (b.x[6][i]-b.x[7][i]);
+        b.Xy[0][i] = (b.y[1][i]-b.y[0][i]) + (b.y[2][i]-b.y[3][i]) + (b.y[5][i]-b.y[4][i]) + (b.y[6][i]-b.y[7][i]);
+        b.Xz[0][i] = (b.z[1][i]-b.z[0][i]) + (b.z[2][i]-b.z[3][i]) + (b.z[5][i]-b.z[4][i]) + (b.z[6][i]-b.z[7][i]);
+    }
+    for(uint i=0; i<n; ++i)
+    {
+        b.Xx[1][i] = (b.x[3][i]-b.x[0][i]) + (b.x[2][i]-b.x[1][i]) + (b.x[7][i]-b.x[4][i]) + (b.x[6][i]-b.x[5][i]);
+        b.Xy[1][i] = (b.y[3][i]-b.y[0][i]) + (b.y[2][i]-b.y[1][i]) + (b.y[7][i]-b.y[4][i]) + (b.y[6][i]-b.y[5][i]);
+        b.Xz[1][i] = (b.z[3][i]-b.z[0][i]) + (b.z[2][i]-b.z[1][i]) + (b.z[7][i]-b.z[4][i]) + (b.z[6][i]-b.z[5][i]);
+    }
+    for(uint i=0; i<n; ++i)
+    {
+        b.Xx[2][i] = (b.x[4][i]-b.x[0][i]) + (b.x[5][i]-b.x[1][i]) + (b.x[6][i]-b.x[2][i]) + (b.x[7][i]-b.x[3][i]);
+        b.Xy[2][i] = (b.y[4][i]-b.y[0][i]) + (b.y[5][i]-b.y[1][i]) + (b.y[6][i]-b.y[2][i]) + (b.y[7][i]-b.y[3][i]);
+        b.Xz[2][i] = (b.z[4][i]-b.z[0][i]) + (b.z[5][i]-b.z[1][i]) + (b.z[6][i]-b.z[2][i]) + (b.z[7][i]-b.z[3][i]);
+    }
+    if(normalized) for(int j=0; j<3; ++j) soa_normalize(b.Xx[j], b.Xy[j], b.Xz[j], n);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// min determinant of the 9 corner tets (see hex_subtets). If normalized
+// returns the scaled jacobian, otherwise the jacobian
+CINO_INLINE
+void hex_batch_jacobian(QualityBatch & b, const bool normalized, double * out)
+{
+    // edge endpoints, as in hex_edges
+    static const int E[12][2] =
+    {
+        {0,1}, {1,2}, {2,3}, {0,3}, {0,4}, {1,5}, {2,6}, {3,7}, {4,5}, {5,6}, {6,7}, {4,7}
+    };
+    // edges spanning the 8 corner tets (and their sign), as in hex_subtets
+    static const int    T[8][3] = { {0,3,4}, {1,0,5}, {2,1,6}, {3,2,7}, {11,8,4}, {8,9,5}, {9,10,6}, {10,11,7} };
+    static const double S[8][3] = { {1, 1, 1}, {1,-1, 1}, {1,-1, 1}, {-1,-1, 1},
+                                    {1, 1,-1}, {-1,1,-1}, {-1,1,-1}, {-1,-1,-1} };
+    const uint n = b.n;
+    for(int e=0; e<12; ++e)
+    {
+        const int v0 = E[e][0];
+        const int v1 = E[e][1];
+        for(uint i=0; i<n; ++i)
+        {
+            b.Lx[e][i] = b.x[v1][i] - b.x[v0][i];
+            b.Ly[e][i] = b.y[v1][i] - b.y[v0][i];
+            b.Lz[e][i] = b.z[v1][i] - b.z[v0][i];
+        }
+        if(normalized) soa_normalize(b.Lx[e], b.Ly[e], b.Lz[e], n);
+    }
+    hex_batch_principal_axes(b, normalized);
+
+    // central tet (the jacobian scales it, as in hex_jacobian)
+    for(uint i=0; i<n; ++i)
+    {
+        double d = soa_det(b.Xx[0][i], b.Xy[0][i], b.Xz[0][i],
+                           b.Xx[1][i], b.Xy[1][i], b.Xz[1][i],
+                           b.Xx[2][i], b.Xy[2][i], b.Xz[2][i]);
+        out[i] = normalized ? d : d/64.0;
+    }
+    for(int t=0; t<8; ++t)
+    {
+        const int    a  = T[t][0], c  = T[t][1], d  = T[t][2];
+        const double sa = S[t][0], sc = S[t][1], sd = S[t][2];
+        for(uint i=0; i<n; ++i)
+        {
+            double det = soa_det(sa*b.Lx[a][i], sa*b.Ly[a][i], sa*b.Lz[a][i],
+                                 sc*b.Lx[c][i], sc*b.Ly[c][i], sc*b.Lz[c][i],
+                                 sd*b.Lx[d][i], sd*b.Ly[d][i], sd*b.Lz[d][i]);
+            out[i] = (det<out[i]) ? det : out[i];
+        }
+    }
+    if(normalized)
+    {
+        for(uint i=0; i<n; ++i) if(out[i]>1.0001) out[i] = -1.0;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_batch_volume(QualityBatch & b, double * out)
+{
+    hex_batch_principal_axes(b, false);
+    for(uint i=0; i<b.n; ++i)
+    {
+        out[i] = soa_det(b.Xx[0][i], b.Xy[0][i], b.Xz[0][i],
+                         b.Xx[1][i], b.Xy[1][i], b.Xz[1][i],
+                         b.Xx[2][i], b.Xy[2][i], b.Xz[2][i]) / 64.0;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+typedef double (*HexMetric)(const vec3d &, const vec3d &, const vec3d &, const vec3d &,
+                            const vec3d &, const vec3d &, const vec3d &, const vec3d &);
+
+// all the remaining metrics use the scalar routines, one lane at a time
+CINO_INLINE
+void hex_batch_scalar(const QualityBatch & b, const int metric, double * out)
+{
+    HexMetric f = nullptr;
+    switch(metric)
+    {
+        case QUALITY_DIAGONAL        : f = hex_diagonal;               break;
+        case QUALITY_EDGE_RATIO      : f = hex_edge_ratio;             break;
+        case QUALITY_MAX_EDGE_RATIO  : f = hex_max_edge_ratio;         break;
+        case QUALITY_MAX_ASPECT_FROB : f = hex_max_aspect_Frobenius;   break;
+        case QUALITY_MEAN_ASPECT_FROB: f = hex_mean_aspect_Frobenius;  break;
+        case QUALITY_ODDY            : f = hex_oddy;                   break;
+        case QUALITY_SHAPE           : f = hex_shape;                  break;
+        case QUALITY_SHEAR           : f = hex_shear;                  break;
+        case QUALITY_SKEW            : f = hex_skew;                   break;
+        case QUALITY_STRETCH         : f = hex_stretch;                break;
+        case QUALITY_TAPER           : f = hex_taper;                  break;
+        default: assert(false);
+    }
+    for(uint i=0; i<b.n; ++i)
+    {
+        vec3d p[8];
+        for(int j=0; j<8; ++j) p[j] = vec3d(b.x[j][i], b.y[j][i], b.z[j][i]);
+        out[i] = f(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void quality_batch_eval(QualityBatch & b, const bool is_hex, const int metric, double * out)
+{
+    if(is_hex)
+    {
+        switch(metric)
+        {
+            case QUALITY_SCALED_JACOBIAN : hex_batch_jacobian(b, true,  out); break;
+            case QUALITY_JACOBIAN        : hex_batch_jacobian(b, false, out); break;
+            case QUALITY_VOLUME          : hex_batch_volume  (b, out);        break;
+            default                      : hex_batch_scalar  (b, metric, out);
+        }
+    }
+    else
+    {
+        switch(metric)
+        {
+            case QUALITY_SCALED_JACOBIAN : tet_batch_scaled_jacobian(b, out); break;
+            case QUALITY_VOLUME          : tet_batch_volume(b, out);          break;
+            default: std::fill(out, out+b.n, std::numeric_limits<double>::quiet_NaN());
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void quality_accumulate(QualityStats & s, const double v, const uint pid, const uint n_bins)
+{
+    if(std::isnan(v)) return;
+    ++s.count;
+    s.sum += v;
+    if(v<s.min || (v==s.min && pid<s.argmin)) { s.min = v; s.argmin = pid; }
+    if(v>s.max || (v==s.max && pid<s.argmax)) { s.max = v; s.argmax = pid; }
+    if(!s.hist.empty()) ++s.hist[quality_bin(v, s.hist_lo, s.hist_hi, n_bins)];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// evaluates all metrics on elements pids[beg..end) (or beg..end if pids is null), writing
+// their values in q.values. If partial is not null, its stats are updated as well
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void quality_eval_range(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                        const uint                              * pids,
+                        const uint                                beg,
+                        const uint                                end,
+                              MeshQuality                       & q,
+                              QualityStats                      * partial)
+{
+    QualityBatch tb, hb;
+    double out[QUALITY_BATCH_SIZE];
+
+    auto flush = [&](QualityBatch & b, const bool is_hex)
+    {
+        for(uint k=0; k<q.stats.size(); ++k)
+        {
+            quality_batch_eval(b, is_hex, q.stats.at(k).metric, out);
+            std::vector<double> & val = q.values.at(k);
+            for(uint i=0; i<b.n; ++i) val[b.pid[i]] = out[i];
+            if(partial!=nullptr)
+            {
+                for(uint i=0; i<b.n; ++i) quality_accumulate(partial[k], out[i], b.pid[i], q.n_bins);
+            }
+        }
+        b.n = 0;
+    };
+
+    auto push = [&](QualityBatch & b, const uint pid, const uint nv)
+    {
+        const uint lane = b.n++;
+        b.pid[lane] = pid;
+        for(uint j=0; j<nv; ++j)
+        {
+            const vec3d & p = m.poly_vert(pid,j);
+            b.x[j][lane] = p.x();
+            b.y[j][lane] = p.y();
+            b.z[j][lane] = p.z();
+        }
+    };
+
+    for(uint i=beg; i<end; ++i)
+    {
+        const uint pid = (pids!=nullptr) ? pids[i] : i;
+        if(m.poly_is_tetrahedron(pid))
+        {
+            push(tb, pid, 4);
+            if(tb.n==QUALITY_BATCH_SIZE) flush(tb, false);
+        }
+        else if(m.poly_is_hexahedron(pid))
+        {
+            push(hb, pid, 8);
+            if(hb.n==QUALITY_BATCH_SIZE) flush(hb, true);
+        }
+        else
+        {
+            for(auto & val : q.values) val[pid] = std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+    if(tb.n>0) flush(tb, false);
+    if(hb.n>0) flush(hb, true);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void quality_rescan_min_max(const std::vector<double> & val, QualityStats & s)
+{
+    s.min =  inf_double;
+    s.max = -inf_double;
+    for(uint pid=0; pid<val.size(); ++pid)
+    {
+        const double v = val.at(pid);
+        if(std::isnan(v)) continue;
+        if(v<s.min) { s.min = v; s.argmin = pid; }
+        if(v>s.max) { s.max = v; s.argmax = pid; }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void mesh_quality(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                  const int                                 metrics,
+                        MeshQuality                       & q,
+                  const uint                                n_bins)
+{
+    q.metrics = metrics;
+    q.n_bins  = std::max(n_bins, 1u);
+    q.stats.clear();
+    for(int bit=1; bit<=QUALITY_TAPER; bit<<=1)
+    {
+        if(!(metrics & bit)) continue;
+        QualityStats s;
+        s.metric = bit;
+        if(quality_metric_range(bit, s.hist_lo, s.hist_hi)) s.hist.assign(q.n_bins, 0);
+        q.stats.push_back(s);
+    }
+    const uint n_metrics = q.stats.size();
+    q.values.resize(n_metrics);
+    for(auto & val : q.values) val.resize(m.num_polys());
+    if(n_metrics==0) return;
+
+    // one pass: each chunk evaluates its elements and accumulates partial stats,
+    // which are then merged in chunk order (results do not depend on the number of threads)
+    const uint n_chunks = (m.num_polys() + QUALITY_CHUNK_SIZE - 1) / QUALITY_CHUNK_SIZE;
+    std::vector<QualityStats> partials(n_chunks*n_metrics);
+    for(uint c=0; c<n_chunks; ++c)
+    {
+        std::copy(q.stats.begin(), q.stats.end(), partials.begin() + c*n_metrics);
+    }
+    PARALLEL_FOR(0, n_chunks, 2, [&](uint c)
+    {
+        uint beg = c*QUALITY_CHUNK_SIZE;
+        uint end = std::min(beg + QUALITY_CHUNK_SIZE, m.num_polys());
+        quality_eval_range(m, nullptr, beg, end, q, partials.data() + c*n_metrics);
+    });
+
+    for(uint k=0; k<n_metrics; ++k)
+    {
+        QualityStats & s = q.stats.at(k);
+        for(uint c=0; c<n_chunks; ++c)
+        {
+            const QualityStats & p = partials.at(c*n_metrics+k);
+            if(p.count==0) continue;
+            s.count += p.count;
+            s.sum   += p.sum;
+            if(p.min<s.min) { s.min = p.min; s.argmin = p.argmin; }
+            if(p.max>s.max) { s.max = p.max; s.argmax = p.argmax; }
+            for(uint i=0; i<s.hist.size(); ++i) s.hist[i] += p.hist[i];
+        }
+        s.avg = (s.count>0) ? s.sum/s.count : 0.0;
+    }
+
+    // unbounded metrics: bin the cached values in the [min,max] range
+    for(uint k=0; k<n_metrics; ++k)
+    {
+        QualityStats & s = q.stats.at(k);
+        if(!s.hist.empty() || s.count==0) continue;
+        s.hist_lo = s.min;
+        s.hist_hi = s.max;
+        std::vector<std::vector<uint>> hist(n_chunks, std::vector<uint>(q.n_bins,0));
+        const std::vector<double> & val = q.values.at(k);
+        PARALLEL_FOR(0, n_chunks, 2, [&](uint c)
+        {
+            uint beg = c*QUALITY_CHUNK_SIZE;
+            uint end = std::min(beg + QUALITY_CHUNK_SIZE, m.num_polys());
+            for(uint pid=beg; pid<end; ++pid)
+            {
+                if(!std::isnan(val[pid])) ++hist[c][quality_bin(val[pid], s.hist_lo, s.hist_hi, q.n_bins)];
+            }
+        });
+        s.hist.assign(q.n_bins, 0);
+        for(uint c=0; c<n_chunks; ++c)
+        for(uint i=0; i<q.n_bins; ++i) s.hist[i] += hist[c][i];
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+MeshQuality mesh_quality(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                         const int                                 metrics,
+                         const uint                                n_bins)
+{
+    MeshQuality q;
+    mesh_quality(m, metrics, q, n_bins);
+    return q;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void mesh_quality_update(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                         const std::vector<uint>                 & moved_verts,
+                               MeshQuality                       & q)
+{
+    assert(q.values.size()==q.stats.size());
+    if(q.stats.empty()) return;
+    assert(q.values.front().size()==m.num_polys());
+
+    std::vector<uint> pids;
+    for(uint vid : moved_verts)
+    {
+        for(uint pid : m.adj_v2p(vid)) pids.push_back(pid);
+    }
+    std::sort(pids.begin(), pids.end());
+    pids.erase(std::unique(pids.begin(), pids.end()), pids.end());
+    if(pids.empty()) return;
+
+    const uint n_metrics = q.stats.size();
+    std::vector<double> old_val(pids.size()*n_metrics);
+    for(uint k=0; k<n_metrics; ++k)
+    for(uint i=0; i<pids.size(); ++i)
+    {
+        old_val[k*pids.size()+i] = q.values[k][pids[i]];
+    }
+
+    const uint n_chunks = (pids.size() + QUALITY_CHUNK_SIZE - 1) / QUALITY_CHUNK_SIZE;
+    PARALLEL_FOR(0, n_chunks, 2, [&](uint c)
+    {
+        uint beg = c*QUALITY_CHUNK_SIZE;
+        uint end = std::min(beg + QUALITY_CHUNK_SIZE, (uint)pids.size());
+        quality_eval_range(m, pids.data(), beg, end, q, nullptr);
+    });
+
+    // update the stats with the difference between old and new values
+    for(uint k=0; k<n_metrics; ++k)
+    {
+        QualityStats & s = q.stats.at(k);
+        const double old_min = s.min;
+        const double old_max = s.max;
+        bool rescan = false;
+        for(uint i=0; i<pids.size(); ++i)
+        {
+            const uint   pid = pids[i];
+            const double ov  = old_val[k*pids.size()+i];
+            const double nv  = q.values[k][pid];
+            if(!std::isnan(ov))
+            {
+                --s.count;
+                s.sum -= ov;
+                if(!s.hist.empty()) --s.hist[quality_bin(ov, s.hist_lo, s.hist_hi, q.n_bins)];
+            }
+            if(pid==s.argmin && !(nv<=old_min)) rescan = true; // the old minimum may be gone
+            if(pid==s.argmax && !(nv>=old_max)) rescan = true; // the old maximum may be gone
+            quality_accumulate(s, nv, pid, q.n_bins);
+        }
+        if(rescan) quality_rescan_min_max(q.values.at(k), s);
+        s.avg = (s.count>0) ? s.sum/s.count : 0.0;
+    }
+}
+
+}
@@ -0,0 +1,155 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_QUALITY_STATS_H
+#define CINO_QUALITY_STATS_H
+
+#include <cinolib/meshes/abstract_polyhedralmesh.h>
+#include <cinolib/min_max_inf.h>
+
+namespace cinolib
+{
+
+/* Whole mesh quality evaluation for tetrahedral and hexahedral meshes.
+ * Any subset of the metrics listed below can be evaluated at once on all
+ * the tets and hexes of a (possibly mixed) polyhedral mesh. Elements are
+ * processed in parallel, in batches of fixed size that store the corners
+ * of their elements in SoA layout (one array per coordinate and corner).
+ * Scaled jacobian, jacobian and volume are evaluated with dedicated kernels
+ * that loop over the lanes of a batch, and are auto-vectorized by the compiler
+ * (use -O3, and possibly -march=native -fno-math-errno, to vectorize also the
+ * square roots with the widest SIMD registers available). All other hex metrics
+ * are evaluated with the scalar routines in quality_hex.h
+ *
+ * Per element values are cached, so that after moving a few vertices the
+ * statistics can be updated by re-evaluating only the elements incident to
+ * them (see mesh_quality_update)
+*/
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// metrics are bit flags, and can be combined with bitwise OR (e.g. QUALITY_SCALED_JACOBIAN | QUALITY_VOLUME)
+enum
+{
+    QUALITY_SCALED_JACOBIAN = 0x0001, // tets and hexes
+    QUALITY_JACOBIAN        = 0x0002, // hexes only (from here on)
+    QUALITY_VOLUME          = 0x0004, // tets and hexes (signed)
+    QUALITY_DIAGONAL        = 0x0008,
+    QUALITY_EDGE_RATIO      = 0x0010,
+    QUALITY_MAX_EDGE_RATIO  = 0x0020,
+    QUALITY_MAX_ASPECT_FROB = 0x0040,
+    QUALITY_MEAN_ASPECT_FROB= 0x0080,
+    QUALITY_ODDY            = 0x0100,
+    QUALITY_SHAPE           = 0x0200,
+    QUALITY_SHEAR           = 0x0400,
+    QUALITY_SKEW            = 0x0800,
+    QUALITY_STRETCH         = 0x1000,
+    QUALITY_TAPER           = 0x2000,
+};
+
+CINO_INLINE
+std::string quality_metric_name(const int metric);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+struct QualityStats
+{
+    int               metric  = 0;
+    uint              count   = 0;           // number of elements on which the metric is defined
+    double            min     =  inf_double;
+    double            max     = -inf_double;
+    double            sum     = 0.0;
+    double            avg     = 0.0;
+    uint              argmin  = 0;           // id of the element with minimum value (lowest id if not unique)
+    uint              argmax  = 0;           // id of the element with maximum value (lowest id if not unique)
+    double            hist_lo = 0.0;         // histogram range. Bounded metrics (e.g. scaled jacobian) use their
+    double            hist_hi = 0.0;         // natural range, the others the [min,max] range of the first evaluation
+    std::vector<uint> hist;                  // uniform bins. Values outside the range go in the first/last bin
+};
+
+CINO_INLINE
+std::ostream & operator<<(std::ostream & in, const QualityStats & stats);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+struct MeshQuality
+{
+    int                              metrics = QUALITY_SCALED_JACOBIAN;
+    uint                             n_bins  = 20;
+    std::vector<QualityStats>        stats;  // one per metric, sorted by flag value
+    std::vector<std::vector<double>> values; // values[i][pid] is the i-th metric for element pid (NaN if undefined)
+
+    const QualityStats        & operator[](const int metric) const; // stats of a given metric
+    const std::vector<double> & per_poly  (const int metric) const; // per element values of a given metric
+};
+
+CINO_INLINE
+std::ostream & operator<<(std::ostream & in, const MeshQuality & q);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// evaluates the metrics in the bitmask for all the elements of m,
+// and computes their min/max/avg and histograms
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void mesh_quality(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                  const int                                 metrics,
+                        MeshQuality                       & q,
+                  const uint                                n_bins = 20);
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+MeshQuality mesh_quality(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                         const int                                 metrics = QUALITY_SCALED_JACOBIAN,
+                         const uint                                n_bins  = 20);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// incremental update of a previous evaluation. Only the elements incident
+// to the vertices in moved_verts are re-evaluated. The mesh connectivity
+// must be the same used to compute q. Histogram ranges are not updated
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void mesh_quality_update(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                         const std::vector<uint>                 & moved_verts,
+                               MeshQuality                       & q);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "quality_stats.cpp"
+#endif
+
+#endif // CINO_QUALITY_STATS_H
@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/remesh_BotschKobbelt2004.h>
+#include <cinolib/profiler_zones.h>
 #include <cinolib/tangential_smoothing.h>
 
 namespace cinolib
@@ -53,6 +54,7 @@ void remesh_Botsch_Kobbelt_2004(Trimesh<M,V,E,P> & m,
                                 const double       target_edge_length,
                                 const bool         preserve_marked_features)
 {
+    CINO_PROFILE_ZONE("remesh_Botsch_Kobbelt_2004");
     double l = (target_edge_length>0) ? target_edge_length : m.edge_avg_length();
 
     // 1) split too long edges
@@ -79,6 +81,7 @@ void remesh_Botsch_Kobbelt_2004(Trimesh<M,V,E,P> & m,
         }
     }
     std::cout << "\t" << count << " edges longer than " << 4./3.*l << " were split." << std::endl;
+    CINO_PROFILE_COUNTER("remesh_Botsch_Kobbelt_2004 splits", count);
 
     // 2) collapse too short edges
     //
@@ -102,6 +105,7 @@ void remesh_Botsch_Kobbelt_2004(Trimesh<M,V,E,P> & m,
         }
     }
     std::cout << "\t" << count << " edges shorter than " << 4./5.*l << " were collapsed." << std::endl;
+    CINO_PROFILE_COUNTER("remesh_Botsch_Kobbelt_2004 collapses", count);
 
     // 3) optimize per vert valence
     //
@@ -160,6 +164,7 @@ void remesh_Botsch_Kobbelt_2004(Trimesh<M,V,E,P> & m,
         }
     }
     std::cout << "\t" << count << " edge flip were performed to normalize vertex valence to 6" << std::endl;
+    CINO_PROFILE_COUNTER("remesh_Botsch_Kobbelt_2004 flips", count);
 
 
     // 4) relocate vertices by tangential smoothing
@@ -0,0 +1,318 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/reorder_mesh.h>
+#include <cinolib/space_filling_curves.h>
+#include <cinolib/geometry/aabb.h>
+#include <cinolib/ipair.h>
+#include <algorithm>
+#include <climits>
+#include <numeric>
+#include <queue>
+
+namespace cinolib
+{
+
+CINO_INLINE
+std::vector<uint> space_filling_curve_order(const std::vector<vec3d> & points,
+                                            const bool                 hilbert)
+{
+    AABB bb(points);
+    std::vector<std::pair<uint64_t,uint>> keys(points.size());
+    for(uint i=0; i<points.size(); ++i)
+    {
+        keys.at(i).first  = hilbert ? hilbert_code(points.at(i), bb) : morton_code(points.at(i), bb);
+        keys.at(i).second = i;
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<uint> order(points.size());
+    for(uint i=0; i<keys.size(); ++i) order.at(i) = keys.at(i).second;
+    return order;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// BFS level structure rooted at seed. Returns the eccentricity of the seed and
+// fills last_level with the nodes at maximum distance from it
+//
+CINO_INLINE
+uint rcm_level_structure(const std::vector<std::vector<uint>> & adj,
+                         const uint                             seed,
+                         std::vector<uint>                    & dist,
+                         std::vector<uint>                    & last_level)
+{
+    std::vector<uint> visited;
+    std::queue<uint>  q;
+    dist.at(seed) = 0;
+    visited.push_back(seed);
+    q.push(seed);
+    uint ecc = 0;
+    while(!q.empty())
+    {
+        uint curr = q.front();
+        q.pop();
+        ecc = std::max(ecc, dist.at(curr));
+        for(uint nbr : adj.at(curr))
+        {
+            if(dist.at(nbr)!=UINT_MAX) continue;
+            dist.at(nbr) = dist.at(curr)+1;
+            visited.push_back(nbr);
+            q.push(nbr);
+        }
+    }
+    last_level.clear();
+    for(uint id : visited)
+    {
+        if(dist.at(id)==ecc) last_level.push_back(id);
+        dist.at(id) = UINT_MAX; // reset for the next call
+    }
+    return ecc;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<uint> reverse_Cuthill_McKee_order(const std::vector<std::vector<uint>> & adj)
+{
+    uint n = uint(adj.size());
+    std::vector<uint> order;
+    order.reserve(n);
+    std::vector<bool> visited(n, false);
+    std::vector<uint> dist(n, UINT_MAX);
+    std::vector<uint> last_level, nbrs;
+
+    auto by_degree = [&](const uint a, const uint b) { return adj.at(a).size() < adj.at(b).size(); };
+
+    for(uint start=0; start<n; ++start)
+    {
+        if(visited.at(start)) continue;
+
+        // George-Liu heuristic for pseudo-peripheral nodes: repeatedly jump to the
+        // min degree node of the last BFS level, as long as the eccentricity grows
+        uint seed = start;
+        uint ecc  = rcm_level_structure(adj, seed, dist, last_level);
+        for(int it=0; it<8; ++it)
+        {
+            uint cand     = *std::min_element(last_level.begin(), last_level.end(), by_degree);
+            uint cand_ecc = rcm_level_structure(adj, cand, dist, last_level);
+            if(cand_ecc<=ecc) break;
+            seed = cand;
+            ecc  = cand_ecc;
+        }
+
+        // Cuthill-McKee: BFS visiting neighbors by increasing degree
+        uint head = uint(order.size());
+        order.push_back(seed);
+        visited.at(seed) = true;
+        while(head<order.size())
+        {
+            uint curr = order.at(head++);
+            nbrs.clear();
+            for(uint nbr : adj.at(curr))
+            {
+                if(visited.at(nbr)) continue;
+                visited.at(nbr) = true;
+                nbrs.push_back(nbr);
+            }
+            std::stable_sort(nbrs.begin(), nbrs.end(), by_degree);
+            order.insert(order.end(), nbrs.begin(), nbrs.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// applies the permutation (new to old ids) with a sequence of id switches, so that
+// all adjacency relations, attributes and properties are updated by the mesh itself
+//
+template<class Mesh, class SwitchFunc>
+CINO_INLINE
+void apply_order(Mesh & m, const std::vector<uint> & order, SwitchFunc switch_id)
+{
+    uint n = uint(order.size());
+    std::vector<uint> pos(n);     // current position of each element (by original id)
+    std::vector<uint> elem(n);    // original id of the element at each position
+    std::iota(pos.begin(),  pos.end(),  0);
+    std::iota(elem.begin(), elem.end(), 0);
+
+    for(uint i=0; i<n; ++i)
+    {
+        uint j = pos.at(order.at(i));
+        if(i==j) continue;
+        (m.*switch_id)(i,j);
+        std::swap(elem.at(i), elem.at(j));
+        pos.at(elem.at(i)) = i;
+        pos.at(elem.at(j)) = j;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void permute_verts(Mesh & m, const std::vector<uint> & order)
+{
+    assert(order.size()==m.num_verts());
+    apply_order(m, order, &Mesh::vert_switch_id);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void permute_edges(Mesh & m, const std::vector<uint> & order)
+{
+    assert(order.size()==m.num_edges());
+    apply_order(m, order, &Mesh::edge_switch_id);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void permute_polys(Mesh & m, const std::vector<uint> & order)
+{
+    assert(order.size()==m.num_polys());
+    apply_order(m, order, &Mesh::poly_switch_id);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void permute_faces(AbstractPolyhedralMesh<M,V,E,F,P> & m, const std::vector<uint> & order)
+{
+    assert(order.size()==m.num_faces());
+    apply_order(m, order, &AbstractPolyhedralMesh<M,V,E,F,P>::face_switch_id);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// surface meshes do not have faces: nothing to do
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void reorder_faces(AbstractPolygonMesh<M,V,E,P> &)
+{}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void reorder_faces(AbstractPolyhedralMesh<M,V,E,F,P> & m)
+{
+    std::vector<std::vector<uint>> keys(m.num_faces());
+    for(uint fid=0; fid<m.num_faces(); ++fid)
+    {
+        keys.at(fid) = m.face_verts_id(fid);
+        std::sort(keys.at(fid).begin(), keys.at(fid).end());
+    }
+    std::vector<uint> order(m.num_faces());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](const uint a, const uint b) { return keys.at(a) < keys.at(b); });
+    permute_faces(m, order);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void reorder_mesh(Mesh                    & m,
+                  const ReorderStrategy     strategy,
+                  std::vector<uint>       & v_old2new,
+                  std::vector<uint>       & p_old2new)
+{
+    std::vector<uint> v_order, p_order;
+    switch(strategy)
+    {
+        case REORDER_MORTON:
+        case REORDER_HILBERT:
+        {
+            std::vector<vec3d> centroids(m.num_polys());
+            for(uint pid=0; pid<m.num_polys(); ++pid) centroids.at(pid) = m.poly_centroid(pid);
+            v_order = space_filling_curve_order(m.vector_verts(), strategy==REORDER_HILBERT);
+            p_order = space_filling_curve_order(centroids,        strategy==REORDER_HILBERT);
+            break;
+        }
+        case REORDER_RCM:
+        {
+            std::vector<std::vector<uint>> adj(m.num_verts());
+            for(uint vid=0; vid<m.num_verts(); ++vid) adj.at(vid) = m.adj_v2v(vid);
+            v_order = reverse_Cuthill_McKee_order(adj);
+            adj.resize(m.num_polys());
+            for(uint pid=0; pid<m.num_polys(); ++pid) adj.at(pid) = m.adj_p2p(pid);
+            p_order = reverse_Cuthill_McKee_order(adj);
+            break;
+        }
+        default: assert(false && "unknown reordering strategy");
+    }
+
+    permute_verts(m, v_order);
+    permute_polys(m, p_order);
+
+    // edges follow their (new) vertex ids
+    std::vector<ipair> e_keys(m.num_edges());
+    for(uint eid=0; eid<m.num_edges(); ++eid)
+    {
+        e_keys.at(eid) = unique_pair(m.edge_vert_id(eid,0), m.edge_vert_id(eid,1));
+    }
+    std::vector<uint> e_order(m.num_edges());
+    std::iota(e_order.begin(), e_order.end(), 0);
+    std::sort(e_order.begin(), e_order.end(), [&](const uint a, const uint b) { return e_keys.at(a) < e_keys.at(b); });
+    permute_edges(m, e_order);
+
+    reorder_faces(m);
+
+    v_old2new.resize(v_order.size());
+    p_old2new.resize(p_order.size());
+    for(uint i=0; i<v_order.size(); ++i) v_old2new.at(v_order.at(i)) = i;
+    for(uint i=0; i<p_order.size(); ++i) p_old2new.at(p_order.at(i)) = i;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void reorder_mesh(Mesh                    & m,
+                  const ReorderStrategy     strategy)
+{
+    std::vector<uint> v_old2new, p_old2new;
+    reorder_mesh(m, strategy, v_old2new, p_old2new);
+}
+
+}
@@ -0,0 +1,124 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_REORDER_MESH_H
+#define CINO_REORDER_MESH_H
+
+#include <vector>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
+#include <cinolib/meshes/abstract_polygonmesh.h>
+#include <cinolib/meshes/abstract_polyhedralmesh.h>
+
+namespace cinolib
+{
+
+/* Element ids of meshes loaded from file follow the file order, hence elements
+ * that are close in space (and in the adjacency graph) are often far apart in
+ * memory. Traversal heavy algorithms (Laplacian assembly, smoothing, geodesics,
+ * BFS/Dijkstra...) therefore pay a cache miss for almost every neighbor they
+ * visit. Reordering the mesh elements so that neighbors have close ids greatly
+ * improves memory locality. Supported strategies are:
+ *
+ *  - REORDER_MORTON : sort by Morton code of vertex positions/poly centroids
+ *  - REORDER_HILBERT: sort by Hilbert code of vertex positions/poly centroids
+ *  - REORDER_RCM    : Reverse Cuthill-McKee on the vert-vert / poly-poly graphs
+ *                     (minimizes the bandwidth of sparse matrices defined on them)
+ *
+ * Edges (and faces, for volume meshes) are sorted according to the new ids of
+ * their vertices. All adjacency, attributes and user defined properties are
+ * permuted consistently.
+*/
+
+enum ReorderStrategy
+{
+    REORDER_MORTON,
+    REORDER_HILBERT,
+    REORDER_RCM
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// returns the sorting (new to old ids) of a set of points along a space filling curve
+//
+CINO_INLINE
+std::vector<uint> space_filling_curve_order(const std::vector<vec3d> & points,
+                                            const bool                 hilbert = true);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// returns the Reverse Cuthill-McKee ordering (new to old ids) of a graph.
+// Each connected component is visited starting from a pseudo-peripheral node
+//
+CINO_INLINE
+std::vector<uint> reverse_Cuthill_McKee_order(const std::vector<std::vector<uint>> & adj);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// reorders verts, edges, (faces) and polys of a mesh. The output arrays map
+// old ids to new ids (e.g. to transfer per element data stored outside the mesh)
+//
+template<class Mesh>
+CINO_INLINE
+void reorder_mesh(Mesh                    & m,
+                  const ReorderStrategy     strategy,
+                  std::vector<uint>       & v_old2new,
+                  std::vector<uint>       & p_old2new);
+
+template<class Mesh>
+CINO_INLINE
+void reorder_mesh(Mesh                    & m,
+                  const ReorderStrategy     strategy = REORDER_HILBERT);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// applies a permutation (new to old ids) to the verts/edges/faces/polys of a mesh
+//
+template<class Mesh> CINO_INLINE void permute_verts(Mesh & m, const std::vector<uint> & order);
+template<class Mesh> CINO_INLINE void permute_edges(Mesh & m, const std::vector<uint> & order);
+template<class Mesh> CINO_INLINE void permute_polys(Mesh & m, const std::vector<uint> & order);
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void permute_faces(AbstractPolyhedralMesh<M,V,E,F,P> & m, const std::vector<uint> & order);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "reorder_mesh.cpp"
+#endif
+
+#endif // CINO_REORDER_MESH_H
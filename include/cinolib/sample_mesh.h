@@ -51,6 +51,9 @@ namespace cinolib
  * Efficient and Flexible Sampling with Blue Noise Properties of Triangular Meshes
  * IEEE Transactions on Visualization and Computer Graphics (2012)
  * M.Corsini, P.Cignoni, R.Scopigno
+ *
+ * To generate blue noise samples on the surface (rather than selecting a
+ * subset of its vertices) use the parallel Poisson sampler in Poisson_sampling.h
 */
 
 template<class M, class V, class E, class P>
@@ -52,6 +52,19 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void shortest_path_tree(AbstractPolygonMesh<M,V,E,P> & m, const uint root, std::vector<bool> & tree);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same as above, but also outputs the distance from the root and the parent of each vertex
+// in the tree (-1 for the root), so that the path towards the root can be walked in O(depth)
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void shortest_path_tree(const AbstractPolygonMesh<M,V,E,P> & m,
+                        const uint                           root,
+                              std::vector<bool>            & tree,
+                              std::vector<double>          & dist,
+                              std::vector<int>             & parent);
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -36,7 +36,7 @@
 #include <cinolib/smoother.h>
 #include <cinolib/laplacian.h>
 #include <cinolib/linear_solvers.h>
-#include <cinolib/octree.h>
+#include <cinolib/feature_projector.h>
 
 namespace cinolib
 {
@@ -48,37 +48,14 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
                    const AbstractPolygonMesh<M2,V2,E2,P2> & target,
                    const SmootherOptions                  & opt)
 {
-    // BUILD OCTREES
-    Octree o_srf;    // for general surface
-    Octree o_line;   // for feature lines
-    Octree o_corner; // for feature corners (i.e. points where feature lines meet or terminate)
-    //
-    for(uint eid=0; eid<target.num_edges(); ++eid)
-    {
-        if(target.edge_data(eid).flags[MARKED]) // marked => flagged as a sharp feature
-        {
-            o_line.push_segment(eid, target.edge_vert(eid,0), target.edge_vert(eid,1));
-        }
-    }
-    for(uint vid=0; vid<target.num_verts(); ++vid)
-    {
-        uint count = 0;
-        for(uint eid : target.adj_v2e(vid))
-        {
-            if(target.edge_data(eid).flags[MARKED]) ++count;
-        }
-        if(count>0 && count!=2)
-        {
-            o_corner.push_point(vid, target.vert(vid));
-        }
-    }
-    o_srf.build_from_mesh_polys(target);
-    o_line.build();
-    o_corner.build();
+    // BUILD SPATIAL INDEX (general surface, feature lines and feature corners)
+    FeatureProjector proj(target, MARKED); // marked => flagged as a sharp feature
 
     // LABEL MESH VERTICES
     enum { REGULAR, CORNER, FEATURE };
-    for(uint vid=0; vid<m.num_verts(); ++vid)
+    uint nv = m.num_verts();
+    std::vector<int> proj_type(nv);
+    for(uint vid=0; vid<nv; ++vid)
     {
         uint count = 0;
         for(uint eid : m.adj_v2e(vid))
@@ -88,9 +65,9 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
         }
         switch(count)
         {
-            case 0  : m.vert_data(vid).label = REGULAR; break;
-            case 2  : m.vert_data(vid).label = FEATURE; break;
-            default : m.vert_data(vid).label = CORNER;  break;
+            case 0  : m.vert_data(vid).label = REGULAR; proj_type.at(vid) = PROJ_SURFACE; break;
+            case 2  : m.vert_data(vid).label = FEATURE; proj_type.at(vid) = PROJ_CREASE;  break;
+            default : m.vert_data(vid).label = CORNER;  proj_type.at(vid) = PROJ_CORNER;  break;
         }
     }
 
@@ -99,16 +76,26 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
     std::vector<double> rhs;     // right hand side
     uint row = 0;
 
+    // closest points on target (one for each vertex), computed in parallel at each iteration
+    std::vector<vec3d>  p_target;
+    std::vector<uint>   id_target;
+    std::vector<double> dist_target;
+
     // additional data used to parameterize verts along feature lines (one for each such vert)
     // each feature vertex is defined as P_curr + dir*t
     std::unordered_map<uint,std::pair<vec3d,uint>> feature_data;
 
     // E_laplacian = \sum_{\forall i} \sum_{\forall j \in N(i)} (v_i - v_j)^2
+    // (uniform weights do not depend on the geometry, and are computed only once)
+    std::vector<Entry> L;
     auto laplacian = [&]()
     {
-        auto L = laplacian_matrix_entries(m, opt.laplacian_mode, 3); // TODO: add row and col offsets for laplacian...
-        for(auto entry : L) entries.push_back(entry);
-        uint extra_rows = m.num_verts()*3;
+        if(L.empty() || opt.laplacian_mode!=UNIFORM)
+        {
+            L = laplacian_matrix_entries(m, opt.laplacian_mode, 3); // TODO: add row and col offsets for laplacian...
+        }
+        entries.insert(entries.end(), L.begin(), L.end());
+        uint extra_rows = nv*3;
         w.reserve(w.size()+extra_rows);
         rhs.reserve(rhs.size()+extra_rows);
         for(uint i=0; i<extra_rows; ++i)
@@ -123,18 +110,14 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
     // where <n,d> is the plane tangent to the mesh at v_i
     auto tangent_space = [&](const uint vid)
     {
-        vec3d  p;
-        double dist;
-        uint   pid;
-        o_srf.closest_point(m.vert(vid), pid, p, dist);
-        vec3d n = target.poly_data(pid).normal;
+        const vec3d & p = p_target.at(vid);
+        vec3d n = target.poly_normal(id_target.at(vid));
 
         // reduces energy for mapping to distant points
         // because they are likely to be wrong assignments
         double w_regular = opt.w_corner;
-        if(dist>m.edge_avg_length(vid)*2) w_regular *= 0.01; // TODO: this should be a Gaussian....
+        if(dist_target.at(vid)>m.edge_avg_length(vid)*2) w_regular *= 0.01; // TODO: this should be a Gaussian....
 
-        uint  nv    = m.num_verts();
         uint  col_x = vid;
         uint  col_y = nv + vid;
         uint  col_z = nv + nv + vid;
@@ -152,13 +135,9 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
     // parameterized by the extra varaible t
     auto tangent_line = [&](const uint vid)
     {
-        vec3d  p;
-        double dist;
-        uint   eid;
-        o_line.closest_point(m.vert(vid), eid, p, dist);
-        vec3d dir = target.edge_vec(eid,true);
+        const vec3d & p = p_target.at(vid);
+        vec3d dir = target.edge_vec(id_target.at(vid),true);
 
-        uint  nv    = m.num_verts();
         uint  col_x = vid;
         uint  col_y = nv + vid;
         uint  col_z = nv + nv + vid;
@@ -193,41 +172,53 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
     // where v_i* is the current position of v_i
     auto corner = [&](const uint vid)
     {
-        vec3d  p;
-        double dist;
-        uint   pid;
-        o_corner.closest_point(m.vert(vid), pid, p, dist);
+        const vec3d & p = p_target.at(vid);
 
         // discards mappings to distant corners because they are likely to be wrong assignments
-        // (e.g. if the feature networks of source and target meshes mismatch)
-        if(dist>m.edge_avg_length(vid)*2) return;
+        // (e.g. if the feature networks of source and target meshes mismatch). Rows are zeroed
+        // rather than skipped, so that the sparsity pattern of the system does not change
+        double w_corner = opt.w_corner;
+        if(dist_target.at(vid)>m.edge_avg_length(vid)*2) w_corner = 0.0;
 
-        uint  nv    = m.num_verts();
         uint  col_x = vid;
         uint  col_y = nv + vid;
         uint  col_z = nv + nv + vid;
 
         entries.push_back(Entry(row, col_x, 1.0));
         rhs.push_back(p.x());
-        w.push_back(opt.w_corner);
+        w.push_back(w_corner);
         ++row;
 
         entries.push_back(Entry(row, col_y, 1.0));
         rhs.push_back(p.y());
-        w.push_back(opt.w_corner);
+        w.push_back(w_corner);
         ++row;
 
         entries.push_back(Entry(row, col_z, 1.0));
         rhs.push_back(p.z());
-        w.push_back(opt.w_corner);
+        w.push_back(w_corner);
         ++row;
     };
 
+    // Connectivity does not change across iterations, and neither does the sparsity
+    // pattern of the system. The symbolic factorization is therefore computed once,
+    // and only the numerical factorization is updated at each iteration
+    Eigen::SimplicialLLT<Eigen::SparseMatrix<double>> solver;
+    Eigen::Index pattern_nnz = -1;
+
     // SMOOTHING ITERATIONS
     for(uint i=0; i<opt.n_iters; ++i)
     {
+        feature_data.clear();
+        entries.clear();
+        w.clear();
+        rhs.clear();
+        row = 0;
+
+        proj.closest_points(m.vector_verts(), proj_type, p_target, id_target, dist_target);
+
         laplacian();
-        for(uint vid=0; vid<m.num_verts(); ++vid)
+        for(uint vid=0; vid<nv; ++vid)
         {
             switch(m.vert_data(vid).label)
             {
@@ -238,41 +229,35 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
             }
         }
 
-        Eigen::SparseMatrix<double> A(row,m.num_verts()*3+feature_data.size());
+        Eigen::SparseMatrix<double> A(row,nv*3+feature_data.size());
         A.setFromTriplets(entries.begin(), entries.end());
         Eigen::VectorXd RHS = Eigen::Map<Eigen::VectorXd>(rhs.data(), rhs.size());
         Eigen::VectorXd W   = Eigen::Map<Eigen::VectorXd>(w.data(), w.size());
-        Eigen::VectorXd res;
-        solve_weighted_least_squares(A, W, RHS, res);
 
-        uint nv = m.num_verts();
-        for(uint vid=0; vid<nv; ++vid)
+        Eigen::SparseMatrix<double> At   = A.transpose();
+        Eigen::SparseMatrix<double> AtWA = At * W.asDiagonal() * A;
+        Eigen::VectorXd             AtWb = At * W.asDiagonal() * RHS;
+        if(AtWA.nonZeros()!=pattern_nnz)
         {
-            vec3d p(res[vid], res[nv+vid], res[2*nv+vid]);
-
-            switch(m.vert_data(vid).label)
-            {
-                case REGULAR: m.vert(vid) = (opt.reproject_on_target) ? o_srf.closest_point(p)    : p; break;
-                case CORNER:  m.vert(vid) = (opt.reproject_on_target) ? o_corner.closest_point(p) : p; break;
-                case FEATURE:
-                {
-                    const auto & line = feature_data.at(vid);
-                    p += line.first * res[line.second];
-                    m.vert(vid) = (opt.reproject_on_target) ? o_line.closest_point(p) : p;
-                    break;
-                }
-                default: assert(false && "unknown vertex type");
-            }
+            solver.analyzePattern(AtWA);
+            pattern_nnz = AtWA.nonZeros();
         }
+        solver.factorize(AtWA);
+        assert(solver.info() == Eigen::Success);
+        Eigen::VectorXd res = solver.solve(AtWb);
 
-        if(i<opt.n_iters)
+        std::vector<vec3d> new_pos(nv);
+        for(uint vid=0; vid<nv; ++vid)
         {
-            feature_data.clear();
-            entries.clear();
-            w.clear();
-            rhs.clear();
-            row = 0;
+            new_pos.at(vid) = vec3d(res[vid], res[nv+vid], res[2*nv+vid]);
+            if(m.vert_data(vid).label==FEATURE)
+            {
+                const auto & line = feature_data.at(vid);
+                new_pos.at(vid) += line.first * res[line.second];
+            }
         }
+        if(opt.reproject_on_target) proj.closest_points(new_pos, proj_type, new_pos);
+        for(uint vid=0; vid<nv; ++vid) m.vert(vid) = new_pos.at(vid);
     }
 }
 
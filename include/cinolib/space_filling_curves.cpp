@@ -0,0 +1,136 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/space_filling_curves.h>
+#include <algorithm>
+
+namespace cinolib
+{
+
+// spreads the lower 21 bits of x, leaving two zeros between consecutive bits
+// https://fgiesen.wordpress.com/2009/12/13/decoding-morton-codes/
+//
+CINO_INLINE
+uint64_t morton_split_by_3(const uint x)
+{
+    uint64_t v = x & 0x1fffff;
+    v = (v | v << 32) & 0x001f00000000ffffull;
+    v = (v | v << 16) & 0x001f0000ff0000ffull;
+    v = (v | v <<  8) & 0x100f00f00f00f00full;
+    v = (v | v <<  4) & 0x10c30c30c30c30c3ull;
+    v = (v | v <<  2) & 0x1249249249249249ull;
+    return v;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t morton_code(const uint x, const uint y, const uint z)
+{
+    return morton_split_by_3(x) | (morton_split_by_3(y) << 1) | (morton_split_by_3(z) << 2);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// quantizes p on a 2^21 x 2^21 x 2^21 grid spanning bbox bb
+//
+CINO_INLINE
+void sfc_quantize(const vec3d & p, const AABB & bb, uint q[3])
+{
+    const double max_coord = double(0x1fffff);
+    vec3d  d = bb.delta();
+    for(int i=0; i<3; ++i)
+    {
+        double t = (d[i]>0) ? (p[i]-bb.min[i])/d[i] : 0.0;
+        q[i] = uint(std::min(max_coord, std::max(0.0, t*max_coord)));
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t morton_code(const vec3d & p, const AABB & bb)
+{
+    uint q[3];
+    sfc_quantize(p, bb, q);
+    return morton_code(q[0], q[1], q[2]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t hilbert_code(const uint x, const uint y, const uint z)
+{
+    uint X[3] = { x & 0x1fffff, y & 0x1fffff, z & 0x1fffff };
+    const uint M = 1u << 20;
+
+    // inverse undo
+    for(uint Q=M; Q>1; Q>>=1)
+    {
+        uint P = Q-1;
+        for(int i=0; i<3; ++i)
+        {
+            if(X[i] & Q) X[0] ^= P;
+            else
+            {
+                uint t = (X[0]^X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+
+    // Gray encode
+    for(int i=1; i<3; ++i) X[i] ^= X[i-1];
+    uint t = 0;
+    for(uint Q=M; Q>1; Q>>=1) if(X[2] & Q) t ^= Q-1;
+    for(int i=0; i<3; ++i) X[i] ^= t;
+
+    // the index is the bitwise interleaving of the transposed coordinates,
+    // with X[0] holding the most significant bit of each triplet
+    return morton_code(X[2], X[1], X[0]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t hilbert_code(const vec3d & p, const AABB & bb)
+{
+    uint q[3];
+    sfc_quantize(p, bb, q);
+    return hilbert_code(q[0], q[1], q[2]);
+}
+
+}
@@ -0,0 +1,81 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_SPACE_FILLING_CURVES_H
+#define CINO_SPACE_FILLING_CURVES_H
+
+#include <stdint.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/aabb.h>
+
+namespace cinolib
+{
+
+// interleaves the lower 21 bits of x,y,z into a 63 bits Morton (Z-order) code
+//
+CINO_INLINE
+uint64_t morton_code(const uint x, const uint y, const uint z);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Morton code of point p, quantized on a 2^21 x 2^21 x 2^21 grid spanning bbox bb
+//
+CINO_INLINE
+uint64_t morton_code(const vec3d & p, const AABB & bb);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// 63 bits index of the grid point (x,y,z) along the 3D Hilbert curve of order 21.
+// Differently from Morton, consecutive indices are always face adjacent in the
+// grid, which gives better spatial locality when used to sort mesh elements.
+// Implementation of: Programming the Hilbert curve, J.Skilling (2004)
+//
+CINO_INLINE
+uint64_t hilbert_code(const uint x, const uint y, const uint z);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Hilbert index of point p, quantized on a 2^21 x 2^21 x 2^21 grid spanning bbox bb
+//
+CINO_INLINE
+uint64_t hilbert_code(const vec3d & p, const AABB & bb);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "space_filling_curves.cpp"
+#endif
+
+#endif // CINO_SPACE_FILLING_CURVES_H
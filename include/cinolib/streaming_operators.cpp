@@ -0,0 +1,397 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/streaming_operators.h>
+#include <cinolib/io/stream_triangles.h>
+#include <cinolib/io/write_OFF.h>
+#include <cinolib/geometry/triangle_utils.h>
+#include <cinolib/space_filling_curves.h>
+#include <cinolib/parallel_for.h>
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <array>
+#include <set>
+#include <cstdio>
+#include <cmath>
+
+namespace cinolib
+{
+
+CINO_INLINE
+AABB stream_bbox(const char * filename,
+                 const uint   chunk_size)
+{
+    AABB bb;
+    stream_triangles(filename, chunk_size, [&](const std::vector<double> & tris)
+    {
+        for(size_t i=0; i<tris.size(); i+=3) bb.push(vec3d(&tris[i]));
+    });
+    return bb;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void stream_area_volume(const char   * filename,
+                              double & area,
+                              double & volume,
+                        const uint     chunk_size)
+{
+    area   = 0;
+    volume = 0;
+    stream_triangles(filename, chunk_size, [&](const std::vector<double> & tris)
+    {
+        for(size_t i=0; i<tris.size(); i+=9)
+        {
+            vec3d A(&tris[i  ]);
+            vec3d B(&tris[i+3]);
+            vec3d C(&tris[i+6]);
+            area   += triangle_area(A,B,C);
+            volume += A.dot(B.cross(C))/6.0; // signed volume of tet (O,A,B,C)
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void stream_quality_stats(const char   * filename,
+                                double & q_min,
+                                double & q_max,
+                                double & q_avg,
+                          const uint     chunk_size)
+{
+    q_min =  inf_double;
+    q_max = -inf_double;
+    q_avg = 0;
+    size_t count = 0;
+    stream_triangles(filename, chunk_size, [&](const std::vector<double> & tris)
+    {
+        for(size_t i=0; i<tris.size(); i+=9)
+        {
+            vec3d  A(&tris[i  ]);
+            vec3d  B(&tris[i+3]);
+            vec3d  C(&tris[i+6]);
+            double a   = B.dist(C);
+            double b   = A.dist(C);
+            double c   = A.dist(B);
+            double ar  = triangle_area(A,B,C);
+            double den = (a+b+c)*a*b*c;
+            double q   = (den>0) ? 16.0*ar*ar/den : 0.0;
+            q_min  = std::min(q_min, q);
+            q_max  = std::max(q_max, q);
+            q_avg += q;
+            ++count;
+        }
+    });
+    if(count>0) q_avg /= double(count);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void stream_normals(const char * filename_in,
+                    const char * filename_out,
+                    const uint   chunk_size)
+{
+    STLStreamWriter out(filename_out);
+    std::vector<double> normals;
+    stream_triangles(filename_in, chunk_size, [&](const std::vector<double> & tris)
+    {
+        normals.resize(tris.size()/3);
+        PARALLEL_FOR(0, uint(tris.size()/9), 10000, [&](const uint tid)
+        {
+            vec3d n = triangle_normal(vec3d(&tris[tid*9  ]),
+                                      vec3d(&tris[tid*9+3]),
+                                      vec3d(&tris[tid*9+6]));
+            normals[tid*3  ] = n.x();
+            normals[tid*3+1] = n.y();
+            normals[tid*3+2] = n.z();
+        });
+        out.append(tris, normals);
+    });
+    out.close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void stream_spatial_reorder(const char * filename_in,
+                            const char * filename_out,
+                            const uint   chunk_size)
+{
+    // a run record is a Morton code followed by the 9 coordinates of the triangle
+    struct Record
+    {
+        uint64_t code;
+        double   xyz[9];
+    };
+
+    // a run is a sorted sequence of records (offset and size are in records)
+    struct Run
+    {
+        size_t beg;
+        size_t size;
+    };
+
+    AABB bb = stream_bbox(filename_in, chunk_size);
+
+    auto new_tmpfile = []() -> FILE*
+    {
+        FILE *fp = tmpfile();
+        if(!fp)
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : stream_spatial_reorder() : couldn't create temporary file " << std::endl;
+            exit(-1);
+        }
+        return fp;
+    };
+
+    // pass 1: sort chunks in memory and append them to a single temporary file.
+    // Runs are not stored in separate files, so that the number of open files
+    // does not grow with the size of the input
+    FILE *src = new_tmpfile();
+    std::vector<Run> runs;
+    std::vector<Record> buf;
+    stream_triangles(filename_in, chunk_size, [&](const std::vector<double> & tris)
+    {
+        uint nt = uint(tris.size()/9);
+        buf.resize(nt);
+        PARALLEL_FOR(0, nt, 10000, [&](const uint tid)
+        {
+            vec3d c = (vec3d(&tris[tid*9]) + vec3d(&tris[tid*9+3]) + vec3d(&tris[tid*9+6]))/3.0;
+            buf[tid].code = morton_code(c, bb);
+            std::copy(tris.begin()+tid*9, tris.begin()+tid*9+9, buf[tid].xyz);
+        });
+        std::sort(buf.begin(), buf.end(), [](const Record & a, const Record & b){ return a.code < b.code; });
+
+        Run r;
+        r.beg  = runs.empty() ? 0 : runs.back().beg + runs.back().size;
+        r.size = buf.size();
+        fwrite(buf.data(), sizeof(Record), buf.size(), src);
+        runs.push_back(r);
+    });
+    buf.clear();
+    buf.shrink_to_fit();
+
+    // empty input: there is nothing to merge, just write an empty STL
+    if(runs.empty())
+    {
+        fclose(src);
+        STLStreamWriter out(filename_out);
+        out.close();
+        return;
+    }
+
+    // pass 2: k-way merge of the sorted runs. Each run is read through a buffer
+    // of chunk_size/k records, therefore the fan-in k is capped to keep buffers
+    // large enough to amortize the seeks. Merged runs are either appended to dst
+    // (intermediate passes) or written to the output STL (last pass)
+    const size_t max_fan_in = 128;
+    STLStreamWriter out(filename_out);
+    std::vector<double> chunk;
+    std::vector<Record> out_buf;
+    auto merge = [&](const std::vector<Run> & group, FILE *dst)
+    {
+        size_t k  = group.size();
+        size_t bs = std::max(size_t(chunk_size)/k, size_t(1));
+        std::vector<std::vector<Record>> heads(k);
+        std::vector<size_t> pos(k,0);
+        std::vector<Run> left = group;
+        auto refill = [&](const size_t i) -> bool
+        {
+            size_t n = std::min(bs, left[i].size);
+            if(n==0) return false;
+            heads[i].resize(n);
+            ooc_fseek(src, left[i].beg*sizeof(Record));
+            if(fread(heads[i].data(), sizeof(Record), n, src)!=n)
+            {
+                std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : stream_spatial_reorder() : couldn't read temporary file " << std::endl;
+                exit(-1);
+            }
+            left[i].beg  += n;
+            left[i].size -= n;
+            pos[i] = 0;
+            return true;
+        };
+
+        typedef std::pair<uint64_t,size_t> Head; // (code, run)
+        std::priority_queue<Head,std::vector<Head>,std::greater<Head>> q;
+        for(size_t i=0; i<k; ++i)
+        {
+            if(refill(i)) q.push(std::make_pair(heads[i][0].code,i));
+        }
+        while(!q.empty())
+        {
+            size_t run = q.top().second;
+            q.pop();
+            const Record & r = heads[run][pos[run]];
+            if(dst)
+            {
+                out_buf.push_back(r);
+                if(out_buf.size() >= chunk_size)
+                {
+                    fwrite(out_buf.data(), sizeof(Record), out_buf.size(), dst);
+                    out_buf.clear();
+                }
+            }
+            else
+            {
+                chunk.insert(chunk.end(), r.xyz, r.xyz+9);
+                if(chunk.size()/9 >= chunk_size)
+                {
+                    out.append(chunk);
+                    chunk.clear();
+                }
+            }
+            if(++pos[run]<heads[run].size() || refill(run)) q.push(std::make_pair(heads[run][pos[run]].code,run));
+        }
+        if(dst && !out_buf.empty())
+        {
+            fwrite(out_buf.data(), sizeof(Record), out_buf.size(), dst);
+            out_buf.clear();
+        }
+    };
+
+    // intermediate passes: each one reduces the number of runs by a factor max_fan_in
+    while(runs.size() > max_fan_in)
+    {
+        FILE *dst = new_tmpfile();
+        std::vector<Run> merged;
+        for(size_t i=0; i<runs.size(); i+=max_fan_in)
+        {
+            std::vector<Run> group(runs.begin()+i, runs.begin()+std::min(i+max_fan_in, runs.size()));
+            Run r;
+            r.beg  = merged.empty() ? 0 : merged.back().beg + merged.back().size;
+            r.size = 0;
+            for(const Run & g : group) r.size += g.size;
+            merge(group, dst);
+            merged.push_back(r);
+        }
+        fclose(src);
+        src = dst;
+        runs.swap(merged);
+    }
+
+    // last pass
+    merge(runs, nullptr);
+    if(!chunk.empty()) out.append(chunk);
+    out.close();
+    fclose(src);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void stream_vertex_clustering(const char                     * filename,
+                              const double                     cell_size,
+                                    std::vector<double>      & xyz,
+                                    std::vector<uint>        & tris,
+                              const uint                       chunk_size)
+{
+    assert(cell_size>0);
+    xyz.clear();
+    tris.clear();
+
+    AABB bb = stream_bbox(filename, chunk_size);
+    uint64_t nx = uint64_t(std::ceil(bb.delta_x()/cell_size)) + 1;
+    uint64_t ny = uint64_t(std::ceil(bb.delta_y()/cell_size)) + 1;
+
+    std::unordered_map<uint64_t,uint> cell_to_vid;
+    std::vector<uint> n_samples;
+    std::set<std::array<uint,3>> unique_tris;
+
+    stream_triangles(filename, chunk_size, [&](const std::vector<double> & chunk)
+    {
+        for(size_t i=0; i<chunk.size(); i+=9)
+        {
+            uint t[3];
+            for(int j=0; j<3; ++j)
+            {
+                vec3d    p(&chunk[i+3*j]);
+                vec3d    d  = (p - bb.min)/cell_size;
+                uint64_t id = uint64_t(d.x()) + nx*(uint64_t(d.y()) + ny*uint64_t(d.z()));
+
+                auto it = cell_to_vid.find(id);
+                if(it==cell_to_vid.end())
+                {
+                    t[j] = uint(n_samples.size());
+                    cell_to_vid[id] = t[j];
+                    n_samples.push_back(0);
+                    xyz.insert(xyz.end(), {0,0,0});
+                }
+                else t[j] = it->second;
+
+                // accumulate positions (averaged at the end)
+                ++n_samples[t[j]];
+                xyz[3*t[j]  ] += p.x();
+                xyz[3*t[j]+1] += p.y();
+                xyz[3*t[j]+2] += p.z();
+            }
+
+            if(t[0]==t[1] || t[1]==t[2] || t[0]==t[2]) continue; // collapsed
+
+            // discard duplicates (also with opposite orientation, as folded sheets are common)
+            std::array<uint,3> key = {{ t[0], t[1], t[2] }};
+            std::sort(key.begin(), key.end());
+            if(unique_tris.insert(key).second) tris.insert(tris.end(), t, t+3);
+        }
+    });
+
+    for(uint vid=0; vid<n_samples.size(); ++vid)
+    {
+        xyz[3*vid  ] /= double(n_samples[vid]);
+        xyz[3*vid+1] /= double(n_samples[vid]);
+        xyz[3*vid+2] /= double(n_samples[vid]);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void stream_vertex_clustering(const char   * filename_in,
+                              const char   * filename_out,
+                              const double   cell_size,
+                              const uint     chunk_size)
+{
+    std::vector<double> xyz;
+    std::vector<uint>   tris;
+    stream_vertex_clustering(filename_in, cell_size, xyz, tris, chunk_size);
+    write_OFF(filename_out, xyz, tris, std::vector<uint>());
+}
+
+}
@@ -0,0 +1,134 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_STREAMING_OPERATORS_H
+#define CINO_STREAMING_OPERATORS_H
+
+#include <vector>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/aabb.h>
+
+namespace cinolib
+{
+
+/* Out-of-core counterparts of common per element mesh operators. They process
+ * meshes that do not fit in memory in bounded windows of chunk_size triangles
+ * (see io/stream_triangles.h), never building a full Trimesh. Input can be any
+ * format supported by stream_triangles (OFF, OBJ, STL). Results that are meshes
+ * are written back to disk as binary STL (STLStreamWriter), with the exception
+ * of vertex clustering, whose output is typically orders of magnitude smaller
+ * than the input and is therefore written as an indexed OFF.
+*/
+
+CINO_INLINE
+AABB stream_bbox(const char * filename,
+                 const uint   chunk_size = 1000000);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// volume is computed with the divergence theorem, hence it is meaningful only
+// for closed and consistently oriented meshes
+//
+CINO_INLINE
+void stream_area_volume(const char   * filename,
+                              double & area,
+                              double & volume,
+                        const uint     chunk_size = 1000000);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// per triangle quality is the normalized radius ratio 2*r_in/r_circ, which
+// ranges from 0 (degenerate) to 1 (equilateral)
+//
+CINO_INLINE
+void stream_quality_stats(const char   * filename,
+                                double & q_min,
+                                double & q_max,
+                                double & q_avg,
+                          const uint     chunk_size = 1000000);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// writes a binary STL with per triangle normals (computed in parallel)
+//
+CINO_INLINE
+void stream_normals(const char * filename_in,
+                    const char * filename_out,
+                    const uint   chunk_size = 1000000);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* External memory reordering: triangles are sorted along a Morton curve
+ * traced through their centroids, so that subsequent streaming passes see
+ * spatially coherent windows. Sorted runs of chunk_size triangles are appended
+ * to a temporary file, and then merged into the output binary STL. At most 128
+ * runs are merged at once: larger inputs are merged in multiple passes.
+*/
+CINO_INLINE
+void stream_spatial_reorder(const char * filename_in,
+                            const char * filename_out,
+                            const uint   chunk_size = 1000000);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Out-of-core simplification by vertex clustering (Rossignac and Borrel 1993,
+ * Lindstrom 2000). Space is partitioned into a uniform grid of cubic cells of
+ * size cell_size; all vertices in the same cell collapse onto their centroid,
+ * and triangles that become degenerate are discarded. Memory scales with the
+ * size of the output, not of the input.
+*/
+CINO_INLINE
+void stream_vertex_clustering(const char                     * filename,
+                              const double                     cell_size,
+                                    std::vector<double>      & xyz,
+                                    std::vector<uint>        & tris,
+                              const uint                       chunk_size = 1000000);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void stream_vertex_clustering(const char   * filename_in,
+                              const char   * filename_out,
+                              const double   cell_size,
+                              const uint     chunk_size = 1000000);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "streaming_operators.cpp"
+#endif
+
+#endif // CINO_STREAMING_OPERATORS_H
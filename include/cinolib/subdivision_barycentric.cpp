@@ -34,7 +34,9 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/subdivision_barycentric.h>
-#include <unordered_map>
+#include <cinolib/standard_elements_tables.h>
+#include <cinolib/vector_serialization.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -46,81 +48,74 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void subdivision_barycentric(Tetmesh<M,V,E,F,P> & m)
 {
-    std::unordered_map<uint,uint> e_map; // edge midpoints
-    std::unordered_map<uint,uint> f_map; // face centroids
-    std::unordered_map<uint,uint> p_map; // poly centroids
-
-    for(uint eid=0; eid<m.num_edges(); ++eid) e_map[eid] = m.vert_add(m.edge_sample_at(eid,0.5));
-    for(uint fid=0; fid<m.num_faces(); ++fid) f_map[fid] = m.vert_add(m.face_centroid(fid));
-    for(uint pid=0; pid<m.num_polys(); ++pid) p_map[pid] = m.vert_add(m.poly_centroid(pid));
-
+    // new verts are appended after the original ones, in this order:
+    // edge midpoints, face centroids, poly centroids
+    uint nv = m.num_verts();
+    uint ne = m.num_edges();
+    uint nf = m.num_faces();
     uint np = m.num_polys();
-    for(uint pid=0; pid<np; ++pid)
-    {
-        // tet verts
-        uint v[4] =
-        {
-            m.poly_vert_id(pid,0),
-            m.poly_vert_id(pid,1),
-            m.poly_vert_id(pid,2),
-            m.poly_vert_id(pid,3),
-        };
+    std::vector<vec3d> verts(nv + ne + nf + np);
+    std::copy(m.vector_verts().begin(), m.vector_verts().end(), verts.begin());
+    PARALLEL_FOR(0, ne, 10000, [&](const uint eid) { verts[nv+eid]       = m.edge_sample_at(eid,0.5); });
+    PARALLEL_FOR(0, nf, 10000, [&](const uint fid) { verts[nv+ne+fid]    = m.face_centroid(fid);      });
+    PARALLEL_FOR(0, np, 10000, [&](const uint pid) { verts[nv+ne+nf+pid] = m.poly_centroid(pid);      });
 
-        // tet faces
-        uint f[4][3] =
-        {
-            { v[TET_FACES[0][0]], v[TET_FACES[0][1]], v[TET_FACES[0][2]] },
-            { v[TET_FACES[1][0]], v[TET_FACES[1][1]], v[TET_FACES[1][2]] },
-            { v[TET_FACES[2][0]], v[TET_FACES[2][1]], v[TET_FACES[2][2]] },
-            { v[TET_FACES[3][0]], v[TET_FACES[3][1]], v[TET_FACES[3][2]] },
-        };
-
-        // tet edges (sorted per face)
-        uint e[4][3] =
+    // each tet is split into 24 tets, stored contiguously. Edges and faces are
+    // fetched from the poly adjacency through the local ids of their vertices
+    std::vector<uint> tets(96*np);
+    PARALLEL_FOR(0, np, 1000, [&](const uint pid)
+    {
+        uint e_loc[4][4]; // edge between local verts i and j
+        uint f_opp[4];    // face opposite to local vert i
+        for(uint eid : m.adj_p2e(pid))
         {
-            { e_map.at(m.edge_id(f[0][0], f[0][1])),
-              e_map.at(m.edge_id(f[0][1], f[0][2])),
-              e_map.at(m.edge_id(f[0][2], f[0][0])) },
-
-            { e_map.at(m.edge_id(f[1][0], f[1][1])),
-              e_map.at(m.edge_id(f[1][1], f[1][2])),
-              e_map.at(m.edge_id(f[1][2], f[1][0])) },
-
-            { e_map.at(m.edge_id(f[2][0], f[2][1])),
-              e_map.at(m.edge_id(f[2][1], f[2][2])),
-              e_map.at(m.edge_id(f[2][2], f[2][0])) },
-
-            { e_map.at(m.edge_id(f[3][0], f[3][1])),
-              e_map.at(m.edge_id(f[3][1], f[3][2])),
-              e_map.at(m.edge_id(f[3][2], f[3][0])) }
-        };
-
-        // face centroids
-        uint fc[4] =
+            uint i = m.poly_vert_offset(pid, m.edge_vert_id(eid,0));
+            uint j = m.poly_vert_offset(pid, m.edge_vert_id(eid,1));
+            e_loc[i][j] = e_loc[j][i] = eid;
+        }
+        for(uint fid : m.adj_p2f(pid))
         {
-            f_map.at(m.face_id({f[0][0], f[0][1], f[0][2]})),
-            f_map.at(m.face_id({f[1][0], f[1][1], f[1][2]})),
-            f_map.at(m.face_id({f[2][0], f[2][1], f[2][2]})),
-            f_map.at(m.face_id({f[3][0], f[3][1], f[3][2]}))
-        };
-
-        // tet centroid
-        uint c = p_map.at(pid);
+            uint mask = 0;
+            for(uint vid : m.adj_f2v(fid)) mask |= (1 << m.poly_vert_offset(pid,vid));
+            for(uint i=0; i<4; ++i) if(!(mask & (1<<i))) f_opp[i] = fid;
+        }
 
+        uint   c   = nv + ne + nf + pid;
+        uint * tet = tets.data() + 96*pid;
         for(uint i=0; i<4; ++i)
         {
+            const uint * lf = TET_FACES[i];
+            uint f [3] = { m.poly_vert_id(pid,lf[0]), m.poly_vert_id(pid,lf[1]), m.poly_vert_id(pid,lf[2]) };
+            uint e [3] = { nv + e_loc[lf[0]][lf[1]], nv + e_loc[lf[1]][lf[2]], nv + e_loc[lf[2]][lf[0]] };
+            uint fc    = nv + ne + f_opp[6-lf[0]-lf[1]-lf[2]];
+
             // split i^th face
-            m.poly_add({c, f[i][0], e[i][0], fc[i]});
-            m.poly_add({c, e[i][0], f[i][1], fc[i]});
-            m.poly_add({c, f[i][1], e[i][1], fc[i]});
-            m.poly_add({c, e[i][1], f[i][2], fc[i]});
-            m.poly_add({c, f[i][2], e[i][2], fc[i]});
-            m.poly_add({c, e[i][2], f[i][0], fc[i]});
+            for(uint j=0; j<3; ++j)
+            {
+                uint t0[4] = { c, f[j], e[j],       fc };
+                uint t1[4] = { c, e[j], f[(j+1)%3], fc };
+                std::copy(t0, t0+4, tet + 24*i + 8*j);
+                std::copy(t1, t1+4, tet + 24*i + 8*j + 4);
+            }
         }
-    }
+    });
 
-    // remove the old polys
-    for(int pid=np-1; pid>=0; --pid) m.poly_remove(pid);
+    // rebuild the mesh in one go, keeping the attributes of the original verts
+    M mesh_data = m.mesh_data();
+    std::vector<V> v_data(nv);
+    for(uint vid=0; vid<nv; ++vid) v_data[vid] = m.vert_data(vid);
+    // lazily allocated attributes in use (normals are recomputed anyway)
+    std::vector<vec3d> uvw;
+    std::vector<float> qlt;
+    if(m.vert_properties().uvw.allocated())     uvw = m.vert_properties().uvw.data;
+    if(m.vert_properties().quality.allocated()) qlt = m.vert_properties().quality.data;
+    m.clear();
+    m.mesh_data() = mesh_data;
+    m.init_bulk(verts, polys_from_serialized_vids(tets,4));
+    for(uint vid=0; vid<nv; ++vid) m.vert_data(vid) = v_data[vid];
+    for(uint vid=0; vid<uvw.size(); ++vid) m.vert_uvw(vid) = uvw[vid];
+    for(uint vid=0; vid<qlt.size(); ++vid) m.vert_quality(vid) = qlt[vid];
+    if(m.mesh_data().update_normals) m.update_v_normals();
 }
 
 
@@ -34,20 +34,502 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/subdivision_midpoint.h>
-#include <cinolib/sort_poly_vertices.h>
-#include <map>
+#include <cinolib/standard_elements_tables.h>
+#include <cinolib/vector_serialization.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
 
 namespace cinolib
 {
 
+/* Flat representation of a hexahedral mesh, with just the local orderings that are
+ * necessary to refine it without any adjacency query. It is used to chain multiple
+ * levels of subdivision, deriving the topology of level k+1 from the one of level k
+*/
+struct MidpointHexTopology
+{
+    std::vector<vec3d> verts;
+    std::vector<uint>  edges; // 2 verts per edge
+    std::vector<uint>  faces; // 4 verts per face
+    std::vector<uint>  f2e;   // 4 edges per face (the i-th joins the i-th and (i+1)-th vert)
+    std::vector<uint>  hexas; // 8 verts per hexa (standard ordering)
+    std::vector<uint>  h2f;   // 6 faces per hexa (HEXA_FACES ordering)
+    std::vector<uint>  h2e;   // 12 edges per hexa (HEXA_EDGES ordering)
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Midpoint subdivision splits each hexa into a 3x3x3 lattice of points with coordinates
+ * in {0,1,2}. The number of odd coordinates tells whether a point is a corner (0), an
+ * edge midpoint (1), a face centroid (2) or the centroid of the hexa (3). The tables below
+ * store, for each lattice point, its type and the local id of the corner/edge/face it comes
+ * from, and for the 8 children of the hexa, where each of their faces and edges comes from.
+ * They only depend on the reference hexahedron, hence they are computed once
+*/
+struct MidpointHexLattice
+{
+    uint type [27];
+    uint local[27];
+    uint edge_faces[12][2];   // local faces incident to each local edge
+    uint child_verts[8][8];   // lattice points of the children
+    uint child_face [8][6][3]; // {type,a,b}: type 0 => sub face of parent face a at corner b
+                               //             type 1 => inner face of parent edge a
+    uint child_edge [8][12][3];// {type,a,b}: type 0 => half of parent edge a at corner b
+                               //             type 1 => edge from centroid of parent face a to midpoint of parent edge b
+                               //             type 2 => edge from centroid of the hexa to centroid of parent face a
+
+    static uint id(const uint x, const uint y, const uint z) { return x + 3*y + 9*z; }
+
+    static uint ref(const uint vid, const uint axis)
+    {
+        return uint(REFERENCE_HEX_VERTS[vid][axis]);
+    }
+
+    MidpointHexLattice()
+    {
+        for(uint x=0; x<3; ++x)
+        for(uint y=0; y<3; ++y)
+        for(uint z=0; z<3; ++z)
+        {
+            uint p[3] = { x, y, z };
+            uint i    = id(x,y,z);
+            type[i]   = (x&1) + (y&1) + (z&1);
+            local[i]  = 0;
+            // corners of the parent hexa that contain the point (i.e. the corners
+            // whose coordinates match all the even coordinates of the point)
+            uint mask = 0;
+            for(uint vid=0; vid<8; ++vid)
+            {
+                bool inside = true;
+                for(uint a=0; a<3; ++a) if(!(p[a]&1) && 2*ref(vid,a)!=p[a]) inside = false;
+                if(inside) mask |= (1<<vid);
+            }
+            switch(type[i])
+            {
+                case 0: for(uint vid=0; vid<8; ++vid) if(mask==uint(1<<vid)) local[i] = vid; break;
+                case 1: for(uint eid=0; eid<12; ++eid) if(mask==uint((1<<HEXA_EDGES[eid][0]) | (1<<HEXA_EDGES[eid][1]))) local[i] = eid; break;
+                case 2: for(uint fid=0; fid<6; ++fid)
+                        {
+                            uint fmask = 0;
+                            for(uint j=0; j<4; ++j) fmask |= (1<<HEXA_FACES[fid][j]);
+                            if(mask==fmask) local[i] = fid;
+                        }
+                        break;
+                default: break;
+            }
+        }
+
+        for(uint eid=0; eid<12; ++eid)
+        {
+            uint n = 0;
+            for(uint fid=0; fid<6; ++fid)
+            {
+                uint count = 0;
+                for(uint j=0; j<4; ++j) if(HEXA_FACES[fid][j]==HEXA_EDGES[eid][0] || HEXA_FACES[fid][j]==HEXA_EDGES[eid][1]) ++count;
+                if(count==2) edge_faces[eid][n++] = fid;
+            }
+            assert(n==2);
+        }
+
+        for(uint c=0; c<8; ++c)
+        {
+            // child c spans the lattice cell at the corner c of the parent
+            auto lattice_point = [&](const uint vid)
+            {
+                return id(ref(c,0)+ref(vid,0), ref(c,1)+ref(vid,1), ref(c,2)+ref(vid,2));
+            };
+
+            for(uint vid=0; vid<8; ++vid) child_verts[c][vid] = lattice_point(vid);
+
+            for(uint fid=0; fid<6; ++fid)
+            {
+                // a child face lies either on a parent face (and contains one parent corner)
+                // or inside the parent (and contains one parent edge midpoint)
+                uint corner = 0, edge = 0, on_srf = 0, axis = 0;
+                for(uint a=0; a<3; ++a)
+                {
+                    if(ref(HEXA_FACES[fid][0],a)==ref(HEXA_FACES[fid][1],a) &&
+                       ref(HEXA_FACES[fid][0],a)==ref(HEXA_FACES[fid][2],a)) axis = a;
+                }
+                for(uint j=0; j<4; ++j)
+                {
+                    uint pt = lattice_point(HEXA_FACES[fid][j]);
+                    if(type[pt]==0) { corner = local[pt]; on_srf = 1; }
+                    if(type[pt]==1) edge = local[pt];
+                }
+                (void)axis;
+                if(on_srf)
+                {
+                    // the parent face is the one that contains both the corner and the child face
+                    uint fc[3] = { 1, 1, 1 };
+                    fc[axis] = ref(c,axis) + ref(HEXA_FACES[fid][0],axis);
+                    child_face[c][fid][0] = 0;
+                    child_face[c][fid][1] = local[id(fc[0],fc[1],fc[2])];
+                    child_face[c][fid][2] = corner;
+                }
+                else
+                {
+                    child_face[c][fid][0] = 1;
+                    child_face[c][fid][1] = edge;
+                    child_face[c][fid][2] = 0;
+                }
+            }
+
+            for(uint eid=0; eid<12; ++eid)
+            {
+                uint p0 = lattice_point(HEXA_EDGES[eid][0]);
+                uint p1 = lattice_point(HEXA_EDGES[eid][1]);
+                if(type[p0]>type[p1]) std::swap(p0,p1);
+                assert(type[p1]==type[p0]+1);
+                switch(type[p0])
+                {
+                    case 0:  child_edge[c][eid][0] = 0; child_edge[c][eid][1] = local[p1]; child_edge[c][eid][2] = local[p0]; break;
+                    case 1:  child_edge[c][eid][0] = 1; child_edge[c][eid][1] = local[p1]; child_edge[c][eid][2] = local[p0]; break;
+                    default: child_edge[c][eid][0] = 2; child_edge[c][eid][1] = local[p0]; child_edge[c][eid][2] = 0;         break;
+                }
+            }
+        }
+    }
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void subdivision_midpoint_refine(const MidpointHexTopology & in, MidpointHexTopology & out)
+{
+    static const MidpointHexLattice L;
+
+    uint nv = uint(in.verts.size());
+    uint ne = uint(in.edges.size()/2);
+    uint nf = uint(in.faces.size()/4);
+    uint nh = uint(in.hexas.size()/8);
+
+    // ids of the new verts, edges and faces are offsets from the parent element id
+    uint e_vert = nv;             // midpoint of edge e   => e_vert + e
+    uint f_vert = nv + ne;        // centroid of face f   => f_vert + f
+    uint h_vert = nv + ne + nf;   // centroid of hexa h   => h_vert + h
+    uint f_edge = 2*ne;           // face f to its i-th edge midpoint => f_edge + 4*f + i
+    uint h_edge = 2*ne + 4*nf;    // hexa h to its j-th face centroid => h_edge + 6*h + j
+    uint h_face = 4*nf;           // inner face of the j-th edge of h => h_face + 12*h + j
+
+    auto half_edge = [&](const uint eid, const uint vid) -> uint
+    {
+        assert(in.edges[2*eid]==vid || in.edges[2*eid+1]==vid);
+        return 2*eid + (in.edges[2*eid]==vid ? 0 : 1);
+    };
+    auto face_vert_pos = [&](const uint fid, const uint vid) -> uint
+    {
+        uint i=0;
+        while(in.faces[4*fid+i]!=vid) ++i;
+        assert(i<4);
+        return i;
+    };
+    auto face_edge_pos = [&](const uint fid, const uint eid) -> uint
+    {
+        uint i=0;
+        while(in.f2e[4*fid+i]!=eid) ++i;
+        assert(i<4);
+        return i;
+    };
+
+    // vertices (with the same arithmetic of edge_sample_at, face_centroid and poly_centroid)
+    out.verts.resize(nv + ne + nf + nh);
+    std::copy(in.verts.begin(), in.verts.end(), out.verts.begin());
+    PARALLEL_FOR(0, ne, 10000, [&](const uint eid)
+    {
+        out.verts[e_vert+eid] = 0.5*in.verts[in.edges[2*eid]] + 0.5*in.verts[in.edges[2*eid+1]];
+    });
+    PARALLEL_FOR(0, nf, 10000, [&](const uint fid)
+    {
+        vec3d c(0,0,0);
+        for(uint i=0; i<4; ++i) c += in.verts[in.faces[4*fid+i]];
+        out.verts[f_vert+fid] = c/4.0;
+    });
+    PARALLEL_FOR(0, nh, 10000, [&](const uint hid)
+    {
+        vec3d c(0,0,0);
+        for(uint i=0; i<8; ++i) c += in.verts[in.hexas[8*hid+i]];
+        out.verts[h_vert+hid] = c/8.0;
+    });
+
+    // edges
+    out.edges.resize(2*(2*ne + 4*nf + 6*nh));
+    PARALLEL_FOR(0, ne, 10000, [&](const uint eid)
+    {
+        out.edges[4*eid  ] = in.edges[2*eid];
+        out.edges[4*eid+1] = e_vert + eid;
+        out.edges[4*eid+2] = e_vert + eid;
+        out.edges[4*eid+3] = in.edges[2*eid+1];
+    });
+    PARALLEL_FOR(0, nf, 10000, [&](const uint fid)
+    {
+        for(uint i=0; i<4; ++i)
+        {
+            out.edges[2*(f_edge+4*fid+i)  ] = f_vert + fid;
+            out.edges[2*(f_edge+4*fid+i)+1] = e_vert + in.f2e[4*fid+i];
+        }
+    });
+    PARALLEL_FOR(0, nh, 10000, [&](const uint hid)
+    {
+        for(uint j=0; j<6; ++j)
+        {
+            out.edges[2*(h_edge+6*hid+j)  ] = h_vert + hid;
+            out.edges[2*(h_edge+6*hid+j)+1] = f_vert + in.h2f[6*hid+j];
+        }
+    });
+
+    // faces: four sub faces for each face, and one inner face for each edge of each hexa
+    out.faces.resize(4*(4*nf + 12*nh));
+    out.f2e.resize(4*(4*nf + 12*nh));
+    PARALLEL_FOR(0, nf, 10000, [&](const uint fid)
+    {
+        for(uint i=0; i<4; ++i)
+        {
+            uint vid   = in.faces[4*fid+i];
+            uint e_nxt = in.f2e[4*fid+i];
+            uint e_prv = in.f2e[4*fid+(i+3)%4];
+            uint sub   = 4*fid + i;
+            out.faces[4*sub  ] = vid;
+            out.faces[4*sub+1] = e_vert + e_nxt;
+            out.faces[4*sub+2] = f_vert + fid;
+            out.faces[4*sub+3] = e_vert + e_prv;
+            out.f2e[4*sub  ] = half_edge(e_nxt, vid);
+            out.f2e[4*sub+1] = f_edge + 4*fid + i;
+            out.f2e[4*sub+2] = f_edge + 4*fid + (i+3)%4;
+            out.f2e[4*sub+3] = half_edge(e_prv, vid);
+        }
+    });
+    PARALLEL_FOR(0, nh, 1000, [&](const uint hid)
+    {
+        for(uint j=0; j<12; ++j)
+        {
+            uint eid = in.h2e[12*hid+j];
+            uint fa  = in.h2f[6*hid+L.edge_faces[j][0]];
+            uint fb  = in.h2f[6*hid+L.edge_faces[j][1]];
+            uint fid = h_face + 12*hid + j;
+            out.faces[4*fid  ] = h_vert + hid;
+            out.faces[4*fid+1] = f_vert + fa;
+            out.faces[4*fid+2] = e_vert + eid;
+            out.faces[4*fid+3] = f_vert + fb;
+            out.f2e[4*fid  ] = h_edge + 6*hid + L.edge_faces[j][0];
+            out.f2e[4*fid+1] = f_edge + 4*fa + face_edge_pos(fa,eid);
+            out.f2e[4*fid+2] = f_edge + 4*fb + face_edge_pos(fb,eid);
+            out.f2e[4*fid+3] = h_edge + 6*hid + L.edge_faces[j][1];
+        }
+    });
+
+    // hexahedra: eight children for each hexa
+    out.hexas.resize(64*nh);
+    out.h2f.resize(48*nh);
+    out.h2e.resize(96*nh);
+    PARALLEL_FOR(0, nh, 1000, [&](const uint hid)
+    {
+        auto lattice_vert = [&](const uint pt) -> uint
+        {
+            switch(L.type[pt])
+            {
+                case 0:  return in.hexas[8*hid+L.local[pt]];
+                case 1:  return e_vert + in.h2e[12*hid+L.local[pt]];
+                case 2:  return f_vert + in.h2f[6*hid+L.local[pt]];
+                default: return h_vert + hid;
+            }
+        };
+
+        for(uint c=0; c<8; ++c)
+        {
+            uint child = 8*hid + c;
+            for(uint i=0; i<8; ++i) out.hexas[8*child+i] = lattice_vert(L.child_verts[c][i]);
+
+            for(uint i=0; i<6; ++i)
+            {
+                const uint * d = L.child_face[c][i];
+                if(d[0]==0)
+                {
+                    uint fid = in.h2f[6*hid+d[1]];
+                    out.h2f[6*child+i] = 4*fid + face_vert_pos(fid, in.hexas[8*hid+d[2]]);
+                }
+                else out.h2f[6*child+i] = h_face + 12*hid + d[1];
+            }
+
+            for(uint i=0; i<12; ++i)
+            {
+                const uint * d = L.child_edge[c][i];
+                switch(d[0])
+                {
+                    case 0: out.h2e[12*child+i] = half_edge(in.h2e[12*hid+d[1]], in.hexas[8*hid+d[2]]); break;
+                    case 1: { uint fid = in.h2f[6*hid+d[1]];
+                              out.h2e[12*child+i] = f_edge + 4*fid + face_edge_pos(fid, in.h2e[12*hid+d[2]]); break; }
+                    default: out.h2e[12*child+i] = h_edge + 6*hid + d[1]; break;
+                }
+            }
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void subdivision_midpoint_topology(const AbstractPolyhedralMesh<M,V,E,F,P> & m, MidpointHexTopology & t)
+{
+    uint nf = m.num_faces();
+    uint np = m.num_polys();
+    t.verts = m.vector_verts();
+    t.edges = m.vector_edges();
+    t.faces.resize(4*nf);
+    t.f2e.resize(4*nf);
+    PARALLEL_FOR(0, nf, 10000, [&](const uint fid)
+    {
+        assert(m.verts_per_face(fid)==4);
+        for(uint i=0; i<4; ++i)
+        {
+            uint v0 = m.face_vert_id(fid,i);
+            uint v1 = m.face_vert_id(fid,(i+1)%4);
+            t.faces[4*fid+i] = v0;
+            for(uint eid : m.adj_f2e(fid))
+            {
+                if(m.edge_contains_vert(eid,v0) && m.edge_contains_vert(eid,v1)) t.f2e[4*fid+i] = eid;
+            }
+        }
+    });
+    t.hexas.resize(8*np);
+    t.h2f.resize(6*np);
+    t.h2e.resize(12*np);
+    PARALLEL_FOR(0, np, 10000, [&](const uint pid)
+    {
+        assert(m.poly_is_hexahedron(pid));
+        for(uint i=0; i<8; ++i) t.hexas[8*pid+i] = m.poly_vert_id(pid,i);
+        // bitmask of the local ids of the vertices of an element
+        auto local_mask = [&](const std::vector<uint> & vids)
+        {
+            uint mask = 0;
+            for(uint vid : vids) mask |= (1 << m.poly_vert_offset(pid,vid));
+            return mask;
+        };
+        for(uint fid : m.adj_p2f(pid))
+        {
+            uint mask = local_mask(m.adj_f2v(fid));
+            for(uint i=0; i<6; ++i)
+            {
+                uint fmask = 0;
+                for(uint j=0; j<4; ++j) fmask |= (1<<HEXA_FACES[i][j]);
+                if(mask==fmask) t.h2f[6*pid+i] = fid;
+            }
+        }
+        for(uint eid : m.adj_p2e(pid))
+        {
+            uint mask = local_mask(m.edge_vert_ids(eid));
+            for(uint i=0; i<12; ++i)
+            {
+                if(mask==uint((1<<HEXA_EDGES[i][0]) | (1<<HEXA_EDGES[i][1]))) t.h2e[12*pid+i] = eid;
+            }
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void subdivision_midpoint_build(const MidpointHexTopology & t, AbstractPolyhedralMesh<M,V,E,F,P> & m)
+{
+    uint nf = uint(t.faces.size()/4);
+    uint nh = uint(t.hexas.size()/8);
+    std::vector<std::vector<uint>> faces(nf);
+    std::vector<std::vector<uint>> polys(nh);
+    std::vector<std::vector<bool>> winding(nh);
+    PARALLEL_FOR(0, nf, 10000, [&](const uint fid)
+    {
+        faces[fid].assign(t.faces.begin()+4*fid, t.faces.begin()+4*fid+4);
+    });
+    PARALLEL_FOR(0, nh, 10000, [&](const uint hid)
+    {
+        polys[hid].assign(t.h2f.begin()+6*hid, t.h2f.begin()+6*hid+6);
+        winding[hid].resize(6);
+        for(uint i=0; i<6; ++i)
+        {
+            // faces in HEXA_FACES are CCW w.r.t. the outward normal. Does the stored face agree?
+            uint fid = t.h2f[6*hid+i];
+            uint v0  = t.hexas[8*hid+HEXA_FACES[i][0]];
+            uint v1  = t.hexas[8*hid+HEXA_FACES[i][1]];
+            uint off = 0;
+            while(t.faces[4*fid+off]!=v0) ++off;
+            winding[hid][i] = (t.faces[4*fid+(off+1)%4]==v1);
+        }
+    });
+    m.clear();
+    m.init_bulk(t.verts, faces, polys, winding);
+    m.update_quality();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// splits each tet into four hexahedra, one for each corner
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void subdivision_midpoint_tets(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
+                                     AbstractPolyhedralMesh<M,V,E,F,P> & m_out,
+                               const std::vector<vec3d>                & verts)
+{
+    // for each corner, the other corners listed such that the corner and
+    // the three of them form a positive permutation of the tet vertices.
+    // They are mapped to the x, y and z axes of the reference hexahedron
+    static const uint TET_CORNER_FRAMES[4][3] = { {1,2,3}, {0,3,2}, {0,1,3}, {0,2,1} };
+
+    uint nv = m_in.num_verts();
+    uint ne = m_in.num_edges();
+    uint nf = m_in.num_faces();
+    std::vector<uint> hexas(32*m_in.num_polys());
+    PARALLEL_FOR(0, m_in.num_polys(), 10000, [&](const uint pid)
+    {
+        uint e_loc[4][4]; // edge between local verts i and j
+        uint f_opp[4];    // face opposite to local vert i
+        for(uint eid : m_in.adj_p2e(pid))
+        {
+            uint i = m_in.poly_vert_offset(pid, m_in.edge_vert_id(eid,0));
+            uint j = m_in.poly_vert_offset(pid, m_in.edge_vert_id(eid,1));
+            e_loc[i][j] = e_loc[j][i] = eid;
+        }
+        for(uint fid : m_in.adj_p2f(pid))
+        {
+            uint mask = 0;
+            for(uint vid : m_in.adj_f2v(fid)) mask |= (1 << m_in.poly_vert_offset(pid,vid));
+            for(uint i=0; i<4; ++i) if(!(mask & (1<<i))) f_opp[i] = fid;
+        }
+        for(uint c=0; c<4; ++c)
+        {
+            uint * hexa = hexas.data() + 32*pid + 8*c;
+            for(uint i=0; i<8; ++i)
+            {
+                // the vertex is the centroid of the corner plus one
+                // tet vertex for each non zero reference coordinate
+                uint set[4] = { c, 0, 0, 0 };
+                uint n = 1;
+                for(uint a=0; a<3; ++a) if(REFERENCE_HEX_VERTS[i][a]>0) set[n++] = TET_CORNER_FRAMES[c][a];
+                switch(n)
+                {
+                    case 1: hexa[i] = m_in.poly_vert_id(pid,c); break;
+                    case 2: hexa[i] = nv + e_loc[set[0]][set[1]]; break;
+                    case 3: hexa[i] = nv + ne + f_opp[6-set[0]-set[1]-set[2]]; break;
+                    default: hexa[i] = nv + ne + nf + pid; break;
+                }
+            }
+        }
+    });
+    m_out.clear();
+    m_out.init_bulk(verts, polys_from_serialized_vids(hexas,8));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
                                 AbstractPolyhedralMesh<M,V,E,F,P> & m_out)
 {
-    std::unordered_map<uint,uint> edge_verts;
-    std::unordered_map<uint,uint> face_verts;
-    std::unordered_map<uint,uint> poly_verts;
+    std::vector<uint> edge_verts;
+    std::vector<uint> face_verts;
+    std::vector<uint> poly_verts;
     subdivision_midpoint(m_in, m_out, edge_verts, face_verts, poly_verts);
 }
 
@@ -57,87 +539,135 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
                                 AbstractPolyhedralMesh<M,V,E,F,P> & m_out,
-                                std::unordered_map<uint,uint>     & edge_verts,
-                                std::unordered_map<uint,uint>     & face_verts,
-                                std::unordered_map<uint,uint>     & poly_verts)
+                                std::vector<uint>                 & edge_verts,
+                                std::vector<uint>                 & face_verts,
+                                std::vector<uint>                 & poly_verts)
 {
-    edge_verts.clear();
-    face_verts.clear();
-    poly_verts.clear();
+    // 1) add one new vert for each edge/face/poly. New verts are appended
+    //    in this order, hence the id tables are just offset sequences
+    //
+    uint nv = m_in.num_verts();
+    uint ne = m_in.num_edges();
+    uint nf = m_in.num_faces();
+    uint np = m_in.num_polys();
+    edge_verts.resize(ne);
+    face_verts.resize(nf);
+    poly_verts.resize(np);
+    for(uint eid=0; eid<ne; ++eid) edge_verts[eid] = nv + eid;
+    for(uint fid=0; fid<nf; ++fid) face_verts[fid] = nv + ne + fid;
+    for(uint pid=0; pid<np; ++pid) poly_verts[pid] = nv + ne + nf + pid;
 
-    std::vector<vec3d>             verts = m_in.vector_verts();
-    std::vector<std::vector<uint>> faces;
-    std::vector<std::vector<uint>> polys;
-    std::vector<std::vector<bool>> polys_winding;
+    if(m_in.mesh_type()==HEXMESH)
+    {
+        MidpointHexTopology t0, t1;
+        subdivision_midpoint_topology(m_in, t0);
+        subdivision_midpoint_refine(t0, t1);
+        subdivision_midpoint_build(t1, m_out);
+        return;
+    }
 
-    // 1) add one new vert for each edge/face/poly
-    //
-    for(uint eid=0; eid<m_in.num_edges(); ++eid) { edge_verts[eid] = verts.size(); verts.push_back(m_in.edge_sample_at(eid,0.5)); }
-    for(uint fid=0; fid<m_in.num_faces(); ++fid) { face_verts[fid] = verts.size(); verts.push_back(m_in.face_centroid(fid)); }
-    for(uint pid=0; pid<m_in.num_polys(); ++pid) { poly_verts[pid] = verts.size(); verts.push_back(m_in.poly_centroid(pid)); }
+    std::vector<vec3d> verts(nv + ne + nf + np);
+    std::copy(m_in.vector_verts().begin(), m_in.vector_verts().end(), verts.begin());
+    PARALLEL_FOR(0, ne, 10000, [&](const uint eid) { verts[edge_verts[eid]] = m_in.edge_sample_at(eid,0.5); });
+    PARALLEL_FOR(0, nf, 10000, [&](const uint fid) { verts[face_verts[fid]] = m_in.face_centroid(fid);      });
+    PARALLEL_FOR(0, np, 10000, [&](const uint pid) { verts[poly_verts[pid]] = m_in.poly_centroid(pid);      });
+
+    if(m_in.mesh_type()==TETMESH)
+    {
+        subdivision_midpoint_tets(m_in, m_out, verts);
+        return;
+    }
+    assert(m_in.mesh_type()==POLYHEDRALMESH);
+
+    // new faces and polys are stored contiguously for each input element. Prefix sums
+    // of the element sizes give the offsets of each block, so that they can be filled
+    // in parallel
+    std::vector<uint> p_off(np+1,0); // faces made at step (2), and polys made at step (4)
+    std::vector<uint> f_off(nf+1,0); // faces made at step (3)
+    std::vector<uint> c_off(np+1,0);
+    for(uint pid=0; pid<np; ++pid) p_off[pid+1] = p_off[pid] + uint(m_in.adj_p2e(pid).size());
+    for(uint fid=0; fid<nf; ++fid) f_off[fid+1] = f_off[fid] + m_in.verts_per_face(fid);
+    for(uint pid=0; pid<np; ++pid) c_off[pid+1] = c_off[pid] + m_in.verts_per_poly(pid);
+
+    std::vector<std::vector<uint>> faces(p_off[np] + f_off[nf]);
+    std::vector<std::vector<uint>> polys(c_off[np]);
+    std::vector<std::vector<bool>> polys_winding(c_off[np]);
 
     // 2) for each pair (edge,poly), make a quad with:
     //      - poly centroid
     //      - incident face centroids
     //      - edge midpoint
     //
-    std::map<ipair,uint> eid_pid_fmap;
-    for(uint pid=0; pid<m_in.num_polys(); ++pid)
-    for(uint eid : m_in.adj_p2e(pid))
-    {
-        std::vector<uint> inc_f = m_in.poly_e2f(pid,eid);
-        std::vector<uint> f;
-        f.push_back(poly_verts.at(pid));
-        f.push_back(face_verts.at(inc_f.front()));
-        f.push_back(edge_verts.at(eid));
-        f.push_back(face_verts.at(inc_f.back()));
-        eid_pid_fmap[std::make_pair(eid,pid)] = faces.size();
-        faces.push_back(f);
-    }
+    PARALLEL_FOR(0, np, 1000, [&](const uint pid)
+    {
+        uint off = p_off[pid];
+        for(uint eid : m_in.adj_p2e(pid))
+        {
+            std::vector<uint> inc_f = m_in.poly_e2f(pid,eid);
+            faces[off++] = { poly_verts[pid], face_verts[inc_f.front()], edge_verts[eid], face_verts[inc_f.back()] };
+        }
+    });
 
     // 3) for each pair (vert,face), make a quad with:
-    //      - poly centroid
-    //      - incident face centroids
-    //      - edge midpoint
+    //      - face centroid
+    //      - incident edge midpoints
+    //      - vertex
     //
-    std::map<ipair,uint> vid_fid_fmap;
-    for(uint fid = 0; fid<m_in.num_faces(); ++fid)
-    for(uint vid : m_in.adj_f2v(fid))
-    {
-        std::vector<uint> e = m_in.face_v2e(fid,vid);
-        std::vector<uint> f;
-        f.push_back(face_verts.at(fid));
-        f.push_back(edge_verts.at(e.front()));
-        f.push_back(vid);
-        f.push_back(edge_verts.at(e.back()));
-        vid_fid_fmap[std::make_pair(vid,fid)] = faces.size();
-        faces.push_back(f);
-    }
+    PARALLEL_FOR(0, nf, 1000, [&](const uint fid)
+    {
+        uint off = p_off[np] + f_off[fid];
+        for(uint vid : m_in.adj_f2v(fid))
+        {
+            std::vector<uint> e = m_in.face_v2e(fid,vid);
+            faces[off++] = { face_verts[fid], edge_verts[e.front()], vid, edge_verts[e.back()] };
+        }
+    });
 
     // 4) for each vertex of each poly, make a new polyhedron
     //    using the faces created at steps (2) and (3)
     //
-    for(uint pid = 0; pid<m_in.num_polys(); ++pid)
+    PARALLEL_FOR(0, np, 1000, [&](const uint pid)
     {
+        uint off = c_off[pid];
         for(uint vid : m_in.adj_p2v(pid))
         {
             std::vector<uint> f;
             std::vector<bool> w;
             for(uint fid : m_in.poly_v2f(pid,vid))
             {
-                f.push_back(vid_fid_fmap.at(std::make_pair(vid,fid)));                                
+                f.push_back(p_off[np] + f_off[fid] + m_in.face_vert_offset(fid,vid));
                 // TODO: fix winding order
                 w.push_back(true);
             }
             for(uint eid : m_in.poly_v2e(pid,vid))
             {
-                f.push_back(eid_pid_fmap.at(std::make_pair(eid,pid)));
+                const std::vector<uint> & p2e = m_in.adj_p2e(pid);
+                f.push_back(p_off[pid] + uint(std::find(p2e.begin(), p2e.end(), eid) - p2e.begin()));
                 // TODO: check on what side the vertex stays w.r.t. oriented plane to assign correct winding
                 w.push_back(true);
             }
-            polys.push_back(f);
-            polys_winding.push_back(w);
+            polys[off] = f;
+            polys_winding[off] = w;
+            ++off;
         }
+    });
+
+    m_out.clear();
+    m_out.init_bulk(verts, faces, polys, polys_winding);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
+                                AbstractPolyhedralMesh<M,V,E,F,P> & m_out,
+                          const uint                                n_levels)
+{
+    if(n_levels==0)
+    {
+        m_out = m_in;
+        return;
     }
 
     switch(m_in.mesh_type())
@@ -145,14 +675,42 @@ void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
         case TETMESH :
         case HEXMESH :
         {
-            std::vector<std::vector<uint>> hexas;
-            sort_poly_vertices_as_hexa(faces, polys, polys_winding, hexas);
-            m_out = Hexmesh<M,V,E,F,P>(verts, hexas);
+            MidpointHexTopology t0, t1;
+            if(m_in.mesh_type()==TETMESH)
+            {
+                // the first level turns tets into hexas. The others are
+                // derived without building the intermediate meshes
+                Hexmesh<M,V,E,F,P> tmp;
+                subdivision_midpoint(m_in, tmp);
+                subdivision_midpoint_topology(tmp, t0);
+            }
+            else
+            {
+                subdivision_midpoint_topology(m_in, t0);
+                subdivision_midpoint_refine(t0, t1);
+                std::swap(t0, t1);
+            }
+            for(uint i=1; i<n_levels; ++i)
+            {
+                subdivision_midpoint_refine(t0, t1);
+                std::swap(t0, t1);
+            }
+            subdivision_midpoint_build(t0, m_out);
+            break;
+        }
+        case POLYHEDRALMESH :
+        {
+            Polyhedralmesh<M,V,E,F,P> tmp;
+            subdivision_midpoint(m_in, tmp);
+            for(uint i=1; i<n_levels; ++i)
+            {
+                Polyhedralmesh<M,V,E,F,P> next;
+                subdivision_midpoint(tmp, next);
+                tmp = next;
+            }
+            m_out = tmp;
             break;
         }
-        case POLYHEDRALMESH : m_out = Polyhedralmesh<M,V,E,F,P>(verts, faces, polys, polys_winding);
-                              break;
-
         default : assert(false);
     }
 }
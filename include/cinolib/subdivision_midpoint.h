@@ -46,6 +46,10 @@ namespace cinolib
  * Hexahedral Meshing Using Midpoint Subdivision and Integer Programming
  * T.S. Li, R.M. McKeag, C.G. Armstrong
  * Computer Methods in Applied Mechanics and Engineering, 1995
+ *
+ * Tetrahedral and hexahedral meshes are refined into hexahedral meshes, general
+ * polyhedral meshes into polyhedral meshes. New elements are generated in parallel
+ * and the output mesh is built in bulk (see AbstractPolyhedralMesh::init_bulk).
 */
 
 template<class M, class V, class E, class F, class P>
@@ -55,13 +59,28 @@ void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// edge_verts[eid], face_verts[fid] and poly_verts[pid] are the ids of the vertices
+// of m_out that were placed at the midpoint of edge eid and at the centroids of face
+// fid and poly pid of m_in, respectively
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
+                                AbstractPolyhedralMesh<M,V,E,F,P> & m_out,
+                                std::vector<uint>                 & edge_verts,
+                                std::vector<uint>                 & face_verts,
+                                std::vector<uint>                 & poly_verts);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// applies n_levels rounds of midpoint subdivision. For hexahedral meshes (and for
+// tetrahedral meshes, after the first round) intermediate levels are not built as
+// meshes: the topology of level k+1 is derived directly from the one of level k,
+// and only the final level goes through mesh construction
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
                                 AbstractPolyhedralMesh<M,V,E,F,P> & m_out,
-                                std::map<uint,uint>               & edge_verts,
-                                std::map<uint,uint>               & face_verts,
-                                std::map<uint,uint>               & poly_verts);
+                          const uint                                n_levels);
 }
 
 #ifndef  CINO_STATIC_LIB
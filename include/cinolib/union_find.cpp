@@ -0,0 +1,102 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/union_find.h>
+#include <algorithm>
+
+namespace cinolib
+{
+
+CINO_INLINE
+UnionFind::UnionFind(const uint n) : parent(n)
+{
+    for(uint i=0; i<n; ++i) parent[i].store(i, std::memory_order_relaxed);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint UnionFind::find(uint id)
+{
+    for(;;)
+    {
+        uint p = parent[id].load(std::memory_order_relaxed);
+        if(p==id) return id;
+        uint gp = parent[p].load(std::memory_order_relaxed);
+        if(p!=gp)
+        {
+            // path halving. If the CAS fails someone else already shortened the path
+            parent[id].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+        }
+        id = gp;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool UnionFind::unite(uint id0, uint id1)
+{
+    for(;;)
+    {
+        id0 = find(id0);
+        id1 = find(id1);
+        if(id0==id1) return false;
+        if(id0<id1) std::swap(id0,id1);
+
+        // hang the larger root below the smaller one, provided that it is still a root
+        uint expected = id0;
+        if(parent[id0].compare_exchange_strong(expected, id1, std::memory_order_relaxed)) return true;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint UnionFind::labels(std::vector<uint> & ids)
+{
+    uint n = size();
+    ids.resize(n);
+    uint n_sets = 0;
+    for(uint i=0; i<n; ++i)
+    {
+        // roots are minimum elements, hence they come before the rest of their set
+        uint r = find(i);
+        ids[i] = (r==i) ? n_sets++ : ids[r];
+    }
+    return n_sets;
+}
+
+}
@@ -0,0 +1,93 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_UNION_FIND_H
+#define CINO_UNION_FIND_H
+
+#include <atomic>
+#include <vector>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+/* Disjoint set forest over the elements {0,...,n-1}, stored as a dense
+ * array of parent ids. Both find() and unite() are lock free, hence the
+ * structure can be safely updated by multiple threads at the same time
+ * (e.g. inside a PARALLEL_FOR). Path halving is used to keep trees shallow.
+ *
+ * The root of each set is always its minimum element, as unite() hangs the
+ * larger root below the smaller one. The partition, and the labeling computed
+ * by labels(), are therefore deterministic and do not depend on the order in
+ * which unite() calls are executed.
+ *
+ * Reference:
+ * Wait-free parallel algorithms for the union-find problem
+ * R.J.Anderson, H.Woll
+ * STOC 1991
+*/
+
+class UnionFind
+{
+    public:
+
+        explicit UnionFind(const uint n);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint size() const { return uint(parent.size()); }
+        uint find (uint id);
+        bool unite(uint id0, uint id1); // returns true if two distinct sets were merged
+        bool same (const uint id0, const uint id1) { return find(id0)==find(id1); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // assigns to each element the compact id (in [0,#sets)) of its set. Sets
+        // are numbered in order of their minimum element. Returns the number of sets
+        uint labels(std::vector<uint> & ids);
+
+    private:
+
+        std::vector<std::atomic<uint>> parent;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "union_find.cpp"
+#endif
+
+#endif // CINO_UNION_FIND_H
@@ -219,7 +219,7 @@ CINO_INLINE
 Curve::Sample IntegralCurve<Trimesh<>>::move_forward_from_vertex(const uint vid)
 {
     vec3d v = m_ptr->vert(vid);
-    vec3d n = m_ptr->vert_data(vid).normal;
+    vec3d n = m_ptr->vert_normal(vid);
     Plane tangent_plane(v,n);
 
     vec3d grad(0,0,0);
@@ -271,7 +271,7 @@ Curve::Sample IntegralCurve<Trimesh<>>::move_forward_from_edge(const uint eid, c
     uint   v1 = m_ptr->edge_vert_id(eid,1);
     uint   v2 = m_ptr->vert_opposite_to(f0, v0, v1);
     uint   v3 = m_ptr->vert_opposite_to(f1, v0, v1);
-    vec3d n  = m_ptr->poly_data(f0).normal + m_ptr->poly_data(f1).normal; n.normalize();
+    vec3d n  = m_ptr->poly_normal(f0) + m_ptr->poly_normal(f1); n.normalize();
 
     Plane tangent_plane(p,n);
 
@@ -34,48 +34,26 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/vertex_clustering.h>
-#include <cinolib/bfs.h>
+#include <cinolib/weld_points.h>
 
 namespace cinolib
 {
 
-template<class Vertex>
+template<uint d, class T>
 CINO_INLINE
-void vertex_clustering(const std::vector<Vertex>             & points,
+void vertex_clustering(const std::vector<mat<d,1,T>>         & points,
                        const double                            proximity_thresh,
                        std::vector<std::unordered_set<uint>> & clusters)
 {
-    // build v2v connectivity based on point proximity
-    std::vector<std::vector<uint>> v2v(points.size());
-    for(uint vid0=0;      vid0<points.size()-1; ++vid0)
-    for(uint vid1=vid0+1; vid1<points.size();   ++vid1)
-    {
-        if (points.at(vid0).dist(points.at(vid1)) < proximity_thresh)
-        {
-            v2v.at(vid0).push_back(vid1);
-            v2v.at(vid1).push_back(vid0);
-        }
-    }
+    std::vector<uint> cluster_id;
+    uint n_clusters = weld_points(points, proximity_thresh, cluster_id);
 
-    // visit the resulting graph with BFS to
-    // isolate clusters of adjacent vertices
-    uint nv   = points.size();
-    uint seed = 0;
-    std::vector<bool> visited(nv, false);
-    do
+    uint offset = uint(clusters.size());
+    clusters.resize(offset + n_clusters);
+    for(uint vid=0; vid<points.size(); ++vid)
     {
-        std::unordered_set<uint> cluster;
-        bfs(v2v, seed, cluster);
-
-        clusters.push_back(cluster);
-        for(uint vid : cluster) visited.at(vid) = true;
-
-        seed = 0;
-        while (seed < nv && visited.at(seed)) ++seed;
+        clusters.at(offset + cluster_id.at(vid)).insert(vid);
     }
-    while (seed < nv);
 }
 
-
 }
-
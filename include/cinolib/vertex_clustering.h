@@ -40,6 +40,7 @@
 #include <vector>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
 
 
 namespace cinolib
@@ -47,13 +48,12 @@ namespace cinolib
 
 /* Groups a list of vertices in clusters of elements closer
  * to each other less than a given proximity threshold
- *
- * NOTE: class Vertex should implement the dist() operator
+ * (see weld_points.h for a flat, per point cluster id output)
 */
 
-template<class Vertex>
+template<uint d, class T>
 CINO_INLINE
-void vertex_clustering(const std::vector<Vertex>             & points,
+void vertex_clustering(const std::vector<mat<d,1,T>>         & points,
                        const double                            proximity_thresh,
                        std::vector<std::unordered_set<uint>> & clusters);
 
@@ -0,0 +1,252 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/weld_points.h>
+#include <cinolib/union_find.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+namespace cinolib
+{
+
+// hashes the (unbounded) integer coordinates of a grid cell. Collisions are
+// harmless: they only add false candidates, which are then discarded by the
+// distance test
+//
+template<uint d>
+CINO_INLINE
+uint64_t sorted_grid_key(const int64_t c[d])
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    for(uint i=0; i<d; ++i)
+    {
+        uint64_t x = uint64_t(c[i]) + 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        x =  x ^ (x >> 31);
+        h = (h ^ x) * 0x100000001b3ull;
+    }
+    return h;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint d, class T>
+CINO_INLINE
+SortedPointGrid<d,T>::SortedPointGrid(const std::vector<mat<d,1,T>> & points, const double cell_size) : cell_size(cell_size)
+{
+    origin = mat<d,1,T>((T)0);
+    if(!points.empty()) origin = points.front();
+    for(const auto & p : points)
+    for(uint i=0; i<d; ++i) origin[i] = std::min(origin[i], p[i]);
+
+    std::vector<std::pair<uint64_t,uint>> grid(points.size());
+    PARALLEL_FOR(0, uint(points.size()), 10000, [&](const uint i)
+    {
+        int64_t c[d];
+        cell(points[i], c);
+        grid[i] = std::make_pair(sorted_grid_key<d>(c), i);
+    });
+    std::sort(grid.begin(), grid.end());
+
+    ids.resize(grid.size());
+    pts.resize(grid.size());
+    uint n_cells = 0;
+    for(uint i=0; i<grid.size(); ++i)
+    {
+        ids[i] = grid[i].second;
+        pts[i] = points[ids[i]];
+        if(i==0 || grid[i].first!=grid[i-1].first) ++n_cells;
+    }
+
+    // linear probing hash table, with load factor below 0.5
+    uint size = 1;
+    while(size < 2*n_cells) size <<= 1;
+    Cell empty = { 0, 0, 0 };
+    table.assign(size, empty);
+    for(uint i=0; i<grid.size();)
+    {
+        uint j = i+1;
+        while(j<grid.size() && grid[j].first==grid[i].first) ++j;
+        uint slot = uint(grid[i].first) & (size-1);
+        while(table[slot].beg!=table[slot].end) slot = (slot+1) & (size-1);
+        table[slot].key = grid[i].first;
+        table[slot].beg = i;
+        table[slot].end = j;
+        i = j;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint d, class T>
+CINO_INLINE
+void SortedPointGrid<d,T>::cell(const mat<d,1,T> & p, int64_t c[d]) const
+{
+    if(cell_size<=0)
+    {
+        // degenerate grid: each cell contains the points with the same exact
+        // coordinates (+0.0 maps -0.0 to 0.0, so that they share the cell)
+        for(uint i=0; i<d; ++i)
+        {
+            double x = double(p[i]) + 0.0;
+            std::memcpy(&c[i], &x, sizeof(double));
+        }
+        return;
+    }
+    for(uint i=0; i<d; ++i) c[i] = int64_t(std::floor((p[i]-origin[i])/cell_size));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint d, class T>
+template<class Func>
+CINO_INLINE
+void SortedPointGrid<d,T>::for_each_in_cell(const int64_t c[d], const Func & func) const
+{
+    if(table.empty()) return;
+    uint64_t key  = sorted_grid_key<d>(c);
+    uint     mask = uint(table.size()-1);
+    uint     slot = uint(key) & mask;
+    while(table[slot].beg!=table[slot].end)
+    {
+        const Cell & cell = table[slot];
+        if(cell.key==key)
+        {
+            for(uint j=cell.beg; j<cell.end; ++j) func(ids[j], pts[j]);
+            return;
+        }
+        slot = (slot+1) & mask;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint d, class T>
+template<class Func>
+CINO_INLINE
+void SortedPointGrid<d,T>::for_each_around(const mat<d,1,T> & p, const double r, const Func & func) const
+{
+    int64_t lo[d], hi[d], c[d];
+    if(cell_size<=0 || r<=0)
+    {
+        cell(p, c);
+        for_each_in_cell(c, func);
+        return;
+    }
+    cell(p - mat<d,1,T>(r), lo);
+    cell(p + mat<d,1,T>(r), hi);
+    for(uint i=0; i<d; ++i) c[i] = lo[i];
+    for(;;)
+    {
+        for_each_in_cell(c, func);
+
+        uint i=0;
+        for(; i<d; ++i)
+        {
+            if(++c[i]<=hi[i]) break;
+            c[i] = lo[i];
+        }
+        if(i==d) break;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint d, class T>
+CINO_INLINE
+uint weld_points(const std::vector<mat<d,1,T>> & points,
+                 const double                    eps,
+                       std::vector<uint>       & cluster_id)
+{
+    SortedPointGrid<d,T> grid(points, 2*eps);
+    const double eps_sqrd = eps*eps;
+
+    // points are visited in grid order, for better memory locality
+    UnionFind uf(uint(points.size()));
+    PARALLEL_FOR(0, uint(points.size()), 10000, [&](const uint pos)
+    {
+        uint i = grid.sorted_ids()[pos];
+        const mat<d,1,T> & p = grid.sorted_points()[pos];
+        grid.for_each_around(p, eps, [&](const uint j, const mat<d,1,T> & q)
+        {
+            // each pair is tested by both points. Only the one with lower id unites
+            // with eps<=0 only exact duplicates are welded
+            if(j>i && (eps>0 ? (p-q).norm_sqrd()<eps_sqrd : p==q)) uf.unite(i,j);
+        });
+    });
+    return uf.labels(cluster_id);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint d, class T>
+CINO_INLINE
+uint match_points(const std::vector<mat<d,1,T>> & ref,
+                  const std::vector<mat<d,1,T>> & query,
+                  const double                    eps,
+                        std::vector<int>        & match)
+{
+    SortedPointGrid<d,T> grid(ref, 2*eps);
+    const double eps_sqrd = eps*eps;
+
+    match.resize(query.size());
+    PARALLEL_FOR(0, uint(query.size()), 10000, [&](const uint i)
+    {
+        const mat<d,1,T> & p = query[i];
+        double best = eps_sqrd;
+        match[i] = -1;
+        grid.for_each_around(p, eps, [&](const uint j, const mat<d,1,T> & q)
+        {
+            // with eps<=0 only exact duplicates are matched
+            double dist = (p-q).norm_sqrd();
+            if(match[i]<0 ? (eps>0 ? dist<best : p==q)
+                          : (dist<best || (dist==best && int(j)<match[i])))
+            {
+                best     = dist;
+                match[i] = int(j);
+            }
+        });
+    });
+
+    uint n_matched = 0;
+    for(int m : match) if(m>=0) ++n_matched;
+    return n_matched;
+}
+
+}
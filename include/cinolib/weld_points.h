@@ -0,0 +1,139 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_WELD_POINTS_H
+#define CINO_WELD_POINTS_H
+
+#include <array>
+#include <vector>
+#include <stdint.h>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
+
+namespace cinolib
+{
+
+/* Spatial hashing facilities to find coincident (or almost coincident)
+ * points in large point sets, such as the vertices of scanned patches that
+ * must be welded together.
+ *
+ * Points are bucketed in a uniform grid with cells of size 2*eps, and sorted
+ * by (hashed) cell. All the points closer than eps to a point p lie in the
+ * cells overlapped by the box [p-eps,p+eps], which spans either one or two
+ * cells per axis (on average, less than 4 cells must be visited in 3D).
+ * Grid construction and neighbor queries run in parallel, and proximity
+ * clusters are computed with a lock free union-find. Both routines output
+ * flat arrays of ids.
+*/
+
+// clusters points closer than eps to each other (transitively), and returns
+// the number of clusters. cluster_id[i] is the cluster of the i-th point.
+// Clusters are numbered in order of their lowest point id. If eps<=0 only
+// points with exactly the same coordinates are welded
+//
+template<uint d, class T>
+CINO_INLINE
+uint weld_points(const std::vector<mat<d,1,T>> & points,
+                 const double                    eps,
+                       std::vector<uint>       & cluster_id);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// for each query point, finds the closest reference point within distance eps
+// (match[i] is -1 if the i-th query point is farther than eps from all points
+// in the reference set). Returns the number of matched query points. If
+// eps<=0 only reference points with exactly the same coordinates are matched
+//
+template<uint d, class T>
+CINO_INLINE
+uint match_points(const std::vector<mat<d,1,T>> & ref,
+                  const std::vector<mat<d,1,T>> & query,
+                  const double                    eps,
+                        std::vector<int>        & match);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// uniform grid used by the routines above. Points are sorted by (hashed)
+// cell, and an open addressing hash table maps each non empty cell to its
+// range of points. Positions are stored in sorted order too, so that points
+// in the same cell are contiguous in memory
+//
+template<uint d, class T>
+class SortedPointGrid
+{
+    public:
+
+        // if cell_size<=0 each cell contains the points with the same exact coordinates
+        explicit SortedPointGrid(const std::vector<mat<d,1,T>> & points, const double cell_size);
+
+        // integer coordinates of the cell containing p
+        void cell(const mat<d,1,T> & p, int64_t c[d]) const;
+
+        // calls func(point_id, point) for each point in the cells overlapped by the box
+        // [p-r,p+r] (and possibly for a few other points, in case of hash collisions)
+        template<class Func>
+        void for_each_around(const mat<d,1,T> & p, const double r, const Func & func) const;
+
+        // calls func(point_id, point) for each point in cell c
+        template<class Func>
+        void for_each_in_cell(const int64_t c[d], const Func & func) const;
+
+        // points (and their ids) sorted by cell
+        const std::vector<uint>       & sorted_ids()    const { return ids; }
+        const std::vector<mat<d,1,T>> & sorted_points() const { return pts; }
+
+    private:
+
+        struct Cell
+        {
+            uint64_t key;
+            uint     beg, end; // range of the cell in ids/pts (beg==end: empty slot)
+        };
+
+        mat<d,1,T>              origin;
+        double                  cell_size;
+        std::vector<uint>       ids;   // point ids sorted by cell key
+        std::vector<mat<d,1,T>> pts;   // point positions sorted by cell key
+        std::vector<Cell>       table; // hash table of non empty cells (linear probing)
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "weld_points.cpp"
+#endif
+
+#endif // CINO_WELD_POINTS_H